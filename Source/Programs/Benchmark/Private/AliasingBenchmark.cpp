@@ -0,0 +1,119 @@
+#include "Benchmark.h"
+#include "Assertion.h"
+#include "TransientAliasingPlanner.h"
+
+namespace Thunder
+{
+    namespace
+    {
+        constexpr uint32 GAliasingIterationCount = 1000;
+        constexpr uint64 GPlacementAlignment = 64 * 1024;
+
+        // Approximates the placement size, a backend adds some tiling padding on top.
+        TransientAllocationRequest MakeTarget(uint32 width, uint32 height, uint32 bytesPerPixel, uint32 firstPass, uint32 lastPass)
+        {
+            const uint64 size = static_cast<uint64>(width) * height * bytesPerPixel;
+            return { (size + GPlacementAlignment - 1) & ~(GPlacementAlignment - 1), GPlacementAlignment, firstPass, lastPass };
+        }
+
+        // Deferred frame at 4K: depth prepass, gbuffer, four shadow cascades each projected right after it is rendered,
+        // SSAO, lighting, a bloom chain and post-processing.
+        TArray<TransientAllocationRequest> MakeDeferredFrame()
+        {
+            constexpr uint32 width = 3840;
+            constexpr uint32 height = 2160;
+            constexpr uint32 cascadeSize = 2048;
+
+            TArray<TransientAllocationRequest> targets;
+            targets.push_back(MakeTarget(width, height, 4, 0, 11)); // Scene depth.
+            targets.push_back(MakeTarget(width, height, 4, 1, 11)); // GBuffer A, B, C.
+            targets.push_back(MakeTarget(width, height, 4, 1, 11));
+            targets.push_back(MakeTarget(width, height, 4, 1, 11));
+            targets.push_back(MakeTarget(width, height, 4, 1, 12)); // Velocity.
+            for (uint32 cascade = 0; cascade < 4; ++cascade)
+            {
+                targets.push_back(MakeTarget(cascadeSize, cascadeSize, 4, 2 + 2 * cascade, 3 + 2 * cascade));
+            }
+            targets.push_back(MakeTarget(width, height, 4, 3, 11)); // Shadow mask.
+            targets.push_back(MakeTarget(width / 2, height / 2, 1, 10, 11)); // SSAO.
+            targets.push_back(MakeTarget(width, height, 8, 11, 13)); // Scene color.
+            for (uint32 mip = 1; mip <= 5; ++mip)
+            {
+                targets.push_back(MakeTarget(width >> mip, height >> mip, 8, 12, 13)); // Bloom chain.
+            }
+            targets.push_back(MakeTarget(width, height, 4, 13, 14)); // Tonemapped.
+            targets.push_back(MakeTarget(width, height, 4, 14, 15)); // Anti-aliased.
+            return targets;
+        }
+
+        FORCEINLINE double ToMB(uint64 bytes)
+        {
+            return static_cast<double>(bytes) / (1024.0 * 1024.0);
+        }
+
+        // Targets live at the same time must not share memory, and the heap must hold every placement.
+        void CheckPlan(const TArray<TransientAllocationRequest>& targets, const TransientAliasingPlan& plan)
+        {
+            TAssertf(plan.Offsets.size() == targets.size(), "Plan has %zu offsets for %zu targets.", plan.Offsets.size(), targets.size());
+            uint64 sumOfSizes = 0;
+            for (size_t index = 0; index < targets.size(); ++index)
+            {
+                const TransientAllocationRequest& target = targets[index];
+                sumOfSizes += target.Size;
+                TAssertf(plan.Offsets[index] % target.Alignment == 0, "Target %zu is misaligned.", index);
+                TAssertf(plan.Offsets[index] + target.Size <= plan.HeapSize, "Target %zu ends past the heap.", index);
+                for (size_t other = index + 1; other < targets.size(); ++other)
+                {
+                    const bool bLiveTogether = target.FirstPass <= targets[other].LastPass && targets[other].FirstPass <= target.LastPass;
+                    const bool bMemoryOverlaps = plan.Offsets[index] < plan.Offsets[other] + targets[other].Size
+                        && plan.Offsets[other] < plan.Offsets[index] + target.Size;
+                    TAssertf(!(bLiveTogether && bMemoryOverlaps), "Targets %zu and %zu are live together but overlap.", index, other);
+                }
+            }
+            TAssertf(plan.HeapSize >= plan.LiveSizeBound, "Heap is smaller than the memory live during one pass.");
+            TAssertf(plan.HeapSize < sumOfSizes, "Aliasing saved nothing, %llu bytes for %llu bytes of targets.", plan.HeapSize, sumOfSizes);
+        }
+
+        // One target over the whole graph and a chain of equally sized targets living one after the other.
+        void CheckSyntheticGraph(TransientAliasingPlanner& planner)
+        {
+            constexpr uint32 chainLength = 3;
+            TArray<TransientAllocationRequest> targets;
+            targets.push_back({ 4 * GPlacementAlignment, GPlacementAlignment, 0, 2 * chainLength - 1 });
+            for (uint32 link = 0; link < chainLength; ++link)
+            {
+                targets.push_back({ 2 * GPlacementAlignment, GPlacementAlignment, 2 * link, 2 * link + 1 });
+            }
+
+            TransientAliasingPlan plan;
+            planner.Plan(targets, plan);
+            CheckPlan(targets, plan);
+            for (uint32 link = 2; link <= chainLength; ++link)
+            {
+                TAssertf(plan.Offsets[link] == plan.Offsets[1], "Chained target %u doesn't share the offset of the first one.", link - 1);
+            }
+            TAssertf(plan.HeapSize == 6 * GPlacementAlignment, "Synthetic graph needs %llu bytes, expected %llu.", plan.HeapSize, 6 * GPlacementAlignment);
+        }
+    }
+
+    THUNDER_BENCHMARK(TransientAliasing)
+    {
+        const TArray<TransientAllocationRequest> targets = MakeDeferredFrame();
+        TransientAliasingPlanner planner;
+        TransientAliasingPlan plan;
+
+        const double start = BenchmarkSeconds();
+        for (uint32 iteration = 0; iteration < GAliasingIterationCount; ++iteration)
+        {
+            planner.Plan(targets, plan);
+        }
+        const double planUs = (BenchmarkSeconds() - start) * 1e6 / GAliasingIterationCount;
+        CheckPlan(targets, plan);
+        CheckSyntheticGraph(planner);
+
+        LOG("%2zu targets | unaliased %8.2f MB | aliased heap %8.2f MB (%5.1f%%) | live bound %8.2f MB | plan %7.2f us",
+            targets.size(), ToMB(plan.UnaliasedSize), ToMB(plan.HeapSize),
+            100.0 * static_cast<double>(plan.HeapSize) / static_cast<double>(plan.UnaliasedSize),
+            ToMB(plan.LiveSizeBound), planUs);
+    }
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include "CoreMinimal.h"
+#include "Matrix.h"
+#include <chrono>
+#include <cmath>
+
+namespace Thunder
+{
+    using BenchmarkFunction = void(*)();
+
+    // Benchmarks register themselves at static init time, main() runs all of them or the ones named on the command line.
+    class BenchmarkRegistry
+    {
+    public:
+        BenchmarkRegistry(const char* name, BenchmarkFunction function)
+        {
+            GetBenchmarks().emplace_back(name, function);
+        }
+
+        static TArray<std::pair<String, BenchmarkFunction>>& GetBenchmarks()
+        {
+            static TArray<std::pair<String, BenchmarkFunction>> benchmarks;
+            return benchmarks;
+        }
+    };
+
+    #define THUNDER_BENCHMARK(Name) \
+        static void Name(); \
+        static BenchmarkRegistry Name##Registry(#Name, &Name); \
+        static void Name()
+
+    FORCEINLINE double BenchmarkSeconds()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    FORCEINLINE double Percentile(TArray<double>& samples, double percent)
+    {
+        if (samples.empty())
+        {
+            return 0.0;
+        }
+        std::ranges::sort(samples);
+        const size_t index = std::min(samples.size() - 1, static_cast<size_t>(percent * static_cast<double>(samples.size())));
+        return samples[index];
+    }
+
+    // Left-handed perspective looking down +Z, row vectors.
+    FORCEINLINE TMatrix44f MakePerspective(float fovY, float aspect, float nearZ, float farZ)
+    {
+        const float yScale = 1.f / std::tan(fovY * 0.5f);
+        TMatrix44f result(0.f);
+        result.M[0][0] = yScale / aspect;
+        result.M[1][1] = yScale;
+        result.M[2][2] = farZ / (farZ - nearZ);
+        result.M[2][3] = 1.f;
+        result.M[3][2] = -nearZ * farZ / (farZ - nearZ);
+        return result;
+    }
+
+    // Orthographic box centered on the origin, like a directional light covering half the scene.
+    FORCEINLINE TMatrix44f MakeOrthographic(float halfWidth, float halfHeight, float halfDepth)
+    {
+        TMatrix44f result(0.f);
+        result.M[0][0] = 1.f / halfWidth;
+        result.M[1][1] = 1.f / halfHeight;
+        result.M[2][2] = 0.5f / halfDepth;
+        result.M[3][2] = 0.5f;
+        result.M[3][3] = 1.f;
+        return result;
+    }
+}
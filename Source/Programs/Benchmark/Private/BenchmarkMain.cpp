@@ -0,0 +1,58 @@
+#include "Benchmark.h"
+#include "CoreModule.h"
+#include "NullRHIModule.h"
+#include "Concurrent/TaskScheduler.h"
+#include "Concurrent/TaskTrace.h"
+#include "Misc/CoreGlabal.h"
+#include <algorithm>
+
+using namespace Thunder;
+
+// Usage: Benchmark [--trace <output prefix>] [benchmark names...]
+int main(int argc, char* argv[])
+{
+    TArray<String> selectedNames;
+    String tracePrefix;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (String(argv[i]) == "--trace" && i + 1 < argc)
+        {
+            tracePrefix = argv[++i];
+        }
+        else
+        {
+            selectedNames.emplace_back(argv[i]);
+        }
+    }
+
+    ModuleManager::GetInstance()->LoadModule<CoreModule>();
+    TaskSchedulerManager::StartUp();
+
+    // Render code runs against the null RHI, the benchmarks advance the render thread frame number themselves.
+    GFrameState = new (TMemory::Malloc<FrameState>()) FrameState();
+    ModuleManager::GetInstance()->LoadModule<TNullRHIModule>();
+    TaskTrace::SetEnabled(!tracePrefix.empty());
+
+    for (const auto& [name, function] : BenchmarkRegistry::GetBenchmarks())
+    {
+        if (selectedNames.empty() || std::ranges::find(selectedNames, name) != selectedNames.end())
+        {
+            LOG("==== %s ====", name.c_str());
+            function();
+        }
+    }
+
+    if (!tracePrefix.empty())
+    {
+        TaskTrace::SetEnabled(false);
+        TaskTrace::DumpChromeTrace(tracePrefix + ".json");
+        TaskTrace::DumpSummary(tracePrefix + ".txt");
+        LOG("%s", TaskTrace::BuildSummary().c_str());
+    }
+
+    ModuleManager::GetInstance()->UnloadModule<TNullRHIModule>();
+    TMemory::Destroy(GFrameState);
+    TaskSchedulerManager::ShutDown();
+    ModuleManager::GetInstance()->UnloadModule<CoreModule>();
+    return 0;
+}
@@ -0,0 +1,332 @@
+#include "Benchmark.h"
+#include "RHICommandPartition.h"
+#include "Concurrent/TaskScheduler.h"
+#include "Concurrent/TheadPool.h"
+#include <cstring>
+#include <deque>
+
+namespace Thunder
+{
+    namespace
+    {
+        constexpr uint32 GSplitIterationCount = 50;
+        constexpr uint32 GDescriptorSize = 32;
+        constexpr uint32 GMaxTableDescriptors = 64;
+        constexpr uint32 GPSODescSize = 512;
+        constexpr uint32 GPacketBufferSize = 1024 * 1024;
+
+        // Synthetic frame recorded the way the frame graph submits it. State pointers are only compared, never dereferenced.
+        struct SyntheticFrame
+        {
+            std::deque<RHIDrawCommand> Draws;
+            std::deque<RHIBeginPassCommand> BeginPasses;
+            std::deque<RHIEndPassCommand> EndPasses;
+            std::deque<RHIUpdateBufferRegionsCommand> Copies;
+            RHIBeginFrameCommand BeginFrame;
+            TArray<IRHICommand*> Commands;
+            uint8 FakeStates[1024] {};
+
+            // Recording side data the cost estimate never sees: descriptor tables differ in size per material.
+            uint32 TableDescriptors[256] {};
+            uint8 DescriptorHeap[GMaxTableDescriptors * GDescriptorSize] {};
+            uint8 PSODescs[256][GPSODescSize] {};
+            uint8 UploadData[4096] {};
+
+            void AddPass(uint32 numRenderTargets, bool bDepth, uint32 numReads)
+            {
+                RHIBeginPassCommand& beginPass = BeginPasses.emplace_back();
+                beginPass.RenderTargetCount = numRenderTargets;
+                beginPass.ReadRenderTargets.resize(numReads);
+                beginPass.bIsBackBufferPass = numRenderTargets == 0 && !bDepth;
+                Commands.push_back(&beginPass);
+            }
+
+            void AddDraws(uint32 numDraws, uint32 drawsPerMaterial, uint32 indexCount)
+            {
+                for (uint32 index = 0; index < numDraws; ++index)
+                {
+                    const uint32 material = (index / drawsPerMaterial) % 256;
+                    RHIDrawCommand& draw = Draws.emplace_back();
+                    draw.GraphicsPSO = reinterpret_cast<TRHIPipelineState*>(&FakeStates[material]);
+                    draw.Shader = reinterpret_cast<ShaderCombination*>(&FakeStates[256 + material]);
+                    draw.VBToSet = reinterpret_cast<RHIVertexBuffer*>(&FakeStates[512 + index % 256]);
+                    draw.IBToSet = reinterpret_cast<RHIIndexBuffer*>(&FakeStates[768 + index % 256]);
+                    draw.IndexCount = indexCount;
+                    Commands.push_back(&draw);
+                }
+            }
+
+            void EndPass()
+            {
+                Commands.push_back(&EndPasses.emplace_back());
+            }
+
+            // Deferred frame: uploads, four shadow cascades of cheap same-state draws, a material heavy gbuffer,
+            // lighting and a chain of single-draw post passes.
+            void Build()
+            {
+                Commands.push_back(&BeginFrame);
+                for (uint32 copy = 0; copy < 8; ++copy)
+                {
+                    RHIUpdateBufferRegionsCommand& command = Copies.emplace_back();
+                    command.NumRegions = 16;
+                    Commands.push_back(&command);
+                }
+                for (uint32 cascade = 0; cascade < 4; ++cascade)
+                {
+                    AddPass(0, true, 0);
+                    AddDraws(3000, 500, 3000);
+                    EndPass();
+                }
+                AddPass(4, true, 0);
+                AddDraws(4000, 2, 30000);
+                EndPass();
+                AddPass(1, false, 5);
+                AddDraws(1, 1, 3);
+                EndPass();
+                for (uint32 post = 0; post < 12; ++post)
+                {
+                    AddPass(1, false, 1);
+                    AddDraws(1, 1, 3);
+                    EndPass();
+                }
+                AddPass(0, false, 1);
+                AddDraws(1, 1, 3);
+                EndPass();
+
+                uint32 seed = 0x2545F491u;
+                for (uint32 material = 0; material < 256; ++material)
+                {
+                    seed = seed * 1664525u + 1013904223u;
+                    TableDescriptors[material] = 2 + (seed >> 8) % (GMaxTableDescriptors - 1);
+                    for (uint32 byteIndex = 0; byteIndex < GPSODescSize; ++byteIndex)
+                    {
+                        PSODescs[material][byteIndex] = static_cast<uint8>(seed >> (byteIndex % 24));
+                    }
+                }
+            }
+
+            uint32 GetMaterial(const void* state, uint32 base) const
+            {
+                return static_cast<uint32>(static_cast<const uint8*>(state) - &FakeStates[base]);
+            }
+        };
+
+        /**
+         * Stand-in for a backend command list. It does the recording work itself instead of asking a cost model:
+         * packets are written to a buffer, redundant state is filtered, a PSO change hashes its desc for the cache
+         * lookup and a shader change copies the material's descriptor table.
+         */
+        class SyntheticCommandList
+        {
+        public:
+            SyntheticCommandList() : Packets(GPacketBufferSize) {}
+
+            void Reset()
+            {
+                PSO = nullptr;
+                Shader = nullptr;
+                VB = nullptr;
+                IB = nullptr;
+            }
+
+            void Record(const SyntheticFrame& frame, const IRHICommand* command)
+            {
+                switch (command->Type)
+                {
+                case ERHICommandType::Draw:
+                    RecordDraw(frame, static_cast<const RHIDrawCommand*>(command));
+                    break;
+                case ERHICommandType::BeginPass:
+                {
+                    const auto* beginPass = static_cast<const RHIBeginPassCommand*>(command);
+                    Reset();
+                    const uint32 numBarriers = beginPass->RenderTargetCount + static_cast<uint32>(beginPass->ReadRenderTargets.size()) + 1;
+                    for (uint32 barrier = 0; barrier < numBarriers; ++barrier)
+                    {
+                        Write(frame.UploadData, 64);
+                    }
+                    break;
+                }
+                case ERHICommandType::EndPass:
+                    Reset();
+                    Write(frame.UploadData, 16);
+                    break;
+                case ERHICommandType::UpdateBufferRegions:
+                    for (uint32 region = 0; region < static_cast<const RHIUpdateBufferRegionsCommand*>(command)->NumRegions; ++region)
+                    {
+                        Write(frame.UploadData, 256);
+                    }
+                    break;
+                default:
+                    Write(frame.UploadData, 16);
+                    break;
+                }
+            }
+
+        private:
+            void RecordDraw(const SyntheticFrame& frame, const RHIDrawCommand* draw)
+            {
+                if (draw->GraphicsPSO != PSO)
+                {
+                    PSO = draw->GraphicsPSO;
+                    const uint8* desc = frame.PSODescs[frame.GetMaterial(PSO, 0)];
+                    uint64 hash = 14695981039346656037ull;
+                    for (uint32 byteIndex = 0; byteIndex < GPSODescSize; ++byteIndex)
+                    {
+                        hash = (hash ^ desc[byteIndex]) * 1099511628211ull;
+                    }
+                    Write(&hash, sizeof(hash));
+                }
+                if (draw->Shader != Shader)
+                {
+                    Shader = draw->Shader;
+                    Write(frame.DescriptorHeap, frame.TableDescriptors[frame.GetMaterial(Shader, 256)] * GDescriptorSize);
+                }
+                if (draw->VBToSet != VB || draw->IBToSet != IB)
+                {
+                    VB = draw->VBToSet;
+                    IB = draw->IBToSet;
+                    const void* buffers[] = { VB, IB };
+                    Write(buffers, sizeof(buffers));
+                }
+                Write(draw, sizeof(RHIDrawCommand));
+            }
+
+            void Write(const void* data, size_t size)
+            {
+                if (Offset + size > Packets.size())
+                {
+                    Offset = 0;
+                }
+                memcpy(&Packets[Offset], data, size);
+                Offset += size;
+            }
+
+            TArray<uint8> Packets;
+            size_t Offset = 0;
+            const void* PSO = nullptr;
+            const void* Shader = nullptr;
+            const void* VB = nullptr;
+            const void* IB = nullptr;
+        };
+
+        uint32 FindOpenPass(const SyntheticFrame& frame, uint32 index)
+        {
+            while (index-- > 0)
+            {
+                if (frame.Commands[index]->Type == ERHICommandType::BeginPass)
+                {
+                    return index;
+                }
+                if (frame.Commands[index]->Type == ERHICommandType::EndPass)
+                {
+                    break;
+                }
+            }
+            return ~0u;
+        }
+
+        // What RHIMain did before: equal command counts, a chunk replays the pass it starts in.
+        void PartitionByCount(const SyntheticFrame& frame, uint32 numChunks, TArray<RHICommandChunk>& outChunks)
+        {
+            outChunks.clear();
+            const uint32 numCommands = static_cast<uint32>(frame.Commands.size());
+            const uint32 chunkSize = (numCommands + numChunks - 1) / numChunks;
+            for (uint32 begin = 0; begin < numCommands; begin += chunkSize)
+            {
+                outChunks.push_back({ begin, std::min(begin + chunkSize, numCommands), FindOpenPass(frame, begin), 0 });
+            }
+        }
+
+        // Records every chunk on its own worker, replaying the begin pass of the pass it starts in where needed.
+        double MeasureMakespan(const SyntheticFrame& frame, const TArray<RHICommandChunk>& chunks, TArray<SyntheticCommandList>& commandLists,
+            TArray<double>& outChunkSeconds)
+        {
+            outChunkSeconds.assign(chunks.size(), 0.0);
+            const double start = BenchmarkSeconds();
+            GSyncWorkers->ParallelForRange(static_cast<uint32>(chunks.size()), [&](uint32 begin, uint32 end, uint32 contextIndex)
+            {
+                SyntheticCommandList& commandList = commandLists[contextIndex];
+                for (uint32 chunk = begin; chunk < end; ++chunk)
+                {
+                    const double chunkStart = BenchmarkSeconds();
+                    commandList.Reset();
+                    if (chunks[chunk].NeedsPassReplay())
+                    {
+                        commandList.Record(frame, frame.Commands[chunks[chunk].ReplayPassBegin]);
+                    }
+                    for (uint32 index = chunks[chunk].Begin; index < chunks[chunk].End; ++index)
+                    {
+                        commandList.Record(frame, frame.Commands[index]);
+                    }
+                    outChunkSeconds[chunk] = BenchmarkSeconds() - chunkStart;
+                }
+            }, 1);
+            return BenchmarkSeconds() - start;
+        }
+
+        double MeasureSerial(const SyntheticFrame& frame, SyntheticCommandList& commandList)
+        {
+            const double start = BenchmarkSeconds();
+            commandList.Reset();
+            for (const IRHICommand* command : frame.Commands)
+            {
+                commandList.Record(frame, command);
+            }
+            return BenchmarkSeconds() - start;
+        }
+
+        void Report(const char* name, const TArray<RHICommandChunk>& chunks, double slowestChunkUs, double makespanUs, double idealUs)
+        {
+            uint32 numReplays = 0;
+            for (const RHICommandChunk& chunk : chunks)
+            {
+                numReplays += chunk.NeedsPassReplay() ? 1 : 0;
+            }
+            LOG("%-6s | %2zu chunks | slowest chunk %8.1f us | makespan %8.1f us (ideal %8.1f us) | pass replays %2u",
+                name, chunks.size(), slowestChunkUs, makespanUs, idealUs, numReplays);
+        }
+    }
+
+    THUNDER_BENCHMARK(CommandSplit)
+    {
+        SyntheticFrame frame;
+        frame.Build();
+        const uint32 numChunks = std::max(2u, static_cast<uint32>(GSyncWorkers->GetNumThreads()));
+        TArray<SyntheticCommandList> commandLists(GSyncWorkers->GetNumContexts());
+
+        TArray<RHICommandChunk> countChunks;
+        PartitionByCount(frame, numChunks, countChunks);
+
+        RHICommandPartitioner partitioner;
+        TArray<RHICommandChunk> costChunks;
+        const double partitionStart = BenchmarkSeconds();
+        for (uint32 iteration = 0; iteration < GSplitIterationCount; ++iteration)
+        {
+            partitioner.Partition(frame.Commands, numChunks, costChunks);
+        }
+        const double partitionUs = (BenchmarkSeconds() - partitionStart) * 1e6 / GSplitIterationCount;
+
+        // Both splits are timed on the same recording work, the ideal is the serial time spread evenly.
+        TArray<double> serialSamples;
+        TArray<double> countSamples;
+        TArray<double> costSamples;
+        TArray<double> countSlowest;
+        TArray<double> costSlowest;
+        TArray<double> chunkSeconds;
+        for (uint32 iteration = 0; iteration < GSplitIterationCount; ++iteration)
+        {
+            serialSamples.push_back(MeasureSerial(frame, commandLists[0]) * 1e6);
+            countSamples.push_back(MeasureMakespan(frame, countChunks, commandLists, chunkSeconds) * 1e6);
+            countSlowest.push_back(*std::ranges::max_element(chunkSeconds) * 1e6);
+            costSamples.push_back(MeasureMakespan(frame, costChunks, commandLists, chunkSeconds) * 1e6);
+            costSlowest.push_back(*std::ranges::max_element(chunkSeconds) * 1e6);
+        }
+        const double idealUs = Percentile(serialSamples, 0.5) / numChunks;
+
+        LOG("%zu commands, partitioned by cost in %.1f us", frame.Commands.size(), partitionUs);
+        Report("count", countChunks, Percentile(countSlowest, 0.5), Percentile(countSamples, 0.5), idealUs);
+        Report("cost", costChunks, Percentile(costSlowest, 0.5), Percentile(costSamples, 0.5), idealUs);
+    }
+}
@@ -0,0 +1,96 @@
+#include "Benchmark.h"
+#include "PrimitiveBounds.h"
+#include "Concurrent/TaskScheduler.h"
+#include <bit>
+#include <random>
+
+namespace Thunder
+{
+    namespace
+    {
+        constexpr uint32 GCullPrimitiveCount = 100000;
+        constexpr uint32 GCullIterationCount = 50;
+
+        void FillRandomBounds(PrimitiveBoundsBuffer& buffer)
+        {
+            std::mt19937 random(1234);
+            std::uniform_real_distribution<float> position(-500.f, 500.f);
+            std::uniform_real_distribution<float> size(0.5f, 5.f);
+            for (uint32 index = 0; index < GCullPrimitiveCount; ++index)
+            {
+                // The buffer never dereferences the scene info, any non-null tag will do.
+                const uint32 primitiveIndex = buffer.Allocate(reinterpret_cast<PrimitiveSceneInfo*>(static_cast<uintptr_t>(index + 1)));
+                const float center[3] = { position(random), position(random), position(random) };
+                const float extent[3] = { size(random), size(random), size(random) };
+                buffer.SetBounds(primitiveIndex, AABB(
+                    TVector3f(center[0] - extent[0], center[1] - extent[1], center[2] - extent[2]),
+                    TVector3f(center[0] + extent[0], center[1] + extent[1], center[2] + extent[2])));
+            }
+        }
+
+        uint32 CountVisible(const TArray<uint64>& visibility)
+        {
+            uint32 count = 0;
+            for (const uint64 word : visibility)
+            {
+                count += static_cast<uint32>(std::popcount(word));
+            }
+            return count;
+        }
+
+        void RunCullingBenchmark(const PrimitiveBoundsBuffer& buffer, const ViewFrustum& frustum, const char* viewName)
+        {
+            const uint32 numWords = buffer.GetNumWords();
+            TArray<uint64> visibility(numWords);
+
+            // Reference: one primitive at a time.
+            uint32 scalarVisible = 0;
+            double start = BenchmarkSeconds();
+            for (uint32 iteration = 0; iteration < GCullIterationCount; ++iteration)
+            {
+                scalarVisible = 0;
+                for (uint32 index = 0; index < buffer.GetNumSlots(); ++index)
+                {
+                    scalarVisible += buffer.GetPrimitive(index) != nullptr && buffer.IsVisible(frustum, index) ? 1 : 0;
+                }
+            }
+            const double scalarMs = (BenchmarkSeconds() - start) * 1e3 / GCullIterationCount;
+
+            start = BenchmarkSeconds();
+            for (uint32 iteration = 0; iteration < GCullIterationCount; ++iteration)
+            {
+                buffer.Cull(frustum, 0, numWords, visibility.data());
+            }
+            const double simdMs = (BenchmarkSeconds() - start) * 1e3 / GCullIterationCount;
+            const uint32 simdVisible = CountVisible(visibility);
+
+            start = BenchmarkSeconds();
+            for (uint32 iteration = 0; iteration < GCullIterationCount; ++iteration)
+            {
+                GSyncWorkers->ParallelForRange(numWords, [&buffer, &frustum, &visibility](uint32 begin, uint32 end, uint32)
+                {
+                    buffer.Cull(frustum, begin, end, &visibility[begin]);
+                }, 8);
+            }
+            const double parallelMs = (BenchmarkSeconds() - start) * 1e3 / GCullIterationCount;
+            const uint32 parallelVisible = CountVisible(visibility);
+
+            LOG("%-10s %6u primitives | scalar %7.3f ms (%6u) | simd %7.3f ms (%6u) | parallel %7.3f ms (%6u)",
+                viewName, GCullPrimitiveCount, scalarMs, scalarVisible, simdMs, simdVisible, parallelMs, parallelVisible);
+        }
+    }
+
+    THUNDER_BENCHMARK(FrustumCulling)
+    {
+        PrimitiveBoundsBuffer buffer;
+        FillRandomBounds(buffer);
+
+        ViewFrustum mainView;
+        mainView.SetViewProjection(MakePerspective(1.0472f, 16.f / 9.f, 0.1f, 1000.f));
+        RunCullingBenchmark(buffer, mainView, "MainView");
+
+        ViewFrustum shadowView;
+        shadowView.SetViewProjection(MakeOrthographic(250.f, 250.f, 500.f));
+        RunCullingBenchmark(buffer, shadowView, "ShadowView");
+    }
+}
@@ -0,0 +1,167 @@
+#include "Benchmark.h"
+#include "Assertion.h"
+#include "RenderTargetPool.h"
+
+namespace Thunder
+{
+    namespace
+    {
+        constexpr uint32 GPoolIterationCount = 100000;
+
+        // Plain render texture objects without RHI resources, counts what the pool asks of it.
+        class CountingRenderTargetFactory : public IRenderTargetFactory
+        {
+        public:
+            RenderTextureRef CreateRenderTarget(const FGRenderTargetDesc& desc) override
+            {
+                ++NumCreated;
+                return new RenderTexture2D(desc.Width, desc.Height, desc.Format, nullptr);
+            }
+
+            void DestroyRenderTarget(const RenderTextureRef& renderTarget) override
+            {
+                ++NumDestroyed;
+                Destroyed.push_back(renderTarget.Get());
+            }
+
+            uint64 GetRenderTargetSize(const FGRenderTargetDesc& desc) override
+            {
+                return static_cast<uint64>(desc.Width) * desc.Height * 4;
+            }
+
+            bool WasDestroyed(const RenderTextureRef& renderTarget) const
+            {
+                return std::ranges::find(Destroyed, renderTarget.Get()) != Destroyed.end();
+            }
+
+            uint32 NumCreated = 0;
+            uint32 NumDestroyed = 0;
+            TArray<RenderTexture*> Destroyed;
+        };
+
+        void CheckReuse(RenderTargetPool& pool, CountingRenderTargetFactory& factory)
+        {
+            const FGRenderTargetDesc colorDesc(1920, 1080, RHIFormat::R8G8B8A8_UNORM);
+            const FGRenderTargetDesc halfDesc(960, 540, RHIFormat::R8G8B8A8_UNORM);
+
+            RenderTextureRef first = pool.AcquireRenderTarget(colorDesc);
+            pool.ReleaseRenderTarget(first);
+            RenderTextureRef reused = pool.AcquireRenderTarget(colorDesc);
+            TAssertf(reused.Get() == first.Get(), "Released target was not handed out again.");
+            TAssertf(factory.NumCreated == 1, "Reuse created %u targets, expected 1.", factory.NumCreated);
+
+            // Live targets are never shared, other descs never match.
+            RenderTextureRef second = pool.AcquireRenderTarget(colorDesc);
+            RenderTextureRef half = pool.AcquireRenderTarget(halfDesc);
+            TAssertf(second.Get() != reused.Get(), "A used target was handed out twice.");
+            TAssertf(factory.NumCreated == 3, "Created %u targets, expected 3.", factory.NumCreated);
+            TAssertf(pool.GetNumUsedTargets() == 3, "Pool tracks %u used targets, expected 3.", pool.GetNumUsedTargets());
+
+            pool.ReleaseRenderTarget(reused);
+            pool.ReleaseRenderTarget(second);
+            pool.ReleaseRenderTarget(half);
+            TAssertf(pool.GetNumFreeTargets() == 3 && pool.GetNumUsedTargets() == 0, "Released targets are not free.");
+            TAssertf(factory.NumDestroyed == 0, "Released targets were destroyed right away.");
+        }
+
+        void CheckEviction(RenderTargetPool& pool, CountingRenderTargetFactory& factory)
+        {
+            const uint32 numFree = pool.GetNumFreeTargets();
+            for (uint32 frame = 1; frame < RENDERTARGET_UNUSED_FRAME_THRESHOLD; ++frame)
+            {
+                pool.TickUnusedFrameCounters();
+                pool.ReleaseLongUnusedTargets();
+            }
+            TAssertf(factory.NumDestroyed == 0, "Targets idle for fewer than %u frames were destroyed.", RENDERTARGET_UNUSED_FRAME_THRESHOLD);
+
+            pool.TickUnusedFrameCounters();
+            pool.ReleaseLongUnusedTargets();
+            TAssertf(factory.NumDestroyed == numFree, "Destroyed %u of %u idle targets.", factory.NumDestroyed, numFree);
+            TAssertf(pool.GetNumFreeTargets() == 0 && pool.GetPooledMemory() == 0, "Evicted targets are still pooled.");
+        }
+
+        // Over budget, free targets go least recently used first whatever their bucket, used targets are never trimmed.
+        void CheckBudget(RenderTargetPool& pool, CountingRenderTargetFactory& factory)
+        {
+            const FGRenderTargetDesc descs[] = {
+                FGRenderTargetDesc(256, 256, RHIFormat::R8G8B8A8_UNORM),
+                FGRenderTargetDesc(512, 256, RHIFormat::R8G8B8A8_UNORM),
+                FGRenderTargetDesc(128, 128, RHIFormat::R8G8B8A8_UNORM),
+            };
+            const FGRenderTargetDesc usedDesc(64, 64, RHIFormat::R8G8B8A8_UNORM);
+            RenderTextureRef used = pool.AcquireRenderTarget(usedDesc);
+
+            // One bucket released per frame, the first one is the least recently used.
+            RenderTextureRef targets[std::size(descs)];
+            for (size_t index = 0; index < std::size(descs); ++index)
+            {
+                targets[index] = pool.AcquireRenderTarget(descs[index]);
+                pool.ReleaseRenderTarget(targets[index]);
+                pool.TickUnusedFrameCounters();
+            }
+            const uint64 usedSize = factory.GetRenderTargetSize(usedDesc);
+            const uint64 sizes[] = { factory.GetRenderTargetSize(descs[0]), factory.GetRenderTargetSize(descs[1]), factory.GetRenderTargetSize(descs[2]) };
+            TAssertf(pool.GetPooledMemory() == usedSize + sizes[0] + sizes[1] + sizes[2], "Pool holds %llu bytes before trimming.", pool.GetPooledMemory());
+
+            // Room for all but the oldest target.
+            pool.SetMemoryBudget(usedSize + sizes[1] + sizes[2]);
+            TAssertf(factory.WasDestroyed(targets[0]) && !factory.WasDestroyed(targets[1]) && !factory.WasDestroyed(targets[2]),
+                "Trimming to budget did not release the least recently used target alone.");
+
+            pool.SetMemoryBudget(usedSize + sizes[2]);
+            TAssertf(factory.WasDestroyed(targets[1]) && !factory.WasDestroyed(targets[2]), "Trimming released the targets out of use order.");
+
+            // Only the used target is left, the pool stays over budget until it is released.
+            pool.SetMemoryBudget(usedSize / 2);
+            TAssertf(factory.WasDestroyed(targets[2]) && !factory.WasDestroyed(used), "Trimming released a used target.");
+            TAssertf(pool.GetNumFreeTargets() == 0 && pool.GetPooledMemory() == usedSize, "Pool holds %llu bytes, expected the used target's %llu.",
+                pool.GetPooledMemory(), usedSize);
+
+            pool.ReleaseRenderTarget(used);
+            TAssertf(!factory.WasDestroyed(used) && pool.GetNumFreeTargets() == 1, "Released target was trimmed before the next trim.");
+            pool.ReleaseLongUnusedTargets();
+            TAssertf(factory.WasDestroyed(used) && pool.GetPooledMemory() == 0, "Released target over budget was not trimmed.");
+        }
+    }
+
+    THUNDER_BENCHMARK(RenderTargetPooling)
+    {
+        CountingRenderTargetFactory factory;
+        {
+            RenderTargetPool pool(&factory);
+            CheckReuse(pool, factory);
+            CheckEviction(pool, factory);
+        }
+        {
+            RenderTargetPool pool(&factory);
+            CheckBudget(pool, factory);
+        }
+
+        // Steady state of a frame graph: every acquire hits a free list.
+        RenderTargetPool pool(&factory);
+        const FGRenderTargetDesc descs[] = {
+            FGRenderTargetDesc(1920, 1080, RHIFormat::R8G8B8A8_UNORM),
+            FGRenderTargetDesc(1920, 1080, RHIFormat::D24_UNORM_S8_UINT),
+            FGRenderTargetDesc(960, 540, RHIFormat::R16G16B16A16_FLOAT),
+        };
+        RenderTextureRef targets[std::size(descs)];
+        const uint32 createdBefore = factory.NumCreated;
+        const double start = BenchmarkSeconds();
+        for (uint32 iteration = 0; iteration < GPoolIterationCount; ++iteration)
+        {
+            for (size_t index = 0; index < std::size(descs); ++index)
+            {
+                targets[index] = pool.AcquireRenderTarget(descs[index]);
+            }
+            for (const RenderTextureRef& target : targets)
+            {
+                pool.ReleaseRenderTarget(target);
+            }
+        }
+        const double pairNs = (BenchmarkSeconds() - start) * 1e9 / (static_cast<double>(GPoolIterationCount) * std::size(descs));
+        const uint32 created = factory.NumCreated - createdBefore;
+        TAssertf(created == std::size(descs), "Steady state created %u targets, expected %zu.", created, std::size(descs));
+
+        LOG("acquire + release %7.1f ns | created %u targets over %u frames", pairNs, created, GPoolIterationCount);
+    }
+}
@@ -0,0 +1,136 @@
+#include "Benchmark.h"
+#include "Concurrent/TaskScheduler.h"
+#include "Concurrent/TheadPool.h"
+
+namespace Thunder
+{
+    namespace
+    {
+        constexpr uint32 GFlatTaskCount = 200000;
+        constexpr uint32 GNestedRootCount = 64;
+        constexpr uint32 GNestedChildCount = 2048;
+        constexpr uint32 GWakeSampleCount = 200;
+
+        struct BenchmarkPool
+        {
+            ThreadPoolBase* Threads = nullptr;
+            PooledTaskScheduler* Scheduler = nullptr;
+        };
+
+        BenchmarkPool CreateBenchmarkPool(ESchedulingMode mode, const String& name)
+        {
+            const auto threadNum = FPlatformProcess::NumberOfLogicalProcessors();
+            BenchmarkPool pool;
+            pool.Threads = new (TMemory::Malloc<ThreadPoolBase>()) ThreadPoolBase(threadNum > 3 ? (threadNum - 3) : threadNum, 96 * 1024, name);
+            pool.Scheduler = new (TMemory::Malloc<PooledTaskScheduler>()) PooledTaskScheduler(mode);
+            pool.Threads->AttachToScheduler(pool.Scheduler);
+            return pool;
+        }
+
+        // Later benchmarks must not share the cores with idle threads of this one.
+        void DestroyBenchmarkPool(BenchmarkPool& pool)
+        {
+            pool.Scheduler->WaitForCompletionAndThreadExit();
+            TMemory::Destroy(pool.Scheduler);
+            TMemory::Destroy(pool.Threads);
+        }
+
+        void WaitForCounter(const std::atomic<uint32>& counter)
+        {
+            while (counter.load(std::memory_order_acquire) != 0)
+            {
+                FPlatformProcess::CoreYield();
+            }
+        }
+
+        // Tasks pushed from a thread outside the pool, every push goes through the shared queue.
+        double MeasureFlatThroughput(PooledTaskScheduler* scheduler)
+        {
+            std::atomic<uint32> remaining { GFlatTaskCount };
+            const double start = BenchmarkSeconds();
+            for (uint32 i = 0; i < GFlatTaskCount; ++i)
+            {
+                scheduler->PushTask([&remaining]()
+                {
+                    remaining.fetch_sub(1, std::memory_order_acq_rel);
+                });
+            }
+            WaitForCounter(remaining);
+            return GFlatTaskCount / (BenchmarkSeconds() - start);
+        }
+
+        // Root tasks spawn children from inside the pool, which is where the local deques kick in.
+        double MeasureNestedThroughput(PooledTaskScheduler* scheduler)
+        {
+            std::atomic<uint32> remaining { GNestedRootCount * GNestedChildCount };
+            const double start = BenchmarkSeconds();
+            for (uint32 root = 0; root < GNestedRootCount; ++root)
+            {
+                scheduler->PushTask([scheduler, &remaining]()
+                {
+                    for (uint32 child = 0; child < GNestedChildCount; ++child)
+                    {
+                        scheduler->PushTask([&remaining]()
+                        {
+                            remaining.fetch_sub(1, std::memory_order_acq_rel);
+                        });
+                    }
+                });
+            }
+            WaitForCounter(remaining);
+            return GNestedRootCount * GNestedChildCount / (BenchmarkSeconds() - start);
+        }
+
+        // Push a single task into an idle pool and time until it starts running.
+        void MeasureWakeLatency(PooledTaskScheduler* scheduler, double& outAverageUs, double& outP99Us)
+        {
+            TArray<double> samples;
+            samples.reserve(GWakeSampleCount);
+            for (uint32 sample = 0; sample < GWakeSampleCount; ++sample)
+            {
+                FPlatformProcess::Sleep(0.002f); // let the pool go back to sleep
+                std::atomic<uint32> remaining { 1 };
+                double startedAt = 0.0;
+                const double pushedAt = BenchmarkSeconds();
+                scheduler->PushTask([&remaining, &startedAt]()
+                {
+                    startedAt = BenchmarkSeconds();
+                    remaining.fetch_sub(1, std::memory_order_acq_rel);
+                });
+                WaitForCounter(remaining);
+                samples.push_back((startedAt - pushedAt) * 1e6);
+            }
+
+            double sum = 0.0;
+            for (const double value : samples)
+            {
+                sum += value;
+            }
+            outAverageUs = sum / static_cast<double>(samples.size());
+            outP99Us = Percentile(samples, 0.99);
+        }
+
+        void RunSchedulerBenchmark(ESchedulingMode mode, const char* modeName)
+        {
+            BenchmarkPool pool = CreateBenchmarkPool(mode, String("Bench") + modeName);
+            PooledTaskScheduler* scheduler = pool.Scheduler;
+
+            const double flat = MeasureFlatThroughput(scheduler);
+            const double nested = MeasureNestedThroughput(scheduler);
+            double wakeAverageUs = 0.0;
+            double wakeP99Us = 0.0;
+            MeasureWakeLatency(scheduler, wakeAverageUs, wakeP99Us);
+
+            LOG("%-13s threads %2d | flat %10.0f tasks/s | nested %10.0f tasks/s | wake avg %7.2f us p99 %7.2f us",
+                modeName, scheduler->GetNumThreads(), flat, nested, wakeAverageUs, wakeP99Us);
+
+            DestroyBenchmarkPool(pool);
+        }
+    }
+
+    THUNDER_BENCHMARK(TaskScheduler)
+    {
+        RunSchedulerBenchmark(ESchedulingMode::SharedQueue, "SharedQueue");
+        RunSchedulerBenchmark(ESchedulingMode::WorkStealing, "WorkStealing");
+    }
+}
@@ -0,0 +1,195 @@
+#include "Benchmark.h"
+#include "ShaderCache.h"
+#include "ShaderCompiler.h"
+#include "Memory/MemoryBase.h"
+#include <filesystem>
+#include <fstream>
+
+namespace Thunder
+{
+    namespace
+    {
+        constexpr uint32 GShaderCacheEntrySize = 1024;
+        constexpr uint32 GShaderCacheLookupCount = 1000;
+
+        // Byte code derived from the source alone, so a cached copy can be compared with a fresh compile.
+        class StubCompiler : public ICompiler
+        {
+        public:
+            void Compile(NameHandle archiveName, const String& inSource, SIZE_T srcDataSize, const THashMap<NameHandle, bool>& marco,
+                const String& includeStr, const String& pEntryPoint, const String& pTarget, BinaryData& outByteCode) override {}
+
+            void Compile(const String& inSource, const String& entryPoint, EShaderStageType stage, BinaryData& outByteCode, bool debug = false) override
+            {
+                ++NumCompiles;
+                MakeStubByteCode(inSource, outByteCode);
+            }
+
+            String GetIdentity() const override { return "StubCompiler 1"; }
+
+            static void MakeStubByteCode(const String& source, BinaryData& outByteCode)
+            {
+                uint8* data = static_cast<uint8*>(TMemory::Malloc<uint8>(GShaderCacheEntrySize));
+                for (uint32 index = 0; index < GShaderCacheEntrySize; ++index)
+                {
+                    data[index] = static_cast<uint8>(source[index % source.size()] + index);
+                }
+                outByteCode.Data = data;
+                outByteCode.Size = GShaderCacheEntrySize;
+            }
+
+            uint32 NumCompiles = 0;
+        };
+
+        void FreeByteCode(BinaryData& byteCode)
+        {
+            if (byteCode.Data)
+            {
+                uint8* data = static_cast<uint8*>(byteCode.Data);
+                TMemory::Destroy(data);
+                byteCode.Data = nullptr;
+                byteCode.Size = 0;
+            }
+        }
+
+        bool IsStubByteCode(const BinaryData& byteCode, const String& source)
+        {
+            BinaryData expected;
+            StubCompiler::MakeStubByteCode(source, expected);
+            const bool bSame = byteCode.Size == expected.Size && memcmp(byteCode.Data, expected.Data, expected.Size) == 0;
+            FreeByteCode(expected);
+            return bSame;
+        }
+
+        // Flips the last byte code byte of every entry file, the header and its CRC stay as they were.
+        uint32 CorruptEntries(const std::filesystem::path& directory)
+        {
+            uint32 numCorrupted = 0;
+            for (const auto& directoryEntry : std::filesystem::directory_iterator(directory))
+            {
+                if (directoryEntry.path().extension() != ".tsc")
+                {
+                    continue;
+                }
+                std::fstream file(directoryEntry.path(), std::ios::binary | std::ios::in | std::ios::out);
+                file.seekg(-1, std::ios::end);
+                const char last = static_cast<char>(file.get());
+                file.seekp(-1, std::ios::end);
+                file.put(static_cast<char>(~last));
+                numCorrupted += file ? 1 : 0;
+            }
+            return numCorrupted;
+        }
+
+        // Hits must skip the compiler and return the stored byte code.
+        void CheckShaderCacheHits(const std::filesystem::path& directory)
+        {
+            const String source = "float4 PSMain() : SV_Target { return 1; }";
+            StubCompiler compiler;
+            ShaderCacheRef cache = MakeRefCount<ShaderCache>(directory.string(), 0);
+
+            BinaryData byteCode;
+            cache->GetOrCompile(&compiler, source, "PSMain", EShaderStageType::Pixel, 0, byteCode, false);
+            FreeByteCode(byteCode);
+
+            const double start = BenchmarkSeconds();
+            bool bAllSame = true;
+            for (uint32 index = 0; index < GShaderCacheLookupCount; ++index)
+            {
+                cache->GetOrCompile(&compiler, source, "PSMain", EShaderStageType::Pixel, 0, byteCode, false);
+                bAllSame = bAllSame && IsStubByteCode(byteCode, source);
+                FreeByteCode(byteCode);
+            }
+            const double hitSeconds = BenchmarkSeconds() - start;
+
+            TAssertf(compiler.NumCompiles == 1, "Cache hits compiled %u times, expected once.", compiler.NumCompiles);
+            TAssertf(cache->GetNumHits() == GShaderCacheLookupCount, "Expected %u hits, got %llu.", GShaderCacheLookupCount, cache->GetNumHits());
+            TAssertf(bAllSame, "A cache hit returned different byte code.");
+            LOG("Hits: %u lookups, %u compile, %7.3f us per hit", GShaderCacheLookupCount, compiler.NumCompiles,
+                hitSeconds * 1e6 / GShaderCacheLookupCount);
+        }
+
+        // An entry failing its CRC is dropped and compiled again, the fresh copy is cached in its place.
+        void CheckShaderCacheCorruption(const std::filesystem::path& directory)
+        {
+            const String source = "float4 VSMain() : SV_Position { return 0; }";
+            StubCompiler compiler;
+            ShaderCacheRef cache = MakeRefCount<ShaderCache>(directory.string(), 0);
+
+            BinaryData byteCode;
+            cache->GetOrCompile(&compiler, source, "VSMain", EShaderStageType::Vertex, 0, byteCode, false);
+            FreeByteCode(byteCode);
+            const uint32 numCorrupted = CorruptEntries(directory);
+            TAssertf(numCorrupted == 1, "Expected one entry file to corrupt, found %u.", numCorrupted);
+
+            cache->GetOrCompile(&compiler, source, "VSMain", EShaderStageType::Vertex, 0, byteCode, false);
+            const bool bRecompiled = compiler.NumCompiles == 2 && IsStubByteCode(byteCode, source);
+            FreeByteCode(byteCode);
+            TAssertf(bRecompiled, "A corrupted entry was not rejected and recompiled, %u compiles.", compiler.NumCompiles);
+
+            cache->GetOrCompile(&compiler, source, "VSMain", EShaderStageType::Vertex, 0, byteCode, false);
+            const bool bCachedAgain = compiler.NumCompiles == 2 && IsStubByteCode(byteCode, source);
+            FreeByteCode(byteCode);
+            TAssertf(bCachedAgain, "The recompiled byte code was not cached again.");
+            LOG("Corruption: rejected and recompiled, %llu hits, %llu misses", cache->GetNumHits(), cache->GetNumMisses());
+        }
+
+        // Stores past the size cap evict the least recently used entries until the cache is back under it.
+        void CheckShaderCacheEviction(const std::filesystem::path& directory)
+        {
+            constexpr uint32 numEntries = 5;
+            constexpr uint64 maxSize = 4 * GShaderCacheEntrySize;
+            ShaderCacheRef cache = MakeRefCount<ShaderCache>(directory.string(), maxSize);
+
+            ShaderBytecodeHash keys[numEntries];
+            String sources[numEntries];
+            for (uint32 index = 0; index < numEntries; ++index)
+            {
+                sources[index] = "Shader" + std::to_string(index);
+                keys[index] = ShaderCache::MakeKey(sources[index], "Main", EShaderStageType::Pixel, 0, "StubCompiler 1", false);
+            }
+
+            BinaryData byteCode;
+            for (uint32 index = 0; index < 3; ++index)
+            {
+                StubCompiler::MakeStubByteCode(sources[index], byteCode);
+                cache->Store(keys[index], byteCode);
+                FreeByteCode(byteCode);
+            }
+
+            // Entry 0 is used again, so 1 and 2 are now the least recently used.
+            cache->Load(keys[0], byteCode);
+            FreeByteCode(byteCode);
+            for (uint32 index = 3; index < numEntries; ++index)
+            {
+                StubCompiler::MakeStubByteCode(sources[index], byteCode);
+                cache->Store(keys[index], byteCode);
+                FreeByteCode(byteCode);
+            }
+
+            TAssertf(cache->GetTotalSize() <= maxSize, "Cache holds %llu bytes over its %llu byte budget.", cache->GetTotalSize(), maxSize);
+            constexpr bool bExpectCached[numEntries] = { true, false, false, true, true };
+            for (uint32 index = 0; index < numEntries; ++index)
+            {
+                const bool bCached = cache->Load(keys[index], byteCode);
+                FreeByteCode(byteCode);
+                TAssertf(bCached == bExpectCached[index], "Entry %u should %s been evicted.", index, bExpectCached[index] ? "not have" : "have");
+            }
+            LOG("Eviction: %u entries, %llu of %llu bytes", cache->GetNumEntries(), cache->GetTotalSize(), maxSize);
+        }
+    }
+
+    THUNDER_BENCHMARK(ShaderCache)
+    {
+        const std::filesystem::path root = std::filesystem::temp_directory_path() / "ThunderShaderCacheBenchmark";
+        const std::filesystem::path directories[] = { root / "Hits", root / "Corruption", root / "Eviction" };
+        std::error_code error;
+        std::filesystem::remove_all(root, error);
+
+        CheckShaderCacheHits(directories[0]);
+        CheckShaderCacheCorruption(directories[1]);
+        CheckShaderCacheEviction(directories[2]);
+
+        std::filesystem::remove_all(root, error);
+    }
+}
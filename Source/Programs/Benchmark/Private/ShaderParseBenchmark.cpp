@@ -0,0 +1,77 @@
+#include "Benchmark.h"
+#include "ShaderArchive.h"
+#include "ShaderIncludeCache.h"
+#include "ShaderModule.h"
+#include "Concurrent/TaskScheduler.h"
+#include "FileSystem/FileModule.h"
+#include "Memory/MemoryBase.h"
+
+namespace Thunder
+{
+    namespace
+    {
+        constexpr uint32 GShaderParseIterationCount = 5;
+
+        // Loads every archive once per iteration, returns the number that parsed.
+        template<typename LoadFunction>
+        uint32 RunShaderParse(const TArray<String>& paths, TArray<ShaderArchive*>& archives, const LoadFunction& load)
+        {
+            uint32 numParsed = 0;
+            for (uint32 iteration = 0; iteration < GShaderParseIterationCount; ++iteration)
+            {
+                load(paths, archives);
+                for (ShaderArchive*& archive : archives)
+                {
+                    if (archive)
+                    {
+                        ++numParsed;
+                        TMemory::Destroy(archive);
+                        archive = nullptr;
+                    }
+                }
+            }
+            return numParsed;
+        }
+    }
+
+    // Preprocess, parse and reflect of the shipped Shader directory, one archive at a time and on the sync workers.
+    THUNDER_BENCHMARK(ShaderParse)
+    {
+        TArray<String> paths;
+        FileModule::TraverseFileFromFolderWithFormat(FileModule::GetEngineShaderRoot(), paths, "tsf");
+        if (paths.empty())
+        {
+            LOG("No .tsf archive found under %s", FileModule::GetEngineShaderRoot().c_str());
+            return;
+        }
+        TArray<ShaderArchive*> archives(paths.size(), nullptr);
+
+        double start = BenchmarkSeconds();
+        const uint32 serialParsed = RunShaderParse(paths, archives, [](const TArray<String>& inPaths, TArray<ShaderArchive*>& outArchives)
+        {
+            for (size_t index = 0; index < inPaths.size(); ++index)
+            {
+                outArchives[index] = ShaderModule::LoadShaderArchive(inPaths[index]);
+            }
+        });
+        const double serialSeconds = BenchmarkSeconds() - start;
+
+        start = BenchmarkSeconds();
+        const uint32 parallelParsed = RunShaderParse(paths, archives, [](const TArray<String>& inPaths, TArray<ShaderArchive*>& outArchives)
+        {
+            GSyncWorkers->ParallelForRange(static_cast<uint32>(inPaths.size()), [&inPaths, &outArchives](uint32 begin, uint32 end, uint32)
+            {
+                for (uint32 index = begin; index < end; ++index)
+                {
+                    outArchives[index] = ShaderModule::LoadShaderArchive(inPaths[index]);
+                }
+            }, 1);
+        });
+        const double parallelSeconds = BenchmarkSeconds() - start;
+
+        LOG("%zu archives x %u | serial %8.1f archives/s (%u parsed) | parallel %8.1f archives/s (%u parsed, %d workers) | %.2fx",
+            paths.size(), GShaderParseIterationCount, serialParsed / serialSeconds, serialParsed,
+            parallelParsed / parallelSeconds, parallelParsed, GSyncWorkers->GetNumThreads(), serialSeconds / parallelSeconds);
+        LOG("Include cache: %llu hits, %llu misses", ShaderIncludeCache::Get().GetNumHits(), ShaderIncludeCache::Get().GetNumMisses());
+    }
+}
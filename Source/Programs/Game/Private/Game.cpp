@@ -31,6 +31,19 @@ int main(int argc, char* argv[])
     }
 #endif
 
+    // Engine initialization
+    EngineMain* GEngine = new EngineMain();
+    GEngine->InitializeEngine();
+
+    // Null RHI: no window or swapchain, the engine runs until it requests exit.
+    if (GEngine->IsHeadless())
+    {
+        GEngine->Run();
+        EngineMain::EngineExitSignal->Wait();
+        GEngine->Exit();
+        delete GEngine;
+        return 0;
+    }
 
     // Create the window
     GameWindow window;
@@ -40,6 +53,7 @@ int main(int argc, char* argv[])
     desc.Title  = L"ThunderGame";
     if (!window.Create(desc))
     {
+        delete GEngine;
         return -1;
     }
 
@@ -48,10 +62,6 @@ int main(int argc, char* argv[])
     uint32 actualWidth = window.GetWidth();
     uint32 actualHeight = window.GetHeight();
 
-    // Engine initialization
-    EngineMain* GEngine = new EngineMain();
-    GEngine->InitializeEngine();
-
     // Set viewport resolution to match actual window size
     GameModule::GetMainViewport()->SetViewportResolution(TVector2u(actualWidth, actualHeight));
 
@@ -2,6 +2,7 @@
 #include "Concurrent/TaskGraph.h"
 #include "Concurrent/TaskScheduler.h"
 #include "Concurrent/TheadPool.h"
+#include "Concurrent/TaskTrace.h"
 
 namespace Thunder
 {
@@ -65,6 +66,7 @@ namespace Thunder
     void TaskGraphProxy::Submit()
     {
         TaskCount.store(static_cast<uint32>(TaskNodeList.size()), std::memory_order_release);
+        THUNDER_TASK_TRACE(ETaskTraceEvent::GraphSubmit, "TaskGraph", TaskNodeList.size());
 
         for (const auto Node : TaskNodeList)
         {
@@ -1,6 +1,8 @@
 
 #include "Concurrent/TaskScheduler.h"
 #include "Concurrent/TheadPool.h"
+#include "Concurrent/TaskTrace.h"
+#include <cstdlib>
 
 namespace Thunder
 {
@@ -10,6 +12,18 @@ namespace Thunder
 	PooledTaskScheduler* GSyncWorkers {};
 	PooledTaskScheduler* GAsyncWorkers {};
 
+	// Stamps the task before it becomes visible to workers, ThreadProxy::Run turns the stamp into the start latency.
+	FORCEINLINE static void TraceEnqueue(ITask* InTask, uint64 InQueueDepth)
+	{
+#if TASK_TRACE_ENABLED
+		if (TaskTrace::IsEnabled()) [[unlikely]]
+		{
+			InTask->TraceEnqueueTime = TaskTrace::Now();
+			TaskTrace::Record(ETaskTraceEvent::Enqueue, InTask->GetName().c_str(), InQueueDepth);
+		}
+#endif
+	}
+
 	void IScheduler::PushTask(const TFunction<void()>& InFunction)
 	{
 		class FunctionTask : public ITask
@@ -69,6 +83,7 @@ namespace Thunder
 
 	void SingleScheduler::PushTask(ITask* InQueuedWork)
 	{
+		TraceEnqueue(InQueuedWork, 0);
 		QueuedWork.Push(InQueuedWork);
 		Thread->Resume();
 	}
@@ -86,20 +101,171 @@ namespace Thunder
 		}
 	}
 
+	namespace
+	{
+		std::atomic<uint32> GNumExternalContexts { 0 };
+		thread_local uint32 GExternalContextSlot = ~0u;
+
+		// Registers the calling thread on first use, the slot is shared by every pool the thread calls into.
+		uint32 GetExternalContextSlot()
+		{
+			if (GExternalContextSlot == ~0u) [[unlikely]]
+			{
+				const uint32 slot = GNumExternalContexts.fetch_add(1, std::memory_order_relaxed);
+				if (slot >= POOLED_SCHEDULER_MAX_EXTERNAL_CONTEXTS) [[unlikely]]
+				{
+					// Sharing a slot would race on per-context data, stop instead of corrupting it.
+					TAssertf(false, "Too many threads outside the pool call ParallelForRange, raise POOLED_SCHEDULER_MAX_EXTERNAL_CONTEXTS.");
+					std::abort();
+				}
+				GExternalContextSlot = slot;
+			}
+			return GExternalContextSlot;
+		}
+	}
+
+	#define PARALLEL_FOR_MAX_HELPERS 256
+	#define PARALLEL_FOR_SPIN_COUNT 1024
+
+	/*
+	 * State shared by everyone working on one ParallelForRange call, lives on the caller's stack.
+	 * Sub ranges are claimed with a guided schedule: large chunks first, shrinking towards MinBatchSize at the tail.
+	 **/
+	struct ParallelForJob
+	{
+		const void* Body;
+		void(*Function)(const void*, uint32, uint32, uint32);
+		uint32 NumItems;
+		uint32 MinBatchSize;
+		uint32 NumParticipants;
+		alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> NextItem { 0 };
+		alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<uint32> RemainingItems { 0 };
+
+		void Execute(uint32 contextIndex)
+		{
+			uint32 begin = NextItem.load(std::memory_order_relaxed);
+			while (begin < NumItems)
+			{
+				const uint32 remaining = NumItems - begin;
+				const uint32 size = std::min(remaining, std::max(MinBatchSize, remaining / (2 * NumParticipants)));
+				if (NextItem.compare_exchange_weak(begin, begin + size, std::memory_order_relaxed))
+				{
+					Function(Body, begin, begin + size, contextIndex);
+					RemainingItems.fetch_sub(size, std::memory_order_acq_rel);
+					begin = NextItem.load(std::memory_order_relaxed);
+				}
+			}
+		}
+	};
+
+	/*
+	 * Helper task preallocated by the scheduler, it joins a ParallelForJob when a worker picks it up.
+	 * The caller cancels helpers nobody picked up in time, so it never waits on queued work.
+	 **/
+	class ParallelForHelperTask : public ITask
+	{
+	public:
+		enum EState : uint32
+		{
+			Free,
+			Queued,
+			Running,
+			Done,
+			Cancelled
+		};
+
+		void DoWork() override
+		{
+			uint32 expected = Queued;
+			if (State.compare_exchange_strong(expected, Running, std::memory_order_acq_rel))
+			{
+				Job->Execute(GetContextId());
+				State.store(Done, std::memory_order_release);
+			}
+			else
+			{
+				TAssert(expected == Cancelled);
+				State.store(Free, std::memory_order_release);
+			}
+		}
+
+		bool IsAutoDestroy() const override { return false; }
+
+		NameHandle GetName() const override
+		{
+			static NameHandle name = "ParallelForHelper";
+			return name;
+		}
+
+		std::atomic<uint32> State { Free };
+		ParallelForJob* Job {};
+	};
+
+	PooledTaskScheduler::PooledTaskScheduler(ESchedulingMode InMode)
+		: Mode(InMode)
+	{
+		ParallelForHelpers.reserve(PARALLEL_FOR_MAX_HELPERS);
+		for (uint32 index = 0; index < PARALLEL_FOR_MAX_HELPERS; ++index)
+		{
+			ParallelForHelpers.push_back(new (TMemory::Malloc<ParallelForHelperTask>()) ParallelForHelperTask());
+		}
+	}
+
+	PooledTaskScheduler::~PooledTaskScheduler()
+	{
+		for (auto helper : ParallelForHelpers)
+		{
+			TMemory::Destroy(helper);
+		}
+		ParallelForHelpers.clear();
+	}
+
 	void PooledTaskScheduler::AttachToThread(ThreadProxy* InThreadProxy)
 	{
 		TAssert(InThreadProxy != nullptr);
-		for (auto* thread : ThreadList)
 		{
-			if (thread == InThreadProxy)
+			auto lock = ThreadListLock.Guard();
+			const uint32 numThreads = NumThreads.load(std::memory_order_relaxed);
+			for (uint32 index = 0; index < numThreads; ++index)
+			{
+				if (GetPoolThread(index) == InThreadProxy)
+				{
+					return;
+				}
+			}
+			if (numThreads == POOLED_SCHEDULER_MAX_THREADS) [[unlikely]]
 			{
+				TAssertf(false, "Pooled scheduler is limited to %d threads.", POOLED_SCHEDULER_MAX_THREADS);
 				return;
 			}
+			// The deque exists before the thread is visible to thieves.
+			if (Mode == ESchedulingMode::WorkStealing)
+			{
+				InThreadProxy->SetStealingScheduler(this);
+			}
+			ThreadList[numThreads].store(InThreadProxy, std::memory_order_relaxed);
+			NumThreads.store(numThreads + 1, std::memory_order_release);
 		}
-		ThreadList.push_back(InThreadProxy);
 		InThreadProxy->AttachToScheduler(this);
 	}
 
+	bool PooledTaskScheduler::IsPoolThread(const ThreadProxy* InThread) const
+	{
+		if (InThread == nullptr)
+		{
+			return false;
+		}
+		const uint32 numThreads = NumThreads.load(std::memory_order_acquire);
+		for (uint32 index = 0; index < numThreads; ++index)
+		{
+			if (GetPoolThread(index) == InThread)
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+
 	void PooledTaskScheduler::AddSingleScheduler(SingleScheduler* InSingleScheduler)
 	{
 		TaskSchedulers.push_back(InSingleScheduler);
@@ -108,11 +274,103 @@ namespace Thunder
 
 	void PooledTaskScheduler::PushTask(ITask* InQueuedWork)
 	{
-		QueuedWork.Push(InQueuedWork);
+		TraceEnqueue(InQueuedWork, NumLocalWork.load(std::memory_order_relaxed));
+		if (Mode == ESchedulingMode::SharedQueue)
+		{
+			QueuedWork.Push(InQueuedWork);
+			const uint32 numThreads = NumThreads.load(std::memory_order_acquire);
+			for (uint32 index = 0; index < numThreads; ++index)
+			{
+				GetPoolThread(index)->Resume();
+			}
+			return;
+		}
+
+		// Pool threads keep their own work local, everyone else goes through the shared queue.
+		ThreadProxy* currentThread = GetThread();
+		if (currentThread && currentThread->GetStealingScheduler() == this)
+		{
+			NumLocalWork.fetch_add(1, std::memory_order_relaxed);
+			if (!currentThread->GetLocalWork()->Push(InQueuedWork)) [[unlikely]]
+			{
+				NumLocalWork.fetch_sub(1, std::memory_order_relaxed);
+				QueuedWork.Push(InQueuedWork);
+			}
+		}
+		else
+		{
+			QueuedWork.Push(InQueuedWork);
+		}
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		WakeSleepingThreads(1);
+	}
+
+	ITask* PooledTaskScheduler::GetNextQueuedWork()
+	{
+		if (Mode == ESchedulingMode::SharedQueue)
+		{
+			return IScheduler::GetNextQueuedWork();
+		}
+
+		ThreadProxy* currentThread = GetThread();
+		if (currentThread && currentThread->GetStealingScheduler() == this)
+		{
+			if (ITask* localWork = currentThread->GetLocalWork()->Pop())
+			{
+				NumLocalWork.fetch_sub(1, std::memory_order_relaxed);
+				return localWork;
+			}
+		}
+		if (ITask* sharedWork = IScheduler::GetNextQueuedWork())
+		{
+			return sharedWork;
+		}
+		return StealWork(currentThread);
+	}
+
+	bool PooledTaskScheduler::IsEmptyWork() const
+	{
+		// Counter instead of walking the deques, cheaper than looking at every thread.
+		return QueuedWork.IsEmpty() && NumLocalWork.load(std::memory_order_seq_cst) == 0;
+	}
+
+	ITask* PooledTaskScheduler::StealWork(const ThreadProxy* InThief)
+	{
+		if (NumLocalWork.load(std::memory_order_relaxed) == 0)
+		{
+			return nullptr;
+		}
+		const uint32 numThreads = NumThreads.load(std::memory_order_acquire);
+
+		// Start from the neighbour so that thieves spread over different victims.
+		const uint32 startIndex = InThief ? InThief->GetContextId() + 1 : 0;
+		for (uint32 offset = 0; offset < numThreads; ++offset)
+		{
+			ThreadProxy* victim = GetPoolThread((startIndex + offset) % numThreads);
+			if (victim == InThief)
+			{
+				continue;
+			}
+			if (ITask* stolenWork = victim->GetLocalWork()->Steal())
+			{
+				NumLocalWork.fetch_sub(1, std::memory_order_relaxed);
+				THUNDER_TASK_TRACE(ETaskTraceEvent::Steal, stolenWork->GetName().c_str(), victim->GetContextId());
+				return stolenWork;
+			}
+		}
+		return nullptr;
+	}
 
-		for (const auto Thread : ThreadList)
+	void PooledTaskScheduler::WakeSleepingThreads(uint32 InNumTasks)
+	{
+		const uint32 numThreads = NumThreads.load(std::memory_order_acquire);
+		const uint32 startIndex = NextWakeIndex.fetch_add(1, std::memory_order_relaxed);
+		for (uint32 offset = 0; offset < numThreads && InNumTasks > 0; ++offset)
 		{
-			Thread->Resume();
+			if (GetPoolThread((startIndex + offset) % numThreads)->TryWakeUp())
+			{
+				--InNumTasks;
+			}
 		}
 	}
 
@@ -120,6 +378,16 @@ namespace Thunder
 	{
 		IScheduler::PushTask(InFunction);
 	}
+
+	uint32 PooledTaskScheduler::GetContextIndex() const
+	{
+		ThreadProxy* currentThread = GetThread();
+		if (IsPoolThread(currentThread))
+		{
+			return currentThread->GetContextId();
+		}
+		return NumThreads.load(std::memory_order_acquire) + GetExternalContextSlot();
+	}
 	
 	void PooledTaskScheduler::PushTask(int Index, const TFunction<void()>& InFunction) const
 	{
@@ -136,82 +404,122 @@ namespace Thunder
 	void PooledTaskScheduler::DetachFromThread(ThreadProxy* InThreadProxy)
 	{
 		TAssert(InThreadProxy != nullptr);
-		auto it = std::ranges::find(ThreadList, InThreadProxy);
-		if (it != ThreadList.end())
+		bool bDetached = false;
+		{
+			// The last thread moves into the freed slot. A reader still using the old count sees that thread twice,
+			// never a dangling one: detached proxies outlive the scheduler.
+			auto lock = ThreadListLock.Guard();
+			const uint32 numThreads = NumThreads.load(std::memory_order_relaxed);
+			for (uint32 index = 0; index < numThreads; ++index)
+			{
+				if (GetPoolThread(index) == InThreadProxy)
+				{
+					ThreadList[index].store(GetPoolThread(numThreads - 1), std::memory_order_relaxed);
+					NumThreads.store(numThreads - 1, std::memory_order_release);
+					bDetached = true;
+					break;
+				}
+			}
+		}
+		if (bDetached)
 		{
 			InThreadProxy->DetachFromScheduler(this);
-			ThreadList.erase(it);
 		}
 	}
 
 	void PooledTaskScheduler::WaitForCompletionAndThreadExit()
 	{
-		for (const auto Thread : ThreadList)
+		const uint32 numThreads = NumThreads.load(std::memory_order_acquire);
+		for (uint32 index = 0; index < numThreads; ++index)
 		{
-			Thread->WaitForCompletion();
+			GetPoolThread(index)->WaitForCompletion();
 		}
 	}
 
 	uint32 PooledTaskScheduler::GetThreadId(uint32 threadIndex) const
 	{
-		return ThreadList[threadIndex]->GetThreadId();
+		TAssert(threadIndex < NumThreads.load(std::memory_order_acquire));
+		return GetPoolThread(threadIndex)->GetThreadId();
 	}
 
-	void PooledTaskScheduler::ParallelFor(TFunction<void(uint32, uint32)>& Body, uint32 NumTask, uint32 BundleSize)
+	void PooledTaskScheduler::ParallelForRangeInternal(uint32 NumItems, uint32 MinBatchSize, const void* Body, ParallelForRangeFunction Function)
 	{
-		class TaskBundle : public ITask
+		if (NumItems == 0)
 		{
-		public:
-			TaskBundle(TFunction<void(uint32, uint32)>* InFunction, uint32 InStart, uint32 InSize)
-			: Function(InFunction)
-			, Head(InStart)
-			, Size(InSize)
-			{}
-
-			void DoWork() override
-			{
-				(*Function)(Head, Size);
-			}
+			return;
+		}
+		MinBatchSize = std::max(MinBatchSize, 1u);
 
-		private:
-			TFunction<void(uint32, uint32)>* Function;
-			uint32 Head;
-			uint32 Size;
-		};
+		// Pool threads keep their own slot, anyone else the one it registered for.
+		const uint32 numThreads = NumThreads.load(std::memory_order_acquire);
+		ThreadProxy* currentThread = GetThread();
+		const bool bIsPoolThread = IsPoolThread(currentThread);
+		const uint32 callerContextIndex = bIsPoolThread ? currentThread->GetContextId() : numThreads + GetExternalContextSlot();
 
-		for (uint32 taskId = 0; taskId < NumTask; taskId += BundleSize)
+		const uint32 numBatches = (NumItems + MinBatchSize - 1) / MinBatchSize;
+		const uint32 numWantedHelpers = std::min(numBatches - 1, bIsPoolThread ? numThreads - 1 : numThreads);
+		if (numWantedHelpers == 0)
 		{
-			const auto bundleTask = new (TMemory::Malloc<TaskBundle>()) TaskBundle(&Body, taskId, BundleSize);
-			PushTask(bundleTask);
+			Function(Body, 0, NumItems, callerContextIndex);
+			return;
 		}
-	}
 
-	void PooledTaskScheduler::ParallelFor(TFunction<void(uint32, uint32)>&& Body, uint32 NumTask, uint32 BundleSize)
-	{
-		class TaskBundle : public ITask
+		ParallelForJob job;
+		job.Body = Body;
+		job.Function = Function;
+		job.NumItems = NumItems;
+		job.MinBatchSize = MinBatchSize;
+		job.NumParticipants = numWantedHelpers + 1;
+		job.RemainingItems.store(NumItems, std::memory_order_relaxed);
+
+		// Grab free helpers from the arena, if it's exhausted the caller just does more of the work itself.
+		ParallelForHelperTask* helpers[PARALLEL_FOR_MAX_HELPERS];
+		uint32 numHelpers = 0;
+		for (uint32 index = 0; index < PARALLEL_FOR_MAX_HELPERS && numHelpers < numWantedHelpers; ++index)
 		{
-		public:
-			TaskBundle(const TFunction<void(uint32, uint32)>& InFunction, uint32 InStart, uint32 InSize)
-			: Function(InFunction)
-			, Head(InStart)
-			, Size(InSize)
-			{}
-
-			void DoWork() override
+			ParallelForHelperTask* helper = ParallelForHelpers[index];
+			uint32 expected = ParallelForHelperTask::Free;
+			if (helper->State.compare_exchange_strong(expected, ParallelForHelperTask::Queued, std::memory_order_acquire))
 			{
-				Function(Head, Size);
+				helper->Job = &job;
+				helpers[numHelpers++] = helper;
 			}
-		private:
+		}
+		for (uint32 index = 0; index < numHelpers; ++index)
+		{
+			PushTask(helpers[index]);
+		}
 
-			TFunction<void(uint32, uint32)> Function;
-			uint32 Head;
-			uint32 Size;
-		};
+		job.Execute(callerContextIndex);
 
-		for (uint32 taskId = 0; taskId < NumTask; taskId += BundleSize)
+		// Wait for sub ranges still being processed by helpers.
+		uint32 spinCount = 0;
+		while (job.RemainingItems.load(std::memory_order_acquire) != 0)
 		{
-			const auto bundleTask = new (TMemory::Malloc<TaskBundle>()) TaskBundle(Body, taskId, BundleSize);
-			PushTask(bundleTask);
+			if (++spinCount < PARALLEL_FOR_SPIN_COUNT)
+			{
+				FPlatformProcess::CoreYield();
+			}
+			else
+			{
+				FPlatformProcess::Sleep(0.f);
+			}
+		}
+
+		// Release helpers, the job goes out of scope after this.
+		for (uint32 index = 0; index < numHelpers; ++index)
+		{
+			ParallelForHelperTask* helper = helpers[index];
+			uint32 expected = ParallelForHelperTask::Queued;
+			if (helper->State.compare_exchange_strong(expected, ParallelForHelperTask::Cancelled, std::memory_order_acq_rel))
+			{
+				continue; // freed by the worker that eventually dequeues it
+			}
+			while (helper->State.load(std::memory_order_acquire) == ParallelForHelperTask::Running)
+			{
+				FPlatformProcess::CoreYield();
+			}
+			helper->State.store(ParallelForHelperTask::Free, std::memory_order_release);
 		}
 	}
 
@@ -0,0 +1,380 @@
+#include "Concurrent/TaskTrace.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <mutex>
+#include "Concurrent/TheadPool.h"
+
+namespace Thunder
+{
+	std::atomic<bool> TaskTrace::bEnabled { false };
+
+	namespace
+	{
+		// Slots right behind the writer are skipped when dumping, they may be overwritten meanwhile.
+		constexpr uint64 DumpSafetyMargin = 1024;
+		static_assert(TASK_TRACE_RING_SIZE > DumpSafetyMargin && (TASK_TRACE_RING_SIZE & (TASK_TRACE_RING_SIZE - 1)) == 0);
+
+		struct TaskTraceRing
+		{
+			TaskTraceEvent Events[TASK_TRACE_RING_SIZE];
+			std::atomic<uint64> WriteIndex { 0 };
+			String ThreadName;
+			uint32 TraceThreadId = 0;
+		};
+
+		// Rings are never freed, threads may still hold them after they exit.
+		struct TaskTraceRegistry
+		{
+			std::mutex Mutex;
+			TArray<TaskTraceRing*> Rings;
+		};
+
+		TaskTraceRegistry& GetRegistry()
+		{
+			static TaskTraceRegistry registry;
+			return registry;
+		}
+
+		thread_local TaskTraceRing* GThreadRing = nullptr;
+
+		TaskTraceRing* CreateThreadRing()
+		{
+			auto* ring = new (TMemory::Malloc<TaskTraceRing>()) TaskTraceRing();
+			const ThreadProxy* thread = GetThread();
+			auto& registry = GetRegistry();
+			std::lock_guard lock(registry.Mutex);
+			ring->TraceThreadId = static_cast<uint32>(registry.Rings.size());
+			ring->ThreadName = thread ? thread->GetThreadName().ToString() : "Thread_" + std::to_string(ring->TraceThreadId);
+			registry.Rings.push_back(ring);
+			return ring;
+		}
+
+		// Copies the readable part of a ring in recording order.
+		void CopyEvents(const TaskTraceRing* ring, TArray<TaskTraceEvent>& outEvents)
+		{
+			const uint64 writeIndex = ring->WriteIndex.load(std::memory_order_acquire);
+			const uint64 readable = std::min<uint64>(writeIndex, TASK_TRACE_RING_SIZE - DumpSafetyMargin);
+			outEvents.clear();
+			outEvents.reserve(readable);
+			for (uint64 index = writeIndex - readable; index < writeIndex; ++index)
+			{
+				outEvents.push_back(ring->Events[index & (TASK_TRACE_RING_SIZE - 1)]);
+			}
+		}
+
+		void AppendEscaped(String& out, const char* name)
+		{
+			for (const char* c = name ? name : "UnKnown"; *c; ++c)
+			{
+				if (*c == '"' || *c == '\\')
+				{
+					out.push_back('\\');
+				}
+				if (static_cast<unsigned char>(*c) >= 0x20)
+				{
+					out.push_back(*c);
+				}
+			}
+		}
+
+		const char* GetEventName(const TaskTraceEvent& event)
+		{
+			switch (event.Type)
+			{
+			case ETaskTraceEvent::Steal: return "Steal";
+			case ETaskTraceEvent::Suspend:
+			case ETaskTraceEvent::Resume: return "Sleep";
+			default: return event.Name ? event.Name : "UnKnown";
+			}
+		}
+
+		struct TaskTraceNameStats
+		{
+			uint64 Count = 0;
+			uint64 TotalNs = 0;
+			uint64 MaxNs = 0;
+			uint64 TotalLatencyNs = 0;
+			uint64 MaxLatencyNs = 0;
+		};
+
+		struct TaskTraceThreadStats
+		{
+			uint64 Tasks = 0;
+			uint64 BusyNs = 0;
+			uint64 SleepNs = 0;
+			uint64 Suspends = 0;
+			uint64 IdleSpins = 0;
+			uint64 Steals = 0;
+			uint64 Enqueues = 0;
+			uint64 MaxQueueDepth = 0;
+			uint64 SpanNs = 0;
+		};
+	}
+
+	void TaskTrace::SetEnabled(bool bInEnabled)
+	{
+		bEnabled.store(bInEnabled, std::memory_order_relaxed);
+	}
+
+	uint64 TaskTrace::Now()
+	{
+		return static_cast<uint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count());
+	}
+
+	void TaskTrace::Record(ETaskTraceEvent type, const char* name, uint64 payload)
+	{
+		TaskTraceRing* ring = GThreadRing;
+		if (ring == nullptr) [[unlikely]]
+		{
+			ring = GThreadRing = CreateThreadRing();
+		}
+		const uint64 writeIndex = ring->WriteIndex.load(std::memory_order_relaxed);
+		ring->Events[writeIndex & (TASK_TRACE_RING_SIZE - 1)] = { Now(), payload, name, type };
+		ring->WriteIndex.store(writeIndex + 1, std::memory_order_release);
+	}
+
+	void TaskTrace::Clear()
+	{
+		auto& registry = GetRegistry();
+		std::lock_guard lock(registry.Mutex);
+		for (TaskTraceRing* ring : registry.Rings)
+		{
+			ring->WriteIndex.store(0, std::memory_order_release);
+		}
+	}
+
+	bool TaskTrace::DumpChromeTrace(const String& fileName)
+	{
+		std::ofstream fout(fileName, std::ios::out | std::ios::trunc);
+		if (!fout.is_open()) [[unlikely]]
+		{
+			LOG("Failed to open task trace file %s", fileName.c_str());
+			return false;
+		}
+
+		TArray<TaskTraceEvent> events;
+		String line;
+		char number[64];
+		bool bFirst = true;
+		auto beginLine = [&line, &bFirst]()
+		{
+			line.clear();
+			line += bFirst ? "\n" : ",\n";
+			bFirst = false;
+		};
+
+		fout << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+		auto& registry = GetRegistry();
+		std::lock_guard lock(registry.Mutex);
+		const uint64 baseTime = [&registry]()
+		{
+			uint64 minTime = ~0ull;
+			for (const TaskTraceRing* ring : registry.Rings)
+			{
+				const uint64 writeIndex = ring->WriteIndex.load(std::memory_order_acquire);
+				const uint64 readable = std::min<uint64>(writeIndex, TASK_TRACE_RING_SIZE - DumpSafetyMargin);
+				if (readable > 0)
+				{
+					minTime = std::min(minTime, ring->Events[(writeIndex - readable) & (TASK_TRACE_RING_SIZE - 1)].Timestamp);
+				}
+			}
+			return minTime == ~0ull ? 0 : minTime;
+		}();
+
+		for (const TaskTraceRing* ring : registry.Rings)
+		{
+			beginLine();
+			snprintf(number, sizeof(number), "%u", ring->TraceThreadId);
+			line += "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":";
+			line += number;
+			line += ",\"args\":{\"name\":\"";
+			AppendEscaped(line, ring->ThreadName.c_str());
+			line += "\"}}";
+			fout << line;
+
+			// Events from before a ring wrap may be missing their begin, skip ends that have no open scope.
+			CopyEvents(ring, events);
+			uint32 openTasks = 0;
+			bool bSleeping = false;
+			for (const TaskTraceEvent& event : events)
+			{
+				const char* phase = nullptr;
+				switch (event.Type)
+				{
+				case ETaskTraceEvent::TaskBegin: phase = "B"; ++openTasks; break;
+				case ETaskTraceEvent::TaskEnd: if (openTasks > 0) { phase = "E"; --openTasks; } break;
+				case ETaskTraceEvent::Suspend: phase = "B"; bSleeping = true; break;
+				case ETaskTraceEvent::Resume: if (bSleeping) { phase = "E"; bSleeping = false; } break;
+				case ETaskTraceEvent::Enqueue: phase = "C"; break;
+				case ETaskTraceEvent::Steal:
+				case ETaskTraceEvent::GraphSubmit: phase = "i"; break;
+				}
+				if (phase == nullptr)
+				{
+					continue;
+				}
+
+				beginLine();
+				line += "{\"name\":\"";
+				AppendEscaped(line, event.Type == ETaskTraceEvent::Enqueue ? "QueueDepth" : GetEventName(event));
+				snprintf(number, sizeof(number), "\",\"ph\":\"%s\",\"ts\":%.3f,\"pid\":0,\"tid\":%u",
+					phase, static_cast<double>(event.Timestamp - baseTime) / 1000.0, ring->TraceThreadId);
+				line += number;
+				switch (event.Type)
+				{
+				case ETaskTraceEvent::TaskBegin:
+					snprintf(number, sizeof(number), ",\"args\":{\"latency_us\":%.3f}", static_cast<double>(event.Payload) / 1000.0);
+					line += number;
+					break;
+				case ETaskTraceEvent::Enqueue:
+					snprintf(number, sizeof(number), ",\"args\":{\"depth\":%llu}", static_cast<unsigned long long>(event.Payload));
+					line += number;
+					break;
+				case ETaskTraceEvent::Suspend:
+					snprintf(number, sizeof(number), ",\"args\":{\"idle_spins\":%llu}", static_cast<unsigned long long>(event.Payload));
+					line += number;
+					break;
+				case ETaskTraceEvent::Steal:
+					snprintf(number, sizeof(number), ",\"s\":\"t\",\"args\":{\"victim\":%llu}", static_cast<unsigned long long>(event.Payload));
+					line += number;
+					break;
+				case ETaskTraceEvent::GraphSubmit:
+					snprintf(number, sizeof(number), ",\"s\":\"t\",\"args\":{\"nodes\":%llu}", static_cast<unsigned long long>(event.Payload));
+					line += number;
+					break;
+				default:
+					break;
+				}
+				line += "}";
+				fout << line;
+			}
+		}
+		fout << "\n]}\n";
+		return fout.good();
+	}
+
+	String TaskTrace::BuildSummary()
+	{
+		TMap<const char*, TaskTraceNameStats> nameStats;
+		TArray<std::pair<String, TaskTraceThreadStats>> threadStats;
+		TArray<TaskTraceEvent> events;
+		TArray<const TaskTraceEvent*> openTasks;
+		{
+			auto& registry = GetRegistry();
+			std::lock_guard lock(registry.Mutex);
+			for (const TaskTraceRing* ring : registry.Rings)
+			{
+				CopyEvents(ring, events);
+				TaskTraceThreadStats stats;
+				openTasks.clear();
+				const TaskTraceEvent* suspend = nullptr;
+				for (const TaskTraceEvent& event : events)
+				{
+					switch (event.Type)
+					{
+					case ETaskTraceEvent::TaskBegin:
+						openTasks.push_back(&event);
+						break;
+					case ETaskTraceEvent::TaskEnd:
+						if (!openTasks.empty())
+						{
+							const TaskTraceEvent* begin = openTasks.back();
+							openTasks.pop_back();
+							const uint64 duration = event.Timestamp - begin->Timestamp;
+							TaskTraceNameStats& entry = nameStats[begin->Name];
+							++entry.Count;
+							entry.TotalNs += duration;
+							entry.MaxNs = std::max(entry.MaxNs, duration);
+							entry.TotalLatencyNs += begin->Payload;
+							entry.MaxLatencyNs = std::max(entry.MaxLatencyNs, begin->Payload);
+							++stats.Tasks;
+							if (openTasks.empty())
+							{
+								stats.BusyNs += duration;
+							}
+						}
+						break;
+					case ETaskTraceEvent::Suspend:
+						suspend = &event;
+						++stats.Suspends;
+						stats.IdleSpins += event.Payload;
+						break;
+					case ETaskTraceEvent::Resume:
+						if (suspend)
+						{
+							stats.SleepNs += event.Timestamp - suspend->Timestamp;
+							suspend = nullptr;
+						}
+						break;
+					case ETaskTraceEvent::Steal:
+						++stats.Steals;
+						break;
+					case ETaskTraceEvent::Enqueue:
+						++stats.Enqueues;
+						stats.MaxQueueDepth = std::max(stats.MaxQueueDepth, event.Payload);
+						break;
+					case ETaskTraceEvent::GraphSubmit:
+						break;
+					}
+				}
+				if (!events.empty())
+				{
+					stats.SpanNs = events.back().Timestamp - events.front().Timestamp;
+				}
+				threadStats.emplace_back(ring->ThreadName, stats);
+			}
+		}
+
+		String summary;
+		char line[256];
+		summary += "Thread                          Tasks   Busy(ms)  Sleep(ms)   Busy%  Suspends  IdleSpins  Steals  Enqueues  MaxDepth\n";
+		for (const auto& [threadName, stats] : threadStats)
+		{
+			snprintf(line, sizeof(line), "%-28s %8llu %10.3f %10.3f %6.1f%% %9llu %10llu %7llu %9llu %9llu\n",
+				threadName.c_str(),
+				static_cast<unsigned long long>(stats.Tasks),
+				static_cast<double>(stats.BusyNs) / 1e6,
+				static_cast<double>(stats.SleepNs) / 1e6,
+				stats.SpanNs ? 100.0 * static_cast<double>(stats.BusyNs) / static_cast<double>(stats.SpanNs) : 0.0,
+				static_cast<unsigned long long>(stats.Suspends),
+				static_cast<unsigned long long>(stats.IdleSpins),
+				static_cast<unsigned long long>(stats.Steals),
+				static_cast<unsigned long long>(stats.Enqueues),
+				static_cast<unsigned long long>(stats.MaxQueueDepth));
+			summary += line;
+		}
+
+		// Most expensive tasks first.
+		TArray<std::pair<const char*, TaskTraceNameStats>> sortedNames(nameStats.begin(), nameStats.end());
+		std::ranges::sort(sortedNames, [](const auto& lhs, const auto& rhs) { return lhs.second.TotalNs > rhs.second.TotalNs; });
+		summary += "\nTask                                Count  Total(ms)   Avg(us)   Max(us)  AvgLatency(us)  MaxLatency(us)\n";
+		for (const auto& [name, stats] : sortedNames)
+		{
+			snprintf(line, sizeof(line), "%-32s %8llu %10.3f %9.2f %9.2f %15.2f %15.2f\n",
+				name ? name : "UnKnown",
+				static_cast<unsigned long long>(stats.Count),
+				static_cast<double>(stats.TotalNs) / 1e6,
+				static_cast<double>(stats.TotalNs) / 1e3 / static_cast<double>(stats.Count),
+				static_cast<double>(stats.MaxNs) / 1e3,
+				static_cast<double>(stats.TotalLatencyNs) / 1e3 / static_cast<double>(stats.Count),
+				static_cast<double>(stats.MaxLatencyNs) / 1e3);
+			summary += line;
+		}
+		return summary;
+	}
+
+	bool TaskTrace::DumpSummary(const String& fileName)
+	{
+		std::ofstream fout(fileName, std::ios::out | std::ios::trunc);
+		if (!fout.is_open()) [[unlikely]]
+		{
+			LOG("Failed to open task trace summary file %s", fileName.c_str());
+			return false;
+		}
+		fout << BuildSummary();
+		return fout.good();
+	}
+}
@@ -7,6 +7,7 @@
 #include "Misc/LazySingleton.h"
 #include "Concurrent/Lock.h"
 #include "Concurrent/TaskScheduler.h"
+#include "Concurrent/TaskTrace.h"
 #include "Misc/TraceProfile.h"
 
 namespace Thunder
@@ -38,6 +39,32 @@ namespace Thunder
 			delete Thread;
 			Thread = nullptr;
 		}
+		if (LocalWork)
+		{
+			TMemory::Destroy(LocalWork);
+			LocalWork = nullptr;
+		}
+	}
+
+	bool ThreadProxy::TryWakeUp()
+	{
+		bool expected = true;
+		if (bSleeping.compare_exchange_strong(expected, false, std::memory_order_seq_cst))
+		{
+			DoWorkEvent->Trigger();
+			return true;
+		}
+		return false;
+	}
+
+	void ThreadProxy::SetStealingScheduler(PooledTaskScheduler* InScheduler)
+	{
+		TAssertf(StealingScheduler == nullptr || StealingScheduler == InScheduler, "Thread is already attached to another work-stealing pool.");
+		StealingScheduler = InScheduler;
+		if (LocalWork == nullptr)
+		{
+			LocalWork = new (TMemory::Malloc<TWorkStealingQueue<ITask>>()) TWorkStealingQueue<ITask>();
+		}
 	}
 
 	uint32 ThreadProxy::GetThreadId() const
@@ -89,9 +116,19 @@ namespace Thunder
 		ThunderTracyCSetThreadName(GetThreadName().c_str())
 		SetCurrentThread(this);
 
+		uint64 idleSpins = 0;
 		while (!(TimeToDie.load(std::memory_order_acquire) && NoWorkToRun()))
 		{
-			DoWorkEvent->Wait();
+			// Publish the sleeping state before the last look at the queues, so a pusher either sees us sleeping or we see its task.
+			bSleeping.store(true, std::memory_order_seq_cst);
+			if (NoWorkToRun() && !TimeToDie.load(std::memory_order_acquire))
+			{
+				THUNDER_TASK_TRACE(ETaskTraceEvent::Suspend, nullptr, idleSpins);
+				idleSpins = 0;
+				DoWorkEvent->Wait();
+				THUNDER_TASK_TRACE(ETaskTraceEvent::Resume);
+			}
+			bSleeping.store(false, std::memory_order_seq_cst);
 
 			int32 numOfFailed = SUSPEND_THRESHOLD;
 			while (numOfFailed > 0)
@@ -105,14 +142,37 @@ namespace Thunder
 						{
 							bHasWork = true;
 							numOfFailed = SUSPEND_THRESHOLD;
+							const bool bAutoDestroy = currentWork->IsAutoDestroy();
+#if TASK_TRACE_ENABLED
+							const bool bTraced = TaskTrace::IsEnabled();
+							const char* traceName = nullptr;
+							if (bTraced) [[unlikely]]
+							{
+								traceName = currentWork->GetName().c_str();
+								const uint64 enqueueTime = currentWork->TraceEnqueueTime;
+								currentWork->TraceEnqueueTime = 0;
+								TaskTrace::Record(ETaskTraceEvent::TaskBegin, traceName, enqueueTime ? TaskTrace::Now() - enqueueTime : 0);
+							}
+#endif
 							currentWork->DoWork();
-							TMemory::Destroy(currentWork);
+#if TASK_TRACE_ENABLED
+							// The task may be gone already, only the interned name is used.
+							if (bTraced) [[unlikely]]
+							{
+								TaskTrace::Record(ETaskTraceEvent::TaskEnd, traceName);
+							}
+#endif
+							if (bAutoDestroy)
+							{
+								TMemory::Destroy(currentWork);
+							}
 						}
 					}
 				}
 				if (!bHasWork)
 				{
 					numOfFailed--;
+					++idleSpins;
 				}
 			}
 		}
@@ -189,6 +249,15 @@ namespace Thunder
 		Threads[Index]->AttachToScheduler(InScheduler);
 	}
 
+	ThreadPoolBase::~ThreadPoolBase()
+	{
+		for (auto Thread : Threads)
+		{
+			TMemory::Destroy(Thread);
+		}
+		Threads.clear();
+	}
+
 	void ThreadPoolBase::WaitForCompletion() const
 	{
 		for (const auto Thread : Threads)
@@ -67,6 +67,27 @@ namespace Thunder
 		}
 	}
 
+	size_t TypeComponent::GetAlignment() const
+	{
+		switch (Kind)
+		{
+		case ETypeKind::Vector2f: return alignof(TVector2f);
+		case ETypeKind::Vector3f: return alignof(TVector3f);
+		case ETypeKind::Vector4f: return alignof(TVector4f);
+		case ETypeKind::Vector2d: return alignof(TVector2d);
+		case ETypeKind::Vector3d: return alignof(TVector3d);
+		case ETypeKind::Vector4d: return alignof(TVector4d);
+		case ETypeKind::Vector2i: return alignof(TVector2i);
+		case ETypeKind::Vector3i: return alignof(TVector3i);
+		case ETypeKind::Vector4i: return alignof(TVector4i);
+		case ETypeKind::Vector2u: return alignof(TVector2u);
+		case ETypeKind::Vector3u: return alignof(TVector3u);
+		case ETypeKind::Vector4u: return alignof(TVector4u);
+		default:
+			return GetSize() > 0 ? GetSize() : 1; // Scalars are aligned to their size
+		}
+	}
+
 	template<typename T>
 	TypeComponent TypeComponent::Create(const String& inName, size_t inOffset)
 	{
@@ -136,6 +157,7 @@ namespace Thunder
 
 	ReflectiveContainer::ReflectiveContainer(ReflectiveContainer&& other) noexcept
 		: Data(other.Data)
+		, ExternalData(std::move(other.ExternalData))
 		, Components(std::move(other.Components))
 		, Stride(other.Stride)
 		, bInitialized(other.bInitialized)
@@ -169,6 +191,7 @@ namespace Thunder
 		{
 			Clear();
 			Data = other.Data;
+			ExternalData = std::move(other.ExternalData);
 			Components = std::move(other.Components);
 			Stride = other.Stride;
 			bInitialized = other.bInitialized;
@@ -219,10 +242,11 @@ namespace Thunder
 		memcpy(static_cast<uint8*>(Data) + offset, src, size);
 	}
 
-	byte* ReflectiveContainer::MoveData()
+	byte* ReflectiveContainer::MoveData(BinaryDataRef& outSource)
 	{
 		byte* data = static_cast<byte*>(Data);
 		Data = nullptr;
+		outSource = std::move(ExternalData);
 		return data;
 	}
 
@@ -341,6 +365,7 @@ namespace Thunder
 		{
 			DestroyData();
 		}
+		ExternalData.SafeRelease();
 		
 		Components.clear();
 		Stride = 0;
@@ -412,6 +437,36 @@ namespace Thunder
 		{
 			bInitialized = true;
 
+			if (IsSerializedLayout())
+			{
+				const size_t totalSize = Stride * DataNum;
+				const void* serializedData = archive.ReadInPlace(totalSize);
+				if (!serializedData) [[unlikely]]
+				{
+					TAssertf(false, "ReflectiveContainer data is truncated, %llu bytes expected", totalSize);
+					bInitialized = false;
+					return;
+				}
+
+				size_t alignment = 1;
+				for (const auto& component : Components)
+				{
+					alignment = std::max(alignment, component.GetAlignment());
+				}
+				if (archive.GetSource() && reinterpret_cast<uintptr_t>(serializedData) % alignment == 0)
+				{
+					// Pages of a mapped package are copy-on-write, so the data stays writable.
+					Data = const_cast<void*>(serializedData);
+					ExternalData = archive.GetSource();
+				}
+				else
+				{
+					AllocateData();
+					memcpy(Data, serializedData, totalSize);
+				}
+				return;
+			}
+
 			AllocateData();
 			
 			for (size_t i = 0; i < DataNum; ++i)
@@ -450,6 +505,21 @@ namespace Thunder
 		Stride = currentOffset;
 	}
 
+	bool ReflectiveContainer::IsSerializedLayout() const
+	{
+		// Plain components packed in order: an element is serialized exactly as it is laid out in memory.
+		size_t currentOffset = 0;
+		for (const auto& component : Components)
+		{
+			if (component.Kind == ETypeKind::Invalid || component.Kind == ETypeKind::Custom || component.Offset != currentOffset)
+			{
+				return false;
+			}
+			currentOffset += component.GetSize();
+		}
+		return Stride > 0 && currentOffset == Stride;
+	}
+
 	void ReflectiveContainer::AllocateData()
 	{
 		if (Stride > 0 && DataNum)
@@ -471,7 +541,10 @@ namespace Thunder
 				}
 			}
 			
-			std::free(Data);
+			if (!ExternalData)
+			{
+				std::free(Data);
+			}
 			Data = nullptr;
 		}
 	}
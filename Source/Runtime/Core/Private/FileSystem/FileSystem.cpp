@@ -4,10 +4,35 @@
     #include <windows.h>
 #elif THUNDER_POSIX
     #include <sys/stat.h>
+    #include <sys/mman.h>
+    #include <fcntl.h>
+    #include <unistd.h>
 #endif
 
 namespace Thunder
 {
+	namespace
+	{
+		// View of a mapped file, unmapped with the last reference.
+		struct MappedBinaryData : BinaryData
+		{
+			MappedBinaryData(void* inData, size_t inSize)
+			{
+				Data = inData;
+				Size = inSize;
+			}
+
+			~MappedBinaryData() override
+			{
+#if THUNDER_WINDOWS
+				UnmapViewOfFile(Data);
+#elif THUNDER_POSIX
+				munmap(Data, Size);
+#endif
+			}
+		};
+	}
+
 	IFileSystem::IFileSystem()
 	{
 	}
@@ -89,6 +114,66 @@ namespace Thunder
 		return remove(fullPath.c_str()) == 0;
 	}
 
+	BinaryDataRef NativeFileSystem::MapFile(const String& path, bool bNeedJoin)
+	{
+		String fullPath = bNeedJoin && !BasePath.empty()? BasePath + path : path;
+#if THUNDER_WINDOWS
+		HANDLE handle = CreateFileA(fullPath.c_str(), GENERIC_READ, FILE_SHARE_READ,
+									nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (handle == INVALID_HANDLE_VALUE)
+		{
+			return nullptr;
+		}
+
+		LARGE_INTEGER fileSize;
+		if (!GetFileSizeEx(handle, &fileSize) || fileSize.QuadPart == 0)
+		{
+			CloseHandle(handle);
+			return nullptr;
+		}
+
+		// Copy-on-write, so in-place data may still be patched without touching the file. The view keeps the mapping open.
+		HANDLE mapping = CreateFileMappingA(handle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+		CloseHandle(handle);
+		if (!mapping)
+		{
+			LOG("Fail to map file %s, error code: %lu\n", path.c_str(), GetLastError());
+			return nullptr;
+		}
+		void* data = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+		CloseHandle(mapping);
+		if (!data)
+		{
+			LOG("Fail to map file %s, error code: %lu\n", path.c_str(), GetLastError());
+			return nullptr;
+		}
+		return new MappedBinaryData(data, static_cast<size_t>(fileSize.QuadPart));
+#elif THUNDER_POSIX
+		const int fd = open(fullPath.c_str(), O_RDONLY);
+		if (fd < 0)
+		{
+			return nullptr;
+		}
+
+		struct stat buffer;
+		if (fstat(fd, &buffer) != 0 || buffer.st_size == 0)
+		{
+			close(fd);
+			return nullptr;
+		}
+
+		// Private mapping, writes land in copied pages and never reach the file.
+		const size_t size = static_cast<size_t>(buffer.st_size);
+		void* data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+		close(fd);
+		if (data == MAP_FAILED)
+		{
+			return nullptr;
+		}
+		return new MappedBinaryData(data, size);
+#endif
+	}
+
 	void NativeFileSystem::Mount(const String& path)
 	{
 		BasePath = path;
@@ -67,6 +67,15 @@ namespace Thunder
 	{
 	}
 
+	MemoryReader::MemoryReader(const BinaryDataRef& data, size_t offset, size_t size)
+		: Source(data)
+		, Buffer(static_cast<const uint8*>(data->Data) + offset)
+		, BufferSize(size)
+		, Position(0)
+	{
+		TAssertf(offset + size <= data->Size, "MemoryReader window [%llu, %llu) is out of %llu bytes", offset, offset + size, data->Size);
+	}
+
 	MemoryReader::~MemoryReader()
 	{
 	}
@@ -100,4 +109,15 @@ namespace Thunder
 			Position += size;
 		}
 	}
+
+	const void* MemoryReader::ReadInPlace(size_t size)
+	{
+		if (Position + size > BufferSize)
+		{
+			return nullptr;
+		}
+		const void* data = static_cast<const uint8*>(Buffer) + Position;
+		Position += size;
+		return data;
+	}
 }
\ No newline at end of file
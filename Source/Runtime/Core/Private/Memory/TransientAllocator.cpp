@@ -1,292 +1,263 @@
 #pragma optimize("", off)
 #include "Memory/TransientAllocator.h"
+#include "Concurrent/TaskScheduler.h"
 #include <algorithm>
-#include <cassert>
+#include <bit>
 
 namespace Thunder
 {
-
-    // MemoryBlock implementation
-    TransientAllocator::MemoryBlock::MemoryBlock(size_t size)
-        : Size(size), Used(0)
+    struct TransientAllocatorPage
     {
-        Memory = std::malloc(size);
-// #if !SHIPPING
-        memset(Memory, 0xce, Size);
-// #endif
-        assert(Memory != nullptr && "Failed to allocate memory block");
-    }
+        TransientAllocatorPage* Next = nullptr; // Rest of the chain while pooled or used.
+        size_t Used = 0;
 
-    TransientAllocator::MemoryBlock::~MemoryBlock()
-    {
-        if (Memory)
+        void* Allocate(size_t size, uint32 alignment)
         {
-            std::free(Memory);
-            Memory = nullptr;
+            uintptr_t const base = reinterpret_cast<uintptr_t>(this);
+            uintptr_t const address = (base + Used + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+            if (address + size > base + TRANSIENT_ALLOCATOR_PAGE_SIZE)
+            {
+                return nullptr;
+            }
+            Used = address + size - base;
+            return reinterpret_cast<void*>(address);
         }
-    }
+    };
 
-    void* TransientAllocator::MemoryBlock::Allocate(size_t size, uint32 alignment)
+    struct TransientLargeBlock
     {
-        if (size == 0) return nullptr;
+        TransientLargeBlock* Next = nullptr;
+        uint64 LastUsedFrame = 0;
+        size_t Size = 0;
+        uint32 SizeClass = 0; // NumLargeSizeClasses for blocks above the largest class, freed on reset.
+    };
 
-        size_t alignedOffset = AlignUp(Used, alignment);
-        size_t alignedSize = AlignUp(size, alignment);
+    struct alignas(PLATFORM_CACHE_LINE_SIZE) TransientContextPage
+    {
+        TransientAllocatorPage* Page = nullptr;
+    };
+
+    namespace
+    {
+        constexpr size_t LargeBlockHeaderSize = PLATFORM_CACHE_LINE_SIZE;
+        static_assert(sizeof(TransientLargeBlock) <= LargeBlockHeaderSize);
 
-        if (alignedOffset + alignedSize > Size)
+        // Pooled page chains shared by all allocators, a reset pushes a whole chain at once.
+        TLockFreeListUnordered<TransientAllocatorPage, PLATFORM_CACHE_LINE_SIZE>& GetPagePool()
         {
-            return nullptr; // Not enough space
+            static TLockFreeListUnordered<TransientAllocatorPage, PLATFORM_CACHE_LINE_SIZE> pagePool;
+            return pagePool;
         }
+        std::atomic<int64> GPooledPageCount = 0;
 
-        void* result = static_cast<char*>(Memory) + alignedOffset;
-// #if !SHIPPING
-        memset(result, 0, alignedSize);
-// #endif
-        Used = alignedOffset + alignedSize;
-        return result;
-    }
+        // Pool threads and registered outside threads each own one context of the sync workers.
+        uint32 GetTransientContextIndex()
+        {
+            return GSyncWorkers ? GSyncWorkers->GetContextIndex() : 0;
+        }
 
-    void TransientAllocator::MemoryBlock::Reset()
-    {
-        Used = 0;
-// #if !SHIPPING
-        memset(Memory, 0xce, Size);
-// #endif
+        void FillDebugPattern(void* memory, size_t size)
+        {
+#if TRANSIENT_ALLOCATOR_DEBUG_FILL
+            memset(memory, 0xce, size);
+#endif
+        }
     }
 
-    // TransientAllocator implementation
     TransientAllocator::TransientAllocator()
-        : CurrentBlockIndex(0), FrameCount(0), MaxBlocksUsedInPeriod(0)
+        : NumContexts(GSyncWorkers ? GSyncWorkers->GetNumContexts() : 1)
     {
-        // Create initial block
-        Blocks.push_back(new MemoryBlock(TRANSIENT_ALLOCATOR_BLOCK_SIZE));
+        ContextPages = static_cast<TransientContextPage*>(TMemory::Malloc<TransientContextPage>(NumContexts));
+        for (uint32 index = 0; index < NumContexts; ++index)
+        {
+            new (&ContextPages[index]) TransientContextPage;
+        }
     }
 
     TransientAllocator::~TransientAllocator()
     {
-        // Free all large allocations
-        for (const auto& pair : LargeBlocks)
-        {
-            std::free(pair.second.Memory);
-        }
-        LargeBlocks.clear();
-
-        for (MemoryBlock* block : Blocks)
+        FreeAll();
+        for (auto& freeList : LargeFreeLists)
         {
-            delete block;
+            while (TransientLargeBlock* block = freeList.Pop())
+            {
+                TMemory::Free(block);
+            }
         }
-        Blocks.clear();
+        TMemory::Free(ContextPages);
     }
 
     void* TransientAllocator::Allocate(size_t size, uint32 alignment)
     {
         if (size == 0) return nullptr;
+        alignment = std::max(alignment, 1u);
 
-        // For large allocations, use direct malloc
-        if (size >= TRANSIENT_ALLOCATOR_LARGE_ALLOCATION_THRESHOLD)
+        if (size + alignment > TRANSIENT_ALLOCATOR_LARGE_ALLOCATION_THRESHOLD)
         {
-            return AllocateLarge(size);
+            return AllocateLarge(size, alignment);
         }
 
-        // Try to allocate from current block
-        MemoryBlock* currentBlock = GetOrCreateCurrentBlock();
-        void* result = currentBlock->Allocate(size, alignment);
-
-        if (result == nullptr)
+        // Bump in this context's page, grab a new one only when it is full.
+        uint32 const contextIndex = GetTransientContextIndex();
+        if (contextIndex >= NumContexts) [[unlikely]]
         {
-            // Current block is full, try to create a new one
-            size_t blockSize = std::max(static_cast<size_t>(TRANSIENT_ALLOCATOR_BLOCK_SIZE), AlignUp(size, alignment));
-            Blocks.push_back(new MemoryBlock(blockSize));
-            CurrentBlockIndex = Blocks.size() - 1;
-
-            currentBlock = Blocks[CurrentBlockIndex];
-            result = currentBlock->Allocate(size, alignment);
-
-            assert(result != nullptr && "Failed to allocate from new block");
+            TAssertf(false, "Transient allocator context %u is out of range, the allocator was created before the sync workers.", contextIndex);
+            return nullptr;
         }
-
-// #if !SHIPPING
-        memset(result, 0xce, size);
-// #endif
-
-        return result;
-    }
-
-    void* TransientAllocator::AllocateLarge(size_t size)
-    {
-        // First try to find a reusable allocation
-        void* reusedMemory = FindReusableLargeAllocation(size);
-        if (reusedMemory != nullptr)
+        TransientContextPage& contextPage = ContextPages[contextIndex];
+        if (contextPage.Page)
         {
-            return reusedMemory;
+            if (void* result = contextPage.Page->Allocate(size, alignment))
+            {
+                FillDebugPattern(result, size);
+                return result;
+            }
         }
 
-        // No reusable allocation found, create new one
-        void* memory = std::malloc(size);
-        assert(memory != nullptr && "Failed to allocate large memory");
-// #if !SHIPPING
-        memset(memory, 0xce, size);
-// #endif
-
-        LargeBlocks.emplace(size, LargeAllocation(memory, size));
-        return memory;
+        contextPage.Page = AcquirePage();
+        void* result = contextPage.Page->Allocate(size, alignment);
+        TAssertf(result != nullptr, "Transient allocation of %zu bytes does not fit in a page.", size);
+        FillDebugPattern(result, size);
+        return result;
     }
 
-    void TransientAllocator::FreeAll()
+    TransientAllocatorPage* TransientAllocator::AcquirePage()
     {
-        // Mark all large allocations as unused and increment frame count
-        for (auto& pair : LargeBlocks)
+        auto& pagePool = GetPagePool();
+        TransientAllocatorPage* page = pagePool.Pop();
+        if (page)
         {
-            LargeAllocation& allocation = pair.second;
-            if (allocation.InUse)
+            // Put the rest of the chain back.
+            if (page->Next)
             {
-                allocation.InUse = false;
-                allocation.UnusedFrameCount = 0;
-            }
-            else
-            {
-                allocation.UnusedFrameCount++;
+                pagePool.Push(page->Next);
             }
+            GPooledPageCount.fetch_sub(1, std::memory_order_relaxed);
         }
-
-        // Clean up expired large allocations
-        CleanupExpiredLargeAllocations();
-
-        // Track maximum blocks used in this period
-        size_t currentBlocksUsed = CurrentBlockIndex + 1;
-        MaxBlocksUsedInPeriod = std::max(currentBlocksUsed, MaxBlocksUsedInPeriod);
-
-        // Check if it's time to cleanup excess blocks
-        FrameCount++;
-        if (FrameCount > TRANSIENT_ALLOCATOR_BLOCK_USAGE_CHECK_FRAMES)
+        else
         {
-            // If we have more blocks than the maximum we want to keep
-            if (Blocks.size() - MaxBlocksUsedInPeriod > TRANSIENT_ALLOCATOR_FREE_BLOCKS_BIAS)
-            {
-                // Free excess blocks
-                for (size_t i = Blocks.size()-1; i >= MaxBlocksUsedInPeriod; i--)
-                {
-                    delete Blocks[i];
-                }
-                Blocks.resize(MaxBlocksUsedInPeriod);
-            }
-
-            // Reset the max blocks counter for next period
-            MaxBlocksUsedInPeriod = 0;
+            page = new (TMemory::Malloc(TRANSIENT_ALLOCATOR_PAGE_SIZE, PLATFORM_CACHE_LINE_SIZE)) TransientAllocatorPage;
         }
+        page->Used = sizeof(TransientAllocatorPage);
 
-        // Reset all blocks without freeing them
-        for (MemoryBlock* block : Blocks)
+        // Link into this frame's pages, only FreeAll unlinks so there is no ABA.
+        page->Next = UsedPages.load(std::memory_order_relaxed);
+        while (!UsedPages.compare_exchange_weak(page->Next, page, std::memory_order_release, std::memory_order_relaxed))
         {
-            block->Reset();
         }
-
-        // Reset to first block
-        CurrentBlockIndex = 0;
+        FramePages.fetch_add(1, std::memory_order_relaxed);
+        return page;
     }
 
-    TransientAllocator::MemoryBlock* TransientAllocator::GetOrCreateCurrentBlock()
+    void* TransientAllocator::AllocateLarge(size_t size, uint32 alignment)
     {
-        if (CurrentBlockIndex >= Blocks.size())
-        {
-            Blocks.push_back(new MemoryBlock(TRANSIENT_ALLOCATOR_BLOCK_SIZE));
-            CurrentBlockIndex = Blocks.size() - 1;
-        }
+        TAssertf(alignment <= LargeBlockHeaderSize, "Transient allocation alignment %u is not supported.", alignment);
 
-        return Blocks[CurrentBlockIndex];
-    }
-
-    size_t TransientAllocator::GetTotalAllocatedMemory() const
-    {
-        size_t total = 0;
+        // Power-of-two size classes starting at the large threshold.
+        size_t const classSize = std::bit_ceil(std::max(size, static_cast<size_t>(TRANSIENT_ALLOCATOR_LARGE_ALLOCATION_THRESHOLD)));
+        uint32 const sizeClass = static_cast<uint32>(std::countr_zero(classSize) - std::countr_zero(static_cast<size_t>(TRANSIENT_ALLOCATOR_LARGE_ALLOCATION_THRESHOLD)));
 
-        // Add block memory
-        for (const MemoryBlock* block : Blocks)
+        TransientLargeBlock* block = sizeClass < NumLargeSizeClasses ? LargeFreeLists[sizeClass].Pop() : nullptr;
+        if (!block)
         {
-            total += block->Size;
+            size_t const blockSize = sizeClass < NumLargeSizeClasses ? classSize : size;
+            block = new (TMemory::Malloc(LargeBlockHeaderSize + blockSize, LargeBlockHeaderSize)) TransientLargeBlock;
+            block->Size = blockSize;
+            block->SizeClass = std::min(sizeClass, NumLargeSizeClasses);
         }
 
-        // Add large allocations
-        for (const auto& pair : LargeBlocks)
+        block->Next = UsedLargeBlocks.load(std::memory_order_relaxed);
+        while (!UsedLargeBlocks.compare_exchange_weak(block->Next, block, std::memory_order_release, std::memory_order_relaxed))
         {
-            total += pair.second.Size;
         }
+        FrameLargeBlocks.fetch_add(1, std::memory_order_relaxed);
+        FrameLargeBytes.fetch_add(block->Size, std::memory_order_relaxed);
 
-        return total;
+        void* result = reinterpret_cast<byte*>(block) + LargeBlockHeaderSize;
+        FillDebugPattern(result, size);
+        return result;
     }
 
-    size_t TransientAllocator::GetTotalUsedMemory() const
+    void TransientAllocator::FreeAll()
     {
-        size_t total = 0;
-
-        // Add used memory from blocks
-        for (const MemoryBlock* block : Blocks)
+        // Frame statistics.
+        uint32 const framePages = FramePages.exchange(0, std::memory_order_relaxed);
+        Stats.FramePages = framePages;
+        Stats.FrameLargeBlocks = FrameLargeBlocks.exchange(0, std::memory_order_relaxed);
+        Stats.FrameBytes = static_cast<uint64>(framePages) * TRANSIENT_ALLOCATOR_PAGE_SIZE + FrameLargeBytes.exchange(0, std::memory_order_relaxed);
+        Stats.HighWaterBytes = std::max(Stats.HighWaterBytes, Stats.FrameBytes);
+
+        // Every context starts the next frame on a fresh page.
+        for (uint32 index = 0; index < NumContexts; ++index)
         {
-            total += block->Used;
+            ContextPages[index].Page = nullptr;
         }
 
-        // Add active large allocations
-        for (const auto& pair : LargeBlocks)
+        // Hand all pages back as one chain, or free them when the pool is already full.
+        TransientAllocatorPage* pages = UsedPages.exchange(nullptr, std::memory_order_acquire);
+        if (pages)
         {
-            if (pair.second.InUse)
+            if (GPooledPageCount.load(std::memory_order_relaxed) + framePages <= TRANSIENT_ALLOCATOR_MAX_POOLED_PAGES)
             {
-                total += pair.second.Size;
+                GPooledPageCount.fetch_add(framePages, std::memory_order_relaxed);
+                GetPagePool().Push(pages);
             }
-        }
-
-        return total;
-    }
-
-    void* TransientAllocator::FindReusableLargeAllocation(size_t size)
-    {
-        auto range = LargeBlocks.equal_range(size);
-        for (auto it = range.first; it != range.second; ++it)
-        {
-            LargeAllocation& allocation = it->second;
-            if (!allocation.InUse)
+            else
             {
-                allocation.InUse = true;
-                allocation.UnusedFrameCount = 0;
-                return allocation.Memory;
+                while (pages)
+                {
+                    TransientAllocatorPage* next = pages->Next;
+                    TMemory::Free(pages);
+                    pages = next;
+                }
             }
         }
-        return nullptr;
+
+        ReleaseLargeBlocks();
+        ++FrameCount;
     }
 
-    void TransientAllocator::CleanupExpiredLargeAllocations()
+    void TransientAllocator::ReleaseLargeBlocks()
     {
-        auto it = LargeBlocks.begin();
-        while (it != LargeBlocks.end())
+        // Used blocks go back to their size class.
+        TransientLargeBlock* block = UsedLargeBlocks.exchange(nullptr, std::memory_order_acquire);
+        while (block)
         {
-            const LargeAllocation& allocation = it->second;
-            if (!allocation.InUse && allocation.UnusedFrameCount >= TRANSIENT_ALLOCATOR_LARGE_FREE_FRAMES_THRESHOLD)
+            TransientLargeBlock* next = block->Next;
+            if (block->SizeClass < NumLargeSizeClasses)
             {
-                std::free(allocation.Memory);
-                it = LargeBlocks.erase(it);
+                block->LastUsedFrame = FrameCount;
+                LargeFreeLists[block->SizeClass].Push(block);
             }
             else
             {
-                ++it;
+                TMemory::Free(block);
             }
+            block = next;
         }
-    }
 
-    size_t TransientAllocator::GetActiveLargeAllocationCount() const
-    {
-        size_t count = 0;
-        for (const auto& pair : LargeBlocks)
+        // Free blocks unused for a few frames.
+        TransientLargeBlock* keptBlocks = nullptr;
+        for (auto& freeList : LargeFreeLists)
         {
-            if (pair.second.InUse)
+            while (TransientLargeBlock* freeBlock = freeList.Pop())
             {
-                count++;
+                if (FrameCount - freeBlock->LastUsedFrame >= TRANSIENT_ALLOCATOR_LARGE_FREE_FRAMES_THRESHOLD)
+                {
+                    TMemory::Free(freeBlock);
+                }
+                else
+                {
+                    freeBlock->Next = keptBlocks;
+                    keptBlocks = freeBlock;
+                }
             }
         }
-        return count;
-    }
-
-    size_t TransientAllocator::AlignUp(size_t value, size_t alignment)
-    {
-        if (alignment == 0) alignment = 1;
-        return (value + alignment - 1) & ~(alignment - 1);
+        while (keptBlocks)
+        {
+            TransientLargeBlock* next = keptBlocks->Next;
+            LargeFreeLists[keptBlocks->SizeClass].Push(keptBlocks);
+            keptBlocks = next;
+        }
     }
-}
\ No newline at end of file
+}
@@ -13,6 +13,20 @@ namespace Thunder
     };
     using BinaryDataRef = TRefCountPtr<BinaryData>;
 
+    /* Binary Data owning its allocation, freed with the last reference */
+    struct HeapBinaryData : BinaryData
+    {
+        HeapBinaryData(size_t inSize)
+        {
+            Data = TMemory::Malloc<uint8>(inSize);
+            Size = inSize;
+        }
+        ~HeapBinaryData() override
+        {
+            TMemory::Destroy(Data);
+        }
+    };
+
     /* Safe Binary Data*/
     struct ManagedBinaryData
     {
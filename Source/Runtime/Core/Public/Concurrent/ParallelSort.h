@@ -0,0 +1,127 @@
+#pragma once
+#include "Concurrent/TaskScheduler.h"
+
+namespace Thunder
+{
+	/*
+	 * Stable LSD radix sort on 64-bit keys, 8 bits per pass.
+	 * Items are split into blocks which build their digit histograms and scatter in parallel on GSyncWorkers,
+	 * passes where every key shares the same digit are skipped. The result ends up in items, scratch is clobbered.
+	 **/
+	template<class T, class KeyFunctionType>
+	void ParallelRadixSort(TArray<T>& items, TArray<T>& scratch, const KeyFunctionType& getKey, uint32 minBlockSize = 4096)
+	{
+		constexpr uint32 RadixBits = 8;
+		constexpr uint32 NumBuckets = 1u << RadixBits;
+		constexpr uint32 NumPasses = 64 / RadixBits;
+
+		const uint32 numItems = static_cast<uint32>(items.size());
+		if (numItems < 2)
+		{
+			return;
+		}
+		scratch.resize(numItems);
+
+		const uint32 maxBlocks = GSyncWorkers ? GSyncWorkers->GetNumThreads() + 1 : 1;
+		const uint32 numBlocks = std::clamp(numItems / std::max(minBlockSize, 1u), 1u, maxBlocks);
+		const uint32 blockSize = (numItems + numBlocks - 1) / numBlocks;
+		auto forEachBlock = [numBlocks](const auto& body)
+		{
+			if (numBlocks == 1)
+			{
+				body(0);
+				return;
+			}
+			GSyncWorkers->ParallelForRange(numBlocks, [&body](uint32 begin, uint32 end, uint32)
+			{
+				for (uint32 block = begin; block < end; ++block)
+				{
+					body(block);
+				}
+			}, 1);
+		};
+
+		// Histograms of every digit in a single read of the keys, used to skip passes that would not move anything.
+		TArray<uint32> histograms(static_cast<size_t>(numBlocks) * NumPasses * NumBuckets, 0);
+		forEachBlock([&](uint32 block)
+		{
+			uint32* histogram = &histograms[static_cast<size_t>(block) * NumPasses * NumBuckets];
+			const uint32 end = std::min(numItems, (block + 1) * blockSize);
+			for (uint32 index = block * blockSize; index < end; ++index)
+			{
+				const uint64 key = getKey(items[index]);
+				for (uint32 pass = 0; pass < NumPasses; ++pass)
+				{
+					++histogram[pass * NumBuckets + ((key >> (pass * RadixBits)) & (NumBuckets - 1))];
+				}
+			}
+		});
+
+		TArray<uint32> offsets(static_cast<size_t>(numBlocks) * NumBuckets);
+		T* source = items.data();
+		T* destination = scratch.data();
+		bool itemsMoved = false;
+		for (uint32 pass = 0; pass < NumPasses; ++pass)
+		{
+			uint32 const shift = pass * RadixBits;
+			bool singleBucket = false;
+			for (uint32 bucket = 0; bucket < NumBuckets && !singleBucket; ++bucket)
+			{
+				uint32 bucketCount = 0;
+				for (uint32 block = 0; block < numBlocks; ++block)
+				{
+					bucketCount += histograms[(static_cast<size_t>(block) * NumPasses + pass) * NumBuckets + bucket];
+				}
+				singleBucket = bucketCount == numItems;
+			}
+			if (singleBucket)
+			{
+				continue;
+			}
+
+			// Blocks hold different items once a scatter ran, recount this digit.
+			if (itemsMoved)
+			{
+				forEachBlock([&](uint32 block)
+				{
+					uint32* histogram = &histograms[(static_cast<size_t>(block) * NumPasses + pass) * NumBuckets];
+					std::fill_n(histogram, NumBuckets, 0u);
+					const uint32 end = std::min(numItems, (block + 1) * blockSize);
+					for (uint32 index = block * blockSize; index < end; ++index)
+					{
+						++histogram[(getKey(source[index]) >> shift) & (NumBuckets - 1)];
+					}
+				});
+			}
+
+			// Bucket-major, then block order, so the scatter stays stable.
+			uint32 running = 0;
+			for (uint32 bucket = 0; bucket < NumBuckets; ++bucket)
+			{
+				for (uint32 block = 0; block < numBlocks; ++block)
+				{
+					offsets[block * NumBuckets + bucket] = running;
+					running += histograms[(static_cast<size_t>(block) * NumPasses + pass) * NumBuckets + bucket];
+				}
+			}
+
+			forEachBlock([&](uint32 block)
+			{
+				uint32* blockOffsets = &offsets[block * NumBuckets];
+				const uint32 end = std::min(numItems, (block + 1) * blockSize);
+				for (uint32 index = block * blockSize; index < end; ++index)
+				{
+					const uint32 digit = static_cast<uint32>((getKey(source[index]) >> shift) & (NumBuckets - 1));
+					destination[blockOffsets[digit]++] = std::move(source[index]);
+				}
+			});
+			std::swap(source, destination);
+			itemsMoved = true;
+		}
+
+		if (source != items.data())
+		{
+			items.swap(scratch);
+		}
+	}
+}
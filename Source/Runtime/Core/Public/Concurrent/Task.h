@@ -9,9 +9,13 @@ namespace Thunder
 	public:
 		CORE_API virtual void DoWork() = 0;
 		CORE_API virtual void Abandon() {}
-		CORE_API NameHandle GetName() const { return DebugName; }
+		// Tasks whose storage is owned elsewhere return false, the worker won't destroy them after DoWork().
+		CORE_API virtual bool IsAutoDestroy() const { return true; }
+		CORE_API virtual NameHandle GetName() const { return DebugName; }
 
 		CORE_API virtual ~ITask() = default;
+
+		uint64 TraceEnqueueTime = 0; // Stamped by the schedulers while TaskTrace is enabled.
 	private:
 		NameHandle DebugName = "UnKnown";
 	};
@@ -11,7 +11,7 @@ namespace Thunder
 		TaskGraphTask(const String& InDebugName = "")
 			: DebugName(InDebugName) {}
 
-		_NODISCARD_ NameHandle GetName() const
+		_NODISCARD_ NameHandle GetName() const override
 		{
 			return DebugName;
 		}
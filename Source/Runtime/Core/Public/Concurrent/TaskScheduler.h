@@ -5,6 +5,7 @@
 #include "Platform.h"
 #include "Task.h"
 #include "Container/LockFree.h"
+#include "Container/WorkStealingQueue.h"
 
 namespace Thunder
 {
@@ -16,8 +17,8 @@ namespace Thunder
 		virtual void DetachFromThread(ThreadProxy* InThreadProxy) = 0;
 		virtual void PushTask(ITask* InQueuedWork) = 0;
 		virtual void PushTask(const TFunction<void()>& InFunction);
-		ITask* GetNextQueuedWork();
-		_NODISCARD_ bool IsEmptyWork() const { return QueuedWork.IsEmpty(); }
+		virtual ITask* GetNextQueuedWork();
+		_NODISCARD_ virtual bool IsEmptyWork() const { return QueuedWork.IsEmpty(); }
 		virtual void WaitForCompletionAndThreadExit() = 0;
 
 	protected:
@@ -37,11 +38,28 @@ namespace Thunder
 		ThreadProxy* Thread {};
 	};
 
+	#define POOLED_SCHEDULER_MAX_THREADS 256
+	#define POOLED_SCHEDULER_MAX_EXTERNAL_CONTEXTS 8 // Threads outside the pool taking part in ParallelForRange.
+
+	enum class ESchedulingMode : uint8
+	{
+		SharedQueue,	// every task goes through QueuedWork, each push wakes the whole pool
+		WorkStealing	// pool threads push to their own deque, idle threads steal, one sleeper woken per task
+	};
+
 	class PooledTaskScheduler : public IScheduler
 	{
 	public:
+		PooledTaskScheduler(ESchedulingMode InMode = ESchedulingMode::WorkStealing);
+		~PooledTaskScheduler() override;
+
+		_NODISCARD_ ESchedulingMode GetSchedulingMode() const { return Mode; }
 		_NODISCARD_ int32 GetNumSchedulers() const { return static_cast<int32>(TaskSchedulers.size()); }
-		_NODISCARD_ int32 GetNumThreads() const { return static_cast<int32>(ThreadList.size()); }
+		_NODISCARD_ int32 GetNumThreads() const { return static_cast<int32>(NumThreads.load(std::memory_order_acquire)); }
+		// Slots needed by per-context data of ParallelForRange, pool threads first, then the outside callers.
+		_NODISCARD_ uint32 GetNumContexts() const { return static_cast<uint32>(GetNumThreads()) + POOLED_SCHEDULER_MAX_EXTERNAL_CONTEXTS; }
+		// Context index the calling thread gets in ParallelForRange.
+		_NODISCARD_ uint32 GetContextIndex() const;
 
 		void AttachToThread(ThreadProxy* InThreadProxy) override;
 		void AddSingleScheduler(SingleScheduler* InSingleScheduler);
@@ -53,13 +71,45 @@ namespace Thunder
 		void WaitForCompletionAndThreadExit() override;
 		uint32 GetThreadId(uint32 threadIndex) const;
 
-		void ParallelFor(TFunction<void(uint32, uint32)>& Body, uint32 NumTask, uint32 BundleSize = 8);
-		void ParallelFor(TFunction<void(uint32, uint32)>&& Body, uint32 NumTask, uint32 BundleSize = 8);
+		ITask* GetNextQueuedWork() override;
+		_NODISCARD_ bool IsEmptyWork() const override;
+
+		/**
+		 * Blocking parallel loop over [0, NumItems), no heap allocation.
+		 * Body(begin, end, contextIndex) is called with adaptively sized sub ranges (never smaller than MinBatchSize
+		 * except for the tail). The calling thread takes part in the work, contextIndex is the worker index for pool
+		 * threads. A thread outside the pool registers for its own index after them the first time it calls in, so the
+		 * game and render threads can run loops at the same time. Per-thread data needs GetNumContexts() slots.
+		 */
+		template<typename BodyType>
+		void ParallelForRange(uint32 NumItems, const BodyType& Body, uint32 MinBatchSize = 16)
+		{
+			ParallelForRangeInternal(NumItems, MinBatchSize, &Body, [](const void* body, uint32 begin, uint32 end, uint32 contextIndex)
+			{
+				(*static_cast<const BodyType*>(body))(begin, end, contextIndex);
+			});
+		}
+
+	private:
+		using ParallelForRangeFunction = void(*)(const void*, uint32, uint32, uint32);
+		void ParallelForRangeInternal(uint32 NumItems, uint32 MinBatchSize, const void* Body, ParallelForRangeFunction Function);
+		ITask* StealWork(const ThreadProxy* InThief);
+		void WakeSleepingThreads(uint32 InNumTasks);
+		FORCEINLINE ThreadProxy* GetPoolThread(uint32 InIndex) const { return ThreadList[InIndex].load(std::memory_order_relaxed); }
+		bool IsPoolThread(const ThreadProxy* InThread) const;
 
 	private:
 		friend class ThreadProxy;
 		TArray<SingleScheduler*> TaskSchedulers {};
-		TArray<ThreadProxy*> ThreadList {};
+		// Fixed storage, pool threads already run and steal while later ones attach. A slot is written before the release
+		// store of NumThreads publishes it and readers only look at [0, NumThreads), so they never see a half built list.
+		std::atomic<ThreadProxy*> ThreadList[POOLED_SCHEDULER_MAX_THREADS] {};
+		std::atomic<uint32> NumThreads { 0 };
+		SpinLock ThreadListLock; // Serializes attach and detach.
+		ESchedulingMode Mode;
+		std::atomic<uint32> NextWakeIndex { 0 };
+		std::atomic<int32> NumLocalWork { 0 };
+		TArray<class ParallelForHelperTask*> ParallelForHelpers {};
 	};
 
 	class TaskSchedulerManager
@@ -0,0 +1,64 @@
+#pragma once
+#include <atomic>
+#include "Container.h"
+#include "NameHandle.h"
+#include "Platform.h"
+
+#ifndef TASK_TRACE_ENABLED
+	#define TASK_TRACE_ENABLED 1 // Compiles the recording calls in, they still do nothing until TaskTrace::SetEnabled(true).
+#endif
+
+#ifndef TASK_TRACE_RING_SIZE
+	#define TASK_TRACE_RING_SIZE (16 * 1024) // Events kept per thread (32 bytes each), the oldest are overwritten.
+#endif
+
+namespace Thunder
+{
+	enum class ETaskTraceEvent : uint8
+	{
+		TaskBegin,		// Payload: enqueue-to-start latency in ns, 0 if unknown.
+		TaskEnd,
+		Enqueue,		// Payload: local deque depth of the work-stealing pool after the push.
+		Steal,			// Payload: context id of the victim.
+		Suspend,		// Payload: empty polls of the queues since the previous suspend.
+		Resume,
+		GraphSubmit		// Payload: number of nodes in the graph.
+	};
+
+	struct TaskTraceEvent
+	{
+		uint64 Timestamp;
+		uint64 Payload;
+		const char* Name;
+		ETaskTraceEvent Type;
+	};
+
+	/**
+	 * Per-thread ring buffers of scheduler events, works without a Tracy server.
+	 * Recording is a relaxed load when disabled, and an unshared buffer write when enabled.
+	 * Dumping while threads keep recording is allowed, events overwritten during the dump may be torn.
+	 */
+	class TaskTrace
+	{
+	public:
+		static CORE_API void SetEnabled(bool bInEnabled);
+		FORCEINLINE static bool IsEnabled() { return bEnabled.load(std::memory_order_relaxed); }
+
+		static CORE_API uint64 Now(); // Nanoseconds, steady clock.
+		static CORE_API void Record(ETaskTraceEvent type, const char* name = nullptr, uint64 payload = 0);
+		static CORE_API void Clear(); // Only while no thread is recording.
+
+		static CORE_API bool DumpChromeTrace(const String& fileName); // chrome://tracing or ui.perfetto.dev
+		static CORE_API String BuildSummary();
+		static CORE_API bool DumpSummary(const String& fileName);
+
+	private:
+		static CORE_API std::atomic<bool> bEnabled;
+	};
+}
+
+#if TASK_TRACE_ENABLED
+	#define THUNDER_TASK_TRACE(...) do { if (::Thunder::TaskTrace::IsEnabled()) [[unlikely]] { ::Thunder::TaskTrace::Record(__VA_ARGS__); } } while (0)
+#else
+	#define THUNDER_TASK_TRACE(...) do {} while (0)
+#endif
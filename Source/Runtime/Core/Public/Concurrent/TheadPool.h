@@ -4,6 +4,8 @@
 #include "Platform.h"
 #include "HAL/Event.h"
 #include "HAL/Thread.h"
+#include "Concurrent/Task.h"
+#include "Container/WorkStealingQueue.h"
 
 namespace Thunder
 {
@@ -32,6 +34,13 @@ namespace Thunder
 
 		void Suspend() const { DoWorkEvent->Reset(); }
 		void Resume() const { DoWorkEvent->Trigger(); }
+		bool TryWakeUp(); // Resume only if the thread is about to sleep, returns false if it is already awake.
+		_NODISCARD_ bool IsSleeping() const { return bSleeping.load(std::memory_order_seq_cst); }
+
+		// Work stealing, the deque belongs to the (single) work-stealing pool this thread is attached to.
+		void SetStealingScheduler(class PooledTaskScheduler* InScheduler);
+		_NODISCARD_ PooledTaskScheduler* GetStealingScheduler() const { return StealingScheduler; }
+		_NODISCARD_ TWorkStealingQueue<ITask>* GetLocalWork() const { return LocalWork; }
 		uint32 Run();
 		void WaitForCompletion(); // Thread termination
 
@@ -42,6 +51,9 @@ namespace Thunder
 	private:
 		IEvent* DoWorkEvent {};
 		std::atomic<bool> TimeToDie { false };
+		std::atomic<bool> bSleeping { false };
+		PooledTaskScheduler* StealingScheduler {};
+		TWorkStealingQueue<ITask>* LocalWork {};
 		IThread* Thread {};
 		ThreadPoolBase* ThreadPoolOwner {};
 		TSet<IScheduler*> AttachedSchedulers {};
@@ -59,6 +71,7 @@ namespace Thunder
 	{
 	public:
 		ThreadPoolBase(uint32 ThreadsNum, uint32 StackSize, const String& ThreadNamePrefix = "");
+		~ThreadPoolBase(); // Waits for the threads to exit, detach them from their schedulers first.
 
 		_NODISCARD_ int32 GetNumThreads() const
 		{
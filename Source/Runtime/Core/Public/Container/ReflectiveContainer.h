@@ -55,6 +55,7 @@ namespace Thunder
 		TypeComponent() : Offset(0), Kind(ETypeKind::Invalid) {}
 
 		size_t GetSize() const;
+		size_t GetAlignment() const;
 		
 		template<typename T>
 		static TypeComponent Create(const String& inName, size_t inOffset);
@@ -85,7 +86,9 @@ namespace Thunder
 		void Initialize();
 
 		void CopyData(const void* src, size_t offset, size_t size) const;
-		byte* MoveData();
+		// Hands the data over to the caller. Data read in place stays owned by the mapped package, whose reference moves to
+		// outSource: the data is valid as long as the caller holds it.
+		byte* MoveData(BinaryDataRef& outSource);
 
 		// Get/Set component values
 		template<typename T>
@@ -124,10 +127,12 @@ namespace Thunder
 		void Clear();
 
 		void Serialize(MemoryWriter& archive);
+		// Elements whose memory layout matches the serialized one are read as one block, in place when the archive holds its source.
 		void DeSerialize(MemoryReader& archive);
 
 	private:
 		void* Data;
+		BinaryDataRef ExternalData; // Set when Data points into it instead of an own allocation.
 		TArray<TypeComponent> Components;
 		size_t Stride;
 		size_t DataNum;
@@ -135,6 +140,7 @@ namespace Thunder
 
 		// Helper functions
 		void CalculateLayout();
+		bool IsSerializedLayout() const;
 		void AllocateData();
 		void DestroyData();
 		void CopyData(const ReflectiveContainer& other);
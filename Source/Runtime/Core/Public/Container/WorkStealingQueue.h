@@ -0,0 +1,105 @@
+#pragma once
+#include "Assertion.h"
+#include "Platform.h"
+#include "Container/LockFree.h"
+
+namespace Thunder
+{
+	/*
+	 * Chase-Lev work stealing deque (fixed capacity).
+	 * The owner thread pushes and pops at the bottom (LIFO), other threads steal from the top (FIFO).
+	 * Push fails when the ring is full, the caller is expected to fall back to a shared queue.
+	 **/
+	template<class T, uint32 Capacity = 1024>
+	class TWorkStealingQueue
+	{
+		static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two.");
+		static constexpr int64 IndexMask = Capacity - 1;
+
+	public:
+		TWorkStealingQueue()
+		{
+			for (auto& slot : Slots)
+			{
+				slot.store(nullptr, std::memory_order_relaxed);
+			}
+		}
+
+		// Owner thread only.
+		bool Push(T* InItem)
+		{
+			const int64 bottom = Bottom.load(std::memory_order_relaxed);
+			const int64 top = Top.load(std::memory_order_acquire);
+			if (bottom - top >= static_cast<int64>(Capacity)) [[unlikely]]
+			{
+				return false;
+			}
+			Slots[bottom & IndexMask].store(InItem, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_release);
+			Bottom.store(bottom + 1, std::memory_order_relaxed);
+			return true;
+		}
+
+		// Owner thread only.
+		T* Pop()
+		{
+			const int64 bottom = Bottom.load(std::memory_order_relaxed) - 1;
+			Bottom.store(bottom, std::memory_order_relaxed);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			int64 top = Top.load(std::memory_order_relaxed);
+
+			if (top > bottom)
+			{
+				Bottom.store(bottom + 1, std::memory_order_relaxed);
+				return nullptr;
+			}
+
+			T* item = Slots[bottom & IndexMask].load(std::memory_order_relaxed);
+			if (top == bottom)
+			{
+				// Last item, race against thieves.
+				if (!Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+				{
+					item = nullptr;
+				}
+				Bottom.store(bottom + 1, std::memory_order_relaxed);
+			}
+			return item;
+		}
+
+		// Any thread.
+		T* Steal()
+		{
+			int64 top = Top.load(std::memory_order_acquire);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			const int64 bottom = Bottom.load(std::memory_order_acquire);
+			if (top >= bottom)
+			{
+				return nullptr;
+			}
+
+			T* item = Slots[top & IndexMask].load(std::memory_order_relaxed);
+			if (!Top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+			{
+				return nullptr;
+			}
+			return item;
+		}
+
+		_NODISCARD_ bool IsEmpty() const
+		{
+			return Bottom.load(std::memory_order_acquire) <= Top.load(std::memory_order_acquire);
+		}
+
+		_NODISCARD_ int64 Num() const
+		{
+			const int64 size = Bottom.load(std::memory_order_acquire) - Top.load(std::memory_order_acquire);
+			return size > 0 ? size : 0;
+		}
+
+	private:
+		alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<int64> Top { 0 };
+		alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<int64> Bottom { 0 };
+		alignas(PLATFORM_CACHE_LINE_SIZE) std::atomic<T*> Slots[Capacity];
+	};
+}
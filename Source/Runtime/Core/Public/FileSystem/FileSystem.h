@@ -1,4 +1,5 @@
 #pragma once
+#include "BinaryData.h"
 #include "Container.h"
 #include "Templates/RefCounting.h"
 #include <cstdio>
@@ -18,6 +19,8 @@ namespace Thunder
 		virtual bool FileExists(const String& path) = 0;
 		virtual bool DirectoryExists(const String& path) = 0;
 		virtual bool Delete(const String& path) = 0;
+		// Maps the whole file with copy-on-write pages, null when it can't be mapped. The mapping lives as long as the returned data.
+		virtual BinaryDataRef MapFile(const String& path, bool bNeedJoin = false) = 0;
 		virtual void Mount(const String& path) = 0;
 		virtual void Unmount(const String& mountPoint) = 0;
 	};
@@ -34,6 +37,7 @@ namespace Thunder
 		CORE_API virtual bool FileExists(const String& path) override;
 		CORE_API virtual bool DirectoryExists(const String& path) override;
 		CORE_API virtual bool Delete(const String& path) override;
+		CORE_API virtual BinaryDataRef MapFile(const String& path, bool bNeedJoin = false) override;
 		CORE_API virtual void Mount(const String& path) override;
 		CORE_API virtual void Unmount(const String& mountPoint) override;
 
@@ -38,6 +38,8 @@ namespace Thunder
 	{
 	public:
 		MemoryReader(BinaryData* data);
+		// Reads [offset, offset + size) of data and keeps it alive, so in-place reads may outlive the reader.
+		MemoryReader(const BinaryDataRef& data, size_t offset, size_t size);
 		~MemoryReader();
 
 		template<typename T>
@@ -50,9 +52,15 @@ namespace Thunder
 			return *this >> guid.A >> guid.B >> guid.C >> guid.D;
 		}
 		void ReadRaw(void* dest, size_t size);
+		// Skips size bytes and returns where they are instead of copying them, nullptr past the end.
+		const void* ReadInPlace(size_t size);
+
+		// Data backing in-place reads, null when the reader doesn't hold a reference to it.
+		_NODISCARD_ const BinaryDataRef& GetSource() const { return Source; }
 
 	private:
 
+		BinaryDataRef Source;
 		const void* Buffer;
 		size_t BufferSize;
 		size_t Position;
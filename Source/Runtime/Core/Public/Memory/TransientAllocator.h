@@ -1,61 +1,54 @@
 #pragma once
 
 #include "MemoryBase.h"
-#include <vector>
-#include <unordered_map>
-#include <cstdlib>
+#include <atomic>
+#include "Container/LockFree.h"
 
-#ifndef TRANSIENT_ALLOCATOR_LARGE_ALLOCATION_THRESHOLD
-#define TRANSIENT_ALLOCATOR_LARGE_ALLOCATION_THRESHOLD (1024 * 1024)  // 1MB threshold
+#ifndef TRANSIENT_ALLOCATOR_PAGE_SIZE
+#define TRANSIENT_ALLOCATOR_PAGE_SIZE (256 * 1024)  // 256KB bump page per thread
 #endif
 
-#ifndef TRANSIENT_ALLOCATOR_BLOCK_SIZE
-#define TRANSIENT_ALLOCATOR_BLOCK_SIZE (4 * 1024 * 1024)  // 4MB per block
+#ifndef TRANSIENT_ALLOCATOR_LARGE_ALLOCATION_THRESHOLD
+#define TRANSIENT_ALLOCATOR_LARGE_ALLOCATION_THRESHOLD (TRANSIENT_ALLOCATOR_PAGE_SIZE / 4)  // Larger requests get their own block
 #endif
 
 #ifndef TRANSIENT_ALLOCATOR_LARGE_FREE_FRAMES_THRESHOLD
 #define TRANSIENT_ALLOCATOR_LARGE_FREE_FRAMES_THRESHOLD 3  // Free large allocations after 3 unused frames
 #endif
 
-#ifndef TRANSIENT_ALLOCATOR_BLOCK_USAGE_CHECK_FRAMES
-#define TRANSIENT_ALLOCATOR_BLOCK_USAGE_CHECK_FRAMES 60  // Check block usage every N frames
+#ifndef TRANSIENT_ALLOCATOR_MAX_POOLED_PAGES
+#define TRANSIENT_ALLOCATOR_MAX_POOLED_PAGES 256  // Pages kept in the shared pool, the rest is freed on reset
 #endif
 
-#ifndef TRANSIENT_ALLOCATOR_FREE_BLOCKS_BIAS
-#define TRANSIENT_ALLOCATOR_FREE_BLOCKS_BIAS 10  // Bias of most blocks when usage check
+#ifndef TRANSIENT_ALLOCATOR_DEBUG_FILL
+#define TRANSIENT_ALLOCATOR_DEBUG_FILL 0  // Fill returned memory with 0xce
 #endif
 
 namespace Thunder
 {
-    class CORE_API TransientAllocator
-    {
-    private:
-        struct MemoryBlock
-        {
-            void* Memory;
-            size_t Size;
-            size_t Used;
-
-            MemoryBlock(size_t size);
-            ~MemoryBlock();
-
-            void* Allocate(size_t size, uint32 alignment);
-            void Reset();
-            size_t GetAvailableSpace() const { return Size - Used; }
-        };
+    struct TransientAllocatorPage;
+    struct TransientLargeBlock;
+    struct TransientContextPage;
 
-        struct LargeAllocation
-        {
-            void* Memory;
-            size_t Size;
-            uint32 UnusedFrameCount;
-            bool InUse;
-
-            LargeAllocation(void* memory, size_t size)
-                : Memory(memory), Size(size), UnusedFrameCount(0), InUse(true) {}
-        };
+    struct TransientAllocatorStats
+    {
+        uint64 FrameBytes = 0;      // Page and large block bytes handed out during the last frame.
+        uint64 HighWaterBytes = 0;  // Largest FrameBytes seen.
+        uint32 FramePages = 0;
+        uint32 FrameLargeBlocks = 0;
+    };
 
+    /**
+     * Frame-lifetime allocator, safe to allocate from any thread.
+     * Each sync worker context bumps inside its own page of this allocator, taken from a lock-free pool shared by all
+     * allocators, so switching between allocators never abandons a partly used page.
+     * FreeAll must not race with Allocate, it hands every page back to the pool in one push.
+     */
+    class CORE_API TransientAllocator
+    {
     public:
+        static constexpr uint32 NumLargeSizeClasses = 16; // Powers of two from the large threshold.
+
         TransientAllocator();
         ~TransientAllocator();
 
@@ -69,24 +62,25 @@ namespace Thunder
 
         void FreeAll();
 
-        size_t GetTotalAllocatedMemory() const;
-        size_t GetTotalUsedMemory() const;
-        size_t GetBlockCount() const { return Blocks.size(); }
-        size_t GetLargeAllocationCount() const { return LargeBlocks.size(); }
-        size_t GetActiveLargeAllocationCount() const;
+        const TransientAllocatorStats& GetStats() const { return Stats; }
 
     private:
-        std::vector<MemoryBlock*> Blocks;
-        std::unordered_multimap<size_t, LargeAllocation> LargeBlocks;
-        size_t CurrentBlockIndex;
-        size_t FrameCount;
-        size_t MaxBlocksUsedInPeriod;
-
-        MemoryBlock* GetOrCreateCurrentBlock();
-        void* AllocateLarge(size_t size);
-        void* FindReusableLargeAllocation(size_t size);
-        void CleanupExpiredLargeAllocations();
-
-        static size_t AlignUp(size_t value, size_t alignment);
+        TransientAllocatorPage* AcquirePage();
+        void* AllocateLarge(size_t size, uint32 alignment);
+        void ReleaseLargeBlocks();
+
+        // Current page per GSyncWorkers context, only the thread owning a context touches its slot.
+        TransientContextPage* ContextPages = nullptr;
+        uint32 NumContexts = 0;
+        uint64 FrameCount = 0;
+
+        std::atomic<TransientAllocatorPage*> UsedPages = nullptr;
+        std::atomic<TransientLargeBlock*> UsedLargeBlocks = nullptr;
+        TLockFreeListUnordered<TransientLargeBlock, 0> LargeFreeLists[NumLargeSizeClasses];
+
+        std::atomic<uint32> FramePages = 0;
+        std::atomic<uint32> FrameLargeBlocks = 0;
+        std::atomic<uint64> FrameLargeBytes = 0;
+        TransientAllocatorStats Stats;
     };
-}
\ No newline at end of file
+}
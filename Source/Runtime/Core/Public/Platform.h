@@ -11,6 +11,15 @@
 	#error "Unknown compiler"
 #endif
 
+#if defined(_M_ARM) || defined(_M_ARM64) || defined(_M_ARM64EC)
+	#define PLATFORM_CPU_ARM_FAMILY							1
+	#define PLATFORM_ENABLE_VECTORINTRINSICS_NEON			1
+	#define PLATFORM_ENABLE_VECTORINTRINSICS				1
+#elif (defined(_M_IX86) || defined(_M_X64))
+	#define PLATFORM_CPU_X86_FAMILY							1
+	#define PLATFORM_ENABLE_VECTORINTRINSICS				1
+#endif
+
 namespace Thunder
 {
 #define FORCEINLINE __forceinline									/* Force code to be inline */
@@ -147,7 +156,8 @@ namespace Thunder
 	{
 		Invalid = 0,
 		D3D11,
-		D3D12
+		D3D12,
+		Null
 	};
 
 	int TMessageBox(void* handle, const char* text, const char* caption, uint32 type);
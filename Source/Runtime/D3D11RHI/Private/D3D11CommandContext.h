@@ -2,9 +2,12 @@
 #include "RHIContext.h"
 #include "CoreMinimal.h"
 #include "d3d11.h"
+#include <wrl/client.h>
 
 namespace Thunder
 {
+	using namespace Microsoft::WRL;
+
 	class D3D11CommandContext : public RHICommandContext
 	{
 	public:
@@ -48,6 +51,7 @@ namespace Thunder
 		void Reset(uint32 index) override {}
     	void BeginFrame() override {}
     	void TransitionBarrier(RHIResource* res, ERHIResourceState oldState, ERHIResourceState newState, uint32 subResource) override {}
+    	void AliasingBarrier(RHIResource* before, RHIResource* after) override {}
 
 		// Backbuffer operations (for present pass)
 		void TransitionBackBufferToRenderTarget() override {}
@@ -1,6 +1,7 @@
 ﻿#include "D3D11RHIModule.h"
 #include "D3D11RHI.h"
 #include "Module/ModuleManager.h"
+#include "PipelineStateCache.h"
 
 namespace Thunder
 {
@@ -16,6 +17,7 @@ namespace Thunder
 
 	void TD3D11RHIModule::ShutDown()
 	{
+		ClearPipelineStateCache();
 		delete DynamicRHI;
 		GDynamicRHI = nullptr;
 		IRHIModule::ModuleInstance = nullptr;
@@ -2,9 +2,12 @@
 #include "RHI.h"
 #include "d3d11.h"
 #include "d3d11_3.h"
+#include <wrl/client.h>
 
 namespace Thunder
 {
+	using namespace Microsoft::WRL;
+
 	class D3D11RHIShaderResourceView : public RHIShaderResourceView
 	{
 	public:
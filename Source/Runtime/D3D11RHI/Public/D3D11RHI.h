@@ -1,9 +1,12 @@
 #pragma once
 #include "IDynamicRHI.h"
 #include "d3d11.h"
+#include <wrl/client.h>
 
 namespace Thunder
 {
+	using namespace Microsoft::WRL;
+
 	class D3D11DynamicRHI : public IDynamicRHI
 	{
 	public:
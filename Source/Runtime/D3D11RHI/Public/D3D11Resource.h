@@ -1,10 +1,13 @@
 ﻿#pragma once
 
+#include <wrl/client.h>
 #include "d3d11.h"
 #include "RHIResource.h"
 
 namespace Thunder
 {
+	using namespace Microsoft::WRL;
+
 	class D3D11Device : public RHIDevice
     {
     public:
@@ -690,6 +690,7 @@ namespace Thunder
 
         // Determine current frame heap from render thread frame number
         uint32 frameIndex = GFrameState->FrameNumberRenderThread.load(std::memory_order_acquire) % MAX_FRAME_LAG;
+        auto guard = Lock.Guard();
         TransientFrameHeap& heap = FrameHeaps[frameIndex];
 
         // Fast path: fits in current page
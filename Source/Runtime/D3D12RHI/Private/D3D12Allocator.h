@@ -173,7 +173,7 @@ namespace Thunder
         D3D12TransientUploadHeapAllocator(ID3D12Device* device);
         ~D3D12TransientUploadHeapAllocator() override;
 
-        // Linear bump allocation. Returns the CPU mapped address, or nullptr on failure.
+        // Linear bump allocation, thread safe. Returns the CPU mapped address, or nullptr on failure.
         void* Allocate(uint32 size, D3D12ResourceLocation& outLocation);
 
         // Call once per frame to recycle the next frame's pages and advance the ring.
@@ -188,5 +188,6 @@ namespace Thunder
         TransientFrameHeap FrameHeaps[MAX_FRAME_LAG];
         TArray<TransientUploadPage*> PagePool;
         uint32 PagePoolIdleFrameCount = 0;
+        SpinLock Lock; // Passes recorded in parallel allocate concurrently.
     };
 }
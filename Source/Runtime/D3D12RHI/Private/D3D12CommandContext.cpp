@@ -439,6 +439,9 @@ namespace Thunder
 		{
 			StateCache->Reset();
 		}
+
+		// The new command list starts without bound state or pass.
+		BeginDrawStatePass(nullptr);
 	}
 
 	void D3D12CommandContext::BeginFrame()
@@ -476,6 +479,17 @@ namespace Thunder
 		CommandList->ResourceBarrier(1, &barrier);
 	}
 
+	void D3D12CommandContext::AliasingBarrier(RHIResource* before, RHIResource* after)
+	{
+		D3D12_RESOURCE_BARRIER barrier = {};
+		barrier.Type  = D3D12_RESOURCE_BARRIER_TYPE_ALIASING;
+		barrier.Flags = D3D12_RESOURCE_BARRIER_FLAG_NONE;
+		barrier.Aliasing.pResourceBefore = before ? static_cast<ID3D12Resource*>(before->GetResource()) : nullptr;
+		barrier.Aliasing.pResourceAfter  = after ? static_cast<ID3D12Resource*>(after->GetResource()) : nullptr;
+
+		CommandList->ResourceBarrier(1, &barrier);
+	}
+
 	void D3D12CommandContext::TransitionBackBufferToRenderTarget()
 	{
 		auto* dx12RHI = static_cast<D3D12DynamicRHI*>(GDynamicRHI);
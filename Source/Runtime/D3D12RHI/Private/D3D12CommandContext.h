@@ -1,6 +1,7 @@
 ﻿#pragma once
 #include "RHIContext.h"
 #include "d3dx12.h"
+#include "D3D12RHICommon.h"
 
 namespace Thunder
 {
@@ -54,6 +55,7 @@ namespace Thunder
 		void Reset(uint32 index) override;
 		void BeginFrame() override;
     	void TransitionBarrier(RHIResource* res, ERHIResourceState oldState, ERHIResourceState newState, uint32 subResource) override;
+    	void AliasingBarrier(RHIResource* before, RHIResource* after) override;
 
         // Backbuffer operations (for present pass)
         void TransitionBackBufferToRenderTarget() override;
@@ -95,6 +95,8 @@ namespace Thunder
 	public:
 		D3D12RHIShaderResourceView(RHIViewDescriptor const& desc, D3D12OfflineDescriptor const& offlineDescriptor)
 			: RHIShaderResourceView(desc, offlineDescriptor.Handle.ptr, offlineDescriptor.HeapIndex) {}
+
+		FORCEINLINE D3D12_CPU_DESCRIPTOR_HANDLE GetCPUHandle() const { return { static_cast<SIZE_T>(CPUHandle) }; }
 	};
 
 	class D3D12RHIUnorderedAccessView : public RHIUnorderedAccessView
@@ -102,6 +104,9 @@ namespace Thunder
 	public:
 		D3D12RHIUnorderedAccessView(RHIViewDescriptor const& desc, D3D12OfflineDescriptor const& offlineDescriptor)
 			: RHIUnorderedAccessView(desc, offlineDescriptor.Handle.ptr, offlineDescriptor.HeapIndex) {}
+
+		FORCEINLINE D3D12_CPU_DESCRIPTOR_HANDLE GetCPUHandle() const { return { static_cast<SIZE_T>(CPUHandle) }; }
+		FORCEINLINE D3D12_GPU_DESCRIPTOR_HANDLE GetGPUHandle() const { return { GPUHandle }; }
 	};
 
 	class D3D12RHIRenderTargetView : public RHIRenderTargetView
@@ -109,6 +114,8 @@ namespace Thunder
 	public:
 		D3D12RHIRenderTargetView(RHIViewDescriptor const& desc, D3D12OfflineDescriptor const& offlineDescriptor)
 			: RHIRenderTargetView(desc, offlineDescriptor.Handle.ptr, offlineDescriptor.HeapIndex) {}
+
+		FORCEINLINE D3D12_CPU_DESCRIPTOR_HANDLE GetCPUHandle() const { return { static_cast<SIZE_T>(CPUHandle) }; }
 	};
 
 	class D3D12RHIDepthStencilView : public RHIDepthStencilView
@@ -116,6 +123,8 @@ namespace Thunder
 	public:
 		D3D12RHIDepthStencilView(RHIViewDescriptor const& desc, D3D12OfflineDescriptor const& offlineDescriptor)
 			: RHIDepthStencilView(desc, offlineDescriptor.Handle.ptr, offlineDescriptor.HeapIndex) {}
+
+		FORCEINLINE D3D12_CPU_DESCRIPTOR_HANDLE GetCPUHandle() const { return { static_cast<SIZE_T>(CPUHandle) }; }
 	};
 
 	class D3D12RHIConstantBufferView : public RHIConstantBufferView
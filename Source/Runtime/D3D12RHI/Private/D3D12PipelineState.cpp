@@ -84,6 +84,12 @@ namespace Thunder
 		outD3D12Desc.CombinedHash = FCrc::BinaryCrc32(stateIdentifier.data(), static_cast<uint32>(stateIdentifier.size()), 0);
 		uint32 shaderHash = ShaderCombination::GetTypeHash(*rhiDesc.shaderVariant);
 		outD3D12Desc.CombinedHash = FCrc::BinaryCrc32(reinterpret_cast<const uint8*>(&shaderHash), 4, outD3D12Desc.CombinedHash);
+
+		// Output formats, topology and sample count are not part of the state identifier.
+		const D3D12_GRAPHICS_PIPELINE_STATE_DESC& desc = outD3D12Desc.Desc;
+		outD3D12Desc.CombinedHash = FCrc::BinaryCrc32(reinterpret_cast<const uint8*>(desc.RTVFormats), sizeof(desc.RTVFormats), outD3D12Desc.CombinedHash);
+		const uint32 outputState[] = { static_cast<uint32>(desc.DSVFormat), desc.NumRenderTargets, static_cast<uint32>(desc.PrimitiveTopologyType), desc.SampleDesc.Count };
+		outD3D12Desc.CombinedHash = FCrc::BinaryCrc32(reinterpret_cast<const uint8*>(outputState), sizeof(outputState), outD3D12Desc.CombinedHash);
 	}
 	
 	TD3D12GraphicsPipelineState* TD3D12PipelineStateCache::CreateAndAddToCache(const TGraphicsPipelineStateDescriptor& rhiDesc, const TD3D12GraphicsPipelineStateDesc& d3d12Desc)
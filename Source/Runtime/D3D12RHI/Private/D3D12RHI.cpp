@@ -239,7 +239,16 @@ namespace Thunder
         switch (resourceDesc->Type)
         {
         case ERHIResourceType::Buffer:
-            srvDesc.Buffer.NumElements = static_cast<UINT>(resourceDesc->Width);
+            if (desc.StructureByteStride > 0)
+            {
+                srvDesc.Format = DXGI_FORMAT_UNKNOWN;
+                srvDesc.Buffer.NumElements = static_cast<UINT>(desc.Width);
+                srvDesc.Buffer.StructureByteStride = desc.StructureByteStride;
+            }
+            else
+            {
+                srvDesc.Buffer.NumElements = static_cast<UINT>(resourceDesc->Width);
+            }
             break;
         case ERHIResourceType::Texture1D:
             srvDesc.Texture1D.MipLevels = resourceDesc->MipLevels;
@@ -538,22 +547,29 @@ namespace Thunder
     RHIStructuredBufferRef D3D12DynamicRHI::RHICreateStructuredBuffer(uint32 size,  EBufferCreateFlags usage, void *resourceData)
     {
         ID3D12Resource* structuredBuffer;
+        const bool bDynamic = EnumHasAnyFlags(usage, EBufferCreateFlags::AnyDynamic);
         const D3D12_HEAP_PROPERTIES heapType = {
-            EnumHasAnyFlags(usage, EBufferCreateFlags::AnyDynamic) ? D3D12_HEAP_TYPE_UPLOAD : D3D12_HEAP_TYPE_DEFAULT,
+            bDynamic ? D3D12_HEAP_TYPE_UPLOAD : D3D12_HEAP_TYPE_DEFAULT,
             D3D12_CPU_PAGE_PROPERTY_UNKNOWN, D3D12_MEMORY_POOL_UNKNOWN, 1, 1
         };
 
+        // Upload heap resources must stay in GENERIC_READ, the GPU reads them in place.
         const auto desc = CD3DX12_RESOURCE_DESC::Buffer(size);
         const HRESULT hr = Device->CreateCommittedResource(&heapType,
                                                             D3D12_HEAP_FLAG_NONE,
                                                             &desc,
-                                                            D3D12_RESOURCE_STATE_COMMON,
+                                                            bDynamic ? D3D12_RESOURCE_STATE_GENERIC_READ : D3D12_RESOURCE_STATE_COMMON,
                                                             nullptr,
                                                             IID_PPV_ARGS(&structuredBuffer));
 
         if (SUCCEEDED(hr))
         {
-            return MakeRefCount<D3D12RHIStructuredBuffer>(RHIResourceDescriptor::Buffer(size), structuredBuffer);
+            auto newBuffer = MakeRefCount<D3D12RHIStructuredBuffer>(RHIResourceDescriptor::Buffer(size), structuredBuffer);
+            if (resourceData && bDynamic)
+            {
+                RHIUpdateSharedMemoryResource(newBuffer.Get(), resourceData, size, 0);
+            }
+            return newBuffer;
         }
         else
         {
@@ -618,22 +634,21 @@ namespace Thunder
         return newUniformBuffer;
     }
 
-    struct RHICommandD3D12UpdateUniformBuffer : public IRHICommand
+    struct RHICommandD3D12UpdateUniformBuffer : public RHICustomCommand
     {
         TRefCountPtr<D3D12UniformBuffer> UniformBuffer;
         D3D12ResourceLocation UpdatedLocation;
 
         RHICommandD3D12UpdateUniformBuffer(D3D12UniformBuffer* InUniformBuffer, D3D12ResourceLocation& InUpdatedLocation)
-            : UniformBuffer(InUniformBuffer)
+            : RHICustomCommand(&Execute), UniformBuffer(InUniformBuffer)
         {
             D3D12ResourceLocation::TransferOwnership(UpdatedLocation, InUpdatedLocation);
         }
 
-        ~RHICommandD3D12UpdateUniformBuffer() override {}
-
-        D3D12RHI_API void Execute(RHICommandContext* cmdList) override
+        static void Execute(RHICustomCommand* command, RHICommandContext* cmdList)
         {
-            D3D12ResourceLocation::TransferOwnership(UniformBuffer->ResourceLocation, UpdatedLocation);
+            auto* updateCommand = static_cast<RHICommandD3D12UpdateUniformBuffer*>(command);
+            D3D12ResourceLocation::TransferOwnership(updateCommand->UniformBuffer->ResourceLocation, updateCommand->UpdatedLocation);
         }
     };
 
@@ -668,93 +683,109 @@ namespace Thunder
             memcpy(mappedData, Contents, alignedSize);
         }
 
-        RHICommandD3D12UpdateUniformBuffer* newCommand = new (recorder->Allocate<RHICommandD3D12UpdateUniformBuffer>()) RHICommandD3D12UpdateUniformBuffer(dx12UB, UpdatedResourceLocation);
+        RHICommandD3D12UpdateUniformBuffer* newCommand = recorder->NewCommand<RHICommandD3D12UpdateUniformBuffer>(dx12UB, UpdatedResourceLocation);
         recorder->AddCommand(newCommand);
     }
 
-    RHITextureRef D3D12DynamicRHI::RHICreateTexture(const RHIResourceDescriptor& desc, ETextureCreateFlags usage, void *resourceData)
+    namespace
     {
-        ID3D12Resource* texture = nullptr;
-        
-        // Configure common heap properties
-        constexpr D3D12_HEAP_PROPERTIES heapType = {D3D12_HEAP_TYPE_DEFAULT, D3D12_CPU_PAGE_PROPERTY_UNKNOWN, D3D12_MEMORY_POOL_UNKNOWN, 1, 1};
-        
-        // Configure common resource desc
-        D3D12_RESOURCE_DESC d3d12Desc = {};
-        d3d12Desc.Alignment = desc.Alignment;
-        d3d12Desc.Width = desc.Width;
-        d3d12Desc.Height = desc.Height;
-        d3d12Desc.MipLevels = desc.MipLevels;
-        // Depth-stencil textures that also need an SRV must be created with a typeless format.
-        DXGI_FORMAT resourceFormat = ConvertRHIFormatToD3DFormat(desc.Format);
-        if (desc.Flags.NeedDSV)
-        {
-            resourceFormat = GetDepthTypelessFormat(resourceFormat);
-        }
-        d3d12Desc.Format = resourceFormat;
-        d3d12Desc.SampleDesc = {1, 0};
-        d3d12Desc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
-        d3d12Desc.Flags = GetRHIResourceFlags(desc.Flags);
+        bool ConvertTextureDescriptor(const RHIResourceDescriptor& desc, D3D12_RESOURCE_DESC& outDesc)
+        {
+            outDesc = {};
+            outDesc.Alignment = desc.Alignment;
+            outDesc.Width = desc.Width;
+            outDesc.Height = desc.Height;
+            outDesc.MipLevels = desc.MipLevels;
+            // Depth-stencil textures that also need an SRV must be created with a typeless format.
+            DXGI_FORMAT resourceFormat = ConvertRHIFormatToD3DFormat(desc.Format);
+            if (desc.Flags.NeedDSV)
+            {
+                resourceFormat = GetDepthTypelessFormat(resourceFormat);
+            }
+            outDesc.Format = resourceFormat;
+            outDesc.SampleDesc = {1, 0};
+            outDesc.Layout = D3D12_TEXTURE_LAYOUT_UNKNOWN;
+            outDesc.Flags = GetRHIResourceFlags(desc.Flags);
 
-        switch (desc.Type)
-        {
-        case ERHIResourceType::Texture1D:
-        {
-            TAssertf(desc.Height == 1, "Height should be 1 for Texture1D.");
-            TAssertf(desc.DepthOrArraySize == 1, "DepthOrArraySize should be 1 for Texture1D.");
-            
-            d3d12Desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE1D;
-            d3d12Desc.Height = 1;
-            d3d12Desc.DepthOrArraySize = 1;
-            break;
-        }
-        case ERHIResourceType::Texture2D:
-        {
-            TAssertf(desc.DepthOrArraySize == 1, "DepthOrArraySize should be 1 for Texture2D.");
-            
-            d3d12Desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-            d3d12Desc.DepthOrArraySize = 1;
-            break;
-        }
-        case ERHIResourceType::Texture2DArray:
-        {
-            d3d12Desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
-            d3d12Desc.DepthOrArraySize = desc.DepthOrArraySize;
-            break;
-        }
-        case ERHIResourceType::Texture3D:
-        {
-            // Note: D3D12 uses TEXTURE3D dimension for 3D textures, not TEXTURE2D
-            d3d12Desc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE3D;
-            d3d12Desc.DepthOrArraySize = desc.DepthOrArraySize;
-            break;
-        }
-        default:
-            TAssertf(false, "Unsupported texture type");
-            return nullptr;
+            switch (desc.Type)
+            {
+            case ERHIResourceType::Texture1D:
+            {
+                TAssertf(desc.Height == 1, "Height should be 1 for Texture1D.");
+                TAssertf(desc.DepthOrArraySize == 1, "DepthOrArraySize should be 1 for Texture1D.");
+                
+                outDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE1D;
+                outDesc.Height = 1;
+                outDesc.DepthOrArraySize = 1;
+                return true;
+            }
+            case ERHIResourceType::Texture2D:
+            {
+                TAssertf(desc.DepthOrArraySize == 1, "DepthOrArraySize should be 1 for Texture2D.");
+                
+                outDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+                outDesc.DepthOrArraySize = 1;
+                return true;
+            }
+            case ERHIResourceType::Texture2DArray:
+            {
+                outDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE2D;
+                outDesc.DepthOrArraySize = desc.DepthOrArraySize;
+                return true;
+            }
+            case ERHIResourceType::Texture3D:
+            {
+                // Note: D3D12 uses TEXTURE3D dimension for 3D textures, not TEXTURE2D
+                outDesc.Dimension = D3D12_RESOURCE_DIMENSION_TEXTURE3D;
+                outDesc.DepthOrArraySize = desc.DepthOrArraySize;
+                return true;
+            }
+            default:
+                TAssertf(false, "Unsupported texture type");
+                return false;
+            }
         }
 
-        D3D12_CLEAR_VALUE  optimizedClearValue{};
-        D3D12_CLEAR_VALUE* pOptimizedClearValue = nullptr;
-        if (desc.bHasOptimizedClearValue && (desc.Flags.NeedRTV || desc.Flags.NeedDSV))
+        const D3D12_CLEAR_VALUE* GetOptimizedClearValue(const RHIResourceDescriptor& desc, D3D12_CLEAR_VALUE& outClearValue)
         {
+            if (!desc.bHasOptimizedClearValue || !(desc.Flags.NeedRTV || desc.Flags.NeedDSV))
+            {
+                return nullptr;
+            }
+            outClearValue = {};
+            outClearValue.Format = ConvertRHIFormatToD3DFormat(desc.Format);
             if (desc.Flags.NeedDSV)
             {
-                optimizedClearValue.Format               = ConvertRHIFormatToD3DFormat(desc.Format);
-                optimizedClearValue.DepthStencil.Depth   = desc.OptimizedClearDepth;
-                optimizedClearValue.DepthStencil.Stencil = desc.OptimizedClearStencil;
+                outClearValue.DepthStencil.Depth   = desc.OptimizedClearDepth;
+                outClearValue.DepthStencil.Stencil = desc.OptimizedClearStencil;
             }
             else
             {
-                optimizedClearValue.Format   = ConvertRHIFormatToD3DFormat(desc.Format);
-                optimizedClearValue.Color[0] = desc.OptimizedClearColor[0];
-                optimizedClearValue.Color[1] = desc.OptimizedClearColor[1];
-                optimizedClearValue.Color[2] = desc.OptimizedClearColor[2];
-                optimizedClearValue.Color[3] = desc.OptimizedClearColor[3];
+                outClearValue.Color[0] = desc.OptimizedClearColor[0];
+                outClearValue.Color[1] = desc.OptimizedClearColor[1];
+                outClearValue.Color[2] = desc.OptimizedClearColor[2];
+                outClearValue.Color[3] = desc.OptimizedClearColor[3];
             }
-            pOptimizedClearValue = &optimizedClearValue;
+            return &outClearValue;
+        }
+    }
+
+    RHITextureRef D3D12DynamicRHI::RHICreateTexture(const RHIResourceDescriptor& desc, ETextureCreateFlags usage, void *resourceData)
+    {
+        ID3D12Resource* texture = nullptr;
+        
+        // Configure common heap properties
+        constexpr D3D12_HEAP_PROPERTIES heapType = {D3D12_HEAP_TYPE_DEFAULT, D3D12_CPU_PAGE_PROPERTY_UNKNOWN, D3D12_MEMORY_POOL_UNKNOWN, 1, 1};
+        
+        D3D12_RESOURCE_DESC d3d12Desc;
+        if (!ConvertTextureDescriptor(desc, d3d12Desc))
+        {
+            return nullptr;
         }
 
+        D3D12_CLEAR_VALUE optimizedClearValue;
+        const D3D12_CLEAR_VALUE* pOptimizedClearValue = GetOptimizedClearValue(desc, optimizedClearValue);
+
         HRESULT hr = Device->CreateCommittedResource(&heapType,
                                                D3D12_HEAP_FLAG_NONE,
                                                &d3d12Desc,
@@ -781,6 +812,74 @@ namespace Thunder
         }
     }
 
+    bool D3D12DynamicRHI::RHIGetTextureAllocationInfo(const RHIResourceDescriptor& desc, uint64& outSize, uint64& outAlignment)
+    {
+        D3D12_RESOURCE_DESC d3d12Desc;
+        if (!ConvertTextureDescriptor(desc, d3d12Desc))
+        {
+            return false;
+        }
+        const D3D12_RESOURCE_ALLOCATION_INFO info = Device->GetResourceAllocationInfo(0, 1, &d3d12Desc);
+        if (info.SizeInBytes == UINT64_MAX) [[unlikely]]
+        {
+            return false;
+        }
+        outSize = info.SizeInBytes;
+        outAlignment = info.Alignment;
+        return true;
+    }
+
+    RHITransientHeapRef D3D12DynamicRHI::RHICreateTransientHeap(uint64 size)
+    {
+        // Render targets and depth stencils only, every resource heap tier accepts that.
+        size = (size + D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1) & ~static_cast<uint64>(D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1);
+        D3D12_HEAP_DESC heapDesc = {};
+        heapDesc.SizeInBytes = size;
+        heapDesc.Properties = {D3D12_HEAP_TYPE_DEFAULT, D3D12_CPU_PAGE_PROPERTY_UNKNOWN, D3D12_MEMORY_POOL_UNKNOWN, 1, 1};
+        heapDesc.Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+        heapDesc.Flags = D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+
+        ComPtr<ID3D12Heap> heap;
+        const HRESULT hr = Device->CreateHeap(&heapDesc, IID_PPV_ARGS(&heap));
+        if (FAILED(hr))
+        {
+            TAssertf(false, "Fail to create transient heap of %llu bytes", size);
+            return nullptr;
+        }
+
+        RHIResourceDescriptor desc{};
+        desc.Width = size;
+        desc.Height = 1;
+        return MakeRefCount<D3D12TransientHeap>(desc, heap.Get());
+    }
+
+    RHITextureRef D3D12DynamicRHI::RHICreatePlacedTexture(RHITransientHeap* heap, uint64 offset, const RHIResourceDescriptor& desc, ETextureCreateFlags usage)
+    {
+        TAssertf(heap != nullptr, "Placed texture needs a heap");
+        D3D12_RESOURCE_DESC d3d12Desc;
+        if (!ConvertTextureDescriptor(desc, d3d12Desc))
+        {
+            return nullptr;
+        }
+
+        D3D12_CLEAR_VALUE optimizedClearValue;
+        const D3D12_CLEAR_VALUE* pOptimizedClearValue = GetOptimizedClearValue(desc, optimizedClearValue);
+
+        ID3D12Resource* texture = nullptr;
+        const HRESULT hr = Device->CreatePlacedResource(static_cast<ID3D12Heap*>(heap->GetResource()),
+                                                        offset,
+                                                        &d3d12Desc,
+                                                        D3D12_RESOURCE_STATE_GENERIC_READ,
+                                                        pOptimizedClearValue,
+                                                        IID_PPV_ARGS(&texture));
+        if (FAILED(hr))
+        {
+            TAssertf(false, "Fail to create placed texture at offset %llu", offset);
+            return nullptr;
+        }
+        return MakeRefCount<D3D12RHITexture>(desc, usage, texture, heap);
+    }
+
     bool D3D12DynamicRHI::RHIUpdateSharedMemoryResource(RHIResource* resource, const void* resourceData, uint32 size, uint8 subresourceId)
     {
         if (auto const d3d12Res = static_cast<ID3D12Resource*>(resource->GetResource()))
@@ -3,6 +3,7 @@
 #include "D3D12RHI.h"
 #include "D3D12PipelineState.h"
 #include "D3D12RootSignature.h"
+#include "PipelineStateCache.h"
 
 namespace Thunder
 {
@@ -18,6 +19,7 @@ namespace Thunder
 
 	void TD3D12RHIModule::ShutDown()
 	{
+		ClearPipelineStateCache();
 		if (DynamicRHI)
 		{
 			delete DynamicRHI;
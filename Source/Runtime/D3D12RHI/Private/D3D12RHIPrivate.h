@@ -1,6 +1,7 @@
 #pragma once
 #include "RHI.h"
 #include "d3d12.h"
+#include "D3D12RHICommon.h"
 
 namespace Thunder
 {
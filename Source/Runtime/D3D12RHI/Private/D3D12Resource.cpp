@@ -68,6 +68,13 @@ namespace Thunder
 		memcpy(mappedData, Data, uploadBufferSize);
 		uploadBuffer->Unmap(0, nullptr);
 
+		// The upload heap holds the copy now, the package the data was read from can be unmapped.
+		if (DataSource)
+		{
+			DataSource.SafeRelease();
+			Data = nullptr;
+		}
+
 		auto dx12Context = static_cast<D3D12CommandContext*>(IRHIModule::GetModule()->GetCopyCommandContext_RHI());
 		if (!dx12Context) [[unlikely]]
 		{
@@ -151,6 +158,13 @@ namespace Thunder
 		memcpy(mappedData, Data, uploadBufferSize);
 		uploadBuffer->Unmap(0, nullptr);
 
+		// The upload heap holds the copy now, the package the data was read from can be unmapped.
+		if (DataSource)
+		{
+			DataSource.SafeRelease();
+			Data = nullptr;
+		}
+
 		auto dx12Context = static_cast<D3D12CommandContext*>(IRHIModule::GetModule()->GetCopyCommandContext_RHI());
 		if (!dx12Context) [[unlikely]]
 		{
@@ -53,6 +53,12 @@ namespace Thunder
 
         D3D12RHI_API RHITextureRef RHICreateTexture(const RHIResourceDescriptor& desc, ETextureCreateFlags usage, void *resourceData = nullptr) override;
 
+        D3D12RHI_API bool RHIGetTextureAllocationInfo(const RHIResourceDescriptor& desc, uint64& outSize, uint64& outAlignment) override;
+
+        D3D12RHI_API RHITransientHeapRef RHICreateTransientHeap(uint64 size) override;
+
+        D3D12RHI_API RHITextureRef RHICreatePlacedTexture(RHITransientHeap* heap, uint64 offset, const RHIResourceDescriptor& desc, ETextureCreateFlags usage) override;
+
         D3D12RHI_API bool RHIUpdateSharedMemoryResource(RHIResource* resource, const void* resourceData, uint32 size, uint8 subresourceId) override;
 
         D3D12RHI_API void RHIReleaseResource_RenderThread() override;
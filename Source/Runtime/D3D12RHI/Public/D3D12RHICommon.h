@@ -1,4 +1,5 @@
 #pragma once
+#include <wrl/client.h>
 #include "Assertion.h"
 #include "Templates/RefCountObject.h"
 
@@ -6,6 +7,8 @@ struct ID3D12Device;
 
 namespace Thunder
 {
+	using namespace Microsoft::WRL;
+
 	class TD3D12DeviceChild : public RefCountedObject
 	{
 	public:
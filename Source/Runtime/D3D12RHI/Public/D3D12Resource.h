@@ -1,6 +1,7 @@
 #pragma once
 #include "Assertion.h"
 #include "d3d12.h"
+#include "D3D12RHICommon.h"
 #include "UniformBuffer.h"
 
 namespace Thunder
@@ -104,12 +105,27 @@ namespace Thunder
         D3D12RHITexture() = delete;
         D3D12RHITexture(RHIResourceDescriptor const& desc, ETextureCreateFlags const& flags, ID3D12Resource* texture)
         : RHITexture(desc, flags), Texture(texture) {}
+        // Placed in a transient heap, which must outlive the texture.
+        D3D12RHITexture(RHIResourceDescriptor const& desc, ETextureCreateFlags const& flags, ID3D12Resource* texture, RHITransientHeap* heap)
+        : RHITexture(desc, flags), Texture(texture), Heap(heap) {}
 
         void Update() override;
     
         _NODISCARD_ void * GetResource() const override { return Texture.Get(); }
     private:
         ComPtr<ID3D12Resource> Texture;
+        RHITransientHeapRef Heap;
+    };
+
+    class D3D12TransientHeap : public RHITransientHeap
+    {
+    public:
+        D3D12TransientHeap() = delete;
+        D3D12TransientHeap(RHIResourceDescriptor const& desc, ID3D12Heap* heap) : RHITransientHeap(desc), Heap(heap) {}
+
+        _NODISCARD_ void * GetResource() const override { return Heap.Get(); }
+    private:
+        ComPtr<ID3D12Heap> Heap;
     };
 
     class D3D12UniformBuffer : public RHIUniformBuffer
@@ -204,34 +204,56 @@ namespace Thunder
 			transform = Owner->GetTransform();
 		}
 		SceneProxy = new (TMemory::Malloc<StaticMeshSceneProxy>()) StaticMeshSceneProxy(this, transform);
+		Owner->GetTransformComponent()->AddPrimitive(SceneProxy);
 		Owner->GetScene()->GetRenderer()->RegisterSceneInfo(SceneProxy->GetSceneInfo());
-		Owner->GetScene()->GetRenderer()->UpdatePrimitiveUniformBuffer_GameThread(SceneProxy->GetSceneInfo());
+		Owner->GetScene()->GetRenderer()->UpdatePrimitiveData_GameThread(SceneProxy->GetSceneInfo());
 	}
 
 	// TransformComponent implementation
+	TransformComponent::TransformComponent(Entity* inOwner)
+		: IComponent(inOwner)
+	{
+		if (inOwner && inOwner->GetScene())
+		{
+			System = inOwner->GetScene()->GetTransformSystem();
+		}
+	}
+
+	TransformComponent::~TransformComponent()
+	{
+		if (System)
+		{
+			System->Unregister(this);
+		}
+	}
+
 	void TransformComponent::SerializeJson(rapidjson::PrettyWriter<rapidjson::StringBuffer>& writer) const
 	{
+		const TVector3f position = GetPosition();
+		const TVector3f rotation = GetRotation();
+		const TVector3f scale = GetScale();
+
 		writer.StartObject();
 
 		writer.Key("Position");
 		writer.StartArray();
-		writer.Double(Position.X);
-		writer.Double(Position.Y);
-		writer.Double(Position.Z);
+		writer.Double(position.X);
+		writer.Double(position.Y);
+		writer.Double(position.Z);
 		writer.EndArray();
 
 		writer.Key("Rotation");
 		writer.StartArray();
-		writer.Double(Rotation.X);
-		writer.Double(Rotation.Y);
-		writer.Double(Rotation.Z);
+		writer.Double(rotation.X);
+		writer.Double(rotation.Y);
+		writer.Double(rotation.Z);
 		writer.EndArray();
 
 		writer.Key("Scale");
 		writer.StartArray();
-		writer.Double(Scale.X);
-		writer.Double(Scale.Y);
-		writer.Double(Scale.Z);
+		writer.Double(scale.X);
+		writer.Double(scale.Y);
+		writer.Double(scale.Z);
 		writer.EndArray();
 
 		writer.EndObject();
@@ -250,9 +272,8 @@ namespace Thunder
 			const rapidjson::Value& posArray = jsonValue["Position"];
 			if (posArray.Size() >= 3)
 			{
-				Position.X = static_cast<float>(posArray[0].GetDouble());
-				Position.Y = static_cast<float>(posArray[1].GetDouble());
-				Position.Z = static_cast<float>(posArray[2].GetDouble());
+				SetPosition(TVector3f(static_cast<float>(posArray[0].GetDouble()), static_cast<float>(posArray[1].GetDouble()),
+					static_cast<float>(posArray[2].GetDouble())));
 			}
 		}
 
@@ -262,9 +283,8 @@ namespace Thunder
 			const rapidjson::Value& rotArray = jsonValue["Rotation"];
 			if (rotArray.Size() >= 3)
 			{
-				Rotation.X = static_cast<float>(rotArray[0].GetDouble());
-				Rotation.Y = static_cast<float>(rotArray[1].GetDouble());
-				Rotation.Z = static_cast<float>(rotArray[2].GetDouble());
+				SetRotation(TVector3f(static_cast<float>(rotArray[0].GetDouble()), static_cast<float>(rotArray[1].GetDouble()),
+					static_cast<float>(rotArray[2].GetDouble())));
 			}
 		}
 
@@ -274,62 +294,61 @@ namespace Thunder
 			const rapidjson::Value& scaleArray = jsonValue["Scale"];
 			if (scaleArray.Size() >= 3)
 			{
-				Scale.X = static_cast<float>(scaleArray[0].GetDouble());
-				Scale.Y = static_cast<float>(scaleArray[1].GetDouble());
-				Scale.Z = static_cast<float>(scaleArray[2].GetDouble());
+				SetScale(TVector3f(static_cast<float>(scaleArray[0].GetDouble()), static_cast<float>(scaleArray[1].GetDouble()),
+					static_cast<float>(scaleArray[2].GetDouble())));
 			}
 		}
 
-		UpdateTransform();
-		MarkPrimitiveUniformBufferDirty();
 		OnLoaded();
 	}
 
+	void TransformComponent::OnLoaded()
+	{
+		const bool bWasLoaded = IsLoaded();
+		IComponent::OnLoaded();
+		if (!bWasLoaded && System)
+		{
+			System->Register(this);
+		}
+	}
+
 	void TransformComponent::SetPosition(const TVector3f& inPosition)
 	{
+		if (IsBound())
+		{
+			System->SetPosition(TransformIndex, inPosition);
+			return;
+		}
 		Position = inPosition;
-		UpdateTransform();
-		MarkPrimitiveUniformBufferDirty();
 	}
 
 	void TransformComponent::SetRotation(const TVector3f& inRotation)
 	{
+		if (IsBound())
+		{
+			System->SetRotation(TransformIndex, inRotation);
+			return;
+		}
 		Rotation = inRotation;
-		UpdateTransform();
-		MarkPrimitiveUniformBufferDirty();
 	}
 
 	void TransformComponent::SetScale(const TVector3f& inScale)
 	{
+		if (IsBound())
+		{
+			System->SetScale(TransformIndex, inScale);
+			return;
+		}
 		Scale = inScale;
-		UpdateTransform();
-		MarkPrimitiveUniformBufferDirty();
 	}
 
-	void TransformComponent::MarkPrimitiveUniformBufferDirty()
+	TMatrix44f TransformComponent::GetTransform() const
 	{
-		// todo : deduplicate
-		TList<IComponent*> compList;
-		Owner->GetAllHierarchyComponents(compList);
-		for (auto& comp : compList)
+		if (IsBound())
 		{
-			// todo : reflect
-			if (auto stMeshComp = dynamic_cast<StaticMeshComponent*>(comp))
-			{
-				StaticMeshSceneProxy* sceneProxy = stMeshComp->GetSceneProxy();
-				if (!sceneProxy) [[unlikely]]
-				{
-					TAssertf(false, "Lack of valid scene proxy for component \"%s\" in entity  \"%s\".", stMeshComp->GetComponentName(), Owner->GetEntityName());
-					continue;
-				}
-
-				GRenderScheduler->PushTask([transform = Transform, sceneProxy]()
-				{
-					sceneProxy->UpdateTransform(transform);
-				});
-				Owner->GetScene()->GetRenderer()->UpdatePrimitiveUniformBuffer_GameThread(sceneProxy->GetSceneInfo());
-			}
+			return System->GetWorld(TransformIndex);
 		}
+		return TransformSystem::ComposeLocal(Position, Rotation, Scale);
 	}
 
 	// CameraComponent implementation
@@ -439,51 +458,4 @@ namespace Thunder
 			Owner->GetScene()->GetRenderer()->GetFrameGraph()->SetViewParameters(type, cameraPosition, vpMatrix);
 		});
 	}
-
-	void TransformComponent::UpdateTransform()
-	{
-		// Left-handed coordinate system (UE convention): X=Forward, Y=Right, Z=Up
-		// Rotation stored as degrees: X=Pitch, Y=Yaw, Z=Roll
-		//
-		// Matches Unreal Engine's FRotationMatrix convention.
-		// Key property: with Roll=0 the Right vector is always horizontal (Z=0),
-		// so the horizon stays level regardless of Pitch.
-		//
-		// R (row-major, row-vector convention: p' = p * R):
-		//   Row 0 (Forward): ( CP*CY,              CP*SY,              SP     )
-		//   Row 1 (Right):   ( SR*SP*CY - CR*SY,   SR*SP*SY + CR*CY, -SR*CP  )
-		//   Row 2 (Up):      (-(CR*SP*CY + SR*SY),  CY*SR - CR*SP*SY,  CR*CP )
-
-		constexpr float DegToRad = DEG_TO_RAD;
-		const float pitchRad = Rotation.X * DegToRad;
-		const float yawRad   = Rotation.Y * DegToRad;
-		const float rollRad  = Rotation.Z * DegToRad;
-
-		const float cp = std::cos(pitchRad);
-		const float sp = std::sin(pitchRad);
-		const float cy = std::cos(yawRad);
-		const float sy = std::sin(yawRad);
-		const float cr = std::cos(rollRad);
-		const float sr = std::sin(rollRad);
-
-		const float r00 =  cp * cy;
-		const float r01 =  cp * sy;
-		const float r02 =  sp;
-
-		const float r10 =  sr * sp * cy - cr * sy;
-		const float r11 =  sr * sp * sy + cr * cy;
-		const float r12 = -sr * cp;
-
-		const float r20 = -(cr * sp * cy + sr * sy);
-		const float r21 =  cy * sr - cr * sp * sy;
-		const float r22 =  cr * cp;
-
-		// Combined Transform = S * R * T (row-vector convention: p' = p * S * R * T)
-		// Row i of rotation is scaled by Scale[i], translation in row 3.
-		Transform = TMatrix44f(
-			r00 * Scale.X, r01 * Scale.X, r02 * Scale.X, 0.0f,
-			r10 * Scale.Y, r11 * Scale.Y, r12 * Scale.Y, 0.0f,
-			r20 * Scale.Z, r21 * Scale.Z, r22 * Scale.Z, 0.0f,
-			Position.X,    Position.Y,     Position.Z,     1.0f);
-	}
 }
@@ -1,6 +1,7 @@
 #pragma optimize("", off)
 #include "Entity.h"
 #include "GameModule.h"
+#include "Scene.h"
 #include "rapidjson/document.h"
 
 namespace Thunder
@@ -75,6 +76,10 @@ namespace Thunder
 			}
 			child->Owner = this;
 			Children.push_back(child);
+			if (OwnerScene)
+			{
+				OwnerScene->GetTransformSystem()->MarkHierarchyDirty();
+			}
 		}
 	}
 
@@ -85,6 +90,10 @@ namespace Thunder
 		{
 			(*it)->Owner = nullptr;
 			Children.erase(it);
+			if (OwnerScene)
+			{
+				OwnerScene->GetTransformSystem()->MarkHierarchyDirty();
+			}
 		}
 	}
 
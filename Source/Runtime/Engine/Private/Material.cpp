@@ -1,6 +1,7 @@
 #pragma optimize("", off)
 #include "Material.h"
 #include "FileSystem/MemoryArchive.h"
+#include "MeshPass.h"
 #include "RenderMaterial.h"
 #include "ShaderArchive.h"
 #include "ShaderModule.h"
@@ -76,6 +77,16 @@ namespace Thunder
 	{
 		LOG("Material loaded: %s", GetResourceName().c_str());
 
+		// Start compiling the mesh pass variants this material will draw with before it is first visible.
+		if (ShaderArchive* archive = GetShaderArchive())
+		{
+			const uint64 variantMask = ShaderModule::GetVariantMask(archive, ShaderParameters->GetStaticSwitchParameters());
+			for (uint8 meshPass = 0; meshPass < static_cast<uint8>(EMeshPass::Num); ++meshPass)
+			{
+				ShaderModule::PrewarmShaderCombination(archive, static_cast<EMeshPass>(meshPass), variantMask);
+			}
+		}
+
 		UpdateRenderResource();
 	}
 
@@ -87,45 +98,45 @@ namespace Thunder
 		archive << ArchiveName.ToString();
 
 		// Serialize int parameters
-		uint32 intParamCount = static_cast<uint32>(ShaderParameters->IntParameters.size());
+		uint32 intParamCount = static_cast<uint32>(ShaderParameters->GetIntParameters().size());
 		archive << intParamCount;
-		for (const auto& pair : ShaderParameters->IntParameters)
+		for (const auto& pair : ShaderParameters->GetIntParameters())
 		{
 			archive << pair.first.ToString();
 			archive << pair.second;
 		}
 
 		// Serialize float parameters
-		uint32 floatParamCount = static_cast<uint32>(ShaderParameters->FloatParameters.size());
+		uint32 floatParamCount = static_cast<uint32>(ShaderParameters->GetFloatParameters().size());
 		archive << floatParamCount;
-		for (const auto& pair : ShaderParameters->FloatParameters)
+		for (const auto& pair : ShaderParameters->GetFloatParameters())
 		{
 			archive << pair.first.ToString();
 			archive << pair.second;
 		}
 
 		// Serialize vector parameters
-		uint32 vectorParamCount = static_cast<uint32>(ShaderParameters->VectorParameters.size());
+		uint32 vectorParamCount = static_cast<uint32>(ShaderParameters->GetVectorParameters().size());
 		archive << vectorParamCount;
-		for (const auto& pair : ShaderParameters->VectorParameters)
+		for (const auto& pair : ShaderParameters->GetVectorParameters())
 		{
 			archive << pair.first.ToString();
 			archive << pair.second.X << pair.second.Y << pair.second.Z << pair.second.W;
 		}
 
 		// Serialize texture parameters (as GUIDs)
-		uint32 textureParamCount = static_cast<uint32>(ShaderParameters->TextureParameters.size());
+		uint32 textureParamCount = static_cast<uint32>(ShaderParameters->GetTextureParameters().size());
 		archive << textureParamCount;
-		for (const auto& pair : ShaderParameters->TextureParameters)
+		for (const auto& pair : ShaderParameters->GetTextureParameters())
 		{
 			archive << pair.first.ToString();
 			archive << pair.second;
 		}
 
 		// Serialize virant parameters
-		uint32 boolParamCount = static_cast<uint32>(ShaderParameters->StaticSwitchParameters.size());
+		uint32 boolParamCount = static_cast<uint32>(ShaderParameters->GetStaticSwitchParameters().size());
 		archive << boolParamCount;
-		for (const auto& pair : ShaderParameters->StaticSwitchParameters)
+		for (const auto& pair : ShaderParameters->GetStaticSwitchParameters())
 		{
 			archive << pair.first.ToString();
 			archive << pair.second;
@@ -152,7 +163,7 @@ namespace Thunder
 			int32 value;
 			archive >> paramName;
 			archive >> value;
-			ShaderParameters->IntParameters[NameHandle(paramName)] = value;
+			ShaderParameters->SetIntParameter(NameHandle(paramName), value);
 		}
 
 		// Deserialize float parameters
@@ -165,7 +176,7 @@ namespace Thunder
 			float value;
 			archive >> paramName;
 			archive >> value;
-			ShaderParameters->FloatParameters[NameHandle(paramName)] = value;
+			ShaderParameters->SetFloatParameter(NameHandle(paramName), value);
 		}
 
 		// Deserialize vector parameters
@@ -178,7 +189,7 @@ namespace Thunder
 			TVector4f value;
 			archive >> paramName;
 			archive >> value.X >> value.Y >> value.Z >> value.W;
-			ShaderParameters->VectorParameters[NameHandle(paramName)] = value;
+			ShaderParameters->SetVectorParameter(NameHandle(paramName), value);
 		}
 
 		// Deserialize texture parameters
@@ -191,7 +202,7 @@ namespace Thunder
 			TGuid value;
 			archive >> paramName;
 			archive >> value;
-			ShaderParameters->TextureParameters[NameHandle(paramName)] = value;
+			ShaderParameters->SetTextureParameter(NameHandle(paramName), value);
 		}
 
 		// Deserialize float parameters
@@ -204,7 +215,7 @@ namespace Thunder
 			bool value;
 			archive >> paramName;
 			archive >> value;
-			ShaderParameters->StaticSwitchParameters[NameHandle(paramName)] = value;
+			ShaderParameters->SetStaticSwitchParameter(NameHandle(paramName), value);
 		}
 	}
 
@@ -212,32 +223,32 @@ namespace Thunder
 
 	void GameMaterial::SetIntParameter(const NameHandle& paramName, int32 value)
 	{
-		ShaderParameters->IntParameters[paramName] = value;
+		ShaderParameters->SetIntParameter(paramName, value);
 		MarkRenderStateDirty();
 	}
 
 	void GameMaterial::SetFloatParameter(const NameHandle& paramName, float value)
 	{
-		ShaderParameters->FloatParameters[paramName] = value;
+		ShaderParameters->SetFloatParameter(paramName, value);
 		MarkRenderStateDirty();
 	}
 
 	void GameMaterial::SetVectorParameter(const NameHandle& paramName, const TVector4f& value)
 	{
-		ShaderParameters->VectorParameters[paramName] = value;
+		ShaderParameters->SetVectorParameter(paramName, value);
 		MarkRenderStateDirty();
 	}
 
 	void GameMaterial::SetTextureParameter(const NameHandle& paramName, const TGuid& textureGuid)
 	{
-		ShaderParameters->TextureParameters[paramName] = textureGuid;
+		ShaderParameters->SetTextureParameter(paramName, textureGuid);
 		AddDependency(textureGuid);
 		MarkRenderStateDirty();
 	}
 
 	void GameMaterial::SetStaticParameter(const NameHandle& paramName, bool value)
 	{
-		ShaderParameters->StaticSwitchParameters[paramName] = value;
+		ShaderParameters->SetStaticSwitchParameter(paramName, value);
 		MarkRenderStateDirty();
 	}
 
@@ -245,82 +256,52 @@ namespace Thunder
 
 	bool GameMaterial::GetIntParameter(const NameHandle& paramName, int32& outValue) const
 	{
-		auto it = ShaderParameters->IntParameters.find(paramName);
-		if (it != ShaderParameters->IntParameters.end())
-		{
-			outValue = it->second;
-			return true;
-		}
-		return false;
+		return ShaderParameters->GetIntParameter(paramName, outValue);
 	}
 
 	bool GameMaterial::GetFloatParameter(const NameHandle& paramName, float& outValue) const
 	{
-		auto it = ShaderParameters->FloatParameters.find(paramName);
-		if (it != ShaderParameters->FloatParameters.end())
-		{
-			outValue = it->second;
-			return true;
-		}
-		return false;
+		return ShaderParameters->GetFloatParameter(paramName, outValue);
 	}
 
 	bool GameMaterial::GetVectorParameter(const NameHandle& paramName, TVector4f& outValue) const
 	{
-		auto it = ShaderParameters->VectorParameters.find(paramName);
-		if (it != ShaderParameters->VectorParameters.end())
-		{
-			outValue = it->second;
-			return true;
-		}
-		return false;
+		return ShaderParameters->GetVectorParameter(paramName, outValue);
 	}
 
 	bool GameMaterial::GetTextureParameter(const NameHandle& paramName, TGuid& outTextureGuid) const
 	{
-		auto it = ShaderParameters->TextureParameters.find(paramName);
-		if (it != ShaderParameters->TextureParameters.end())
-		{
-			outTextureGuid = it->second;
-			return true;
-		}
-		return false;
+		return ShaderParameters->GetTextureParameter(paramName, outTextureGuid);
 	}
 
 	bool GameMaterial::GetStaticParameter(const NameHandle& paramName, bool& outValue) const
 	{
-		auto it = ShaderParameters->StaticSwitchParameters.find(paramName);
-		if (it != ShaderParameters->StaticSwitchParameters.end())
-		{
-			outValue = it->second;
-			return true;
-		}
-		return false;
+		return ShaderParameters->GetStaticSwitchParameter(paramName, outValue);
 	}
 
 	// ========== Parameter removal ==========
 
 	void GameMaterial::RemoveIntParameter(const NameHandle& paramName)
 	{
-		ShaderParameters->IntParameters.erase(paramName);
+		ShaderParameters->RemoveIntParameter(paramName);
 		MarkRenderStateDirty();
 	}
 
 	void GameMaterial::RemoveFloatParameter(const NameHandle& paramName)
 	{
-		ShaderParameters->FloatParameters.erase(paramName);
+		ShaderParameters->RemoveFloatParameter(paramName);
 		MarkRenderStateDirty();
 	}
 
 	void GameMaterial::RemoveVectorParameter(const NameHandle& paramName)
 	{
-		ShaderParameters->VectorParameters.erase(paramName);
+		ShaderParameters->RemoveVectorParameter(paramName);
 		MarkRenderStateDirty();
 	}
 
 	void GameMaterial::RemoveTextureParameter(const NameHandle& paramName)
 	{
-		ShaderParameters->TextureParameters.erase(paramName);
+		ShaderParameters->RemoveTextureParameter(paramName);
 		MarkRenderStateDirty();
 	}
 
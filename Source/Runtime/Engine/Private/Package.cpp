@@ -155,29 +155,30 @@ namespace Thunder
 			return false;
 		}
 
-		const TRefCountPtr<NativeFile> file = static_cast<NativeFile*>(fileSystem->Open(fullPath, false));
-		const size_t fileSize = file->Size();
-		if (fileSize == 0)
+		// Map the package so the header and payloads are read in place, mesh data keeps referencing the mapping until upload.
+		BinaryDataRef fileData = fileSystem->MapFile(fullPath);
+		if (!fileData)
 		{
-			return false;
-		}
+			const TRefCountPtr<NativeFile> file = static_cast<NativeFile*>(fileSystem->Open(fullPath, false));
+			const size_t fileSize = file->Size();
+			if (fileSize == 0)
+			{
+				return false;
+			}
 
-		void* fileData = TMemory::Malloc<uint8>(fileSize);
-		const size_t bytesRead = file->Read(fileData, fileSize);
-		file->Close();
+			fileData = new HeapBinaryData(fileSize);
+			const size_t bytesRead = file->Read(fileData->Data, fileSize);
+			file->Close();
 
-		if (bytesRead != fileSize)
-		{
-			TMemory::Destroy(fileData);
-			return false;
+			if (bytesRead != fileSize)
+			{
+				return false;
+			}
 		}
-
-		BinaryData binaryData;
-		binaryData.Data = fileData;
-		binaryData.Size = fileSize;
+		const size_t fileSize = fileData->Size;
 		
 		// DeSerialize
-		MemoryReader headerArchive(&binaryData);
+		MemoryReader headerArchive(fileData, 0, fileSize);
 		uint32 headerSize = 0;
 		headerArchive >> headerSize;
 		DeSerialize(headerArchive);
@@ -206,16 +207,14 @@ namespace Thunder
 		// check data
 		if (Header.MagicNumber != 0x50414745) // "PAGE"
 		{
-			TMemory::Destroy(fileData);
 			return false;
 		}
 
 		// Verify checksum.
-		uint8* fileDataPtr = static_cast<uint8*>(fileData);
+		const uint8* fileDataPtr = static_cast<const uint8*>(fileData->Data);
 		const uint32 calculatedChecksum = FCrc::BinaryCrc32(fileDataPtr + 12, fileSize - 12); // Skip magic number and checksum.
 		if (Header.CheckSum != calculatedChecksum)
 		{
-			TMemory::Destroy(fileData);
 			return false;
 		}
 
@@ -224,11 +223,12 @@ namespace Thunder
 		// Deserialize each object.
 		for (uint32 i = 0; i < numGuids; ++i)
 		{
-			const void* objectDataStart = fileDataPtr + offsetList[i];
-			BinaryData objectBinaryData;
-			objectBinaryData.Data = const_cast<void*>(objectDataStart);
-			objectBinaryData.Size = sizeList[i];
-			MemoryReader objectArchive(&objectBinaryData);
+			if (static_cast<size_t>(offsetList[i]) + sizeList[i] > fileSize) [[unlikely]]
+			{
+				TAssertf(false, "Package::Load: object %u of %s is out of the file", i, fullPath.c_str());
+				return false;
+			}
+			MemoryReader objectArchive(fileData, offsetList[i], sizeList[i]);
 			
 			GameResource* gameResource;
 			if (typeList[i] == ETempGameResourceReflective::StaticMesh)
@@ -245,7 +245,6 @@ namespace Thunder
 			}
 			else
 			{
-				TMemory::Destroy(fileData);
 				return false;
 			}
 			gameResource->DeSerialize(objectArchive);
@@ -257,8 +256,6 @@ namespace Thunder
 		}
 
 		LOG("load package : %s complete, resource count: %llu", fullPath.c_str(), Objects.size());
-
-		TMemory::Destroy(fileData);
 		return true;
 	}
 
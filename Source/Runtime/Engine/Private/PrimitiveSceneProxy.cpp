@@ -24,16 +24,6 @@ namespace Thunder
         TMemory::Destroy(SceneInfo);
     }
 
-    void PrimitiveSceneProxy::UpdateTransform(const TMatrix44f& transform) const
-    {
-        // Check in render thread
-        if (SceneInfo == nullptr) [[unlikely]]
-        {
-            return;
-        }
-        SceneInfo->SetTransform(transform);
-    }
-
     StaticMeshSceneProxy::StaticMeshSceneProxy(StaticMeshComponent* inComponent, const TMatrix44f& inTransform)
         : PrimitiveSceneProxy(inComponent)
     {
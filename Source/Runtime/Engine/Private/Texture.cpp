@@ -185,14 +185,13 @@ namespace Thunder
 		int compressed_size;
 		archive >> compressed_size;
 		
-		if (compressed_size > 0)
+		// Decoded straight from the package data, no intermediate copy of the compressed image.
+		const auto* compressed_data = compressed_size > 0 ? static_cast<const stbi_uc*>(archive.ReadInPlace(compressed_size)) : nullptr;
+		if (compressed_data)
 		{
-			std::vector<unsigned char> compressed_data(compressed_size);
-			archive.ReadRaw(compressed_data.data(), compressed_size);
-
 			int loaded_width, loaded_height, loaded_channels;
 			unsigned char* raw_data = stbi_load_from_memory(
-				compressed_data.data(),
+				compressed_data,
 				compressed_size,
 				&loaded_width,
 				&loaded_height,
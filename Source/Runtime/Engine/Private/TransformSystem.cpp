@@ -0,0 +1,468 @@
+#include "TransformSystem.h"
+#include "Compomemt.h"
+#include "Entity.h"
+#include "IRenderer.h"
+#include "MathUtilities.h"
+#include "Platform.h"
+#include "PrimitiveSceneProxy.h"
+#include "Concurrent/TaskScheduler.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <immintrin.h>
+#endif
+
+namespace Thunder
+{
+	namespace
+	{
+		constexpr uint32 LanesPerGroup = 4;
+		constexpr uint32 MinGroupsPerBatch = 64; // 256 transforms per worker at least.
+
+#if PLATFORM_CPU_X86_FAMILY
+		// Local matrices of 4 consecutive transforms, outRows[lane][row] holds row 'row' of lane 'lane'. Same math as ComposeLocal.
+		FORCEINLINE void ComposeLocalFour(const float* px, const float* py, const float* pz, const float* rx, const float* ry, const float* rz,
+			const float* scx, const float* scy, const float* scz, __m128 (&outRows)[LanesPerGroup][4])
+		{
+			alignas(16) float cosP[LanesPerGroup], sinP[LanesPerGroup];
+			alignas(16) float cosY[LanesPerGroup], sinY[LanesPerGroup];
+			alignas(16) float cosR[LanesPerGroup], sinR[LanesPerGroup];
+			for (uint32 lane = 0; lane < LanesPerGroup; ++lane)
+			{
+				cosP[lane] = std::cos(rx[lane] * DEG_TO_RAD);
+				sinP[lane] = std::sin(rx[lane] * DEG_TO_RAD);
+				cosY[lane] = std::cos(ry[lane] * DEG_TO_RAD);
+				sinY[lane] = std::sin(ry[lane] * DEG_TO_RAD);
+				cosR[lane] = std::cos(rz[lane] * DEG_TO_RAD);
+				sinR[lane] = std::sin(rz[lane] * DEG_TO_RAD);
+			}
+			const __m128 cp = _mm_load_ps(cosP);
+			const __m128 sp = _mm_load_ps(sinP);
+			const __m128 cy = _mm_load_ps(cosY);
+			const __m128 sy = _mm_load_ps(sinY);
+			const __m128 cr = _mm_load_ps(cosR);
+			const __m128 sr = _mm_load_ps(sinR);
+			const __m128 scaleX = _mm_loadu_ps(scx);
+			const __m128 scaleY = _mm_loadu_ps(scy);
+			const __m128 scaleZ = _mm_loadu_ps(scz);
+			const __m128 spcy = _mm_mul_ps(sp, cy);
+			const __m128 spsy = _mm_mul_ps(sp, sy);
+
+			__m128 row0[4] = {
+				_mm_mul_ps(_mm_mul_ps(cp, cy), scaleX),
+				_mm_mul_ps(_mm_mul_ps(cp, sy), scaleX),
+				_mm_mul_ps(sp, scaleX),
+				_mm_setzero_ps() };
+			__m128 row1[4] = {
+				_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(sr, spcy), _mm_mul_ps(cr, sy)), scaleY),
+				_mm_mul_ps(_mm_add_ps(_mm_mul_ps(sr, spsy), _mm_mul_ps(cr, cy)), scaleY),
+				_mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), _mm_mul_ps(sr, cp)), scaleY),
+				_mm_setzero_ps() };
+			__m128 row2[4] = {
+				_mm_mul_ps(_mm_sub_ps(_mm_setzero_ps(), _mm_add_ps(_mm_mul_ps(cr, spcy), _mm_mul_ps(sr, sy))), scaleZ),
+				_mm_mul_ps(_mm_sub_ps(_mm_mul_ps(cy, sr), _mm_mul_ps(cr, spsy)), scaleZ),
+				_mm_mul_ps(_mm_mul_ps(cr, cp), scaleZ),
+				_mm_setzero_ps() };
+			__m128 row3[4] = { _mm_loadu_ps(px), _mm_loadu_ps(py), _mm_loadu_ps(pz), _mm_set1_ps(1.f) };
+
+			// Components are laid out per lane, transposing turns them into one row per lane.
+			_MM_TRANSPOSE4_PS(row0[0], row0[1], row0[2], row0[3]);
+			_MM_TRANSPOSE4_PS(row1[0], row1[1], row1[2], row1[3]);
+			_MM_TRANSPOSE4_PS(row2[0], row2[1], row2[2], row2[3]);
+			_MM_TRANSPOSE4_PS(row3[0], row3[1], row3[2], row3[3]);
+			for (uint32 lane = 0; lane < LanesPerGroup; ++lane)
+			{
+				outRows[lane][0] = row0[lane];
+				outRows[lane][1] = row1[lane];
+				outRows[lane][2] = row2[lane];
+				outRows[lane][3] = row3[lane];
+			}
+		}
+
+		// outWorld = local * parent (row vectors), local alone for roots.
+		FORCEINLINE void StoreWorld(const __m128 (&local)[4], const TMatrix44f* parent, TMatrix44f& outWorld)
+		{
+			if (!parent)
+			{
+				for (uint32 row = 0; row < 4; ++row)
+				{
+					_mm_storeu_ps(outWorld.M[row], local[row]);
+				}
+				return;
+			}
+			const __m128 parent0 = _mm_loadu_ps(parent->M[0]);
+			const __m128 parent1 = _mm_loadu_ps(parent->M[1]);
+			const __m128 parent2 = _mm_loadu_ps(parent->M[2]);
+			const __m128 parent3 = _mm_loadu_ps(parent->M[3]);
+			for (uint32 row = 0; row < 4; ++row)
+			{
+				const __m128 value = local[row];
+				const __m128 result = _mm_add_ps(
+					_mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(value, value, _MM_SHUFFLE(0, 0, 0, 0)), parent0),
+						_mm_mul_ps(_mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 1, 1, 1)), parent1)),
+					_mm_add_ps(_mm_mul_ps(_mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 2, 2, 2)), parent2),
+						_mm_mul_ps(_mm_shuffle_ps(value, value, _MM_SHUFFLE(3, 3, 3, 3)), parent3)));
+				_mm_storeu_ps(outWorld.M[row], result);
+			}
+		}
+#endif
+	}
+
+	TransformSystem::~TransformSystem()
+	{
+		// Components outliving the scene fall back to their own copy of the local transform.
+		for (uint32 index = 0; index < GetNumTransforms(); ++index)
+		{
+			if (TransformComponent* component = Components[index])
+			{
+				Unregister(component);
+				component->System = nullptr;
+			}
+		}
+		auto lock = PendingLock.Guard();
+		for (TransformComponent* component : PendingComponents)
+		{
+			component->System = nullptr;
+		}
+		PendingComponents.clear();
+	}
+
+	void TransformSystem::Register(TransformComponent* component)
+	{
+		auto lock = PendingLock.Guard();
+		PendingComponents.push_back(component);
+	}
+
+	void TransformSystem::Unregister(TransformComponent* component)
+	{
+		const uint32 index = component->TransformIndex;
+		if (index == InvalidTransformIndex)
+		{
+			auto lock = PendingLock.Guard();
+			auto pendingIt = std::ranges::find(PendingComponents, component);
+			if (pendingIt != PendingComponents.end())
+			{
+				PendingComponents.erase(pendingIt);
+			}
+			return;
+		}
+
+		// The slot is left empty and dropped by the next rebuild, so the order of the others is kept.
+		component->Position = GetPosition(index);
+		component->Rotation = GetRotation(index);
+		component->Scale = GetScale(index);
+		component->TransformIndex = InvalidTransformIndex;
+		Components[index] = nullptr;
+		Dirty[index] = 0;
+		Changed[index] = 0;
+		MarkHierarchyDirty();
+	}
+
+	void TransformSystem::SetPosition(uint32 index, const TVector3f& position)
+	{
+		PositionX[index] = position.X;
+		PositionY[index] = position.Y;
+		PositionZ[index] = position.Z;
+		Dirty[index] = 1;
+	}
+
+	void TransformSystem::SetRotation(uint32 index, const TVector3f& rotation)
+	{
+		RotationX[index] = rotation.X;
+		RotationY[index] = rotation.Y;
+		RotationZ[index] = rotation.Z;
+		Dirty[index] = 1;
+	}
+
+	void TransformSystem::SetScale(uint32 index, const TVector3f& scale)
+	{
+		ScaleX[index] = scale.X;
+		ScaleY[index] = scale.Y;
+		ScaleZ[index] = scale.Z;
+		Dirty[index] = 1;
+	}
+
+	const TMatrix44f& TransformSystem::GetWorld(uint32 index)
+	{
+		RefreshWorld(index);
+		return World[index];
+	}
+
+	void TransformSystem::RefreshWorld(uint32 index)
+	{
+		const uint32 parent = Parents[index];
+		if (parent != InvalidTransformIndex)
+		{
+			RefreshWorld(parent);
+		}
+		if (NeedsUpdate(index))
+		{
+			const TMatrix44f local = ComputeLocal(index);
+			World[index] = parent == InvalidTransformIndex ? local : local * World[parent];
+			Dirty[index] = 0;
+			Changed[index] = 1;
+		}
+	}
+
+	void TransformSystem::Update(IRenderer* renderer)
+	{
+		// Bind the transforms loaded since the last frame, they are put in order below.
+		TArray<TransformComponent*> pendingComponents;
+		{
+			auto lock = PendingLock.Guard();
+			pendingComponents.swap(PendingComponents);
+		}
+		for (TransformComponent* component : pendingComponents)
+		{
+			component->TransformIndex = GetNumTransforms();
+			PositionX.push_back(component->Position.X);
+			PositionY.push_back(component->Position.Y);
+			PositionZ.push_back(component->Position.Z);
+			RotationX.push_back(component->Rotation.X);
+			RotationY.push_back(component->Rotation.Y);
+			RotationZ.push_back(component->Rotation.Z);
+			ScaleX.push_back(component->Scale.X);
+			ScaleY.push_back(component->Scale.Y);
+			ScaleZ.push_back(component->Scale.Z);
+			World.push_back(TMatrix44f::Identity());
+			Parents.push_back(InvalidTransformIndex);
+			Dirty.push_back(1);
+			Changed.push_back(0);
+			Components.push_back(component);
+		}
+		if (!pendingComponents.empty())
+		{
+			MarkHierarchyDirty();
+		}
+
+		if (bHierarchyDirty.exchange(false, std::memory_order_acq_rel))
+		{
+			RebuildHierarchy();
+		}
+
+		// Depth by depth, parents are final before their children read them.
+		for (uint32 depth = 0; depth + 1 < static_cast<uint32>(DepthOffsets.size()); ++depth)
+		{
+			const uint32 begin = DepthOffsets[depth];
+			const uint32 end = DepthOffsets[depth + 1];
+			const uint32 numGroups = (end - begin + LanesPerGroup - 1) / LanesPerGroup;
+			if (!GSyncWorkers || numGroups <= MinGroupsPerBatch)
+			{
+				UpdateWorldRange(begin, end);
+				continue;
+			}
+			GSyncWorkers->ParallelForRange(numGroups, [this, begin, end](uint32 beginGroup, uint32 endGroup, uint32)
+			{
+				UpdateWorldRange(begin + beginGroup * LanesPerGroup, std::min(end, begin + endGroup * LanesPerGroup));
+			}, MinGroupsPerBatch);
+		}
+
+		SubmitChanged(renderer);
+	}
+
+	void TransformSystem::RebuildHierarchy()
+	{
+		const uint32 numSlots = GetNumTransforms();
+
+		// Parents by current index, empty slots are dropped.
+		TArray<uint32> parents(numSlots, InvalidTransformIndex);
+		for (uint32 index = 0; index < numSlots; ++index)
+		{
+			TransformComponent* component = Components[index];
+			Entity* parentEntity = component && component->Owner ? component->Owner->GetOwner() : nullptr;
+			TransformComponent* parentComponent = parentEntity ? parentEntity->GetTransformComponent() : nullptr;
+			if (parentComponent && parentComponent->System == this && parentComponent->TransformIndex != InvalidTransformIndex)
+			{
+				parents[index] = parentComponent->TransformIndex;
+			}
+		}
+
+		// Counting sort by depth, stable so siblings keep their relative order.
+		TArray<uint32> depths(numSlots, 0);
+		uint32 maxDepth = 0;
+		for (uint32 index = 0; index < numSlots; ++index)
+		{
+			for (uint32 parent = parents[index]; parent != InvalidTransformIndex; parent = parents[parent])
+			{
+				++depths[index];
+			}
+			maxDepth = std::max(maxDepth, depths[index]);
+		}
+		DepthOffsets.assign(maxDepth + 2, 0);
+		for (uint32 index = 0; index < numSlots; ++index)
+		{
+			if (Components[index])
+			{
+				++DepthOffsets[depths[index] + 1];
+			}
+		}
+		for (uint32 depth = 0; depth <= maxDepth; ++depth)
+		{
+			DepthOffsets[depth + 1] += DepthOffsets[depth];
+		}
+		TArray<uint32> order(DepthOffsets.back());
+		TArray<uint32> newIndices(numSlots, InvalidTransformIndex);
+		{
+			TArray<uint32> cursors(DepthOffsets.begin(), DepthOffsets.end() - 1);
+			for (uint32 index = 0; index < numSlots; ++index)
+			{
+				if (Components[index])
+				{
+					newIndices[index] = cursors[depths[index]]++;
+					order[newIndices[index]] = index;
+				}
+			}
+		}
+
+		auto gather = [&order](auto& values)
+		{
+			std::remove_reference_t<decltype(values)> sorted;
+			sorted.reserve(order.size());
+			for (uint32 index : order)
+			{
+				sorted.push_back(values[index]);
+			}
+			values.swap(sorted);
+		};
+		gather(PositionX);
+		gather(PositionY);
+		gather(PositionZ);
+		gather(RotationX);
+		gather(RotationY);
+		gather(RotationZ);
+		gather(ScaleX);
+		gather(ScaleY);
+		gather(ScaleZ);
+		gather(World);
+		gather(Components);
+
+		const uint32 numTransforms = static_cast<uint32>(order.size());
+		Parents.resize(numTransforms);
+		for (uint32 index = 0; index < numTransforms; ++index)
+		{
+			const uint32 oldParent = parents[order[index]];
+			Parents[index] = oldParent == InvalidTransformIndex ? InvalidTransformIndex : newIndices[oldParent];
+			Components[index]->TransformIndex = index;
+		}
+
+		// Parents may have changed, everything is recomputed once.
+		Dirty.assign(numTransforms, 1);
+		Changed.assign(numTransforms, 0);
+	}
+
+	void TransformSystem::UpdateWorldRange(uint32 begin, uint32 end)
+	{
+		uint32 index = begin;
+#if PLATFORM_CPU_X86_FAMILY
+		for (; index + LanesPerGroup <= end; index += LanesPerGroup)
+		{
+			uint32 laneMask = 0;
+			for (uint32 lane = 0; lane < LanesPerGroup; ++lane)
+			{
+				laneMask |= NeedsUpdate(index + lane) ? (1u << lane) : 0u;
+			}
+			if (laneMask == 0)
+			{
+				continue;
+			}
+
+			__m128 localRows[LanesPerGroup][4];
+			ComposeLocalFour(&PositionX[index], &PositionY[index], &PositionZ[index], &RotationX[index], &RotationY[index], &RotationZ[index],
+				&ScaleX[index], &ScaleY[index], &ScaleZ[index], localRows);
+			for (uint32 lane = 0; lane < LanesPerGroup; ++lane)
+			{
+				if (laneMask & (1u << lane))
+				{
+					const uint32 parent = Parents[index + lane];
+					StoreWorld(localRows[lane], parent == InvalidTransformIndex ? nullptr : &World[parent], World[index + lane]);
+					Dirty[index + lane] = 0;
+					Changed[index + lane] = 1;
+				}
+			}
+		}
+#endif
+		for (; index < end; ++index)
+		{
+			if (NeedsUpdate(index))
+			{
+				const uint32 parent = Parents[index];
+				const TMatrix44f local = ComputeLocal(index);
+				World[index] = parent == InvalidTransformIndex ? local : local * World[parent];
+				Dirty[index] = 0;
+				Changed[index] = 1;
+			}
+		}
+	}
+
+	void TransformSystem::SubmitChanged(IRenderer* renderer)
+	{
+		TArray<PrimitiveTransformUpdate> updates;
+		for (uint32 index = 0; index < GetNumTransforms(); ++index)
+		{
+			if (!Changed[index])
+			{
+				continue;
+			}
+			Changed[index] = 0;
+			for (const PrimitiveSceneProxy* primitive : Components[index]->GetPrimitives())
+			{
+				updates.push_back({ primitive->GetSceneInfo(), World[index] });
+			}
+		}
+		if (renderer && !updates.empty())
+		{
+			renderer->UpdatePrimitiveTransforms_GameThread(updates.data(), static_cast<uint32>(updates.size()));
+		}
+	}
+
+	TMatrix44f TransformSystem::ComputeLocal(uint32 index) const
+	{
+		return ComposeLocal(GetPosition(index), GetRotation(index), GetScale(index));
+	}
+
+	TMatrix44f TransformSystem::ComposeLocal(const TVector3f& position, const TVector3f& rotation, const TVector3f& scale)
+	{
+		// Left-handed coordinate system (UE convention): X=Forward, Y=Right, Z=Up
+		// Rotation stored as degrees: X=Pitch, Y=Yaw, Z=Roll
+		//
+		// Matches Unreal Engine's FRotationMatrix convention.
+		// Key property: with Roll=0 the Right vector is always horizontal (Z=0),
+		// so the horizon stays level regardless of Pitch.
+		//
+		// R (row-major, row-vector convention: p' = p * R):
+		//   Row 0 (Forward): ( CP*CY,              CP*SY,              SP     )
+		//   Row 1 (Right):   ( SR*SP*CY - CR*SY,   SR*SP*SY + CR*CY, -SR*CP  )
+		//   Row 2 (Up):      (-(CR*SP*CY + SR*SY),  CY*SR - CR*SP*SY,  CR*CP )
+
+		constexpr float DegToRad = DEG_TO_RAD;
+		const float pitchRad = rotation.X * DegToRad;
+		const float yawRad   = rotation.Y * DegToRad;
+		const float rollRad  = rotation.Z * DegToRad;
+
+		const float cp = std::cos(pitchRad);
+		const float sp = std::sin(pitchRad);
+		const float cy = std::cos(yawRad);
+		const float sy = std::sin(yawRad);
+		const float cr = std::cos(rollRad);
+		const float sr = std::sin(rollRad);
+
+		const float r00 =  cp * cy;
+		const float r01 =  cp * sy;
+		const float r02 =  sp;
+
+		const float r10 =  sr * sp * cy - cr * sy;
+		const float r11 =  sr * sp * sy + cr * cy;
+		const float r12 = -sr * cp;
+
+		const float r20 = -(cr * sp * cy + sr * sy);
+		const float r21 =  cy * sr - cr * sp * sy;
+		const float r22 =  cr * cp;
+
+		// Combined Transform = S * R * T (row-vector convention: p' = p * S * R * T)
+		// Row i of rotation is scaled by Scale[i], translation in row 3.
+		return TMatrix44f(
+			r00 * scale.X, r01 * scale.X, r02 * scale.X, 0.0f,
+			r10 * scale.Y, r11 * scale.Y, r12 * scale.Y, 0.0f,
+			r20 * scale.Z, r21 * scale.Z, r22 * scale.Z, 0.0f,
+			position.X,    position.Y,     position.Z,     1.0f);
+	}
+}
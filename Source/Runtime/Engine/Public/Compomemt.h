@@ -6,6 +6,7 @@
 #include "Vector.h"
 #include "Matrix.h"
 #include "SceneView.h"
+#include "TransformSystem.h"
 #include "rapidjson/prettywriter.h"
 #include "rapidjson/stringbuffer.h"
 #include "rapidjson/document.h"
@@ -124,8 +125,8 @@ namespace Thunder
 	class TransformComponent : public IComponent
 	{
 	public:
-		TransformComponent(Entity* inOwner) : IComponent(inOwner) {}
-		~TransformComponent() override = default;
+		TransformComponent(Entity* inOwner);
+		~TransformComponent() override;
 
 		NameHandle GetComponentName() const override { return "TransformComponent"; }
 
@@ -133,26 +134,35 @@ namespace Thunder
 		void SerializeJson(rapidjson::PrettyWriter<rapidjson::StringBuffer>& writer) const override;
 		void DeserializeJson(const rapidjson::Value& jsonValue) override;
 
-		// Transform accessors
+		// Joins the scene's transform system.
+		void OnLoaded() override;
+
+		// Transform accessors, setters only mark the transform dirty until the scene updates its transforms.
 		void SetPosition(const TVector3f& inPosition);
 		void SetRotation(const TVector3f& inRotation);
 		void SetScale(const TVector3f& inScale);
-		const TVector3f& GetPosition() const { return Position; }
-		const TVector3f& GetRotation() const { return Rotation; }
-		const TVector3f& GetScale() const { return Scale; }
-		const TMatrix44f& GetTransform() const { return Transform; }
+		TVector3f GetPosition() const { return IsBound() ? System->GetPosition(TransformIndex) : Position; }
+		TVector3f GetRotation() const { return IsBound() ? System->GetRotation(TransformIndex) : Rotation; }
+		TVector3f GetScale() const { return IsBound() ? System->GetScale(TransformIndex) : Scale; }
+		// World transform, parents included once the transform is bound.
+		TMatrix44f GetTransform() const;
 
-		// Redner
-		void MarkPrimitiveUniformBufferDirty();
-	private:
-		void UpdateTransform();
+		// Render, primitives moved along with this transform.
+		void AddPrimitive(class PrimitiveSceneProxy* primitive) { Primitives.push_back(primitive); }
+		const TArray<PrimitiveSceneProxy*>& GetPrimitives() const { return Primitives; }
 
 	private:
+		friend class TransformSystem;
+		FORCEINLINE bool IsBound() const { return TransformIndex != InvalidTransformIndex; }
+
+		// Local transform until the system takes it over.
 		TVector3f Position { 0.0f, 0.0f, 0.0f };
 		TVector3f Rotation { 0.0f, 0.0f, 0.0f };
 		TVector3f Scale { 1.0f, 1.0f, 1.0f };
 
-		TMatrix44f Transform { TMatrix44f::Identity() };
+		TransformSystem* System { nullptr };
+		uint32 TransformIndex { InvalidTransformIndex };
+		TArray<PrimitiveSceneProxy*> Primitives;
 	};
 
 	class CameraComponent : public IComponent
@@ -18,7 +18,6 @@ namespace Thunder
 
         bool NeedRenderView(EViewType type) { return true; }
         PrimitiveSceneInfo* GetSceneInfo() const { return SceneInfo; }
-        void UpdateTransform(const TMatrix44f& transform) const;
 
     protected:
         PrimitiveComponent* Component = nullptr;
@@ -1,6 +1,7 @@
 #pragma once
 #include "GameObject.h"
 #include "Entity.h"
+#include "TransformSystem.h"
 #include "Container.h"
 #include "rapidjson/document.h"
 #include "rapidjson/prettywriter.h"
@@ -47,9 +48,14 @@ namespace Thunder
 		ENGINE_API BaseViewport* GetViewport() const { return Viewport; }
 		ENGINE_API void SetViewport(BaseViewport* inViewport) { Viewport = inViewport; }
 
+		// Transforms of all entities, updated and sent to the renderer once per frame.
+		ENGINE_API TransformSystem* GetTransformSystem() { return &Transforms; }
+		ENGINE_API void UpdateTransforms() { Transforms.Update(Renderer); }
+
 	private:
 		NameHandle SceneName;
 		TArray<Entity*> RootEntities;
+		TransformSystem Transforms;
 		IRenderer* Renderer{ nullptr };
 		BaseViewport* Viewport{ nullptr };
 	};
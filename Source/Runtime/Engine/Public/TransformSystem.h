@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include "Container.h"
+#include "Matrix.h"
+#include "Vector.h"
+#include "Concurrent/Lock.h"
+
+namespace Thunder
+{
+	class IRenderer;
+	class TransformComponent;
+
+	constexpr uint32 InvalidTransformIndex = 0xFFFFFFFF;
+
+	/**
+	 * Local and world transforms of a scene's TransformComponents in SoA layout, sorted by hierarchy depth so every parent
+	 * comes before its children and each depth is one contiguous range.
+	 * Setters only raise a dirty flag, Update recomputes the dirty world matrices (and those below them) once per frame
+	 * and hands the changed primitive transforms to the renderer as one batch.
+	 * Transforms join when their component is loaded, anything else touches the arrays on the game thread only.
+	 */
+	class TransformSystem
+	{
+	public:
+		TransformSystem() = default;
+		ENGINE_API ~TransformSystem();
+
+		// Any thread, the component is bound to an index on the next Update.
+		ENGINE_API void Register(TransformComponent* component);
+		ENGINE_API void Unregister(TransformComponent* component);
+		// Parents are resolved from the entity hierarchy, call when it changes.
+		FORCEINLINE void MarkHierarchyDirty() { bHierarchyDirty.store(true, std::memory_order_release); }
+
+		FORCEINLINE TVector3f GetPosition(uint32 index) const { return TVector3f(PositionX[index], PositionY[index], PositionZ[index]); }
+		FORCEINLINE TVector3f GetRotation(uint32 index) const { return TVector3f(RotationX[index], RotationY[index], RotationZ[index]); }
+		FORCEINLINE TVector3f GetScale(uint32 index) const { return TVector3f(ScaleX[index], ScaleY[index], ScaleZ[index]); }
+		ENGINE_API void SetPosition(uint32 index, const TVector3f& position);
+		ENGINE_API void SetRotation(uint32 index, const TVector3f& rotation);
+		ENGINE_API void SetScale(uint32 index, const TVector3f& scale);
+
+		// World matrix, brought up to date first when the transform or one of its parents is dirty.
+		ENGINE_API const TMatrix44f& GetWorld(uint32 index);
+		// Scale, then rotation, then translation.
+		ENGINE_API static TMatrix44f ComposeLocal(const TVector3f& position, const TVector3f& rotation, const TVector3f& scale);
+
+		// Game thread, once per frame.
+		ENGINE_API void Update(IRenderer* renderer);
+
+		FORCEINLINE uint32 GetNumTransforms() const { return static_cast<uint32>(Components.size()); }
+
+	private:
+		void RebuildHierarchy();
+		void RefreshWorld(uint32 index);
+		void UpdateWorldRange(uint32 begin, uint32 end);
+		void SubmitChanged(IRenderer* renderer);
+		TMatrix44f ComputeLocal(uint32 index) const;
+		FORCEINLINE bool NeedsUpdate(uint32 index) const
+		{
+			const uint32 parent = Parents[index];
+			return Dirty[index] || (parent != InvalidTransformIndex && Changed[parent]);
+		}
+
+		// Local transform, rotation in degrees (X=Pitch, Y=Yaw, Z=Roll).
+		TArray<float> PositionX;
+		TArray<float> PositionY;
+		TArray<float> PositionZ;
+		TArray<float> RotationX;
+		TArray<float> RotationY;
+		TArray<float> RotationZ;
+		TArray<float> ScaleX;
+		TArray<float> ScaleY;
+		TArray<float> ScaleZ;
+
+		TArray<TMatrix44f> World;
+		TArray<uint32> Parents;
+		TArray<uint8> Dirty;   // Local transform changed since the last update.
+		TArray<uint8> Changed; // World matrix changed since the last submit.
+		TArray<TransformComponent*> Components;
+		TArray<uint32> DepthOffsets; // Depth d covers [DepthOffsets[d], DepthOffsets[d + 1]).
+
+		SpinLock PendingLock;
+		TArray<TransformComponent*> PendingComponents;
+		std::atomic<bool> bHierarchyDirty { false };
+	};
+}
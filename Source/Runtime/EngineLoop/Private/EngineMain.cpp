@@ -4,6 +4,7 @@
 #include "CoreModule.h"
 #include "D3D12RHIModule.h"
 #include "D3D11RHIModule.h"
+#include "NullRHIModule.h"
 #include "GameMain.h"
 #include "GameModule.h"
 #include "PackageModule.h"
@@ -15,6 +16,7 @@
 #include "Scene.h"
 #include "Concurrent/TaskScheduler.h"
 #include "Concurrent/TheadPool.h"
+#include "Concurrent/TaskTrace.h"
 #include "Memory/MallocMinmalloc.h"
 #include "FileSystem/FileModule.h"
 
@@ -57,6 +59,10 @@ namespace Thunder
         {
             rhiType = EGfxApiType::D3D12;
         }
+        else if (configRHIType == "Null")
+        {
+            rhiType = EGfxApiType::Null;
+        }
         else
         {
             TAssertf(false, "Invalid RHI Type");
@@ -65,6 +71,7 @@ namespace Thunder
         {
             return;
         }
+        RHIType = rhiType;
         TAssertf(GStaticSamplerNames.size() == GStaticSamplerDefinitions.size(), "Inconsistent sampler counts");
         std::cout << IRHIModule::GetModule()->GetName().c_str() << std::endl;
 
@@ -73,6 +80,7 @@ namespace Thunder
 
         // setup task scheduler: parallel render thread, worker thread
         TaskSchedulerManager::StartUp();
+        TaskTrace::SetEnabled(GConfigManager->GetConfig("BaseEngine")->GetBool("EnableTaskTrace"));
 
         // setup shader archive
         ShaderModule::InitShaderMap();
@@ -122,6 +130,11 @@ namespace Thunder
                 ModuleManager::GetInstance()->LoadModule<TD3D11RHIModule>();
                 break;
             }
+            case EGfxApiType::Null:
+            {
+                ModuleManager::GetInstance()->LoadModule<TNullRHIModule>();
+                break;
+            }
             case EGfxApiType::Invalid:
                 return false;
         }
@@ -156,6 +169,16 @@ namespace Thunder
         GRenderScheduler->WaitForCompletionAndThreadExit();
         GRHIScheduler->WaitForCompletionAndThreadExit();
 
+        if (TaskTrace::IsEnabled())
+        {
+            TaskTrace::SetEnabled(false);
+            const String savedDir = FileModule::GetProjectRoot() + "\\Saved\\";
+            TaskTrace::DumpChromeTrace(savedDir + "TaskTrace.json");
+            TaskTrace::DumpSummary(savedDir + "TaskTraceSummary.txt");
+        }
+
+        // Async shader compiles run on the async workers, they must be done before the workers go away.
+        ShaderModule::FlushVariantCompiles();
         TaskSchedulerManager::ShutDown();
         ModuleManager::GetInstance()->UnloadModule<GameModule>();
         ModuleManager::GetInstance()->UnloadModule<PackageModule>();
@@ -171,13 +171,20 @@ namespace Thunder
         if (LoadingSignal == 0)
         {
             uint32 LoadingIndex = frameNum / 400;
-            GAsyncWorkers->ParallelFor([this, LoadingIndex](uint32 modelIndex, uint32 dummy)
+            // The loop runs on a pool thread so the game thread does not wait for it.
+            GAsyncWorkers->PushTask([this, LoadingIndex]()
             {
-                ThunderZoneScopedN("AsyncLoading");
-                FPlatformProcess::BusyWaiting(100000);
-                ModelLoaded[LoadingIndex * 8 + modelIndex] = true;
-                ModelData[LoadingIndex * 8 + modelIndex] = static_cast<int>(modelIndex) * 100;
-            }, 8, 1);
+                GAsyncWorkers->ParallelForRange(8, [this, LoadingIndex](uint32 begin, uint32 end, uint32)
+                {
+                    for (uint32 modelIndex = begin; modelIndex < end; ++modelIndex)
+                    {
+                        ThunderZoneScopedN("AsyncLoading");
+                        FPlatformProcess::BusyWaiting(100000);
+                        ModelLoaded[LoadingIndex * 8 + modelIndex] = true;
+                        ModelData[LoadingIndex * 8 + modelIndex] = static_cast<int>(modelIndex) * 100;
+                    }
+                }, 1);
+            });
         }
 
         for (int i = 0; i < 1024; i++)
@@ -214,6 +221,15 @@ namespace Thunder
         {
             tickable->Tick();
         }
+
+        // Transforms set this frame are propagated once and reach the renderers as one batch per scene.
+        for (auto* viewport : GameModule::GetViewports())
+        {
+            for (auto* scene : viewport->GetScenes())
+            {
+                scene->UpdateTransforms();
+            }
+        }
         
         // physics
         auto* taskPhysics = new (TMemory::Malloc<SimulatedPhysicsTask>()) SimulatedPhysicsTask(frameNum, "PhysicsTask");
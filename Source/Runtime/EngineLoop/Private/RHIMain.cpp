@@ -3,6 +3,7 @@
 
 #include "IDynamicRHI.h"
 #include "IRHIModule.h"
+#include "PipelineStateCache.h"
 #include "RenderResource.h"
 #include "RenderContext.h"
 #include "RHICommand.h"
@@ -19,13 +20,7 @@
 
 namespace Thunder
 {
-
-    void SimulatedPopulateCommandList::DoWork()
-    {
-        ThunderZoneScopedN("PopulateCommandList");
-        FPlatformProcess::BusyWaiting(50);
-        Dispatcher->Notify();
-    }
+    constexpr uint32 DrawStateStatsInterval = 300; // Frames between draw state reports.
 
     void RHITask::RHIMain()
     {
@@ -52,19 +47,6 @@ namespace Thunder
         }
         ExecuteRendererCommands();
 
-        const auto doWorkEvent = FPlatformProcess::GetSyncEventFromPool();
-        auto* dispatcher = new (TMemory::Malloc<TaskDispatcher>()) TaskDispatcher(doWorkEvent);
-        dispatcher->Promise(1000);
-        int i = 1000;
-        while (i-- > 0)
-        {
-            auto* task = new (TMemory::Malloc<SimulatedPopulateCommandList>()) SimulatedPopulateCommandList(dispatcher);
-            GSyncWorkers->PushTask(task);
-        }
-        doWorkEvent->Wait();
-        FPlatformProcess::ReturnSyncEventToPool(doWorkEvent);
-        TMemory::Destroy(dispatcher);
-
         RHIPresent();
 
         RHIReleaseResource_RHIThread();
@@ -81,46 +63,57 @@ namespace Thunder
         uint32 numThread = static_cast<uint32>(rhiCommandContexts.size());
 
         uint32 frontFrameGraphIndex = GFrameState->FrameNumberRHIThread.load(std::memory_order_acquire) % 2;
-        auto allCommands = renderer->GetFrameGraph()->GetCurrentAllCommands(static_cast<int>(frontFrameGraphIndex));
-        auto passStates = renderer->GetFrameGraph()->GetCurrentPassStates(static_cast<int>(frontFrameGraphIndex));
-        uint32 commandNum = static_cast<uint32>(allCommands.size());
-        if (commandNum > 0)
+        const auto& allCommands = renderer->GetFrameGraph()->GetCurrentAllCommands(static_cast<int>(frontFrameGraphIndex));
+        const auto& passStates = renderer->GetFrameGraph()->GetCurrentPassStates(static_cast<int>(frontFrameGraphIndex));
+        if (!allCommands.empty())
         {
+            // Split by estimated cost, one chunk per command context, in submission order.
+            CommandPartitioner.Partition(allCommands, numThread, CommandChunks);
+
             const auto doWorkEvent = FPlatformProcess::GetSyncEventFromPool();
             auto* dispatcher = new (TMemory::Malloc<TaskDispatcher>()) TaskDispatcher(doWorkEvent);
-            dispatcher->Promise(static_cast<int>(commandNum));
+            dispatcher->Promise(static_cast<int>(CommandChunks.size()));
 
-            // Split and push tasks.
-            const uint32 chunkSize   = (commandNum + numThread - 1) / numThread;
-            for (uint32 threadIndex = 0; threadIndex < numThread; ++threadIndex)
+            const TArray<IRHICommand*>* commands = &allCommands;
+            for (uint32 chunkIndex = 0; chunkIndex < static_cast<uint32>(CommandChunks.size()); ++chunkIndex)
             {
-                const uint32 chunkBegin = threadIndex * chunkSize;
-                if (chunkBegin >= commandNum)
+                const RHICommandChunk chunk = CommandChunks[chunkIndex];
+                RHICommandContext* commandList = rhiCommandContexts[chunkIndex];
+                GSyncWorkers->PushTask(static_cast<int>(chunkIndex), [commands, commandList, dispatcher, chunk]()
                 {
-                    break;
-                }
-                const uint32 chunkEnd = std::min(chunkBegin + chunkSize, commandNum);
-
-                GSyncWorkers->PushTask(static_cast<int>(threadIndex), [rhiCommandContexts, allCommands, passStates, dispatcher, chunkBegin, chunkEnd, threadIndex]()
-                {
-                    RHICommandContext* commandList = rhiCommandContexts[threadIndex];
-
-                    if (threadIndex > 0)
+                    // A chunk starting inside a pass restores that pass's render targets first.
+                    if (chunk.NeedsPassReplay())
                     {
-                        RHITask::ExecuteBeginCommandListCommand(passStates, commandList, chunkBegin);
+                        const auto* beginCommand = static_cast<const RHIBeginPassCommand*>((*commands)[chunk.ReplayPassBegin]);
+                        RHIBeginCommandListCommand command(beginCommand->PassState);
+                        command.Execute(commandList);
                     }
 
-                    for (uint32 index = chunkBegin; index < chunkEnd; ++index)
+                    for (uint32 index = chunk.Begin; index < chunk.End; ++index)
                     {
-                        allCommands[index]->ExecuteAndDestruct(commandList);
-                        dispatcher->Notify();
+                        (*commands)[index]->Dispatch(commandList);
                     }
+                    commandList->FlushDrawStateStats();
+                    dispatcher->Notify();
                 });
             }
 
             doWorkEvent->Wait();
             FPlatformProcess::ReturnSyncEventToPool(doWorkEvent);
             TMemory::Destroy(dispatcher);
+
+            // Report redundant binds skipped thanks to sorted draw lists.
+            if (GFrameState->FrameNumberRHIThread.load(std::memory_order_acquire) % DrawStateStatsInterval == 0)
+            {
+                for (auto const& passState : passStates)
+                {
+                    LOG("Pass %s: PSO binds %u (skipped %u), SRV table binds %u (skipped %u)", passState->Name.c_str(),
+                        passState->PSOBinds.load(std::memory_order_relaxed), passState->PSOBindsSkipped.load(std::memory_order_relaxed),
+                        passState->SRVTableBinds.load(std::memory_order_relaxed), passState->SRVTableBindsSkipped.load(std::memory_order_relaxed));
+                }
+                const PipelineStateCacheStats psoCacheStats = GetPipelineStateCacheStats();
+                LOG("PSO cache: %llu hits, %llu misses, %u entries", psoCacheStats.Hits, psoCacheStats.Misses, psoCacheStats.NumEntries);
+            }
         }
     }
 
@@ -135,33 +128,4 @@ namespace Thunder
         uint32 fenceIndex = GFrameState->FrameNumberRHIThread.load(std::memory_order_acquire) % MAX_FRAME_LAG;
         GDynamicRHI->RHISignalFence(fenceIndex);
     }
-
-    void RHITask::ExecuteBeginCommandListCommand(const TArray<RHIPassState*>& passStates, RHICommandContext* commandList, uint32 firstCommandId)
-    {
-        if (passStates.empty())
-        {
-            return;
-        }
-        // find pass, set render targets
-        uint32 passStatIndex = 0;
-        // Binary search
-        int32 lo = 0;
-        int32 hi = static_cast<int32>(passStates.size()) - 1;
-        while (lo <= hi)
-        {
-            int32 mid = lo + (hi - lo) / 2;
-            if (passStates[mid]->BeginCommandIndex <= firstCommandId)
-            {
-                passStatIndex = static_cast<uint32>(mid);
-                lo = mid + 1;
-            }
-            else
-            {
-                hi = mid - 1;
-            }
-        }
-        auto passStat = passStates[passStatIndex];
-        RHIBeginCommandListCommand command(passStat);
-        command.Execute(commandList);
-    }
 }
@@ -17,6 +17,7 @@ namespace Thunder
     	bool RHIInit(EGfxApiType type);
 		int32 Run();
         void Exit();
+		bool IsHeadless() const { return RHIType == EGfxApiType::Null; }
 
 		static std::atomic<bool> IsRequestingExit;
 		static class IEvent* EngineExitSignal;
@@ -24,6 +25,9 @@ namespace Thunder
 		{
 			return IsRequestingExit.load(std::memory_order_acquire);
 		}
+
+	private:
+		EGfxApiType RHIType = EGfxApiType::Invalid;
     };
 }
 
@@ -1,20 +1,9 @@
 ﻿#pragma once
+#include "RHICommandPartition.h"
 #include "Concurrent/TaskGraph.h"
 
 namespace Thunder
 {
-    class SimulatedPopulateCommandList : public ITask
-    {
-    public:
-        SimulatedPopulateCommandList(class TaskDispatcher* inDispatcher)
-            : Dispatcher(inDispatcher) {}
-
-        void DoWork() override;
-
-    private:
-        TaskDispatcher* Dispatcher{};
-    };
-
     class RHITask
     {
     public:
@@ -40,9 +29,10 @@ namespace Thunder
         void RHIMain();
         void CommitRendererCommands(const IRenderer* renderer);
         void ExecuteRendererCommands();
-        static void ExecuteBeginCommandListCommand(const TArray<struct RHIPassState*>& passStates, class RHICommandContext* commandList, uint32 firstCommandId);
 
         TArray<IRenderer*> Renderers;
+        RHICommandPartitioner CommandPartitioner;
+        TArray<RHICommandChunk> CommandChunks;
     };
 
     
@@ -0,0 +1,249 @@
+#include "NullCommandContext.h"
+
+namespace Thunder
+{
+	namespace
+	{
+		constexpr uint32 MaxRenderTargets = 8;
+	}
+
+	void NullCommandContext::ClearDepthStencilView(RHIDepthStencilView* dsv, ERHIClearFlags clearFlags, float depthValue, uint8 stencilValue)
+	{
+		ValidateRecording();
+	}
+
+	void NullCommandContext::ClearRenderTargetView(RHIRenderTargetView* rtv, TVector4f clearColor)
+	{
+		ValidateRecording();
+	}
+
+	void NullCommandContext::ClearState(TRHIPipelineState* pso)
+	{
+		ValidateRecording();
+		BoundPipelineState = nullptr;
+		NumBoundRenderTargets = 0;
+		bDepthStencilBound = false;
+		bBackBufferBound = false;
+		bIndexBufferBound = false;
+	}
+
+	void NullCommandContext::ClearUnorderedAccessViewUint(RHIResource* resource, TVector4u clearValue)
+	{
+		ValidateRecording();
+	}
+
+	void NullCommandContext::ClearUnorderedAccessViewFloat(RHIResource* resource, TVector4f clearValue)
+	{
+		ValidateRecording();
+	}
+
+	void NullCommandContext::SetIndexBuffer(RHIIndexBufferRef indexBuffer)
+	{
+		ValidateRecording();
+		++Stats.BufferBinds;
+		bIndexBufferBound = indexBuffer.IsValid();
+	}
+
+	void NullCommandContext::SetPrimitiveTopology(ERHIPrimitive type)
+	{
+		ValidateRecording();
+	}
+
+	void NullCommandContext::SetVertexBuffer(uint32 slot, uint32 numViews, RHIVertexBufferRef vertexBuffer)
+	{
+		ValidateRecording();
+		++Stats.BufferBinds;
+	}
+
+	void NullCommandContext::SetRenderTarget(uint32 numRT, TArray<RHIRenderTargetView*> rtvs, RHIDepthStencilView* dsv)
+	{
+		ValidateRecording();
+		++Stats.RenderTargetBinds;
+		if (DynamicRHI->IsValidationEnabled() && (numRT > MaxRenderTargets || numRT > rtvs.size())) [[unlikely]]
+		{
+			ReportValidationError("SetRenderTarget with more targets than views or than the hardware supports");
+		}
+		NumBoundRenderTargets = numRT;
+		bDepthStencilBound = dsv != nullptr;
+		bBackBufferBound = false;
+	}
+
+	void NullCommandContext::SetPipelineState(TRHIPipelineState* pso)
+	{
+		ValidateRecording();
+		++Stats.PSOBinds;
+		BoundPipelineState = pso;
+	}
+
+	void NullCommandContext::BindSRVTable(TShaderRegisterCounts const& shaderRC, const uint64* srvHandles, uint32 count)
+	{
+		ValidateRecording();
+		if (count == 0) [[unlikely]]
+		{
+			return;
+		}
+		++Stats.SRVTableBinds;
+		if (DynamicRHI->IsValidationEnabled() && count > shaderRC.ShaderResourceCount) [[unlikely]]
+		{
+			ReportValidationError("SRV table larger than the shader's resource count");
+		}
+	}
+
+	void NullCommandContext::BindCBVs(TShaderRegisterCounts const& shaderRC, const uint64* cbvHandles, uint32 count)
+	{
+		ValidateRecording();
+		Stats.CBVBinds += count;
+		if (DynamicRHI->IsValidationEnabled() && count > shaderRC.ConstantBufferCount) [[unlikely]]
+		{
+			ReportValidationError("More constant buffers bound than the shader declares");
+		}
+	}
+
+	void NullCommandContext::CopyBufferRegion(RHIResource* dst, uint64 dstOffset, RHIResource* src, uint64 srcOffset, uint64 numBytes)
+	{
+		ValidateRecording();
+		++Stats.Copies;
+		if (DynamicRHI->IsValidationEnabled()
+			&& (dstOffset + numBytes > dst->GetResourceDescriptor()->Width || srcOffset + numBytes > src->GetResourceDescriptor()->Width)) [[unlikely]]
+		{
+			ReportValidationError("CopyBufferRegion out of buffer bounds");
+		}
+	}
+
+	void NullCommandContext::CopyTextureRegion(RHIResource* dst, uint32 dstMip, RHIResource* src, uint32 srcMip, const RHITextureRegion* copyRegion)
+	{
+		ValidateRecording();
+		++Stats.Copies;
+	}
+
+	void NullCommandContext::CopyResource(RHIResource* dst, RHIResource* src)
+	{
+		ValidateRecording();
+		++Stats.Copies;
+	}
+
+	void NullCommandContext::ResolveSubresource(RHIResource* dst, uint32 dstSubId, RHIResource* src, uint32 srcSubId)
+	{
+		ValidateRecording();
+		++Stats.Copies;
+	}
+
+	void NullCommandContext::Dispatch(uint32 threadGroupCountX, uint32 threadGroupCountY, uint32 threadGroupCountZ)
+	{
+		ValidateRecording();
+		++Stats.Dispatches;
+		if (DynamicRHI->IsValidationEnabled()
+			&& (!BoundPipelineState || BoundPipelineState->GetPipelineStateType() != ERHIPipelineStateType::Compute)) [[unlikely]]
+		{
+			ReportValidationError("Dispatch without a compute pipeline state");
+		}
+	}
+
+	void NullCommandContext::DrawIndexedInstanced(uint32 indexCountPerInstance, uint32 instanceCount, uint32 startIndexLocation, int32 baseVertexLocation, uint32 startInstanceLocation)
+	{
+		ValidateDraw(true);
+		++Stats.Draws;
+	}
+
+	void NullCommandContext::DrawInstanced(uint32 vertexCountPerInstance, uint32 instanceCount, uint32 startVertexLocation, uint32 startInstanceLocation)
+	{
+		ValidateDraw(false);
+		++Stats.Draws;
+	}
+
+	void NullCommandContext::Execute()
+	{
+		ValidateRecording();
+		bRecording = false;
+		DynamicRHI->AddCommandStats(Stats);
+		Stats = {};
+	}
+
+	void NullCommandContext::Reset(uint32 index)
+	{
+		bRecording = true;
+		BoundPipelineState = nullptr;
+		NumBoundRenderTargets = 0;
+		bDepthStencilBound = false;
+		bBackBufferBound = false;
+		bIndexBufferBound = false;
+
+		// The new command list starts without bound state or pass.
+		BeginDrawStatePass(nullptr);
+	}
+
+	void NullCommandContext::TransitionBarrier(RHIResource* res, ERHIResourceState oldState, ERHIResourceState newState, uint32 subResource)
+	{
+		ValidateRecording();
+		++Stats.Barriers;
+		if (DynamicRHI->IsValidationEnabled() && oldState == newState) [[unlikely]]
+		{
+			ReportValidationError("Transition barrier between identical states");
+		}
+	}
+
+	void NullCommandContext::AliasingBarrier(RHIResource* before, RHIResource* after)
+	{
+		ValidateRecording();
+		++Stats.Barriers;
+	}
+
+	void NullCommandContext::TransitionBackBufferToRenderTarget()
+	{
+		ValidateRecording();
+		++Stats.Barriers;
+	}
+
+	void NullCommandContext::TransitionBackBufferToPresent()
+	{
+		ValidateRecording();
+		++Stats.Barriers;
+	}
+
+	void NullCommandContext::SetBackBufferAsRenderTarget()
+	{
+		ValidateRecording();
+		++Stats.RenderTargetBinds;
+		NumBoundRenderTargets = 0;
+		bDepthStencilBound = false;
+		bBackBufferBound = true;
+	}
+
+	void NullCommandContext::ValidateRecording()
+	{
+		if (DynamicRHI->IsValidationEnabled() && !bRecording) [[unlikely]]
+		{
+			ReportValidationError("Command recorded into a closed command list");
+		}
+	}
+
+	void NullCommandContext::ValidateDraw(bool bIndexed)
+	{
+		ValidateRecording();
+		if (!DynamicRHI->IsValidationEnabled()) [[likely]]
+		{
+			return;
+		}
+		if (!BoundPipelineState || BoundPipelineState->GetPipelineStateType() != ERHIPipelineStateType::Graphics)
+		{
+			ReportValidationError("Draw without a graphics pipeline state");
+		}
+		if (NumBoundRenderTargets == 0 && !bDepthStencilBound && !bBackBufferBound)
+		{
+			ReportValidationError("Draw without a render target or depth stencil");
+		}
+		if (bIndexed && !bIndexBufferBound)
+		{
+			ReportValidationError("Indexed draw without an index buffer");
+		}
+	}
+
+	void NullCommandContext::ReportValidationError(const char* message)
+	{
+		// Only the first error of a command list is logged, the rest show up in the frame stats.
+		if (Stats.ValidationErrors++ == 0)
+		{
+			LOG("NullRHI validation: %s", message);
+		}
+	}
+}
@@ -0,0 +1,76 @@
+#pragma once
+#include "RHIContext.h"
+#include "NullRHI.h"
+
+namespace Thunder
+{
+	/**
+	 * Records nothing, counts what a GPU command list would receive. With validation on, it also tracks the bound
+	 * state and reports draws missing a pipeline state, render target or index buffer.
+	 */
+	class NullCommandContext : public RHICommandContext
+	{
+	public:
+		NullCommandContext(NullDynamicRHI* inDynamicRHI) : DynamicRHI(inDynamicRHI) {}
+
+		// Clear
+		void ClearDepthStencilView(RHIDepthStencilView* dsv, ERHIClearFlags clearFlags, float depthValue, uint8 stencilValue) override;
+		void ClearRenderTargetView(RHIRenderTargetView* rtv, TVector4f clearColor) override;
+		void ClearState(TRHIPipelineState* pso) override;
+		void ClearUnorderedAccessViewUint(RHIResource* resource, TVector4u clearValue) override;
+		void ClearUnorderedAccessViewFloat(RHIResource* resource, TVector4f clearValue) override;
+
+		// Set
+		void SetIndexBuffer(RHIIndexBufferRef indexBuffer) override;
+		void SetPrimitiveTopology(ERHIPrimitive type) override;
+		void SetVertexBuffer(uint32 slot, uint32 numViews, RHIVertexBufferRef vertexBuffer) override;
+		void SetBlendFactor(TVector4f const& blendFactor) override {}
+		void SetRenderTarget(uint32 numRT, TArray<RHIRenderTargetView*> rtvs, RHIDepthStencilView* dsv = nullptr) override;
+		void SetScissorRects(TArray<RHIRect*> rects) override {}
+		void SetViewports(TArray<RHIViewport*> viewports) override {}
+		void SetPipelineState(TRHIPipelineState* pso) override;
+		void BindSRVTable(TShaderRegisterCounts const& shaderRC, const uint64* srvHandles, uint32 count) override;
+		void BindCBVs(TShaderRegisterCounts const& shaderRC, const uint64* cbvHandles, uint32 count) override;
+
+		// Copy
+		void CopyBufferRegion(RHIResource* dst, uint64 dstOffset, RHIResource* src, uint64 srcOffset, uint64 numBytes) override;
+		void CopyTextureRegion(RHIResource* dst, uint32 dstMip, RHIResource* src, uint32 srcMip, const RHITextureRegion* copyRegion) override;
+		void CopyResource(RHIResource* dst, RHIResource* src) override;
+		void DiscardResource(RHIResource* resource, TArray<RHIRect> const& rects) override {}
+		void ResolveSubresource(RHIResource* dst, uint32 dstSubId, RHIResource* src, uint32 srcSubId) override;
+
+		// Draw
+		void Dispatch(uint32 threadGroupCountX, uint32 threadGroupCountY, uint32 threadGroupCountZ) override;
+		void DrawIndexedInstanced(uint32 indexCountPerInstance, uint32 instanceCount, uint32 startIndexLocation, int32 baseVertexLocation, uint32 startInstanceLocation) override;
+		void DrawInstanced(uint32 vertexCountPerInstance, uint32 instanceCount, uint32 startVertexLocation, uint32 startInstanceLocation) override;
+		void Execute() override;
+
+		// Misc
+		void Reset(uint32 index) override;
+		void BeginFrame() override {}
+		void TransitionBarrier(RHIResource* res, ERHIResourceState oldState, ERHIResourceState newState, uint32 subResource) override;
+		void AliasingBarrier(RHIResource* before, RHIResource* after) override;
+
+		// Backbuffer operations (for present pass)
+		void TransitionBackBufferToRenderTarget() override;
+		void TransitionBackBufferToPresent() override;
+		void ClearBackBuffer(TVector4f clearColor) override {}
+		void SetBackBufferAsRenderTarget() override;
+
+	private:
+		void ValidateRecording();
+		void ValidateDraw(bool bIndexed);
+		void ReportValidationError(const char* message);
+
+		NullDynamicRHI* DynamicRHI = nullptr;
+		NullRHIFrameStats Stats;
+
+		// Validation state, reset with the command list.
+		const TRHIPipelineState* BoundPipelineState = nullptr;
+		uint32 NumBoundRenderTargets = 0;
+		bool bDepthStencilBound = false;
+		bool bBackBufferBound = false;
+		bool bIndexBufferBound = false;
+		bool bRecording = false;
+	};
+}
@@ -0,0 +1,227 @@
+#include "NullRHI.h"
+#include "NullCommandContext.h"
+#include "NullResource.h"
+#include "RHICommand.h"
+#include "CoreModule.h"
+
+namespace Thunder
+{
+	namespace
+	{
+		constexpr uint32 NullRHIStatsInterval = 300; // Frames between stats reports.
+	}
+
+	NullDynamicRHI::NullDynamicRHI()
+	{
+		auto engineConfig = GConfigManager ? GConfigManager->GetConfig("BaseEngine") : nullptr;
+		if (engineConfig && engineConfig->Layout.contains("NullRHIValidation"))
+		{
+			bValidation = engineConfig->GetBool("NullRHIValidation");
+		}
+	}
+
+	RHIDeviceRef NullDynamicRHI::RHICreateDevice()
+	{
+		LOG("Null RHI: no GPU work is submitted");
+		return MakeRefCount<NullDevice>();
+	}
+
+	RHICommandContextRef NullDynamicRHI::RHICreateCommandContext()
+	{
+		return MakeRefCount<NullCommandContext>(this);
+	}
+
+	TRHIGraphicsPipelineState* NullDynamicRHI::RHICreateGraphicsPipelineState(TGraphicsPipelineStateDescriptor& initializer)
+	{
+		return new TRHIGraphicsPipelineState(initializer);
+	}
+
+	uint64 NullDynamicRHI::AllocateDescriptor()
+	{
+		NumDescriptorAllocations.fetch_add(1, std::memory_order_relaxed);
+		return NextDescriptorHandle.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	void NullDynamicRHI::RHICreateConstantBufferView(RHIBuffer& resource, uint32 bufferSize)
+	{
+		resource.SetCBV(new RHIConstantBufferView(RHIViewDescriptor{}, AllocateDescriptor()));
+	}
+
+	void NullDynamicRHI::RHICreateShaderResourceView(RHIResource& resource, const RHIViewDescriptor& desc)
+	{
+		resource.SetSRV(new RHIShaderResourceView(desc, AllocateDescriptor()));
+	}
+
+	void NullDynamicRHI::RHICreateUnorderedAccessView(RHIResource& resource, const RHIViewDescriptor& desc)
+	{
+		resource.SetUAV(new RHIUnorderedAccessView(desc, AllocateDescriptor()));
+	}
+
+	void NullDynamicRHI::RHICreateRenderTargetView(RHITexture& resource, const RHIViewDescriptor& desc)
+	{
+		resource.SetRTV(new RHIRenderTargetView(desc, AllocateDescriptor()));
+	}
+
+	void NullDynamicRHI::RHICreateDepthStencilView(RHITexture& resource, const RHIViewDescriptor& desc)
+	{
+		resource.SetDSV(new RHIDepthStencilView(desc, AllocateDescriptor()));
+	}
+
+	RHISamplerRef NullDynamicRHI::RHICreateSampler(const RHISamplerDescriptor& desc)
+	{
+		NumDescriptorAllocations.fetch_add(1, std::memory_order_relaxed);
+		return MakeRefCount<RHISampler>(desc);
+	}
+
+	RHIFenceRef NullDynamicRHI::RHICreateFence(uint64 initValue, uint32 fenceFlags)
+	{
+		return MakeRefCount<RHIFence>(initValue);
+	}
+
+	RHIVertexBufferRef NullDynamicRHI::RHICreateVertexBuffer(uint32 sizeInBytes, uint32 strideInBytes, EBufferCreateFlags usage, void* resourceData)
+	{
+		if (resourceData)
+		{
+			AddUpload(sizeInBytes);
+		}
+		return MakeRefCount<NullRHIVertexBuffer>(sizeInBytes, resourceData, RHIResourceDescriptor::Buffer(sizeInBytes), usage);
+	}
+
+	RHIIndexBufferRef NullDynamicRHI::RHICreateIndexBuffer(uint32 width, ERHIIndexBufferType type, EBufferCreateFlags usage, void* resourceData)
+	{
+		if (resourceData)
+		{
+			AddUpload(width);
+		}
+		return MakeRefCount<NullRHIIndexBuffer>(width, resourceData, RHIResourceDescriptor::Buffer(width), usage);
+	}
+
+	RHIStructuredBufferRef NullDynamicRHI::RHICreateStructuredBuffer(uint32 size, EBufferCreateFlags usage, void* resourceData)
+	{
+		if (resourceData)
+		{
+			AddUpload(size);
+		}
+		return MakeRefCount<NullRHIStructuredBuffer>(size, resourceData, RHIResourceDescriptor::Buffer(size));
+	}
+
+	RHIConstantBufferRef NullDynamicRHI::RHICreateConstantBuffer(uint32 size, EBufferCreateFlags usage, void* resourceData)
+	{
+		if (resourceData)
+		{
+			AddUpload(size);
+		}
+		return MakeRefCount<NullRHIConstantBuffer>(size, resourceData, RHIResourceDescriptor::Buffer(size));
+	}
+
+	RHIUniformBufferRef NullDynamicRHI::RHICreateUniformBuffer(uint32 size, EUniformBufferFlags usage, const void* Contents)
+	{
+		NullUniformBuffer* newUniformBuffer = new NullUniformBuffer(size, usage);
+		if (Contents)
+		{
+			const uint8* bytes = static_cast<const uint8*>(Contents);
+			newUniformBuffer->Contents.assign(bytes, bytes + size);
+			AddUpload(size);
+		}
+		else
+		{
+			TAssertf(false, "Fail to create uniform buffer.");
+		}
+		return newUniformBuffer;
+	}
+
+	struct RHICommandNullUpdateUniformBuffer : public RHICustomCommand
+	{
+		TRefCountPtr<NullUniformBuffer> UniformBuffer;
+		TArray<uint8> UpdatedContents;
+
+		RHICommandNullUpdateUniformBuffer(NullUniformBuffer* InUniformBuffer, TArray<uint8>&& InUpdatedContents)
+			: RHICustomCommand(&Execute), UniformBuffer(InUniformBuffer), UpdatedContents(std::move(InUpdatedContents)) {}
+
+		static void Execute(RHICustomCommand* command, RHICommandContext* cmdList)
+		{
+			auto* updateCommand = static_cast<RHICommandNullUpdateUniformBuffer*>(command);
+			updateCommand->UniformBuffer->Contents.swap(updateCommand->UpdatedContents);
+		}
+	};
+
+	void NullDynamicRHI::RHIUpdateUniformBuffer(IRHICommandRecorder* recorder, RHIUniformBuffer* uniformBuffer, const void* Contents)
+	{
+		// In render thread, the new contents are swapped in when the RHI thread reaches the command, like a real upload.
+		NullUniformBuffer* nullUB = static_cast<NullUniformBuffer*>(uniformBuffer);
+		const uint8* bytes = static_cast<const uint8*>(Contents);
+		TArray<uint8> updatedContents(bytes, bytes + nullUB->Size);
+		AddUpload(updatedContents.size());
+
+		RHICommandNullUpdateUniformBuffer* newCommand = recorder->NewCommand<RHICommandNullUpdateUniformBuffer>(nullUB, std::move(updatedContents));
+		recorder->AddCommand(newCommand);
+	}
+
+	RHITextureRef NullDynamicRHI::RHICreateTexture(const RHIResourceDescriptor& desc, ETextureCreateFlags usage, void* resourceData)
+	{
+		if (resourceData)
+		{
+			AddUpload(desc.Width * desc.Height * desc.DepthOrArraySize * GetFormatBytesPerPixel(desc.Format));
+		}
+		return MakeRefCount<NullRHITexture>(desc, usage);
+	}
+
+	bool NullDynamicRHI::RHIUpdateSharedMemoryResource(RHIResource* resource, const void* resourceData, uint32 size, uint8 subresourceId)
+	{
+		if (resource->GetResourceDescriptor()->Type == ERHIResourceType::Buffer)
+		{
+			// Buffers keep their memory, the update lands in it like a write to a mapped upload heap.
+			auto* buffer = static_cast<uint8*>(resource->GetResource());
+			const uint64 bufferSize = resource->GetResourceDescriptor()->Width;
+			if (size > bufferSize) [[unlikely]]
+			{
+				TAssertf(false, "Update of %u bytes overflows a %llu bytes buffer", size, bufferSize);
+				return false;
+			}
+			memcpy(buffer, resourceData, size);
+		}
+		AddUpload(size);
+		return true;
+	}
+
+	void NullDynamicRHI::RHISignalFence(uint32 frameIndex)
+	{
+		// Contexts have executed, the frame is complete.
+		NullRHIFrameStats stats;
+		{
+			auto lock = StatsLock.Guard();
+			stats = PendingStats;
+			PendingStats = {};
+			stats.Uploads = NumUploads.exchange(0, std::memory_order_relaxed);
+			stats.UploadBytes = NumUploadBytes.exchange(0, std::memory_order_relaxed);
+			stats.DescriptorAllocations = NumDescriptorAllocations.exchange(0, std::memory_order_relaxed);
+			LastFrameStats = stats;
+		}
+
+		if (++NumFrames % NullRHIStatsInterval == 0)
+		{
+			LOG("Null RHI frame: %llu draws, %llu dispatches, %llu PSO binds, %llu SRV tables, %llu CBVs, %llu buffer binds, %llu render target binds, "
+				"%llu barriers, %llu copies, %llu uploads (%llu bytes), %llu descriptors, %llu validation errors",
+				stats.Draws, stats.Dispatches, stats.PSOBinds, stats.SRVTableBinds, stats.CBVBinds, stats.BufferBinds, stats.RenderTargetBinds,
+				stats.Barriers, stats.Copies, stats.Uploads, stats.UploadBytes, stats.DescriptorAllocations, stats.ValidationErrors);
+		}
+	}
+
+	void NullDynamicRHI::AddCommandStats(const NullRHIFrameStats& stats)
+	{
+		auto lock = StatsLock.Guard();
+		PendingStats += stats;
+	}
+
+	void NullDynamicRHI::AddUpload(uint64 numBytes)
+	{
+		NumUploads.fetch_add(1, std::memory_order_relaxed);
+		NumUploadBytes.fetch_add(numBytes, std::memory_order_relaxed);
+	}
+
+	NullRHIFrameStats NullDynamicRHI::GetLastFrameStats() const
+	{
+		auto lock = StatsLock.Guard();
+		return LastFrameStats;
+	}
+}
@@ -0,0 +1,25 @@
+#include "NullRHIModule.h"
+#include "NullRHI.h"
+#include "Module/ModuleManager.h"
+#include "PipelineStateCache.h"
+
+namespace Thunder
+{
+	IMPLEMENT_MODULE(NullRHI, TNullRHIModule)
+
+	void TNullRHIModule::StartUp()
+	{
+		IRHIModule::ModuleInstance = this;
+
+		DynamicRHI = new NullDynamicRHI();
+		GDynamicRHI = DynamicRHI;
+	}
+
+	void TNullRHIModule::ShutDown()
+	{
+		ClearPipelineStateCache();
+		delete DynamicRHI;
+		GDynamicRHI = nullptr;
+		IRHIModule::ModuleInstance = nullptr;
+	}
+}
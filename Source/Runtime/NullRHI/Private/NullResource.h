@@ -0,0 +1,61 @@
+#pragma once
+#include "RHIResource.h"
+#include "UniformBuffer.h"
+
+namespace Thunder
+{
+	class NullDevice : public RHIDevice
+	{
+	};
+
+	/**
+	 * Buffers keep their contents in CPU memory, so creation and updates copy as much as a real upload would.
+	 */
+	template<typename BufferType>
+	class TNullRHIBuffer : public BufferType
+	{
+	public:
+		template<typename... ArgTypes>
+		TNullRHIBuffer(uint32 size, const void* resourceData, ArgTypes&&... args)
+			: BufferType(std::forward<ArgTypes>(args)...), Memory(size)
+		{
+			if (resourceData && size > 0)
+			{
+				memcpy(Memory.data(), resourceData, size);
+			}
+		}
+
+		_NODISCARD_ void* GetResource() const override { return const_cast<uint8*>(Memory.data()); }
+		_NODISCARD_ uint64 GetSize() const { return Memory.size(); }
+
+	private:
+		TArray<uint8> Memory;
+	};
+
+	using NullRHIVertexBuffer = TNullRHIBuffer<RHIVertexBuffer>;
+	using NullRHIIndexBuffer = TNullRHIBuffer<RHIIndexBuffer>;
+	using NullRHIStructuredBuffer = TNullRHIBuffer<RHIStructuredBuffer>;
+	using NullRHIConstantBuffer = TNullRHIBuffer<RHIConstantBuffer>;
+
+	// Texels are never read back, only the descriptor is kept.
+	class NullRHITexture : public RHITexture
+	{
+	public:
+		NullRHITexture(RHIResourceDescriptor const& desc, ETextureCreateFlags const& flags) : RHITexture(desc, flags) {}
+
+		_NODISCARD_ void* GetResource() const override { return const_cast<NullRHITexture*>(this); }
+	};
+
+	class NullUniformBuffer : public RHIUniformBuffer
+	{
+	public:
+		NullUniformBuffer(uint32 size, EUniformBufferFlags usage) : RHIUniformBuffer(usage), Size(size) {}
+
+		_NODISCARD_ void* GetResource() const override { return const_cast<uint8*>(Contents.data()); }
+		uint64 GetGpuVirtualAddress() override { return reinterpret_cast<uint64>(Contents.data()); }
+
+		// Fixed at creation, the render thread reads it while the RHI thread swaps in new contents.
+		const uint32 Size;
+		TArray<uint8> Contents;
+	};
+}
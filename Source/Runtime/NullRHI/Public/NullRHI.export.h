@@ -0,0 +1,43 @@
+
+#ifndef NULLRHI_API_H
+#define NULLRHI_API_H
+
+#ifdef NULLRHI_STATIC_DEFINE
+#  define NULLRHI_API
+#  define NULLRHI_NO_EXPORT
+#else
+#  ifndef NULLRHI_API
+#    ifdef NULLRHI_EXPORTS
+        /* We are building this library */
+#      define NULLRHI_API __declspec(dllexport)
+#    else
+        /* We are using this library */
+#      define NULLRHI_API __declspec(dllimport)
+#    endif
+#  endif
+
+#  ifndef NULLRHI_NO_EXPORT
+#    define NULLRHI_NO_EXPORT 
+#  endif
+#endif
+
+#ifndef NULLRHI_DEPRECATED
+#  define NULLRHI_DEPRECATED __declspec(deprecated)
+#endif
+
+#ifndef NULLRHI_DEPRECATED_EXPORT
+#  define NULLRHI_DEPRECATED_EXPORT NULLRHI_API NULLRHI_DEPRECATED
+#endif
+
+#ifndef NULLRHI_DEPRECATED_NO_EXPORT
+#  define NULLRHI_DEPRECATED_NO_EXPORT NULLRHI_NO_EXPORT NULLRHI_DEPRECATED
+#endif
+
+/* NOLINTNEXTLINE(readability-avoid-unconditional-preprocessor-if) */
+#if 0 /* DEFINE_NO_DEPRECATED */
+#  ifndef NULLRHI_NO_DEPRECATED
+#    define NULLRHI_NO_DEPRECATED
+#  endif
+#endif
+
+#endif /* NULLRHI_API_H */
@@ -0,0 +1,126 @@
+#pragma once
+#include <atomic>
+#include "IDynamicRHI.h"
+
+namespace Thunder
+{
+	/**
+	 * Work one frame would have handed to the GPU, gathered from the command contexts and the uploads.
+	 */
+	struct NullRHIFrameStats
+	{
+		uint64 Draws = 0;
+		uint64 Dispatches = 0;
+		uint64 PSOBinds = 0;
+		uint64 SRVTableBinds = 0;
+		uint64 CBVBinds = 0;
+		uint64 BufferBinds = 0;
+		uint64 RenderTargetBinds = 0;
+		uint64 Barriers = 0;
+		uint64 Copies = 0;
+		uint64 Uploads = 0;
+		uint64 UploadBytes = 0;
+		uint64 DescriptorAllocations = 0;
+		uint64 ValidationErrors = 0;
+
+		NullRHIFrameStats& operator+=(const NullRHIFrameStats& rhs)
+		{
+			Draws += rhs.Draws;
+			Dispatches += rhs.Dispatches;
+			PSOBinds += rhs.PSOBinds;
+			SRVTableBinds += rhs.SRVTableBinds;
+			CBVBinds += rhs.CBVBinds;
+			BufferBinds += rhs.BufferBinds;
+			RenderTargetBinds += rhs.RenderTargetBinds;
+			Barriers += rhs.Barriers;
+			Copies += rhs.Copies;
+			Uploads += rhs.Uploads;
+			UploadBytes += rhs.UploadBytes;
+			DescriptorAllocations += rhs.DescriptorAllocations;
+			ValidationErrors += rhs.ValidationErrors;
+			return *this;
+		}
+	};
+
+	/**
+	 * Headless backend: resources are CPU-side stubs and command contexts only count what they record, so the render
+	 * and RHI thread paths run and profile without a GPU. Selected with "RHI" : "Null" in BaseEngine.json,
+	 * "NullRHIValidation" checks bind and draw sequences. Neither this module nor the RHI headers it builds on pull in
+	 * D3D12, DXGI or DXC, the core and platform layers are still Win32 so the base Windows SDK is required.
+	 */
+	class NullDynamicRHI : public IDynamicRHI
+	{
+	public:
+		NULLRHI_API NullDynamicRHI();
+		NULLRHI_API virtual ~NullDynamicRHI() = default;
+
+		/////// RHI Methods
+		NULLRHI_API RHIDeviceRef RHICreateDevice() override;
+
+		NULLRHI_API RHICommandContextRef RHICreateCommandContext() override;
+
+		NULLRHI_API TRHIGraphicsPipelineState* RHICreateGraphicsPipelineState(TGraphicsPipelineStateDescriptor& initializer) override;
+
+		NULLRHI_API void RHICreateComputePipelineState() override {}
+
+		NULLRHI_API void RHICreateConstantBufferView(RHIBuffer& resource, uint32 bufferSize) override;
+
+		NULLRHI_API void RHICreateShaderResourceView(RHIResource& resource, const RHIViewDescriptor& desc) override;
+
+		NULLRHI_API void RHICreateUnorderedAccessView(RHIResource& resource, const RHIViewDescriptor& desc) override;
+
+		NULLRHI_API void RHICreateRenderTargetView(RHITexture& resource, const RHIViewDescriptor& desc) override;
+
+		NULLRHI_API void RHICreateDepthStencilView(RHITexture& resource, const RHIViewDescriptor& desc) override;
+
+		NULLRHI_API RHISamplerRef RHICreateSampler(const RHISamplerDescriptor& desc) override;
+
+		NULLRHI_API RHIFenceRef RHICreateFence(uint64 initValue, uint32 fenceFlags) override;
+
+		NULLRHI_API RHIVertexBufferRef RHICreateVertexBuffer(uint32 sizeInBytes, uint32 strideInBytes, EBufferCreateFlags usage, void* resourceData = nullptr) override;
+
+		NULLRHI_API RHIIndexBufferRef RHICreateIndexBuffer(uint32 width, ERHIIndexBufferType type, EBufferCreateFlags usage, void* resourceData = nullptr) override;
+
+		NULLRHI_API RHIStructuredBufferRef RHICreateStructuredBuffer(uint32 size, EBufferCreateFlags usage, void* resourceData = nullptr) override;
+
+		NULLRHI_API RHIConstantBufferRef RHICreateConstantBuffer(uint32 size, EBufferCreateFlags usage, void* resourceData = nullptr) override;
+
+		NULLRHI_API RHIUniformBufferRef RHICreateUniformBuffer(uint32 size, EUniformBufferFlags usage, const void* Contents) override;
+
+		NULLRHI_API void RHIUpdateUniformBuffer(IRHICommandRecorder* recorder, RHIUniformBuffer* unformBuffer, const void* Contents) override;
+
+		NULLRHI_API RHITextureRef RHICreateTexture(const RHIResourceDescriptor& desc, ETextureCreateFlags usage, void* resourceData = nullptr) override;
+
+		NULLRHI_API bool RHIUpdateSharedMemoryResource(RHIResource* resource, const void* resourceData, uint32 size, uint8 subresourceId) override;
+
+		NULLRHI_API void RHIReleaseResource_RenderThread() override {}
+		NULLRHI_API void RHIReleaseResource_RHIThread() override {}
+
+		NULLRHI_API void RHIBeginFrame(uint32 frameIndex) override {}
+
+		NULLRHI_API void RHISignalFence(uint32 frameIndex) override;
+
+		NULLRHI_API void RHIWaitForFrame(uint32 frameIndex) override {}
+
+		// Counters, called by the command contexts.
+		bool IsValidationEnabled() const { return bValidation; }
+		void AddCommandStats(const NullRHIFrameStats& stats);
+		void AddUpload(uint64 numBytes);
+
+		NULLRHI_API NullRHIFrameStats GetLastFrameStats() const;
+
+	private:
+		uint64 AllocateDescriptor();
+
+		bool bValidation = false;
+		std::atomic<uint64> NextDescriptorHandle { 1 };
+		std::atomic<uint64> NumUploads { 0 };
+		std::atomic<uint64> NumUploadBytes { 0 };
+		std::atomic<uint64> NumDescriptorAllocations { 0 };
+
+		mutable SpinLock StatsLock;
+		NullRHIFrameStats PendingStats;
+		NullRHIFrameStats LastFrameStats;
+		uint32 NumFrames = 0;
+	};
+}
@@ -0,0 +1,14 @@
+#pragma once
+#include "IDynamicRHI.h"
+#include "IRHIModule.h"
+
+namespace Thunder
+{
+	class TNullRHIModule : public IRHIModule
+	{
+		DECLARE_MODULE_WITH_SUPER(NullRHI, TNullRHIModule, IRHIModule, NULLRHI_API)
+	public:
+		NULLRHI_API void StartUp() override;
+		NULLRHI_API void ShutDown() override;
+	};
+}
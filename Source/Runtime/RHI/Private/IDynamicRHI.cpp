@@ -4,12 +4,12 @@
 namespace Thunder
 {
 	IDynamicRHI* GDynamicRHI = nullptr;
-	std::atomic_uint64_t GCachedMeshDrawCommandIndex = 0;
 
 	void IDynamicRHI::DeferredDeleteResource(TRefCountPtr<RHIResource> resource)
 	{
 		//render thread
 		uint32 index = GFrameState->FrameNumberRenderThread.load(std::memory_order_acquire) % MAX_FRAME_LAG;
+		auto guard = DeferredDeleteLock.Guard();
 		DeferredDeleteQueue[index].push_back(std::move(resource));
 	}
 
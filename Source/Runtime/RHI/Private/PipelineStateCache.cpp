@@ -1,10 +1,133 @@
 ﻿#include "PipelineStateCache.h"
+#include <cstddef>
 #include "IDynamicRHI.h"
+#include "Concurrent/Lock.h"
 
 namespace Thunder
 {
-    void SetGraphicsPipelineState(RenderContext* context, TGraphicsPipelineStateDescriptor& Initializer)
+    namespace
     {
-        auto pipelineStateObject = RHICreateGraphicsPipelineState(Initializer);
+        constexpr uint32 PipelineStateCacheShardBits = 4; // Top bits of the key hash pick the shard.
+        constexpr uint32 NumPipelineStateCacheShards = 1u << PipelineStateCacheShardBits;
+        constexpr uint64 KeyHashedBytes = offsetof(GraphicsPipelineStateKey, Hash);
+        static_assert(KeyHashedBytes % sizeof(uint64) == 0);
+
+        struct alignas(PLATFORM_CACHE_LINE_SIZE) PipelineStateCacheShard
+        {
+            SharedLock Lock;
+            THashMap<GraphicsPipelineStateKey, TRefCountPtr<TRHIGraphicsPipelineState>> Entries;
+            std::atomic<uint64> Hits { 0 }; // Per shard so that lookups from many threads don't share one counter.
+            std::atomic<uint64> Misses { 0 };
+        };
+
+        PipelineStateCacheShard* GetShards()
+        {
+            static PipelineStateCacheShard shards[NumPipelineStateCacheShards];
+            return shards;
+        }
+
+        FORCEINLINE PipelineStateCacheShard& GetShard(uint64 hash)
+        {
+            return GetShards()[hash >> (64 - PipelineStateCacheShardBits)];
+        }
+    }
+
+    bool GraphicsPipelineStateKey::Build(const TGraphicsPipelineStateDescriptor& desc)
+    {
+        const size_t numVertexElements = desc.VertexDeclaration.Elements.size();
+        if (numVertexElements > MaxVertexElementCount) [[unlikely]]
+        {
+            TAssertf(false, "Too many vertex elements in declaration: %zu.", numVertexElements);
+            return false;
+        }
+
+        // Unused elements and padding take part in the hash and the comparison, they must be zero.
+        memset(this, 0, sizeof(GraphicsPipelineStateKey));
+        Shader = desc.shaderVariant;
+        Pass = desc.Pass;
+        for (size_t index = 0; index < numVertexElements; ++index)
+        {
+            memcpy(VertexElements[index], desc.VertexDeclaration.Elements[index].Hash, sizeof(VertexElements[index]));
+        }
+        memcpy(BlendState, desc.BlendState.Hash, sizeof(BlendState));
+        memcpy(RasterizerState, desc.RasterizerState.Hash, sizeof(RasterizerState));
+        memcpy(DepthStencilState, desc.DepthStencilState.Hash, sizeof(DepthStencilState));
+        memcpy(RegisterCounts, desc.RegisterCounts.Hash, sizeof(RegisterCounts));
+        NumVertexElements = static_cast<uint8>(numVertexElements);
+        PrimitiveType = static_cast<uint8>(desc.PrimitiveType);
+        NumSamples = desc.NumSamples;
+
+        // Word-at-a-time multiply-xorshift, finalized so that the top bits (shard index) are well mixed.
+        uint64 hash = 0x9e3779b97f4a7c15ull;
+        const byte* bytes = reinterpret_cast<const byte*>(this);
+        for (uint64 offset = 0; offset < KeyHashedBytes; offset += sizeof(uint64))
+        {
+            uint64 word;
+            memcpy(&word, bytes + offset, sizeof(word));
+            hash = (hash ^ word) * 0xff51afd7ed558ccdull;
+            hash ^= hash >> 32;
+        }
+        hash ^= hash >> 33;
+        hash *= 0xc4ceb9fe1a85ec53ull;
+        hash ^= hash >> 33;
+        Hash = hash;
+        return true;
+    }
+
+    TRHIGraphicsPipelineState* GetGraphicsPipelineState(TGraphicsPipelineStateDescriptor& desc)
+    {
+        GraphicsPipelineStateKey key;
+        if (!key.Build(desc)) [[unlikely]]
+        {
+            return RHICreateGraphicsPipelineState(desc);
+        }
+
+        PipelineStateCacheShard& shard = GetShard(key.Hash);
+        {
+            auto lock = shard.Lock.Read();
+            const auto psoIt = shard.Entries.find(key);
+            if (psoIt != shard.Entries.end()) [[likely]]
+            {
+                shard.Hits.fetch_add(1, std::memory_order_relaxed);
+                return psoIt->second.Get();
+            }
+        }
+
+        // Miss, the backend compiles (or finds) it outside of the shard lock.
+        shard.Misses.fetch_add(1, std::memory_order_relaxed);
+        TRHIGraphicsPipelineState* pso = RHICreateGraphicsPipelineState(desc);
+        if (!pso) [[unlikely]]
+        {
+            return nullptr;
+        }
+
+        // Another thread may have inserted it meanwhile, keep the first one.
+        auto lock = shard.Lock.Write();
+        return shard.Entries.try_emplace(key, pso).first->second.Get();
+    }
+
+    PipelineStateCacheStats GetPipelineStateCacheStats()
+    {
+        PipelineStateCacheStats stats;
+        PipelineStateCacheShard* shards = GetShards();
+        for (uint32 index = 0; index < NumPipelineStateCacheShards; ++index)
+        {
+            PipelineStateCacheShard& shard = shards[index];
+            stats.Hits += shard.Hits.load(std::memory_order_relaxed);
+            stats.Misses += shard.Misses.load(std::memory_order_relaxed);
+            auto lock = shard.Lock.Read();
+            stats.NumEntries += static_cast<uint32>(shard.Entries.size());
+        }
+        return stats;
+    }
+
+    void ClearPipelineStateCache()
+    {
+        PipelineStateCacheShard* shards = GetShards();
+        for (uint32 index = 0; index < NumPipelineStateCacheShards; ++index)
+        {
+            auto lock = shards[index].Lock.Write();
+            shards[index].Entries.clear();
+        }
     }
 }
@@ -7,17 +7,78 @@
 
 namespace Thunder
 {
+    void IRHICommand::Dispatch(RHICommandContext* cmdList)
+    {
+        switch (Type)
+        {
+        case ERHICommandType::Dummy:
+            static_cast<RHIDummyCommand*>(this)->Execute(cmdList);
+            break;
+        case ERHICommandType::BeginFrame:
+            static_cast<RHIBeginFrameCommand*>(this)->Execute(cmdList);
+            break;
+        case ERHICommandType::BeginCommandList:
+            static_cast<RHIBeginCommandListCommand*>(this)->Execute(cmdList);
+            break;
+        case ERHICommandType::Draw:
+            static_cast<RHIDrawCommand*>(this)->Execute(cmdList);
+            break;
+        case ERHICommandType::BeginPass:
+            static_cast<RHIBeginPassCommand*>(this)->Execute(cmdList);
+            break;
+        case ERHICommandType::EndPass:
+            static_cast<RHIEndPassCommand*>(this)->Execute(cmdList);
+            break;
+        case ERHICommandType::UpdateBufferRegions:
+            static_cast<RHIUpdateBufferRegionsCommand*>(this)->Execute(cmdList);
+            break;
+        case ERHICommandType::Custom:
+        {
+            auto* customCommand = static_cast<RHICustomCommand*>(this);
+            customCommand->ExecuteFunction(customCommand, cmdList);
+            break;
+        }
+        default:
+            TAssertf(false, "Unknown RHI command type %u.", static_cast<uint32>(Type));
+            break;
+        }
+    }
+
     void RHIDummyCommand::Execute(RHICommandContext* cmdList)
     {
     }
 
+    void RHICommandContext::BeginDrawStatePass(RHIPassState* passState)
+    {
+        FlushDrawStateStats();
+        InvalidateDrawState();
+        CurrentPassState = passState;
+    }
+
+    void RHICommandContext::FlushDrawStateStats()
+    {
+        if (CurrentPassState)
+        {
+            CurrentPassState->PSOBinds.fetch_add(DrawStateCache.PSOBinds, std::memory_order_relaxed);
+            CurrentPassState->PSOBindsSkipped.fetch_add(DrawStateCache.PSOBindsSkipped, std::memory_order_relaxed);
+            CurrentPassState->SRVTableBinds.fetch_add(DrawStateCache.SRVTableBinds, std::memory_order_relaxed);
+            CurrentPassState->SRVTableBindsSkipped.fetch_add(DrawStateCache.SRVTableBindsSkipped, std::memory_order_relaxed);
+        }
+        DrawStateCache.PSOBinds = 0;
+        DrawStateCache.PSOBindsSkipped = 0;
+        DrawStateCache.SRVTableBinds = 0;
+        DrawStateCache.SRVTableBindsSkipped = 0;
+    }
+
     void RHIBeginFrameCommand::Execute(RHICommandContext* cmdList)
     {
         cmdList->BeginFrame();
+        cmdList->InvalidateDrawState();
     }
 
     void RHIBeginCommandListCommand::Execute(RHICommandContext* cmdList)
     {
+        cmdList->BeginDrawStatePass(PassState);
         if (PassState->bIsBackBufferPass)
         {
             // Present pass: restore the backbuffer as the render target for this command list.
@@ -47,8 +108,18 @@ namespace Thunder
 
     void RHIDrawCommand::Execute(RHICommandContext* cmdList)
     {
-        // Set pipeline state.
-        BindPSO(cmdList);
+        // Set pipeline state, draw lists sorted by SortKey keep consecutive draws on the same PSO.
+        RHIDrawStateCache& stateCache = cmdList->GetDrawStateCache();
+        if (GraphicsPSO != stateCache.PipelineState)
+        {
+            BindPSO(cmdList);
+            stateCache.PipelineState = GraphicsPSO;
+            ++stateCache.PSOBinds;
+        }
+        else
+        {
+            ++stateCache.PSOBindsSkipped;
+        }
 
         // Build and set SRV table.
         BindSRVTable(cmdList);
@@ -111,12 +182,31 @@ namespace Thunder
             maxSlotUsedCount = std::max<uint32>(srvSlot + 1, maxSlotUsedCount);
         }
 
-        // Bind SRVs.
+        // Bind SRVs, unless the previous draw on this context bound the same table with the same shader.
+        RHIDrawStateCache& stateCache = cmdList->GetDrawStateCache();
         if (maxSlotUsedCount > 0)
         {
+            if (stateCache.SRVShader == Shader && stateCache.SRVCount == maxSlotUsedCount
+                && memcmp(stateCache.SRVHandles, srvHandles, sizeof(uint64) * maxSlotUsedCount) == 0)
+            {
+                ++stateCache.SRVTableBindsSkipped;
+                return;
+            }
+
             uint32 srvCount = maxSlotUsedCount;
             TShaderRegisterCounts const& shaderRC = Shader->GetSubShader()->GetShaderRegisterCounts();
             cmdList->BindSRVTable(shaderRC, srvHandles, srvCount);
+
+            stateCache.SRVShader = Shader;
+            stateCache.SRVCount = srvCount;
+            memcpy(stateCache.SRVHandles, srvHandles, sizeof(uint64) * srvCount);
+            ++stateCache.SRVTableBinds;
+        }
+        else
+        {
+            // The root signature may change without a table bind, forget the last one.
+            stateCache.SRVShader = nullptr;
+            stateCache.SRVCount = 0;
         }
     }
 
@@ -165,6 +255,8 @@ namespace Thunder
 
     void RHIBeginPassCommand::Execute(RHICommandContext* cmdList)
     {
+        cmdList->BeginDrawStatePass(PassState);
+
         // Transition read targets to shader-readable states.
         for (auto& readRes : ReadRenderTargets)
         {
@@ -195,9 +287,14 @@ namespace Thunder
             return;
         }
 
+        // Aliased memory holds another target's data: activate the target, then clear or discard it before use.
         TArray<RHIRenderTargetView*> rtvPtrs(RenderTargetCount);
         for (uint32 i = 0; i < RenderTargetCount; i++)
         {
+            if (RenderTargets[i].bAliasingBarrier)
+            {
+                cmdList->AliasingBarrier(nullptr, RenderTargets[i].Texture.Get());
+            }
             if (RenderTargets[i].bNeedBarrier)
             {
                 cmdList->TransitionBarrier(RenderTargets[i].Texture.Get(), RenderTargets[i].OldState, ERHIResourceState::RenderTarget);
@@ -207,10 +304,18 @@ namespace Thunder
             {
                 cmdList->ClearRenderTargetView(rtvPtrs[i], RenderTargets[i].ClearColor);
             }
+            else if (RenderTargets[i].bAliasingBarrier)
+            {
+                cmdList->DiscardResource(RenderTargets[i].Texture.Get(), {});
+            }
         }
         RHIDepthStencilView* dsv = nullptr;
         if (DepthStencil.Texture.IsValid())
         {
+            if (DepthStencil.bAliasingBarrier)
+            {
+                cmdList->AliasingBarrier(nullptr, DepthStencil.Texture.Get());
+            }
             if (DepthStencil.bNeedBarrier)
             {
                 cmdList->TransitionBarrier(DepthStencil.Texture.Get(), DepthStencil.OldState, ERHIResourceState::DepthWrite);
@@ -220,6 +325,10 @@ namespace Thunder
             {
                 cmdList->ClearDepthStencilView(dsv, ERHIClearFlags::DepthStencil, DepthStencil.ClearDepth, DepthStencil.ClearStencil);
             }
+            else if (DepthStencil.bAliasingBarrier)
+            {
+                cmdList->DiscardResource(DepthStencil.Texture.Get(), {});
+            }
         }
 
         cmdList->SetRenderTarget(RenderTargetCount, rtvPtrs, dsv);
@@ -233,4 +342,20 @@ namespace Thunder
             cmdList->TransitionBackBufferToPresent();
         }
     }
+
+    void RHIUpdateBufferRegionsCommand::Execute(RHICommandContext* cmdList)
+    {
+        if (!Destination.IsValid() || !Source.IsValid() || NumRegions == 0) [[unlikely]]
+        {
+            return;
+        }
+
+        cmdList->TransitionBarrier(Destination.Get(), ERHIResourceState::Common, ERHIResourceState::CopyDest);
+        for (uint32 regionIndex = 0; regionIndex < NumRegions; ++regionIndex)
+        {
+            RHIBufferCopyRegion const& region = Regions[regionIndex];
+            cmdList->CopyBufferRegion(Destination.Get(), region.DstOffset, Source.Get(), region.SrcOffset, region.NumBytes);
+        }
+        cmdList->TransitionBarrier(Destination.Get(), ERHIResourceState::CopyDest, ERHIResourceState::AllShaderResource);
+    }
 }
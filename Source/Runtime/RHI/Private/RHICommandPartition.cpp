@@ -0,0 +1,173 @@
+#include "RHICommandPartition.h"
+#include <algorithm>
+
+namespace Thunder
+{
+    namespace
+    {
+        constexpr uint32 DrawCost = 8;               // Root descriptors and the draw call itself.
+        constexpr uint32 PSOBindCost = 16;
+        constexpr uint32 SRVTableBindCost = 6;       // The table is rebuilt when the shader changes.
+        constexpr uint32 BufferBindCost = 2;
+        constexpr uint32 MaxGeometryCost = 4;        // The CPU side of a draw barely depends on its size.
+        constexpr uint32 GeometryCostShift = 16;
+        constexpr uint32 PassBeginCost = 16;
+        constexpr uint32 PassTargetCost = 6;         // Barrier, clear or discard of one target.
+        constexpr uint32 PassEndCost = 4;
+        constexpr uint32 CopyRegionCost = 2;
+        constexpr uint32 DefaultCommandCost = 4;
+        constexpr uint32 NoPass = ~0u;
+
+        uint32 EstimateDrawCost(const RHIDrawCommand* draw, const RHIDrawCommand* previousDraw)
+        {
+            uint32 cost = DrawCost;
+            if (!previousDraw || previousDraw->GraphicsPSO != draw->GraphicsPSO)
+            {
+                cost += PSOBindCost;
+            }
+            if (!previousDraw || previousDraw->Shader != draw->Shader)
+            {
+                cost += SRVTableBindCost;
+            }
+            if (!previousDraw || previousDraw->VBToSet != draw->VBToSet || previousDraw->IBToSet != draw->IBToSet)
+            {
+                cost += BufferBindCost;
+            }
+            const uint64 numElements = static_cast<uint64>(draw->IBToSet ? draw->IndexCount : draw->VertexCount) * draw->InstanceCount;
+            return cost + static_cast<uint32>(std::min<uint64>(numElements >> GeometryCostShift, MaxGeometryCost));
+        }
+
+        uint32 EstimateBeginPassCost(const RHIBeginPassCommand* beginPass)
+        {
+            uint32 numTargets = beginPass->RenderTargetCount + static_cast<uint32>(beginPass->ReadRenderTargets.size());
+            numTargets += beginPass->DepthStencil.Texture.IsValid() ? 1 : 0;
+            numTargets += beginPass->ReadDepthStencil.Texture.IsValid() ? 1 : 0;
+            numTargets += beginPass->bIsBackBufferPass ? 1 : 0;
+            return PassBeginCost + PassTargetCost * numTargets;
+        }
+    }
+
+    uint32 EstimateRHICommandCost(const IRHICommand* command, const RHIDrawCommand* previousDraw)
+    {
+        switch (command->Type)
+        {
+        case ERHICommandType::Draw:
+            return EstimateDrawCost(static_cast<const RHIDrawCommand*>(command), previousDraw);
+        case ERHICommandType::BeginPass:
+            return EstimateBeginPassCost(static_cast<const RHIBeginPassCommand*>(command));
+        case ERHICommandType::EndPass:
+            return PassEndCost;
+        case ERHICommandType::UpdateBufferRegions:
+            return DefaultCommandCost + CopyRegionCost * static_cast<const RHIUpdateBufferRegionsCommand*>(command)->NumRegions;
+        case ERHICommandType::Dummy:
+            return 1;
+        default:
+            return DefaultCommandCost;
+        }
+    }
+
+    void RHICommandPartitioner::Partition(const TArray<IRHICommand*>& commands, uint32 numChunks, TArray<RHICommandChunk>& outChunks)
+    {
+        outChunks.clear();
+        const uint32 numCommands = static_cast<uint32>(commands.size());
+        if (numCommands == 0 || numChunks == 0)
+        {
+            PrefixCosts.clear();
+            return;
+        }
+
+        // Prefix-summed costs, with the pass each command records into. A begin pass sets its own state, so a chunk
+        // starting there or between passes has nothing to replay.
+        PrefixCosts.resize(numCommands + 1);
+        OpenPassBegins.resize(numCommands + 1);
+        PassBoundaries.clear();
+        PrefixCosts[0] = 0;
+        const RHIDrawCommand* previousDraw = nullptr;
+        uint32 openPass = NoPass;
+        for (uint32 index = 0; index < numCommands; ++index)
+        {
+            const IRHICommand* command = commands[index];
+            if (command->Type == ERHICommandType::BeginPass)
+            {
+                openPass = NoPass;
+                if (PassBoundaries.empty() || PassBoundaries.back() != index)
+                {
+                    PassBoundaries.push_back(index);
+                }
+            }
+            OpenPassBegins[index] = openPass;
+            PrefixCosts[index + 1] = PrefixCosts[index] + EstimateRHICommandCost(command, previousDraw);
+
+            switch (command->Type)
+            {
+            case ERHICommandType::Draw:
+                previousDraw = static_cast<const RHIDrawCommand*>(command);
+                break;
+            case ERHICommandType::BeginPass:
+                openPass = index;
+                previousDraw = nullptr; // Draw state is invalidated at pass begin.
+                break;
+            case ERHICommandType::EndPass:
+                openPass = NoPass;
+                previousDraw = nullptr;
+                PassBoundaries.push_back(index + 1);
+                break;
+            default:
+                break;
+            }
+        }
+        OpenPassBegins[numCommands] = NoPass;
+
+        // Cut at even shares of the total cost, the last chunk takes the rest.
+        const uint64 totalCost = PrefixCosts[numCommands];
+        uint32 begin = 0;
+        for (uint32 chunk = 1; chunk <= numChunks && begin < numCommands; ++chunk)
+        {
+            const uint32 end = chunk == numChunks ? numCommands : FindSplit(totalCost * chunk / numChunks, begin);
+            if (end > begin)
+            {
+                outChunks.push_back({ begin, end, OpenPassBegins[begin], PrefixCosts[end] - PrefixCosts[begin] });
+                begin = end;
+            }
+        }
+    }
+
+    uint32 RHICommandPartitioner::FindSplit(uint64 targetCost, uint32 minSplit) const
+    {
+        // First cut reaching the target. Inside a pass, a boundary is taken instead while it moves less cost than
+        // replaying the pass's state would add.
+        const uint32 split = static_cast<uint32>(std::lower_bound(PrefixCosts.begin() + minSplit, PrefixCosts.end(), targetCost) - PrefixCosts.begin());
+        const uint32 openPass = OpenPassBegins[split];
+        if (openPass == NoPass)
+        {
+            return split;
+        }
+        uint32 bestSplit = split;
+        uint64 bestDistance = PrefixCosts[openPass + 1] - PrefixCosts[openPass] + 1;
+        auto considerBoundary = [this, targetCost, minSplit, &bestSplit, &bestDistance](uint32 boundary)
+        {
+            if (boundary < minSplit)
+            {
+                return;
+            }
+            const uint64 cost = PrefixCosts[boundary];
+            const uint64 distance = cost > targetCost ? cost - targetCost : targetCost - cost;
+            if (distance < bestDistance)
+            {
+                bestSplit = boundary;
+                bestDistance = distance;
+            }
+        };
+
+        const auto boundaryIt = std::lower_bound(PassBoundaries.begin(), PassBoundaries.end(), split);
+        if (boundaryIt != PassBoundaries.end())
+        {
+            considerBoundary(*boundaryIt);
+        }
+        if (boundaryIt != PassBoundaries.begin())
+        {
+            considerBoundary(*(boundaryIt - 1));
+        }
+        return bestSplit;
+    }
+}
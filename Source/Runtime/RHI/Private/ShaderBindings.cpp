@@ -16,11 +16,6 @@ namespace Thunder
     {
     }
 
-    SingleShaderBindings::~SingleShaderBindings()
-    {
-        // Data releasing is handled by ShaderBindings
-    }
-
     void SingleShaderBindings::ClearData()
     {
         // Make sure that "Data" is allocated by TMemory.
@@ -261,7 +256,7 @@ namespace Thunder
         return offset;
     }
 
-    ShaderBindings::~ShaderBindings()
+    void ShaderBindings::ReleaseData()
     {
         if (!IsTransientAllocated)
         {
@@ -1,4 +1,5 @@
 #pragma once
+#include "Concurrent/Lock.h"
 #include "RHI.h"
 #include "RHIContext.h"
 #include "RHIResource.h"
@@ -54,6 +55,11 @@ namespace Thunder
     
         RHI_API virtual RHITextureRef RHICreateTexture(const RHIResourceDescriptor& desc, ETextureCreateFlags usage, void* resourceData = nullptr) = 0;
 
+        // Placed render targets for transient memory aliasing. Backends without support return false / nullptr.
+        RHI_API virtual bool RHIGetTextureAllocationInfo(const RHIResourceDescriptor& desc, uint64& outSize, uint64& outAlignment) { return false; }
+        RHI_API virtual RHITransientHeapRef RHICreateTransientHeap(uint64 size) { return nullptr; }
+        RHI_API virtual RHITextureRef RHICreatePlacedTexture(RHITransientHeap* heap, uint64 offset, const RHIResourceDescriptor& desc, ETextureCreateFlags usage) { return nullptr; }
+
         RHI_API virtual bool RHIUpdateSharedMemoryResource(RHIResource* resource, const void* resourceData, uint32 size, uint8 subresourceId) = 0;
 
         RHI_API virtual void RHIReleaseResource_RenderThread() = 0;
@@ -75,6 +81,7 @@ namespace Thunder
 
     protected:
         TArray<TRefCountPtr<RHIResource>> DeferredDeleteQueue[MAX_FRAME_LAG] {};
+        SpinLock DeferredDeleteLock; // Passes recorded in parallel queue deletes concurrently.
         TVector2u MainViewportResolution[3] = { { 1920, 1080 }, { 1920, 1080 }, { 1920, 1080 } };
     };
     
@@ -175,6 +182,21 @@ namespace Thunder
         return GDynamicRHI->RHICreateTexture(desc, usage, resourceData);
     }
 
+    FORCEINLINE bool RHIGetTextureAllocationInfo(const RHIResourceDescriptor& desc, uint64& outSize, uint64& outAlignment)
+    {
+        return GDynamicRHI->RHIGetTextureAllocationInfo(desc, outSize, outAlignment);
+    }
+
+    FORCEINLINE RHITransientHeapRef RHICreateTransientHeap(uint64 size)
+    {
+        return GDynamicRHI->RHICreateTransientHeap(size);
+    }
+
+    FORCEINLINE RHITextureRef RHICreatePlacedTexture(RHITransientHeap* heap, uint64 offset, const RHIResourceDescriptor& desc, ETextureCreateFlags usage)
+    {
+        return GDynamicRHI->RHICreatePlacedTexture(heap, offset, desc, usage);
+    }
+
     FORCEINLINE bool RHIUpdateSharedMemoryResource(RHIResource* resource, const void* resourceData, uint32 size, uint8 subresourceId)
     {
         return GDynamicRHI->RHIUpdateSharedMemoryResource(resource, resourceData, size, subresourceId);
@@ -219,12 +241,5 @@ namespace Thunder
     {
         GDynamicRHI->RHIPresent();
     }
-
-    RHI_API extern std::atomic_uint64_t GCachedMeshDrawCommandIndex;
-    FORCEINLINE uint64 RHIAllocateCachedMeshDrawCommandIndex()
-    {
-        TAssertf(GCachedMeshDrawCommandIndex.load(std::memory_order_acquire) < 0xFFFFFFFFFFFFFFFFull, "Cached mesh-draw index is out-of-range.");
-        return GCachedMeshDrawCommandIndex.fetch_add(1, std::memory_order_acq_rel);
-    }
 }
 
@@ -1,6 +1,58 @@
 ﻿#pragma once
+#include "RHI.h"
 
 namespace Thunder
 {
-    void SetGraphicsPipelineState(struct RenderContext* context, class TGraphicsPipelineStateDescriptor& Initializer);
+    class TRHIGraphicsPipelineState;
+
+    /**
+     * Everything a graphics PSO depends on, packed into fixed-size storage so building it allocates nothing.
+     * Shader combinations and render passes are interned (per variant, per format key), their addresses stand for their contents.
+     */
+    struct GraphicsPipelineStateKey
+    {
+        const void* Shader;
+        const void* Pass;
+        uint8 VertexElements[MaxVertexElementCount][sizeof(RHIVertexElement::Hash)];
+        uint8 BlendState[sizeof(RHIBlendState::Hash)];
+        uint8 RasterizerState[sizeof(RHIRasterizerState::Hash)];
+        uint8 DepthStencilState[sizeof(RHIDepthStencilState::Hash)];
+        uint8 RegisterCounts[sizeof(TShaderRegisterCounts::Hash)];
+        uint8 NumVertexElements;
+        uint8 PrimitiveType;
+        uint8 NumSamples;
+        uint64 Hash; // Over all of the above, computed once by Build.
+
+        // Returns false when the descriptor can't be keyed (too many vertex elements).
+        RHI_API bool Build(const TGraphicsPipelineStateDescriptor& desc);
+
+        bool operator==(const GraphicsPipelineStateKey& rhs) const
+        {
+            return Hash == rhs.Hash && memcmp(this, &rhs, sizeof(GraphicsPipelineStateKey)) == 0;
+        }
+    };
+
+    struct PipelineStateCacheStats
+    {
+        uint64 Hits = 0;
+        uint64 Misses = 0; // Calls that went to the RHI backend.
+        uint32 NumEntries = 0;
+    };
+
+    /**
+     * Front-end PSO cache, thread-safe. A hit is one probe in a sharded map, the backend only sees misses.
+     * Concurrent misses on the same key both reach the backend, which deduplicates the compilation itself.
+     */
+    RHI_API TRHIGraphicsPipelineState* GetGraphicsPipelineState(TGraphicsPipelineStateDescriptor& desc);
+    RHI_API PipelineStateCacheStats GetPipelineStateCacheStats();
+    RHI_API void ClearPipelineStateCache(); // Before the RHI backend is torn down.
 }
+
+template <>
+struct std::hash<Thunder::GraphicsPipelineStateKey>
+{
+    size_t operator()(const Thunder::GraphicsPipelineStateKey& key) const noexcept
+    {
+        return static_cast<size_t>(key.Hash);
+    }
+};
@@ -1,12 +1,9 @@
 #pragma once
-#include <d3d12.h>
-
 #include "RHIDefinition.h"
 #include "Templates/RefCountObject.h"
 
 namespace Thunder
 {
-	using namespace Microsoft::WRL;
 #define MAX_RENDER_TARGETS 8
 
 	class RenderPass;
@@ -165,6 +162,7 @@ namespace Thunder
 		uint64 Width;
 		uint32 Height;
 		uint16 DepthOrArraySize;
+		uint32 StructureByteStride = 0; // Buffer views only, non-zero makes a structured view of Width elements.
 	};
 
 	struct RHISamplerDescriptor
@@ -174,7 +172,7 @@ namespace Thunder
 		ERHITextureAddressMode AddressV = ERHITextureAddressMode::Wrap;
 		ERHITextureAddressMode AddressW = ERHITextureAddressMode::Wrap;
 		float MipLODBias = 0.f;
-		UINT MaxAnisotropy = 8;
+		uint32 MaxAnisotropy = 8;
 		ERHICompareFunction ComparisonFunc = ERHICompareFunction::Never;
 		float BorderColor[4] = {};
 		float MinLOD = 0.f;
@@ -193,11 +191,11 @@ namespace Thunder
     
 	struct RHIResourceSampleDescriptor
 	{
-		UINT Count;
-		UINT Quality;
+		uint32 Count;
+		uint32 Quality;
 
 		RHIResourceSampleDescriptor() : Count(0), Quality(0) {}
-		RHIResourceSampleDescriptor(UINT inCount, UINT inQuality) :	Count(inCount), Quality(inQuality) {}
+		RHIResourceSampleDescriptor(uint32 inCount, uint32 inQuality) :	Count(inCount), Quality(inQuality) {}
 	};
 	
     struct RHIResourceDescriptor
@@ -206,14 +204,14 @@ namespace Thunder
     
     	RHIResourceDescriptor(
     		ERHIResourceType dimension,
-    		UINT64 alignment,
-    		UINT64 width,
-    		UINT height,
-    		UINT16 depthOrArraySize,
-    		UINT16 mipLevels,
+    		uint64 alignment,
+    		uint64 width,
+    		uint32 height,
+    		uint16 depthOrArraySize,
+    		uint16 mipLevels,
     		RHIFormat format,
-    		UINT sampleCount,
-    		UINT sampleQuality,
+    		uint32 sampleCount,
+    		uint32 sampleQuality,
     		ERHITextureLayout layout,
     		RHIResourceFlags flags) noexcept
     		: SampleDesc{}, Flags{}
@@ -232,20 +230,20 @@ namespace Thunder
     	}
     
     	static inline RHIResourceDescriptor Buffer(
-    		UINT64 width,
+    		uint64 width,
     		RHIResourceFlags flags = {},
-    		UINT64 alignment = 0) noexcept
+    		uint64 alignment = 0) noexcept
     	{
     		return RHIResourceDescriptor( ERHIResourceType::Buffer, alignment, width, 1, 1, 1,
     			RHIFormat::UNKNOWN, 1, 0, ERHITextureLayout::RowMajor, flags );
     	}
     
     	ERHIResourceType Type;
-    	UINT64 Alignment;
-    	UINT64 Width;
-    	UINT Height;
-    	UINT16 DepthOrArraySize;
-    	UINT16 MipLevels;
+    	uint64 Alignment;
+    	uint64 Width;
+    	uint32 Height;
+    	uint16 DepthOrArraySize;
+    	uint16 MipLevels;
     	RHIFormat Format;
     	RHIResourceSampleDescriptor SampleDesc;
     	ERHITextureLayout Layout;
@@ -266,23 +264,19 @@ namespace Thunder
 	{
 	public:
 		RHI_API RHIDescriptorView(RHIViewDescriptor const& desc, uint64 handle = 0xFFFFFFFFFFFFFFFF, uint32 offlineHeapIndex = 0xFFFFFFFF)
-			: Desc(desc), CPUHandle(D3D12_CPU_DESCRIPTOR_HANDLE{ handle }), OfflineHeapIndex(offlineHeapIndex) {}
+			: Desc(desc), CPUHandle(handle), OfflineHeapIndex(offlineHeapIndex) {}
 		RHI_API virtual ~RHIDescriptorView() = default;
 
-		RHI_API void SetOfflineHandle(uint64 handle) { CPUHandle = D3D12_CPU_DESCRIPTOR_HANDLE{ handle }; }
-		RHI_API uint64 GetOfflineHandle() const { return static_cast<uint64>(CPUHandle.ptr); }
-		RHI_API void SetOnlineHandle(uint64 handle) { GPUHandle = D3D12_GPU_DESCRIPTOR_HANDLE{ handle }; }
-		RHI_API uint64 GetOnlineHandle() const { return static_cast<uint64>(GPUHandle.ptr); }
-
-		RHI_API void SetCPUHandle(D3D12_CPU_DESCRIPTOR_HANDLE handle) { CPUHandle = handle; }
-		RHI_API D3D12_CPU_DESCRIPTOR_HANDLE GetCPUHandle() const { return CPUHandle; }
-		RHI_API void SetGPUHandle(D3D12_GPU_DESCRIPTOR_HANDLE handle) { GPUHandle = handle; }
-		RHI_API D3D12_GPU_DESCRIPTOR_HANDLE GetGPUHandle() const { return GPUHandle; }
+		// Opaque backend handles, D3D12 views wrap them in descriptor handle structs.
+		RHI_API void SetOfflineHandle(uint64 handle) { CPUHandle = handle; }
+		RHI_API uint64 GetOfflineHandle() const { return CPUHandle; }
+		RHI_API void SetOnlineHandle(uint64 handle) { GPUHandle = handle; }
+		RHI_API uint64 GetOnlineHandle() const { return GPUHandle; }
 
 	protected:
 		RHIViewDescriptor Desc = {};
-		D3D12_CPU_DESCRIPTOR_HANDLE CPUHandle{ 0xFFFFFFFFFFFFFFFF };
-		D3D12_GPU_DESCRIPTOR_HANDLE GPUHandle{ 0xFFFFFFFFFFFFFFFF };
+		uint64 CPUHandle = 0xFFFFFFFFFFFFFFFF;
+		uint64 GPUHandle = 0xFFFFFFFFFFFFFFFF;
 		uint32 OfflineHeapIndex = 0xFFFFFFFF; // Used for freeing this descriptor and return it back to descriptor pool.
 	};
     
@@ -1,4 +1,5 @@
 #pragma once
+#include <type_traits>
 #include "IDynamicRHI.h"
 #include "RHIContext.h"
 #include "RHIResource.h"
@@ -21,67 +22,100 @@ namespace Thunder
     {
         RHI_API virtual ~IRHICommandRecorder() = default;
 
-        /** Allocate raw memory from the transient allocator. */
+        /** Frame-lifetime transient allocator, safe to allocate from any thread. */
         RHI_API virtual TransientAllocator* GetTransientAllocator_RenderThread() const = 0;
 
         /** Enqueue a command into this recorder. */
         RHI_API virtual void AddCommand(IRHICommand* command) = 0;
 
+        /** Register a command destructor, run in batch when the transient allocator is reset. */
+        RHI_API virtual void AddCommandDestructor(void* command, void (*destruct)(void*)) = 0;
+
         /** Typed allocation helper. */
         template<typename T>
         void* Allocate(size_t count = 1) const
         {
             return GetTransientAllocator_RenderThread()->Allocate(sizeof(T) * count, alignof(T));
         }
+
+        /** Construct a command in the transient allocator, only commands owning resources need a destructor. */
+        template<typename T, typename... Args>
+        T* NewCommand(Args&&... args)
+        {
+            T* command = new (Allocate<T>()) T(std::forward<Args>(args)...);
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                AddCommandDestructor(command, [](void* object) { static_cast<T*>(object)->~T(); });
+            }
+            return command;
+        }
+    };
+
+    enum class ERHICommandType : uint8
+    {
+        Dummy,
+        BeginFrame,
+        BeginCommandList,
+        Draw,
+        BeginPass,
+        EndPass,
+        UpdateBufferRegions,
+        Custom, // Backend commands, executed through RHICustomCommand::ExecuteFunction.
     };
 
     /**
-     * Abstract base class for all RHI commands
+     * Base of all RHI commands, tagged with its type and dispatched without virtual calls.
+     * Commands are never destructed after execution, transient memory is reset once per frame.
      */
     struct IRHICommand
     {
-        virtual ~IRHICommand() = default;
+        explicit IRHICommand(ERHICommandType type) : Type(type) {}
 
-        /** Execute and then destruct the command */
-        FORCEINLINE void ExecuteAndDestruct(RHICommandContext* cmdList)
-        {
-            Execute(cmdList);
-            if (!IsCached)
-            {
-                this->~IRHICommand();
-            }
-        }
         /** Execute the command on the given command context */
-        RHI_API virtual void Execute(RHICommandContext* cmdList) = 0;
+        RHI_API void Dispatch(RHICommandContext* cmdList);
 
+        ERHICommandType Type;
         bool IsCached = false;
     };
 
+    struct RHICustomCommand : public IRHICommand
+    {
+        using ExecuteFunctionType = void (*)(RHICustomCommand* command, RHICommandContext* cmdList);
+
+        explicit RHICustomCommand(ExecuteFunctionType executeFunction)
+            : IRHICommand(ERHICommandType::Custom), ExecuteFunction(executeFunction) {}
+
+        ExecuteFunctionType ExecuteFunction;
+    };
+
     /**
      * Simple vertex buffer setting command
      */
     struct RHIDummyCommand : public IRHICommand
     {
-        RHI_API void Execute(RHICommandContext* cmdList) override;
+        RHIDummyCommand() : IRHICommand(ERHICommandType::Dummy) {}
+        RHI_API void Execute(RHICommandContext* cmdList);
     };
 
     struct RHIBeginFrameCommand : public IRHICommand
     {
-        RHI_API void Execute(RHICommandContext* cmdList) override;
+        RHIBeginFrameCommand() : IRHICommand(ERHICommandType::BeginFrame) {}
+        RHI_API void Execute(RHICommandContext* cmdList);
     };
 
     struct RHIBeginCommandListCommand : public IRHICommand
     {
-        RHI_API void Execute(RHICommandContext* cmdList) override;
+        RHI_API void Execute(RHICommandContext* cmdList);
 
-        RHIBeginCommandListCommand(struct RHIPassState* state) : PassState(state) {}
+        RHIBeginCommandListCommand(struct RHIPassState* state) : IRHICommand(ERHICommandType::BeginCommandList), PassState(state) {}
 
         RHIPassState* PassState;
     };
 
     struct RHIDrawCommand : public IRHICommand
     {
-        RHI_API void Execute(RHICommandContext* cmdList) override;
+        RHIDrawCommand() : IRHICommand(ERHICommandType::Draw) {}
+        RHI_API void Execute(RHICommandContext* cmdList);
         void BindPSO(RHICommandContext* cmdList) const;
         void BindSRVTable(RHICommandContext* cmdList);
         void BindCBV(RHICommandContext* cmdList);
@@ -92,6 +126,7 @@ namespace Thunder
         TRHIPipelineState* GraphicsPSO = nullptr;
         ShaderCombination* Shader = nullptr;
         ShaderBindings Bindings{};
+        uint64 SortKey = 0; // State bits of DrawSortKey, depth bits are filled per view when sorting.
 
         // TODO.
         // RHIConstantBufferRef CB;
@@ -109,8 +144,9 @@ namespace Thunder
 
     struct RHICachedDrawCommand : public RHIDrawCommand
     {
-        RHICachedDrawCommand() : CachedCommandIndex(RHIAllocateCachedMeshDrawCommandIndex()) { IsCached = true; }
-        uint64 CachedCommandIndex = 0;
+        RHICachedDrawCommand() { IsCached = true; }
+        ~RHICachedDrawCommand() { Bindings.ReleaseData(); }
+        uint64 CachedCommandIndex = ~0ull; // Slot in the pass draw list, assigned when the command gets cached.
     };
 
     enum class ELoadOp : uint8
@@ -130,7 +166,8 @@ namespace Thunder
     constexpr uint32 kMaxRTVCount = MAX_RTVS;
     struct RHIBeginPassCommand : public IRHICommand
     {
-        RHI_API void Execute(RHICommandContext* cmdList) override;
+        RHIBeginPassCommand() : IRHICommand(ERHICommandType::BeginPass) {}
+        RHI_API void Execute(RHICommandContext* cmdList);
 
         struct TRenderTargetBinding
         {
@@ -138,6 +175,7 @@ namespace Thunder
             ELoadOp       LoadOp     = ELoadOp::Load;
             TVector4f     ClearColor = { 0.f, 0.f, 0.f, 1.f };
             bool bNeedBarrier = false;
+            bool bAliasingBarrier = false; // First use of a placed target this frame, its memory held another target.
             ERHIResourceState OldState;
         };
 
@@ -148,6 +186,7 @@ namespace Thunder
             float         ClearDepth   = 1.f;
             uint8         ClearStencil = 0;
             bool bNeedBarrier = false;
+            bool bAliasingBarrier = false;
             ERHIResourceState OldState;
         };
 
@@ -162,19 +201,49 @@ namespace Thunder
         // When true, this pass renders directly to the swapchain backbuffer.
         // No pool render targets are bound; the backbuffer is bound instead.
         bool bIsBackBufferPass = false;
+
+        struct RHIPassState* PassState = nullptr;
     };
 
     struct RHIEndPassCommand : public IRHICommand
     {
-        RHI_API void Execute(RHICommandContext* cmdList) override;
+        RHIEndPassCommand() : IRHICommand(ERHICommandType::EndPass) {}
+        RHI_API void Execute(RHICommandContext* cmdList);
 
         // When true, transitions the swapchain backbuffer to Present state.
         bool bIsBackBufferPass = false;
     };
 
+    struct RHIBufferCopyRegion
+    {
+        uint64 DstOffset = 0;
+        uint64 SrcOffset = 0;
+        uint64 NumBytes = 0;
+    };
+
+    /**
+     * Copies staged regions into a buffer and leaves it readable by shaders.
+     * Buffers decay to the common state between submissions, the copy starts from there.
+     */
+    struct RHIUpdateBufferRegionsCommand : public IRHICommand
+    {
+        RHIUpdateBufferRegionsCommand() : IRHICommand(ERHICommandType::UpdateBufferRegions) {}
+        RHI_API void Execute(RHICommandContext* cmdList);
+
+        TRefCountPtr<RHIResource> Destination;
+        TRefCountPtr<RHIResource> Source;
+        const RHIBufferCopyRegion* Regions = nullptr; // Transient, allocated by the recorder.
+        uint32 NumRegions = 0;
+    };
+
+    // The per-frame commands are reset with their allocator, without running destructors.
+    static_assert(std::is_trivially_destructible_v<RHIDrawCommand>);
+    static_assert(std::is_trivially_destructible_v<RHIBeginFrameCommand>);
+    static_assert(std::is_trivially_destructible_v<RHIEndPassCommand>);
+
     struct RHIPassState
     {
-        RHIPassState(const RHIBeginPassCommand* beginCommand, uint32 commandId);
+        RHIPassState(const RHIBeginPassCommand* beginCommand, uint32 commandId, NameHandle name);
         ~RHIPassState() = default;
 
         RHITextureRef RenderTargets[kMaxRTVCount];
@@ -186,5 +255,12 @@ namespace Thunder
         bool bIsBackBufferPass = false;
 
         uint32 BeginCommandIndex = 0;
+        NameHandle Name;
+
+        // Draw binds issued and skipped as redundant, accumulated by RHI threads.
+        std::atomic<uint32> PSOBinds = 0;
+        std::atomic<uint32> PSOBindsSkipped = 0;
+        std::atomic<uint32> SRVTableBinds = 0;
+        std::atomic<uint32> SRVTableBindsSkipped = 0;
     };
 }
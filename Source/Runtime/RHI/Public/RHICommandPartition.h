@@ -0,0 +1,41 @@
+#pragma once
+#include "RHICommand.h"
+
+namespace Thunder
+{
+    /**
+     * Relative recording cost of a command on an RHI worker, in abstract units. Draws are weighted by the state they
+     * change compared to the previous draw, pass boundaries by their barriers and clears.
+     */
+    RHI_API uint32 EstimateRHICommandCost(const IRHICommand* command, const RHIDrawCommand* previousDraw);
+
+    struct RHICommandChunk
+    {
+        uint32 Begin = 0;
+        uint32 End = 0;
+        uint32 ReplayPassBegin = ~0u; // Begin pass command of the pass open at Begin, its state is replayed first.
+        uint64 Cost = 0;
+
+        bool NeedsPassReplay() const { return ReplayPassBegin != ~0u; }
+    };
+
+    /**
+     * Splits a frame's command list into contiguous chunks of similar estimated cost, one per RHI command context.
+     * A cut close enough to a pass boundary snaps to it, sparing the chunk a replay of the state of the pass it starts in.
+     */
+    class RHICommandPartitioner
+    {
+    public:
+        RHI_API void Partition(const TArray<IRHICommand*>& commands, uint32 numChunks, TArray<RHICommandChunk>& outChunks);
+
+        uint64 GetTotalCost() const { return PrefixCosts.empty() ? 0 : PrefixCosts.back(); }
+
+    private:
+        uint32 FindSplit(uint64 targetCost, uint32 minSplit) const;
+
+        // Scratch, kept to avoid allocating every frame.
+        TArray<uint64> PrefixCosts;      // Cost of the commands before each index.
+        TArray<uint32> OpenPassBegins;   // Begin pass command of the pass open before each command, ~0u outside passes.
+        TArray<uint32> PassBoundaries;   // Indices a chunk can start at without replaying a pass.
+    };
+}
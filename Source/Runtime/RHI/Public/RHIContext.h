@@ -2,10 +2,28 @@
 
 #include "RHI.h"
 #include "RHIResource.h"
+#include "ShaderDefinition.h"
 #include "Vector.h"
 
 namespace Thunder
 {
+    /**
+     * Draw state last bound through a command context, lets draw commands skip redundant PSO and SRV table binds.
+     * Counts are per context and get flushed into the current pass.
+     */
+    struct RHIDrawStateCache
+    {
+        const TRHIPipelineState* PipelineState = nullptr;
+        const void* SRVShader = nullptr;
+        uint64 SRVHandles[MAX_SRVS] = {};
+        uint32 SRVCount = 0;
+
+        uint32 PSOBinds = 0;
+        uint32 PSOBindsSkipped = 0;
+        uint32 SRVTableBinds = 0;
+        uint32 SRVTableBindsSkipped = 0;
+    };
+
     class RHICommandContext : public RefCountedObject
     {
     public:
@@ -51,12 +69,29 @@ namespace Thunder
     	virtual void Reset(uint32 index) = 0;
     	virtual void BeginFrame() = 0;
     	virtual void TransitionBarrier(RHIResource* res, ERHIResourceState oldState, ERHIResourceState newState, uint32 subResource = 0xffffffff) = 0;
+    	virtual void AliasingBarrier(RHIResource* before, RHIResource* after) = 0; // Null before: any resource overlapping after.
 
         // Backbuffer operations (for present pass)
         virtual void TransitionBackBufferToRenderTarget() = 0;
         virtual void TransitionBackBufferToPresent() = 0;
     	virtual void ClearBackBuffer(TVector4f clearColor) = 0;
         virtual void SetBackBufferAsRenderTarget() = 0;
+
+        // Redundant bind tracking.
+        FORCEINLINE RHIDrawStateCache& GetDrawStateCache() { return DrawStateCache; }
+        FORCEINLINE void InvalidateDrawState()
+        {
+            DrawStateCache.PipelineState = nullptr;
+            DrawStateCache.SRVShader = nullptr;
+            DrawStateCache.SRVCount = 0;
+        }
+        // Flushes counts into the previous pass, bound state is dropped since render targets changed.
+        RHI_API void BeginDrawStatePass(struct RHIPassState* passState);
+        RHI_API void FlushDrawStateStats();
+
+    private:
+        RHIDrawStateCache DrawStateCache;
+        RHIPassState* CurrentPassState = nullptr;
     };
 
 	using RHICommandContextRef = TRefCountPtr<RHICommandContext>;
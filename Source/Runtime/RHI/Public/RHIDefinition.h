@@ -199,6 +199,33 @@ namespace Thunder
         }
     }
 
+    // Uncompressed formats only, for memory estimates.
+    FORCEINLINE uint32 GetFormatBytesPerPixel(RHIFormat format)
+    {
+        const uint8 value = static_cast<uint8>(format);
+        if (value >= static_cast<uint8>(RHIFormat::R32G32B32A32_TYPELESS) && value <= static_cast<uint8>(RHIFormat::R32G32B32A32_SINT))
+        {
+            return 16;
+        }
+        if (value >= static_cast<uint8>(RHIFormat::R32G32B32_TYPELESS) && value <= static_cast<uint8>(RHIFormat::R32G32B32_SINT))
+        {
+            return 12;
+        }
+        if (value >= static_cast<uint8>(RHIFormat::R16G16B16A16_TYPELESS) && value <= static_cast<uint8>(RHIFormat::X32_TYPELESS_G8X24_UINT))
+        {
+            return 8;
+        }
+        if (value >= static_cast<uint8>(RHIFormat::R8G8_TYPELESS) && value <= static_cast<uint8>(RHIFormat::R16_SINT))
+        {
+            return 2;
+        }
+        if (value >= static_cast<uint8>(RHIFormat::R8_TYPELESS) && value <= static_cast<uint8>(RHIFormat::A8_UNORM))
+        {
+            return 1;
+        }
+        return 4;
+    }
+
     enum class ERHIViewDimension : uint32
     {
         Unknown	= 0,
@@ -123,7 +123,10 @@ namespace Thunder
         return m_assetsPath + assetName;
     }
     
-    DXGI_FORMAT ConvertRHIFormatToD3DFormat(RHIFormat type);
+    inline DXGI_FORMAT ConvertRHIFormatToD3DFormat(RHIFormat type)
+    {
+        return static_cast<DXGI_FORMAT>(type);
+    }
 
     // Returns the typeless resource format for a given depth format.
     // Used when creating a texture that needs both a DSV and an SRV.
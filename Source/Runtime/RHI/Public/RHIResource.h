@@ -100,6 +100,17 @@ namespace Thunder
         BinaryDataRef Data;
     };
     
+    /**
+     * \brief memory placed render targets are created in, targets with disjoint lifetimes may overlap in it
+     */
+    class RHITransientHeap : public RHIResource
+    {
+    public:
+        RHITransientHeap(RHIResourceDescriptor const& desc) : RHIResource(desc) {}
+
+        _NODISCARD_ uint64 GetSize() const { return Desc.Width; }
+    };
+
     /**
      * \brief buffer
      */
@@ -108,12 +119,14 @@ namespace Thunder
     public:
         RHIVertexBuffer(RHIResourceDescriptor const& desc, EBufferCreateFlags const& flags) : RHIBuffer(desc, flags) {}
 
-        void SetBinaryData(byte* src)
+        void SetBinaryData(byte* src, BinaryDataRef source = nullptr)
         {
             Data = src;
+            DataSource = std::move(source);
         }
     protected:
         byte* Data;
+        BinaryDataRef DataSource; // Set when Data points into a mapped package, released once uploaded.
     };
     
     class RHIIndexBuffer : public RHIBuffer
@@ -121,12 +134,14 @@ namespace Thunder
     public:
         RHIIndexBuffer(RHIResourceDescriptor const& desc, EBufferCreateFlags const& flags) : RHIBuffer(desc, flags) {}
 
-        void SetBinaryData(byte* src)
+        void SetBinaryData(byte* src, BinaryDataRef source = nullptr)
         {
             Data = src;
+            DataSource = std::move(source);
         }
     protected:
         byte* Data;
+        BinaryDataRef DataSource; // Set when Data points into a mapped package, released once uploaded.
     };
     
     class RHIStructuredBuffer : public RHIBuffer
@@ -203,6 +218,7 @@ namespace Thunder
     using RHISamplerRef = TRefCountPtr<RHISampler>;
     using RHIFenceRef = TRefCountPtr<RHIFence>;
     using RHITextureRef = TRefCountPtr<RHITexture>;
+    using RHITransientHeapRef = TRefCountPtr<RHITransientHeap>;
     using RHIVertexBufferRef = TRefCountPtr<RHIVertexBuffer>;
     using RHIIndexBufferRef = TRefCountPtr<RHIIndexBuffer>;
     using RHIStructuredBufferRef = TRefCountPtr<RHIStructuredBuffer>;
@@ -15,7 +15,6 @@ namespace Thunder
     {
     public:
         SingleShaderBindings(byte* inData = nullptr);
-        ~SingleShaderBindings();
 
         void SetData(byte* inData) { Data = inData; }
         byte* GetData() const { return Data; }
@@ -52,9 +51,10 @@ namespace Thunder
     {
     public:
         ShaderBindings() = default;
-        ~ShaderBindings();
 
         void SetTransientAllocated(bool isTransientAllocated) { IsTransientAllocated = isTransientAllocated; }
+        // Frees binding data unless it lives in a transient allocator, called by owners of persistent bindings.
+        void ReleaseData();
 
         SingleShaderBindings* GetSingleShaderBindings() { return &(Bindings); }
         void SetBindingsData(byte* inData) { Bindings.SetData(inData); }
@@ -1,6 +1,7 @@
 #pragma optimize("", off)
 #include "FrameGraph.h"
 #include <algorithm>
+#include <bit>
 #include <UniformBuffer.h>
 #include "RenderTexture.h"
 #include "RenderContext.h"
@@ -12,9 +13,11 @@
 #include "ShaderModule.h"
 #include "ShaderParameterMap.h"
 #include "Concurrent/ConcurrentBase.h"
+#include "Concurrent/ParallelSort.h"
 #include "Concurrent/TaskGraph.h"
 #include "Concurrent/TaskScheduler.h"
 #include "Concurrent/TheadPool.h"
+#include "CoreModule.h"
 #include "HAL/Event.h"
 #include "Misc/CoreGlabal.h"
 
@@ -23,6 +26,17 @@ namespace Thunder
 {
     class TaskDispatcher;
 
+    namespace
+    {
+        FORCEINLINE uint64 MixGraphHash(uint64 hash, uint64 value)
+        {
+            hash = (hash ^ value) * 0x9e3779b97f4a7c15ull;
+            return hash ^ (hash >> 32);
+        }
+    }
+
+    thread_local FrameGraph::PassRecordingSlot* FrameGraph::CurrentRecordingSlot = nullptr;
+
     void PassOperations::Read(const FGRenderTarget* renderTarget, NameHandle overrideRTName)
     {
         if (overrideRTName.IsEmpty())
@@ -94,8 +108,8 @@ namespace Thunder
         }
     }
 
-    RHIPassState::RHIPassState(const RHIBeginPassCommand* beginCommand, uint32 commandId)
-        : BeginCommandIndex(commandId)
+    RHIPassState::RHIPassState(const RHIBeginPassCommand* beginCommand, uint32 commandId, NameHandle name)
+        : BeginCommandIndex(commandId), Name(name)
     {
         bIsBackBufferPass = beginCommand->bIsBackBufferPass;
         RenderTargetCount = beginCommand->RenderTargetCount;
@@ -116,11 +130,37 @@ namespace Thunder
             Views[i] = new (TMemory::Malloc<SceneView>()) SceneView(this, static_cast<EViewType>(i));
         }
         CachedGlobalParameters = new ShaderParameterMap;
+
+        // Free pooled targets beyond the budget are trimmed, least recently used first.
+        auto engineConfig = GConfigManager ? GConfigManager->GetConfig("BaseEngine") : nullptr;
+        if (engineConfig && engineConfig->Layout.contains("RenderTargetPoolBudgetMB"))
+        {
+            Pool.SetMemoryBudget(static_cast<uint64>(engineConfig->GetFloatAsInt("RenderTargetPoolBudgetMB")) * 1024 * 1024);
+        }
+        if (engineConfig && engineConfig->Layout.contains("ParallelPassRecording"))
+        {
+            bParallelPassRecording = engineConfig->GetBool("ParallelPassRecording");
+        }
     }
 
     FrameGraph::~FrameGraph()
     {
         Reset();
+        TransientHeap.Reset();
+        Pool.Reset();
+        FreeRetiredCachedDrawCommands(0);
+        FreeRetiredCachedDrawCommands(1);
+        for (auto& state : PassVisibility)
+        {
+            for (auto& command : state.CachedDrawList.MeshDrawCommands)
+            {
+                if (command)
+                {
+                    TMemory::Destroy(command);
+                }
+            }
+            state.CachedDrawList.MeshDrawCommands.clear();
+        }
         for (auto& view : Views)
         {
             TMemory::Destroy(view);
@@ -156,6 +196,17 @@ namespace Thunder
             }
         }
         PassUniformBufferMap.clear();
+
+        // RenderThreadSlot holds MainContext and RenderContexts, the other slots own their contexts.
+        for (size_t index = 0; index < RecordingSlots.size(); ++index)
+        {
+            delete RecordingSlots[index].MainContext;
+            for (auto& context : RecordingSlots[index].RenderContexts)
+            {
+                delete context;
+            }
+        }
+        RecordingSlots.clear();
     }
 
     void FrameGraph::Reset()
@@ -180,15 +231,23 @@ namespace Thunder
         CurrentFramePasses.clear();
         PresentPassName = "";
 
-        ExecutionOrder.clear();
+        // Execution order, lifetimes and per-pass target lists stay for the compiled-graph cache, Compile rebuilds them on change.
         RenderTargets.clear();
         AllocatedRenderTargets.clear();
-        RenderTargetLifetimes.clear();
+        PlacedRenderTargets.clear();
+
+        // Targets placed for another resolution are never reused, drop them with the heap so it is sized anew.
+        if (TransientHeapResolution.X != ViewportResolution.X || TransientHeapResolution.Y != ViewportResolution.Y)
+        {
+            TransientHeap.Reset();
+            TransientHeapResolution = ViewportResolution;
+        }
 
         // Clear commands from previous frame
         uint32 frameIndex = GFrameState->FrameNumberRenderThread.load(std::memory_order_acquire) % 2;
         AllCommands[frameIndex].clear();
         AllPassStates[frameIndex].clear();
+        FreeRetiredCachedDrawCommands(frameIndex);
         for (auto& context : RenderContexts)
         {
             context->ClearCommands();
@@ -196,18 +255,44 @@ namespace Thunder
         }
         MainContext->ClearCommands();
         MainContext->FreeAllocator();
+        for (size_t index = 0; index < RecordingSlots.size(); ++index)
+        {
+            PassRecordingSlot& slot = RecordingSlots[index];
+            if (slot.MainContext == nullptr)
+            {
+                continue;
+            }
+            slot.MainContext->ClearCommands();
+            slot.MainContext->FreeAllocator();
+            for (auto& context : slot.RenderContexts)
+            {
+                context->ClearCommands();
+                context->FreeAllocator();
+            }
+        }
     }
 
     void FrameGraph::Compile()
     {
-        // Cull unused passes
-        CullUnusedPasses();
+        // Same passes reading and writing the same targets as last frame compile to the same graph.
+        const uint64 declarationHash = HashGraphDeclarations();
+        if (!bHasCompiledGraph || declarationHash != CompiledDeclarationHash)
+        {
+            // Cull unused passes
+            CullUnusedPasses();
+
+            // Sort passes topologically
+            TopologicalSort();
+
+            // Calculate render target lifetimes
+            ScheduleRenderTargetLifetime();
 
-        // Sort passes topologically
-        TopologicalSort();
+            // Group independent passes for parallel recording
+            ScheduleRecordingWaves();
 
-        // Calculate render target lifetimes
-        ScheduleRenderTargetLifetime();
+            CompiledDeclarationHash = declarationHash;
+            bHasCompiledGraph = true;
+        }
 
         // Allocate render targets with lifetime-based reuse
         AllocateRenderTargets();
@@ -219,39 +304,44 @@ namespace Thunder
         SetPresentCommand();
     }
 
-    void FrameGraph::AggregateContextCommands(uint32 frameIndex)
+    void FrameGraph::GatherContextCommands(const PassRecordingSlot& slot, TArray<IRHICommand*>& outCommands)
     {
         // Add main context commands.
-        const auto& mainCommands = MainContext->GetCommands();
-        AllCommands[frameIndex].insert(AllCommands[frameIndex].end(), mainCommands.begin(), mainCommands.end());
-        MainContext->ClearCommands();
+        const auto& mainCommands = slot.MainContext->GetCommands();
+        outCommands.insert(outCommands.end(), mainCommands.begin(), mainCommands.end());
+        slot.MainContext->ClearCommands();
 
         // Add threaded commands.
-        for (auto& context : RenderContexts)
+        for (auto& context : slot.RenderContexts)
         {
             auto const& commands = context->GetCommands();
             if (!commands.empty())
             {
-                AllCommands[frameIndex].insert(AllCommands[frameIndex].end(), commands.begin(), commands.end());
+                outCommands.insert(outCommands.end(), commands.begin(), commands.end());
             }
             context->ClearCommands();
         }
     }
 
+    void FrameGraph::AggregateContextCommands(uint32 frameIndex)
+    {
+        GatherContextCommands(RenderThreadSlot, AllCommands[frameIndex]);
+    }
+
     void FrameGraph::AddBeginFrameCommand(uint32 frameIndex)
     {
         // Add begin frame command
-        RHIBeginFrameCommand* beginFrameCommand = new (MainContext->Allocate<RHIBeginFrameCommand>()) RHIBeginFrameCommand;
+        RHIBeginFrameCommand* beginFrameCommand = MainContext->NewCommand<RHIBeginFrameCommand>();
         MainContext->AddCommand(beginFrameCommand);
 
         // Execute command before passes
         AggregateContextCommands(frameIndex);
     }
 
-    void FrameGraph::AddBeginPassCommand(FrameGraphPass* curPass, uint32 frameIndex)
+    void FrameGraph::AddBeginPassCommand(FrameGraphPass* curPass, uint32 execIndex, uint32 frameIndex)
     {
         // Begin pass.
-        RHIBeginPassCommand* newBeginCommand = new (MainContext->Allocate<RHIBeginPassCommand>()) RHIBeginPassCommand;
+        RHIBeginPassCommand* newBeginCommand = MainContext->NewCommand<RHIBeginPassCommand>();
 
         // Handle read targets first (same for both regular and present passes).
         auto readRTs = curPass->GetOperations().GetReadTargets();
@@ -318,6 +408,7 @@ namespace Thunder
                 newBeginCommand->DepthStencil.ClearStencil = writeInfo.ClearStencil;
                 newBeginCommand->DepthStencil.OldState     = texture->GetTextureRHI()->GetState_RenderThread();
                 newBeginCommand->DepthStencil.bNeedBarrier = newBeginCommand->DepthStencil.OldState != ERHIResourceState::DepthWrite;
+                newBeginCommand->DepthStencil.bAliasingBarrier = IsFirstUseOfPlacedTarget(rtId, execIndex);
                 if (newBeginCommand->DepthStencil.bNeedBarrier)
                 {
                     texture->GetTextureRHI()->SetState_RenderThread(ERHIResourceState::DepthWrite);
@@ -331,6 +422,7 @@ namespace Thunder
                 binding.ClearColor   = writeInfo.ClearColor;
                 binding.OldState     = texture->GetTextureRHI()->GetState_RenderThread();
                 binding.bNeedBarrier = binding.OldState != ERHIResourceState::RenderTarget;
+                binding.bAliasingBarrier = IsFirstUseOfPlacedTarget(rtId, execIndex);
                 if (binding.bNeedBarrier)
                 {
                     texture->GetTextureRHI()->SetState_RenderThread(ERHIResourceState::RenderTarget);
@@ -346,20 +438,33 @@ namespace Thunder
         AllCommands[frameIndex].push_back(newBeginCommand);
     }
 
-    void FrameGraph::AddPassState(uint32 frameIndex)
+    bool FrameGraph::IsFirstUseOfPlacedTarget(uint32 rtId, uint32 execIndex) const
+    {
+        if (!PlacedRenderTargets.contains(rtId))
+        {
+            return false;
+        }
+        const std::span<const uint32> acquired = GetAcquiredTargets(execIndex);
+        return std::ranges::find(acquired, rtId) != acquired.end();
+    }
+
+    void FrameGraph::AddPassState(FrameGraphPass* pass, uint32 frameIndex)
     {
         uint32 commandId = static_cast<uint32>(AllCommands[frameIndex].size()) - 1;
         auto const lastCommand = AllCommands[frameIndex][commandId];
-        if (auto const beginCommand = dynamic_cast<RHIBeginPassCommand*>(lastCommand)) // todo dynamic_cast
+        if (lastCommand->Type == ERHICommandType::BeginPass)
         {
-            AllPassStates[frameIndex].push_back(new RHIPassState(beginCommand, commandId));
+            auto const beginCommand = static_cast<RHIBeginPassCommand*>(lastCommand);
+            auto passState = new RHIPassState(beginCommand, commandId, pass->GetName());
+            beginCommand->PassState = passState;
+            AllPassStates[frameIndex].push_back(passState);
         }
     }
 
     void FrameGraph::AddEndPassCommand(FrameGraphPass* curPass, uint32 frameIndex)
     {
         // End pass.
-        RHIEndPassCommand* newEndCommand = new (MainContext->Allocate<RHIEndPassCommand>()) RHIEndPassCommand;
+        RHIEndPassCommand* newEndCommand = MainContext->NewCommand<RHIEndPassCommand>();
 
         if (curPass->bIsPresentPass)
         {
@@ -376,45 +481,128 @@ namespace Thunder
         AggregateContextCommands(frameIndex);
 
         AllPassStates[frameIndex].reserve(ExecutionOrder.size());
-        // Execute passes in order.
-        for (size_t i = 0; i < ExecutionOrder.size(); ++i)
+        uint32 waveBegin = 0;
+        for (const uint32 waveEnd : CompiledWaveEnds)
         {
-            NameHandle passName = ExecutionOrder[i];
-            if (!Passes.contains(passName) || Passes[passName]->bCulled) [[unlikely]]
-            {
-                TAssertf(false, "Execution invalid pass \"%s\".", passName);
-                continue;
-            }
+            // Record the wave's passes, in parallel when there is more than one.
+            RecordPasses(waveBegin, waveEnd);
 
+            // Submit in execution order, state transitions are tracked here on the render thread.
+            for (uint32 i = waveBegin; i < waveEnd; ++i)
             {
-                auto& pass = Passes[passName];
-                // Execute pass.
-                SetCurrentPass(pass.Get());
-                pass->ExecuteFunction();
-
-                AddBeginPassCommand(pass, frameIndex);
-                AddPassState(frameIndex);
-                AggregateContextCommands(frameIndex);
+                auto passIt = Passes.find(ExecutionOrder[i]);
+                if (passIt == Passes.end() || passIt->second->bCulled) [[unlikely]]
+                {
+                    continue;
+                }
+
+                FrameGraphPass* pass = passIt->second.Get();
+                TArray<IRHICommand*>& passCommands = RecordedPassCommands[i - waveBegin];
+                AddBeginPassCommand(pass, i, frameIndex);
+                AddPassState(pass, frameIndex);
+                AllCommands[frameIndex].insert(AllCommands[frameIndex].end(), passCommands.begin(), passCommands.end());
+                passCommands.clear();
                 AddEndPassCommand(pass, frameIndex);
+
+                // After pass execution, release render targets whose last use it was.
+                for (const uint32 rtID : GetReleasedTargets(i))
+                {
+                    auto it = AllocatedRenderTargets.find(rtID);
+                    if (it != AllocatedRenderTargets.end())
+                    {
+                        Pool.ReleaseRenderTarget(it->second);
+                    }
+                }
             }
+            waveBegin = waveEnd;
+        }
+    }
 
-            // After pass execution, release render targets that are no longer needed.
-            for (const auto& [rtID, lifetime] : RenderTargetLifetimes)
+    FrameGraph::PassRecordingSlot& FrameGraph::GetRecordingSlot(uint32 contextIndex)
+    {
+        // Only the participant owning the slot touches it, so it's filled without a lock.
+        PassRecordingSlot& slot = RecordingSlots[contextIndex];
+        if (slot.MainContext == nullptr)
+        {
+            slot.Owner = this;
+            slot.MainContext = new RenderContext(this);
+            slot.RenderContexts.reserve(RecordingSlots.size());
+            for (size_t index = 0; index < RecordingSlots.size(); ++index)
             {
-                if (lifetime.second != i) continue; // Not the last use yet.
+                slot.RenderContexts.push_back(new RenderContext(this));
+            }
+        }
+        return slot;
+    }
 
-                auto it = AllocatedRenderTargets.find(rtID);
-                if (it != AllocatedRenderTargets.end())
-                {
-                    Pool.ReleaseRenderTarget(it->second);
-                }
+    void FrameGraph::RecordPasses(uint32 waveBegin, uint32 waveEnd)
+    {
+        const uint32 numPasses = waveEnd - waveBegin;
+        if (RecordedPassCommands.size() < numPasses)
+        {
+            RecordedPassCommands.resize(numPasses);
+        }
+
+        auto recordPass = [this, waveBegin](uint32 index, PassRecordingSlot& slot)
+        {
+            NameHandle passName = ExecutionOrder[waveBegin + index];
+            auto passIt = Passes.find(passName);
+            if (passIt == Passes.end() || passIt->second->bCulled) [[unlikely]]
+            {
+                TAssertf(false, "Execution invalid pass \"%s\".", passName);
+                return;
             }
+            RecordPass(passIt->second.Get(), slot, RecordedPassCommands[index]);
+        };
+
+        if (numPasses == 1)
+        {
+            recordPass(0, RenderThreadSlot);
+            return;
         }
+
+        // One pass per sub range, the render thread takes part with its own slot.
+        const uint32 renderThreadContextIndex = GSyncWorkers->GetContextIndex();
+        GSyncWorkers->ParallelForRange(numPasses, [this, &recordPass, renderThreadContextIndex](uint32 begin, uint32 end, uint32 contextIndex)
+        {
+            PassRecordingSlot& slot = contextIndex == renderThreadContextIndex ? RenderThreadSlot : GetRecordingSlot(contextIndex);
+            for (uint32 index = begin; index < end; ++index)
+            {
+                recordPass(index, slot);
+            }
+        }, 1);
+    }
+
+    void FrameGraph::RecordPass(FrameGraphPass* pass, PassRecordingSlot& slot, TArray<IRHICommand*>& outCommands)
+    {
+        PassRecordingSlot* previousSlot = CurrentRecordingSlot;
+        CurrentRecordingSlot = &slot;
+
+        SetCurrentPass(pass);
+        pass->ExecuteFunction();
+        GatherContextCommands(slot, outCommands);
+
+        CurrentRecordingSlot = previousSlot;
+    }
+
+    RenderContext* FrameGraph::GetMainContext() const
+    {
+        const PassRecordingSlot* slot = CurrentRecordingSlot;
+        return slot && slot->Owner == this ? slot->MainContext : MainContext;
+    }
+
+    const TArray<RenderContext*>& FrameGraph::GetRenderContexts() const
+    {
+        const PassRecordingSlot* slot = CurrentRecordingSlot;
+        return slot && slot->Owner == this ? slot->RenderContexts : RenderContexts;
     }
 
     void FrameGraph::SetViewParameters(EViewType type, TVector4f cameraPos, const TMatrix44f& vpMatrix) const
     {
         // Render thread.
+        auto view = GetSceneView(type);
+        view->SetViewProjection(vpMatrix);
+        view->SetViewOrigin(TVector3f(cameraPos.X, cameraPos.Y, cameraPos.Z));
         auto globalParameters = GetGlobalParameters();
         globalParameters->SetVectorParameter("CameraPosition", cameraPos);
         globalParameters->SetVectorParameter("ViewProjectionMatrix0", vpMatrix.GetColumn(0));
@@ -453,12 +641,21 @@ namespace Thunder
     {
         uint32 const renderThreadIndex = GFrameState->FrameNumberRenderThread.load(std::memory_order_acquire) % 2;
 
+        // Primitives cached with a fallback shader last frame, before unregistration drops the removed ones.
+        for (auto& state : PassVisibility)
+        {
+            FallbackShaderSceneInfos.insert(state.FallbackSceneInfos.begin(), state.FallbackSceneInfos.end());
+            state.FallbackSceneInfos.clear();
+        }
+
         // Register.
         auto& registerRequests = SceneInfoRegistrationSet[renderThreadIndex];
         for (auto const& registerRequest : registerRequests)
         {
-            //registerRequest->CreateUniformBuffer();
             SceneInfos.insert(registerRequest);
+            registerRequest->SetPrimitiveIndex(PrimitiveBounds.Allocate(registerRequest));
+            registerRequest->CreateUniformBuffer();
+            PrimitiveDirtySet.insert(registerRequest);
         }
         registerRequests.clear();
 
@@ -467,21 +664,85 @@ namespace Thunder
         for (auto const& unregisterRequest : unregisterRequests)
         {
             SceneInfos.erase(unregisterRequest);
+            PrimitiveDirtySet.erase(unregisterRequest);
+            FallbackShaderSceneInfos.erase(unregisterRequest);
+            if (unregisterRequest->GetPrimitiveIndex() != InvalidPrimitiveIndex)
+            {
+                PrimitiveBounds.Free(unregisterRequest->GetPrimitiveIndex());
+                unregisterRequest->SetPrimitiveIndex(InvalidPrimitiveIndex);
+            }
+            for (uint32 passIndex = 0; passIndex < static_cast<uint32>(EMeshPass::Num); ++passIndex)
+            {
+                RetireCachedDrawCommands(unregisterRequest, static_cast<EMeshPass>(passIndex));
+            }
         }
         unregisterRequests.clear();
 
         // Update.
         SceneInfoCurrentUpdateSet.clear();
         SceneInfoCurrentUpdateSet.swap(SceneInfoUpdateSet[renderThreadIndex]);
+        PrimitiveDirtySet.insert(SceneInfoCurrentUpdateSet.begin(), SceneInfoCurrentUpdateSet.end());
+
+        // Async compiles published new variants, cache the fallback draws again. The ones still compiling come back
+        // through FallbackSceneInfos.
+        uint64 const publishedVariantEpoch = ShaderModule::GetPublishedVariantEpoch();
+        if (publishedVariantEpoch != FallbackShaderEpoch)
+        {
+            FallbackShaderEpoch = publishedVariantEpoch;
+            SceneInfoCurrentUpdateSet.insert(FallbackShaderSceneInfos.begin(), FallbackShaderSceneInfos.end());
+            FallbackShaderSceneInfos.clear();
+        }
+    }
+
+    void FrameGraph::MarkPrimitiveDirty(PrimitiveSceneInfo* sceneInfo)
+    {
+        PrimitiveDirtySet.insert(sceneInfo);
+    }
+
+    void FrameGraph::UpdatePrimitiveData_RenderThread()
+    {
+        // Only dirty primitives are touched, the rest of the buffers is kept from previous frames.
+        for (auto const& sceneInfo : PrimitiveDirtySet)
+        {
+            uint32 const primitiveIndex = sceneInfo->GetPrimitiveIndex();
+            if (primitiveIndex == InvalidPrimitiveIndex) [[unlikely]]
+            {
+                continue;
+            }
+
+            AABB worldBounds;
+            if (sceneInfo->GetWorldBounds(worldBounds))
+            {
+                PrimitiveBounds.SetBounds(primitiveIndex, worldBounds);
+            }
+            else
+            {
+                PrimitiveBounds.SetUnbounded(primitiveIndex);
+            }
+            PrimitiveSceneData.SetLocalToWorld(primitiveIndex, sceneInfo->GetTransform());
+        }
+        PrimitiveDirtySet.clear();
+
+        // Recorded before any pass, the copy is aggregated ahead of the draws reading it.
+        if (PrimitiveSceneData.Upload_RenderThread(MainContext))
+        {
+            // Cached draws still point at the old buffer's view, cache them again.
+            SceneInfoCurrentUpdateSet.insert(SceneInfos.begin(), SceneInfos.end());
+        }
     }
 
     void FrameGraph::UpdatePassSceneInfo(EMeshPass passType)
     {
+        // SceneInfoCurrentUpdateSet is only written by the render thread between frames, passes just read it.
         // Get scene infos to update.
         TArray<PrimitiveSceneInfo*> sceneInfos{};
+        sceneInfos.reserve(SceneInfoCurrentUpdateSet.size());
         for (auto const& sceneInfo : SceneInfoCurrentUpdateSet)
         {
-            sceneInfos.push_back(sceneInfo);
+            if (sceneInfo->IsMeshDrawCacheSupported())
+            {
+                sceneInfos.push_back(sceneInfo);
+            }
         }
         uint32 const sceneInfoCount = static_cast<uint32>(sceneInfos.size());
         if (sceneInfoCount == 0)
@@ -489,44 +750,31 @@ namespace Thunder
             return;
         }
 
-        // Dispatch update tasks.
-        const auto doWorkEvent = FPlatformProcess::GetSyncEventFromPool();
-        auto* dispatcher = new (TMemory::Malloc<TaskDispatcher>()) TaskDispatcher(doWorkEvent);
-        dispatcher->Promise(static_cast<int>(sceneInfoCount));
-        GSyncWorkers->ParallelFor([this, &sceneInfos, dispatcher, sceneInfoCount, passType](uint32 bundleBegin, uint32 bundleSize)
+        // Commands cached for these primitives in earlier frames are stale now.
+        for (auto const& sceneInfo : sceneInfos)
         {
-            auto const& contexts = GetRenderContexts();
-            auto context = contexts[GetContextId()];
-            for (uint32 index = bundleBegin; index < bundleBegin + bundleSize; ++index)
-            {
-                if (index >= sceneInfoCount)
-                {
-                    break;
-                }
-
-                // Cache static mesh-draw commands for current pass.
-                for (auto& sceneInfo : sceneInfos)
-                {
-                    if (sceneInfo->IsMeshDrawCacheSupported())
-                    {
-                        sceneInfo->CacheMeshDrawCommand(context, passType);
-                    }
-                }
+            RetireCachedDrawCommands(sceneInfo, passType);
+        }
 
-                dispatcher->Notify();
+        // Cache static mesh-draw commands for current pass, once per primitive.
+        auto const& contexts = GetRenderContexts();
+        GSyncWorkers->ParallelForRange(sceneInfoCount, [&contexts, &sceneInfos, passType](uint32 begin, uint32 end, uint32 contextIndex)
+        {
+            auto context = contexts[contextIndex];
+            for (uint32 index = begin; index < end; ++index)
+            {
+                sceneInfos[index]->CacheMeshDrawCommand(context, passType);
             }
-        }, sceneInfoCount);
-
-        // Wait for task to finish.
-        doWorkEvent->Wait();
-        FPlatformProcess::ReturnSyncEventToPool(doWorkEvent);
-        TMemory::Destroy(dispatcher);
-
-        // todo uptda
+        }, 4);
 
         // Finalize commands.
-        for (auto& context : RenderContexts)
+        PassVisibilityState& state = PassVisibility[static_cast<size_t>(passType)];
+        CachedPassMeshDrawList& cachedDrawList = state.CachedDrawList;
+        for (auto& context : contexts)
         {
+            auto const& fallbackSceneInfos = context->GetFallbackSceneInfos();
+            state.FallbackSceneInfos.insert(state.FallbackSceneInfos.end(), fallbackSceneInfos.begin(), fallbackSceneInfos.end());
+
             auto const& cachedCommands = context->GetCachedCommands();
             for (auto& cachedCommandEntry : cachedCommands)
             {
@@ -536,14 +784,8 @@ namespace Thunder
                 PrimitiveSceneInfo* sceneInfo = meshBatch->GetSceneInfo();
 
                 // Cache mesh-draw command.
-                auto cachedDrawListIt = CachedDrawLists.find(passType);
-                if (cachedDrawListIt == CachedDrawLists.end())
-                {
-                    CachedDrawLists[passType] = CachedPassMeshDrawList{};
-                }
-                CachedPassMeshDrawList& cachedDrawList = CachedDrawLists[passType];
-                uint64 commandIndex = command->CachedCommandIndex;
-                cachedDrawList.MeshDrawCommands[commandIndex] = command;
+                uint64 const commandIndex = cachedDrawList.Add(command);
+                command->CachedCommandIndex = commandIndex;
 
                 // Save mesh draw info.
                 sceneInfo->EmplaceDrawCommandInfo(passType, meshBatch->GetKey(), commandIndex);
@@ -553,22 +795,52 @@ namespace Thunder
         }
     }
 
+    void FrameGraph::RetireCachedDrawCommands(PrimitiveSceneInfo* sceneInfo, EMeshPass passType)
+    {
+        TArray<uint64> staleCommandIndices;
+        sceneInfo->ReleaseDrawCommandInfos(passType, staleCommandIndices);
+        if (staleCommandIndices.empty())
+        {
+            return;
+        }
+
+        CachedPassMeshDrawList& cachedDrawList = PassVisibility[static_cast<size_t>(passType)].CachedDrawList;
+        uint32 const frameIndex = GFrameState->FrameNumberRenderThread.load(std::memory_order_acquire) % 2;
+        auto guard = RetiredCachedDrawCommandsLock.Guard();
+        for (uint64 const commandIndex : staleCommandIndices)
+        {
+            // The RHI thread may still be executing last frame's list, so defer the free.
+            if (RHICachedDrawCommand* staleCommand = cachedDrawList.Remove(commandIndex))
+            {
+                RetiredCachedDrawCommands[frameIndex].push_back(staleCommand);
+            }
+        }
+    }
+
+    void FrameGraph::FreeRetiredCachedDrawCommands(uint32 frameIndex)
+    {
+        for (auto& command : RetiredCachedDrawCommands[frameIndex])
+        {
+            TMemory::Destroy(command);
+        }
+        RetiredCachedDrawCommands[frameIndex].clear();
+    }
+
     void FrameGraph::ResolveVisibility(EViewType viewType, EMeshPass passType)
     {
+        PassVisibilityState& state = PassVisibility[static_cast<size_t>(passType)];
+
         // Update pass.
         UpdatePassSceneInfo(passType);
 
-        // Cull.
+        // Cull, passes sharing the view wait for the first one.
         auto view = GetSceneView(viewType);
-        if (!view->IsCulled())
-        {
-            view->CullSceneProxies();
-        }
+        view->CullSceneProxiesOnce();
 
-        // Save visible cached mesh-draw commands.
+        // Gather visible cached mesh-draw commands with their sort keys.
         auto const& visibleSceneInfos = view->GetVisibleStaticSceneInfos();
-        auto& visibleCachedDrawList = VisibleCachedDrawLists[passType];
-        visibleCachedDrawList.clear();
+        state.SortItems.clear();
+        CachedPassMeshDrawList const& cachedDrawList = state.CachedDrawList;
         for (auto const& sceneInfo : visibleSceneInfos)
         {
             bool const isStatic = sceneInfo->IsMeshDrawCacheSupported();
@@ -579,19 +851,229 @@ namespace Thunder
             }
 
             // Add cached command.
+            uint64 const depthKey = DrawSortKey::MakeDepth(view->GetViewDistanceSquared(sceneInfo));
             auto const& staticMeshes = sceneInfo->GetStaticMeshes();
             for (const auto& batchKey : staticMeshes | std::views::keys)
             {
                 auto const& commandInfo = sceneInfo->GetDrawCommandInfo(passType, batchKey);
-                auto commandIt = CachedDrawLists[passType].MeshDrawCommands.find(commandInfo.CommandIndex);
-                if (commandIt == CachedDrawLists[passType].MeshDrawCommands.end())
+                if (commandInfo.CommandIndex == InvalidCachedCommandIndex)
+                {
+                    // Not drawn by this pass, or its shader is still compiling without a fallback.
+                    continue;
+                }
+                RHICachedDrawCommand* command = cachedDrawList.Find(commandInfo.CommandIndex);
+                if (command == nullptr) [[unlikely]]
                 {
                     TAssertf(false, "Mesh draw command index is invalid, this mesh draw is not cached yet.");
                     continue;
                 }
-                visibleCachedDrawList.push_back(commandIt->second);
+                state.SortItems.push_back({ command->SortKey | depthKey, command, sceneInfo });
+            }
+        }
+
+        // Sort by state, then front to back, so the RHI can skip redundant binds.
+        ParallelRadixSort(state.SortItems, state.SortScratch, [](const VisibleDrawSortItem& item) { return item.SortKey; });
+
+        MergeInstancedDraws(state);
+    }
+
+    namespace
+    {
+        constexpr uint32 MinMergedInstanceCount = 2;
+        constexpr uint32 MinInstanceIdsBufferSize = 1024;
+
+        // Same geometry, pipeline and bindings, except for the primitive uniform buffer which the merged draw replaces.
+        bool CanMergeDraws(RHIDrawCommand* first, RHIDrawCommand* other, size_t primitiveOffset, size_t bindingSize)
+        {
+            if (first->VBToSet != other->VBToSet || first->IBToSet != other->IBToSet
+                || first->GraphicsPSO != other->GraphicsPSO || first->Shader != other->Shader
+                || first->IndexCount != other->IndexCount || first->VertexCount != other->VertexCount
+                || first->StartIndexLocation != other->StartIndexLocation || first->BaseVertexLocation != other->BaseVertexLocation
+                || first->InstanceCount != 1 || other->InstanceCount != 1)
+            {
+                return false;
+            }
+            byte const* firstData = first->Bindings.GetSingleShaderBindings()->GetData();
+            byte const* otherData = other->Bindings.GetSingleShaderBindings()->GetData();
+            size_t const primitiveEnd = primitiveOffset + sizeof(ShaderBindingHandle);
+            return memcmp(firstData, otherData, primitiveOffset) == 0
+                && memcmp(firstData + primitiveEnd, otherData + primitiveEnd, bindingSize - primitiveEnd) == 0;
+        }
+    }
+
+    void FrameGraph::MergeInstancedDraws(PassVisibilityState& state)
+    {
+        static NameHandle primitiveUBName = "Primitive";
+        static NameHandle instanceIdsSRVName = "PrimitiveInstanceIds";
+        RenderContext* context = GetMainContext();
+        auto& sortItems = state.SortItems;
+        auto& visibleDrawList = state.VisibleDrawList;
+        visibleDrawList.clear();
+        state.MergedDrawItems.clear();
+        state.InstanceIds.clear();
+        state.InstanceGroupOffsets.clear();
+
+        uint32 const numItems = static_cast<uint32>(sortItems.size());
+        uint32 runBegin = 0;
+        while (runBegin < numItems)
+        {
+            // Draws with equal state bits are adjacent after sorting and ordered front to back among themselves. Only
+            // neighbours sharing geometry are merged, so the merged draw takes its first instance's place in that order.
+            uint64 const stateKey = sortItems[runBegin].SortKey >> DrawSortKey::DepthBits;
+            uint32 runEnd = runBegin + 1;
+            while (runEnd < numItems && (sortItems[runEnd].SortKey >> DrawSortKey::DepthBits) == stateKey)
+            {
+                ++runEnd;
+            }
+
+            uint32 groupBegin = runBegin;
+            while (groupBegin < runEnd)
+            {
+                RHIDrawCommand* first = sortItems[groupBegin].Command;
+                uint32 groupEnd = groupBegin + 1;
+
+                // Only shaders reading PrimitiveInstanceIds can be instanced.
+                ShaderBindingsLayout const* bindingsLayout = first->Shader->GetSubShader()->GetArchive()->GetBindingsLayout();
+                auto const& uniformBuffers = bindingsLayout->GetUniformBuffersNameMap();
+                auto const& srvs = bindingsLayout->GetSRVsNameMap();
+                auto const primitiveIt = uniformBuffers.find(primitiveUBName);
+                auto const instanceIdsIt = srvs.find(instanceIdsSRVName);
+                bool const canInstance = primitiveIt != uniformBuffers.end() && instanceIdsIt != srvs.end();
+                if (canInstance)
+                {
+                    size_t const bindingSize = bindingsLayout->GetTotalSize();
+                    size_t const primitiveOffset = SingleShaderBindings::CalculateOffset(bindingsLayout, primitiveIt->second.Index, EShaderParameterType::UniformBuffer);
+                    while (groupEnd < runEnd && CanMergeDraws(first, sortItems[groupEnd].Command, primitiveOffset, bindingSize))
+                    {
+                        ++groupEnd;
+                    }
+                }
+
+                uint32 const instanceCount = groupEnd - groupBegin;
+                if (instanceCount < MinMergedInstanceCount)
+                {
+                    visibleDrawList.push_back(first);
+                    groupBegin = groupEnd;
+                    continue;
+                }
+
+                RHIUniformBuffer* primitiveUB = GetInstanceGroupUniformBuffer(state, static_cast<uint32>(state.InstanceGroupOffsets.size()));
+                if (primitiveUB == nullptr) [[unlikely]]
+                {
+                    for (uint32 index = groupBegin; index < groupEnd; ++index)
+                    {
+                        visibleDrawList.push_back(sortItems[index].Command);
+                    }
+                    groupBegin = groupEnd;
+                    continue;
+                }
+
+                // Per-instance primitive indices, transforms are read from the scene data buffer.
+                state.InstanceGroupOffsets.push_back(static_cast<uint32>(state.InstanceIds.size()));
+                for (uint32 index = groupBegin; index < groupEnd; ++index)
+                {
+                    state.InstanceIds.push_back(sortItems[index].SceneInfo->GetPrimitiveIndex());
+                }
+
+                // Frame-lifetime copy of the first draw, the cached commands stay untouched. Nothing is destructed after
+                // execution, the copy goes away with the context's transient memory when it is reset.
+                RHIDrawCommand* merged = context->NewCommand<RHIDrawCommand>();
+                merged->VBToSet = first->VBToSet;
+                merged->IBToSet = first->IBToSet;
+                merged->GraphicsPSO = first->GraphicsPSO;
+                merged->Shader = first->Shader;
+                merged->SortKey = first->SortKey;
+                merged->IndexCount = first->IndexCount;
+                merged->VertexCount = first->VertexCount;
+                merged->StartIndexLocation = first->StartIndexLocation;
+                merged->BaseVertexLocation = first->BaseVertexLocation;
+                merged->InstanceCount = instanceCount;
+
+                size_t const bindingSize = bindingsLayout->GetTotalSize();
+                byte* bindingData = static_cast<byte*>(context->Allocate<byte>(bindingSize));
+                memcpy(bindingData, first->Bindings.GetSingleShaderBindings()->GetData(), bindingSize);
+                merged->Bindings.SetTransientAllocated(true);
+                merged->Bindings.SetBindingsData(bindingData);
+                merged->Bindings.GetSingleShaderBindings()->SetUniformBuffer(bindingsLayout, primitiveIt->second.Index,
+                    { .Handle = reinterpret_cast<uint64>(primitiveUB) });
+
+                visibleDrawList.push_back(merged);
+                state.MergedDrawItems.push_back({ merged, instanceIdsIt->second.Index });
+                groupBegin = groupEnd;
+            }
+            runBegin = runEnd;
+        }
+
+        if (state.MergedDrawItems.empty())
+        {
+            return;
+        }
+
+        // The group table goes first, a group's uniform buffer only holds its index into it.
+        uint32 const numGroups = static_cast<uint32>(state.InstanceGroupOffsets.size());
+        for (uint32& offset : state.InstanceGroupOffsets)
+        {
+            offset += numGroups;
+        }
+        state.InstanceIds.insert(state.InstanceIds.begin(), state.InstanceGroupOffsets.begin(), state.InstanceGroupOffsets.end());
+
+        // The buffer exists once all rows are known, patch its SRV into the merged draws.
+        uint64 const instanceIdsSRV = UploadInstanceIds(state);
+        for (auto const& item : state.MergedDrawItems)
+        {
+            ShaderBindingsLayout const* bindingsLayout = item.Command->Shader->GetSubShader()->GetArchive()->GetBindingsLayout();
+            item.Command->Bindings.GetSingleShaderBindings()->SetSRV(bindingsLayout, item.InstanceIdsSRVIndex, { .Handle = instanceIdsSRV });
+        }
+    }
+
+    uint64 FrameGraph::UploadInstanceIds(PassVisibilityState& state)
+    {
+        // One upload-heap buffer per pass and frame in flight, grown on demand and rewritten in place.
+        uint32 const frameIndex = GFrameState->FrameNumberRenderThread.load(std::memory_order_acquire) % MAX_FRAME_LAG;
+        InstanceIdsBuffer& instanceIds = state.InstanceIdsBuffers[frameIndex];
+        uint32 const numIds = static_cast<uint32>(state.InstanceIds.size());
+        if (!instanceIds.Buffer.IsValid() || instanceIds.NumIds < numIds)
+        {
+            if (instanceIds.Buffer.IsValid())
+            {
+                RHIDeferredDeleteResource(std::move(instanceIds.Buffer));
+            }
+            instanceIds.NumIds = std::bit_ceil(std::max(numIds, MinInstanceIdsBufferSize));
+            instanceIds.Buffer = RHICreateStructuredBuffer(instanceIds.NumIds * static_cast<uint32>(sizeof(uint32)), EBufferCreateFlags::Dynamic);
+            if (!instanceIds.Buffer.IsValid()) [[unlikely]]
+            {
+                TAssertf(false, "Failed to create instance ids buffer.");
+                instanceIds.NumIds = 0;
+                return 0;
             }
+            RHICreateShaderResourceView(*instanceIds.Buffer, {
+                .Format = RHIFormat::UNKNOWN,
+                .Type = ERHIViewDimension::Buffer,
+                .Width = instanceIds.NumIds,
+                .Height = 1,
+                .DepthOrArraySize = 1,
+                .StructureByteStride = static_cast<uint32>(sizeof(uint32))
+            });
         }
+
+        RHIUpdateSharedMemoryResource(instanceIds.Buffer.Get(), state.InstanceIds.data(), numIds * static_cast<uint32>(sizeof(uint32)), 0);
+        RHIShaderResourceView* srv = instanceIds.Buffer->GetSRV();
+        return srv ? srv->GetOfflineHandle() : 0;
+    }
+
+    RHIUniformBuffer* FrameGraph::GetInstanceGroupUniformBuffer(PassVisibilityState& state, uint32 group)
+    {
+        // The content only depends on the group index, so every frame reuses the same buffers.
+        if (group >= state.InstanceGroupUniformBuffers.size())
+        {
+            state.InstanceGroupUniformBuffers.resize(group + 1);
+        }
+        TRefCountPtr<RHIUniformBuffer>& uniformBuffer = state.InstanceGroupUniformBuffers[group];
+        if (!uniformBuffer.IsValid())
+        {
+            uniformBuffer = PrimitiveSceneInfo::CreateInstancedUniformBuffer(static_cast<int>(group));
+        }
+        return uniformBuffer.Get();
     }
 
     void FrameGraph::AddPass(const String& name, PassOperations&& operations, PassExecutionFunction&& executeFunction)
@@ -643,7 +1125,7 @@ namespace Thunder
             return;
         }
 
-        byte* constantData = RenderModule::SetupUniformBufferParameters(MainContext, layout, CachedGlobalParameters, "Global");
+        const byte* constantData = RenderModule::SetupUniformBufferParameters(GlobalUBPacking, layout, CachedGlobalParameters, "Global");
         if (GlobalUniformBuffer.IsValid())
         {
             //RHIDeferredDeleteResource(std::move(GlobalUniformBuffer));
@@ -657,6 +1139,7 @@ namespace Thunder
 
     ShaderParameterMap* FrameGraph::GetPassParameters(EMeshPass pass)
     {
+        auto guard = PassParametersLock.Guard();
         auto it = PassParameters.find(pass);
         if (it == PassParameters.end())
         {
@@ -677,12 +1160,18 @@ namespace Thunder
             TAssertf(false, "Cannot update uniform buffer: UniformBufferLayout \"%s\" not found.", ubName);
             return;
         }
+
+        // Map nodes are stable, each mesh pass's entries are only written by the pass updating them.
+        auto guard = PassParametersLock.Guard();
         TRefCountPtr<RHIUniformBuffer>& passUniformBuffer = PassUniformBufferMap.at(pass);
-        byte* constantData = RenderModule::SetupUniformBufferParameters(MainContext, layout, parameters, ubName);
+        UniformBufferPackingProgram& packing = PassUBPackings[pass];
+        guard.Unlock();
+
+        const byte* constantData = RenderModule::SetupUniformBufferParameters(packing, layout, parameters, ubName);
         if (passUniformBuffer.IsValid())
         {
             //RHIDeferredDeleteResource(std::move(passUniformBuffer));
-            RHIUpdateUniformBuffer(MainContext, passUniformBuffer, constantData);
+            RHIUpdateUniformBuffer(GetMainContext(), passUniformBuffer, constantData);
         }
         else
         {
@@ -692,6 +1181,7 @@ namespace Thunder
 
     const RHIUniformBuffer* FrameGraph::GetPassUniformBuffer(EMeshPass pass) const
     {
+        auto guard = PassParametersLock.Guard();
         auto it = PassUniformBufferMap.find(pass);
         if (it == PassUniformBufferMap.end()) [[unlikely]]
         {
@@ -715,13 +1205,17 @@ namespace Thunder
         }
         RenderContexts.clear();
 
-        // Create new contexts for each thread
-        uint32 threadCount = GSyncWorkers->GetNumThreads();
+        // Create new contexts for each ParallelForRange context, pool threads and the outside threads joining in.
+        uint32 threadCount = GSyncWorkers->GetNumContexts();
         RenderContexts.reserve(threadCount);
         for (uint32 i = 0; i < threadCount; ++i)
         {
             RenderContexts.push_back(new RenderContext(this));
         }
+
+        // One recording slot per ParallelForRange context, the render thread's own contexts are kept apart.
+        RecordingSlots.resize(threadCount);
+        RenderThreadSlot = { this, MainContext, RenderContexts };
     }
 
     void FrameGraph::RegisterRenderTarget(FGRenderTarget* renderTarget, TVector2u resolution)
@@ -739,6 +1233,8 @@ namespace Thunder
     {
         Pool.TickUnusedFrameCounters();
         Pool.ReleaseLongUnusedTargets();
+        TransientHeap.TickUnusedFrameCounters();
+        TransientHeap.ReleaseLongUnusedTargets();
     }
 
     void FrameGraph::CullUnusedPasses() const
@@ -914,10 +1410,125 @@ namespace Thunder
                 }
             }
         }
+
+        // Flatten into per-pass lists: each pass's range holds the targets it acquires, then the ones it releases.
+        CompiledPassTargets.assign(ExecutionOrder.size(), {});
+        for (const auto& lifetime : RenderTargetLifetimes | std::views::values)
+        {
+            CompiledPassTargets[lifetime.first].NumAcquired++;
+            CompiledPassTargets[lifetime.second].NumReleased++;
+        }
+        uint32 numEvents = 0;
+        for (CompiledPassTargetRange& range : CompiledPassTargets)
+        {
+            range.Begin = numEvents;
+            numEvents += range.NumAcquired + range.NumReleased;
+        }
+        CompiledTargetEvents.resize(numEvents);
+
+        TArray<uint32> acquireCursor(ExecutionOrder.size());
+        TArray<uint32> releaseCursor(ExecutionOrder.size());
+        for (size_t execIndex = 0; execIndex < ExecutionOrder.size(); ++execIndex)
+        {
+            acquireCursor[execIndex] = CompiledPassTargets[execIndex].Begin;
+            releaseCursor[execIndex] = CompiledPassTargets[execIndex].Begin + CompiledPassTargets[execIndex].NumAcquired;
+        }
+        for (const auto& [rtID, lifetime] : RenderTargetLifetimes)
+        {
+            CompiledTargetEvents[acquireCursor[lifetime.first]++] = rtID;
+            CompiledTargetEvents[releaseCursor[lifetime.second]++] = rtID;
+        }
+    }
+
+    void FrameGraph::ScheduleRecordingWaves()
+    {
+        // A pass starts a new wave when it reads a target written earlier in the current one.
+        CompiledWaveEnds.clear();
+        THashSet<uint32> waveWriteTargets;
+        for (uint32 execIndex = 0; execIndex < static_cast<uint32>(ExecutionOrder.size()); ++execIndex)
+        {
+            PassOperations& operations = Passes[ExecutionOrder[execIndex]]->Operations;
+            const bool bReadsWave = std::ranges::any_of(operations.GetReadTargets() | std::views::keys,
+                [&waveWriteTargets](uint32 rtID) { return waveWriteTargets.contains(rtID); });
+            if (execIndex > 0 && (bReadsWave || !bParallelPassRecording))
+            {
+                CompiledWaveEnds.push_back(execIndex);
+                waveWriteTargets.clear();
+            }
+            for (uint32 rtID : operations.GetWriteTargets() | std::views::keys)
+            {
+                waveWriteTargets.insert(rtID);
+            }
+        }
+        if (!ExecutionOrder.empty())
+        {
+            CompiledWaveEnds.push_back(static_cast<uint32>(ExecutionOrder.size()));
+        }
+    }
+
+    uint64 FrameGraph::HashGraphDeclarations()
+    {
+        uint64 hash = MixGraphHash(std::hash<NameHandle>{}(PresentPassName), RenderTargets.size());
+        for (NameHandle passName : CurrentFramePasses)
+        {
+            hash = MixGraphHash(hash, std::hash<NameHandle>{}(passName));
+            auto passIt = Passes.find(passName);
+            if (passIt == Passes.end()) [[unlikely]]
+            {
+                continue;
+            }
+            PassOperations& operations = passIt->second->Operations;
+            for (uint32 rtID : operations.GetReadTargets() | std::views::keys)
+            {
+                hash = MixGraphHash(hash, rtID);
+            }
+            hash = MixGraphHash(hash, ~0ull); // Keeps a target moving from the read to the write set from hashing the same.
+            for (uint32 rtID : operations.GetWriteTargets() | std::views::keys)
+            {
+                hash = MixGraphHash(hash, rtID);
+            }
+        }
+        return hash;
+    }
+
+    bool FrameGraph::AllocatePlacedRenderTargets()
+    {
+        TArray<uint32> rtIDs;
+        TArray<TransientRenderTargetRequest> requests;
+        rtIDs.reserve(RenderTargetLifetimes.size());
+        requests.reserve(RenderTargetLifetimes.size());
+        for (const auto& [rtID, lifetime] : RenderTargetLifetimes)
+        {
+            auto rtIt = RenderTargets.find(rtID);
+            if (rtIt == RenderTargets.end())
+            {
+                continue;
+            }
+            rtIDs.push_back(rtID);
+            requests.push_back({ &rtIt->second->GetDesc(), static_cast<uint32>(lifetime.first), static_cast<uint32>(lifetime.second) });
+        }
+
+        TArray<RenderTextureRef> placedTargets;
+        if (!TransientHeap.AllocateRenderTargets(requests, placedTargets))
+        {
+            return false;
+        }
+        for (size_t index = 0; index < rtIDs.size(); ++index)
+        {
+            AllocatedRenderTargets[rtIDs[index]] = placedTargets[index];
+            PlacedRenderTargets.insert(rtIDs[index]);
+        }
+        return true;
     }
 
     void FrameGraph::AllocateRenderTargets()
     {
+        // Alias targets with disjoint lifetimes in one heap when the RHI can place them.
+        if (AllocatePlacedRenderTargets())
+        {
+            return;
+        }
+
         // Group render targets by their allocation time and compatible specs for reuse
         TArray<std::pair<uint32, std::pair<size_t, size_t>>> sortedLifetimes;
         for (const auto& [rtID, lifetime] : RenderTargetLifetimes)
@@ -19,55 +19,36 @@ namespace Thunder
         FrameGraph = nullptr;
     }
 
-    void IRenderer::UpdatePrimitiveUniformBuffer_GameThread(PrimitiveSceneInfo* sceneInfo)
+    void IRenderer::UpdatePrimitiveData_GameThread(PrimitiveSceneInfo* sceneInfo)
     {
         uint32 const gameThreadIndex = GFrameState->FrameNumberGameThread.load(std::memory_order_acquire) % 2;
-        PrimitiveUniformBufferUpdateSet[gameThreadIndex].insert(sceneInfo);
+        PrimitiveDataUpdateSet[gameThreadIndex].insert(sceneInfo);
     }
 
-    void IRenderer::UpdatePrimitiveUniformBuffer_RenderThread()
+    void IRenderer::UpdatePrimitiveTransforms_GameThread(const PrimitiveTransformUpdate* updates, uint32 count)
     {
-        uint32 const renderThreadIndex = GFrameState->FrameNumberRenderThread.load(std::memory_order_acquire) % 2;
-        TSet<PrimitiveSceneInfo*> PrimitiveUniformBufferCurrentUpdateSet;
-        PrimitiveUniformBufferCurrentUpdateSet.swap(PrimitiveUniformBufferUpdateSet[renderThreadIndex]);
+        uint32 const gameThreadIndex = GFrameState->FrameNumberGameThread.load(std::memory_order_acquire) % 2;
+        PrimitiveTransformUpdates[gameThreadIndex].insert(PrimitiveTransformUpdates[gameThreadIndex].end(), updates, updates + count);
+    }
 
-        // Get scene infos to update.
-        TArray<PrimitiveSceneInfo*> sceneInfos{};
-        sceneInfos.reserve(PrimitiveUniformBufferCurrentUpdateSet.size());
-        for (auto const& sceneInfo : PrimitiveUniformBufferCurrentUpdateSet)
-        {
-            sceneInfos.push_back(sceneInfo);
-        }
-        uint32 const sceneInfoCount = static_cast<uint32>(sceneInfos.size());
-        if (sceneInfoCount == 0)
+    void IRenderer::UpdatePrimitiveData_RenderThread()
+    {
+        uint32 const renderThreadIndex = GFrameState->FrameNumberRenderThread.load(std::memory_order_acquire) % 2;
+        auto& primitiveTransformUpdates = PrimitiveTransformUpdates[renderThreadIndex];
+        for (auto const& update : primitiveTransformUpdates)
         {
-            return;
+            update.SceneInfo->SetTransform(update.Transform);
+            FrameGraph->MarkPrimitiveDirty(update.SceneInfo);
         }
+        primitiveTransformUpdates.clear();
 
-        // Dispatch update tasks.
-        const auto doWorkEvent = FPlatformProcess::GetSyncEventFromPool();
-        auto* dispatcher = new (TMemory::Malloc<TaskDispatcher>()) TaskDispatcher(doWorkEvent);
-        dispatcher->Promise(static_cast<int>(sceneInfoCount));
-        GSyncWorkers->ParallelFor([this, &sceneInfos, dispatcher, sceneInfoCount](uint32 bundleBegin, uint32 bundleSize)
-        {
-            auto const& contexts = FrameGraph->GetRenderContexts();
-            auto context = contexts[GetContextId()];
-            for (uint32 index = bundleBegin; index < bundleBegin + bundleSize; ++index)
-            {
-                if (index >= sceneInfoCount)
-                {
-                    break;
-                }
-                auto sceneInfo = sceneInfos[index];
-                sceneInfo->UpdatePrimitiveUniformBuffer(context);
-
-                dispatcher->Notify();
-            }
-        }, sceneInfoCount);
+        auto& primitiveDataUpdateSet = PrimitiveDataUpdateSet[renderThreadIndex];
 
-        // Wait for task to finish.
-        doWorkEvent->Wait();
-        FPlatformProcess::ReturnSyncEventToPool(doWorkEvent);
-        TMemory::Destroy(dispatcher);
+        // Transforms are gathered into the scene data buffer by FrameGraph.
+        for (auto const& sceneInfo : primitiveDataUpdateSet)
+        {
+            FrameGraph->MarkPrimitiveDirty(sceneInfo);
+        }
+        primitiveDataUpdateSet.clear();
     }
 }
@@ -8,6 +8,7 @@
 //#include "UniformBuffer.h"
 #include "FrameGraph.h"
 #include "IDynamicRHI.h"
+#include "PipelineStateCache.h"
 #include "RHICommand.h"
 #include "RHI.h"
 #include "ShaderModule.h"
@@ -32,25 +33,37 @@ namespace Thunder
         auto const& elements = batch->GetElements();
         for (auto const& meshBatchElement : elements)
         {
-            RHIDrawCommand* newCommand = (cacheMeshDrawCommand) ?
-                new (TMemory::Malloc<RHICachedDrawCommand>()) RHICachedDrawCommand :
-                new (context->Allocate<RHIDrawCommand>()) RHIDrawCommand;
             RenderMaterial* material = meshBatchElement.Material;
             SubMesh* subMesh = meshBatchElement.SubMesh;
 
-            // vb ib
-            newCommand->VBToSet = subMesh->GetVerticesBuffer();
-            newCommand->IBToSet = subMesh->GetIndicesBuffer();
-            newCommand->VertexCount = static_cast<uint32>(subMesh->GetVertices()->GetDataNum());
-            newCommand->IndexCount = static_cast<uint32>(subMesh->GetIndices()->GetDataNum());
-
-            // Get shader variant first.
-            ShaderCombination* shaderVariant = GetShaderCombination(meshPassType, material);
+            // Get shader variant first. Cached commands take the fallback too, the frame graph caches them again once
+            // the variant is published.
+            bool isFallback = false;
+            ShaderCombination* shaderVariant = GetShaderCombination(meshPassType, material, &isFallback);
+            if (isFallback && cacheMeshDrawCommand)
+            {
+                context->AddFallbackSceneInfo(batch->GetSceneInfo());
+            }
             if (!shaderVariant) [[unlikely]]
             {
+                if (ShaderModule::IsAsyncCompilationEnabled())
+                {
+                    // Still compiling and there is no fallback yet, skip the element this frame.
+                    continue;
+                }
                 TAssertf(false, "Fail to prepare mesh draw command, Shader variant not found.");
                 return false;
             }
+
+            RHIDrawCommand* newCommand = (cacheMeshDrawCommand) ?
+                new (TMemory::Malloc<RHICachedDrawCommand>()) RHICachedDrawCommand :
+                context->NewCommand<RHIDrawCommand>();
+
+            // vb ib
+            newCommand->VBToSet = subMesh->GetVerticesBuffer();
+            newCommand->IBToSet = subMesh->GetIndicesBuffer();
+            newCommand->VertexCount = static_cast<uint32>(subMesh->GetVertices()->GetDataNum());
+            newCommand->IndexCount = static_cast<uint32>(subMesh->GetIndices()->GetDataNum());
             newCommand->Shader = shaderVariant;
 
             // Fetch PSO.
@@ -64,6 +77,7 @@ namespace Thunder
 
             // Apply shader bindings.
             ApplyShaderBindings(context, newCommand, shaderVariant, material, batch->GetSceneInfo(), meshPassType, cacheMeshDrawCommand);
+            newCommand->SortKey = DrawSortKey::MakeState(pso, shaderVariant, material);
 
             // Add mesh-draw command.
             FinalizeCommand(context, batch, newCommand, cacheMeshDrawCommand);
@@ -84,18 +98,18 @@ namespace Thunder
         }
     }
 
-    ShaderCombination* MeshPassProcessor::GetShaderCombination(EMeshPass meshPassType, const RenderMaterial* material)
+    ShaderCombination* MeshPassProcessor::GetShaderCombination(EMeshPass meshPassType, const RenderMaterial* material, bool* outIsFallback)
     {
         auto shaderAst = material->GetShaderArchive();
         uint64 shaderVariantMask = ShaderModule::GetVariantMask(shaderAst, material->GetStaticSwitchParameters());
-        ShaderCombination* shaderVariant = ShaderModule::GetShaderCombination(shaderAst, meshPassType, shaderVariantMask);
+        ShaderCombination* shaderVariant = ShaderModule::GetShaderCombination(shaderAst, meshPassType, shaderVariantMask, outIsFallback);
         return shaderVariant;
     }
 
     TRHIGraphicsPipelineState* MeshPassProcessor::GetPipelineState(const RenderContext* context, ShaderCombination* shaderCombination, EMeshPass meshPassType, const SubMesh* subMesh, RenderMaterial* material)
     {
-        // Set shader.
-        TGraphicsPipelineStateDescriptor psoDesc;
+        // Set shader. The descriptor is reused so its vertex declaration keeps capacity, a cache hit allocates nothing.
+        thread_local TGraphicsPipelineStateDescriptor psoDesc;
         if (!shaderCombination) [[unlikely]]
         {
             // Shader is not ready yet.
@@ -136,8 +150,7 @@ namespace Thunder
             return nullptr;
         }
 
-        auto pipelineStateObject = RHICreateGraphicsPipelineState(psoDesc);
-        return pipelineStateObject;
+        return GetGraphicsPipelineState(psoDesc);
     }
 
     void MeshPassProcessor::ApplyShaderBindings(RenderContext* context, RHIDrawCommand* command, ShaderCombination* shader, RenderMaterial* material, PrimitiveSceneInfo* sceneInfo, EMeshPass meshPassType, bool cacheMeshDrawCommand)
@@ -202,6 +215,13 @@ namespace Thunder
             bindings->SetUniformBuffer(bindingsLayout, primitiveUBName, { .Handle = reinterpret_cast<uint64>(primitiveUB) });
         }
 
+        // Scene-wide primitive data.
+        static NameHandle primitiveSceneDataName = "PrimitiveSceneData";
+        if (bindingsLayout->GetSRVsNameMap().contains(primitiveSceneDataName))
+        {
+            bindings->SetSRV(bindingsLayout, primitiveSceneDataName, { .Handle = context->GetFrameGraph()->GetPrimitiveSceneDataSRV() });
+        }
+
         // Bind textures.
         auto const& textureParameterMap = material->GetTextureParameters();
         for (const auto& textureParameterEntry : textureParameterMap)
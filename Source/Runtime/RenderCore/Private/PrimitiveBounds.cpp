@@ -0,0 +1,216 @@
+#include "PrimitiveBounds.h"
+#include "Assertion.h"
+#include "Platform.h"
+
+#if PLATFORM_CPU_X86_FAMILY
+#include <immintrin.h>
+#endif
+
+namespace Thunder
+{
+    namespace
+    {
+        constexpr float UnboundedExtent = 1e30f; // Large but finite, so 0 * extent stays 0.
+
+#if PLATFORM_CPU_X86_FAMILY && defined(__AVX__)
+        // 8 boxes against all planes, returns one bit per box.
+        FORCEINLINE uint32 CullEight(const ViewFrustum& frustum, const float* cx, const float* cy, const float* cz,
+            const float* ex, const float* ey, const float* ez)
+        {
+            const __m256 centerX = _mm256_loadu_ps(cx);
+            const __m256 centerY = _mm256_loadu_ps(cy);
+            const __m256 centerZ = _mm256_loadu_ps(cz);
+            const __m256 extentX = _mm256_loadu_ps(ex);
+            const __m256 extentY = _mm256_loadu_ps(ey);
+            const __m256 extentZ = _mm256_loadu_ps(ez);
+            const __m256 zero = _mm256_setzero_ps();
+            __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+            for (uint32 plane = 0; plane < frustum.NumPlanes; ++plane)
+            {
+                const __m256 distance = _mm256_add_ps(_mm256_add_ps(
+                    _mm256_mul_ps(centerX, _mm256_set1_ps(frustum.NormalX[plane])),
+                    _mm256_mul_ps(centerY, _mm256_set1_ps(frustum.NormalY[plane]))), _mm256_add_ps(
+                    _mm256_mul_ps(centerZ, _mm256_set1_ps(frustum.NormalZ[plane])),
+                    _mm256_set1_ps(frustum.Distance[plane])));
+                const __m256 radius = _mm256_add_ps(_mm256_add_ps(
+                    _mm256_mul_ps(extentX, _mm256_set1_ps(std::abs(frustum.NormalX[plane]))),
+                    _mm256_mul_ps(extentY, _mm256_set1_ps(std::abs(frustum.NormalY[plane])))),
+                    _mm256_mul_ps(extentZ, _mm256_set1_ps(std::abs(frustum.NormalZ[plane]))));
+                inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, radius), zero, _CMP_GE_OQ));
+            }
+            return static_cast<uint32>(_mm256_movemask_ps(inside));
+        }
+#elif PLATFORM_CPU_X86_FAMILY
+        // 4 boxes against all planes, returns one bit per box.
+        FORCEINLINE uint32 CullFour(const ViewFrustum& frustum, const float* cx, const float* cy, const float* cz,
+            const float* ex, const float* ey, const float* ez)
+        {
+            const __m128 centerX = _mm_loadu_ps(cx);
+            const __m128 centerY = _mm_loadu_ps(cy);
+            const __m128 centerZ = _mm_loadu_ps(cz);
+            const __m128 extentX = _mm_loadu_ps(ex);
+            const __m128 extentY = _mm_loadu_ps(ey);
+            const __m128 extentZ = _mm_loadu_ps(ez);
+            const __m128 zero = _mm_setzero_ps();
+            __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+            for (uint32 plane = 0; plane < frustum.NumPlanes; ++plane)
+            {
+                const __m128 distance = _mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(centerX, _mm_set1_ps(frustum.NormalX[plane])),
+                    _mm_mul_ps(centerY, _mm_set1_ps(frustum.NormalY[plane]))), _mm_add_ps(
+                    _mm_mul_ps(centerZ, _mm_set1_ps(frustum.NormalZ[plane])),
+                    _mm_set1_ps(frustum.Distance[plane])));
+                const __m128 radius = _mm_add_ps(_mm_add_ps(
+                    _mm_mul_ps(extentX, _mm_set1_ps(std::abs(frustum.NormalX[plane]))),
+                    _mm_mul_ps(extentY, _mm_set1_ps(std::abs(frustum.NormalY[plane])))),
+                    _mm_mul_ps(extentZ, _mm_set1_ps(std::abs(frustum.NormalZ[plane]))));
+                inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, radius), zero));
+            }
+            return static_cast<uint32>(_mm_movemask_ps(inside));
+        }
+#endif
+    }
+
+    void ViewFrustum::SetViewProjection(const TMatrix44f& viewProjection)
+    {
+        // Row vectors: clip = p * M, so clip.x = p . column0 and so on.
+        auto const& m = viewProjection.M;
+        auto setPlane = [this, &m](uint32 plane, float sx, float sy, float sz, float sw)
+        {
+            NormalX[plane] = sx * m[0][0] + sy * m[0][1] + sz * m[0][2] + sw * m[0][3];
+            NormalY[plane] = sx * m[1][0] + sy * m[1][1] + sz * m[1][2] + sw * m[1][3];
+            NormalZ[plane] = sx * m[2][0] + sy * m[2][1] + sz * m[2][2] + sw * m[2][3];
+            Distance[plane] = sx * m[3][0] + sy * m[3][1] + sz * m[3][2] + sw * m[3][3];
+        };
+        setPlane(0, 1.f, 0.f, 0.f, 1.f);  // Left:   w + x >= 0
+        setPlane(1, -1.f, 0.f, 0.f, 1.f); // Right:  w - x >= 0
+        setPlane(2, 0.f, 1.f, 0.f, 1.f);  // Bottom: w + y >= 0
+        setPlane(3, 0.f, -1.f, 0.f, 1.f); // Top:    w - y >= 0
+        setPlane(4, 0.f, 0.f, 1.f, 0.f);  // Near:   z >= 0
+        setPlane(5, 0.f, 0.f, -1.f, 1.f); // Far:    w - z >= 0
+        NumPlanes = 6;
+        for (uint32 plane = NumPlanes; plane < MaxPlanes; ++plane)
+        {
+            NormalX[plane] = NormalY[plane] = NormalZ[plane] = 0.f;
+            Distance[plane] = 1.f;
+        }
+    }
+
+    uint32 PrimitiveBoundsBuffer::Allocate(PrimitiveSceneInfo* sceneInfo)
+    {
+        if (FreeSlots.empty())
+        {
+            Grow();
+        }
+        uint32 const primitiveIndex = FreeSlots.back();
+        FreeSlots.pop_back();
+
+        Primitives[primitiveIndex] = sceneInfo;
+        ActiveMask[primitiveIndex / SlotsPerWord] |= (1ull << (primitiveIndex % SlotsPerWord));
+        SetUnbounded(primitiveIndex);
+        return primitiveIndex;
+    }
+
+    void PrimitiveBoundsBuffer::Free(uint32 primitiveIndex)
+    {
+        if (primitiveIndex >= GetNumSlots() || Primitives[primitiveIndex] == nullptr) [[unlikely]]
+        {
+            TAssertf(false, "Freeing invalid primitive index %u.", primitiveIndex);
+            return;
+        }
+        Primitives[primitiveIndex] = nullptr;
+        ActiveMask[primitiveIndex / SlotsPerWord] &= ~(1ull << (primitiveIndex % SlotsPerWord));
+        FreeSlots.push_back(primitiveIndex);
+    }
+
+    void PrimitiveBoundsBuffer::SetBounds(uint32 primitiveIndex, const AABB& worldBounds)
+    {
+        CenterX[primitiveIndex] = (worldBounds.Min.X + worldBounds.Max.X) * 0.5f;
+        CenterY[primitiveIndex] = (worldBounds.Min.Y + worldBounds.Max.Y) * 0.5f;
+        CenterZ[primitiveIndex] = (worldBounds.Min.Z + worldBounds.Max.Z) * 0.5f;
+        ExtentX[primitiveIndex] = (worldBounds.Max.X - worldBounds.Min.X) * 0.5f;
+        ExtentY[primitiveIndex] = (worldBounds.Max.Y - worldBounds.Min.Y) * 0.5f;
+        ExtentZ[primitiveIndex] = (worldBounds.Max.Z - worldBounds.Min.Z) * 0.5f;
+    }
+
+    void PrimitiveBoundsBuffer::SetUnbounded(uint32 primitiveIndex)
+    {
+        CenterX[primitiveIndex] = CenterY[primitiveIndex] = CenterZ[primitiveIndex] = 0.f;
+        ExtentX[primitiveIndex] = ExtentY[primitiveIndex] = ExtentZ[primitiveIndex] = UnboundedExtent;
+    }
+
+    void PrimitiveBoundsBuffer::Grow()
+    {
+        uint32 const oldSlots = GetNumSlots();
+        uint32 const newSlots = oldSlots + SlotsPerWord;
+        CenterX.resize(newSlots, 0.f);
+        CenterY.resize(newSlots, 0.f);
+        CenterZ.resize(newSlots, 0.f);
+        ExtentX.resize(newSlots, 0.f);
+        ExtentY.resize(newSlots, 0.f);
+        ExtentZ.resize(newSlots, 0.f);
+        Primitives.resize(newSlots, nullptr);
+        ActiveMask.push_back(0);
+
+        // Hand out low indices first.
+        for (uint32 slot = newSlots; slot > oldSlots; --slot)
+        {
+            FreeSlots.push_back(slot - 1);
+        }
+    }
+
+    void PrimitiveBoundsBuffer::Cull(const ViewFrustum& frustum, uint32 beginWord, uint32 endWord, uint64* outVisibility) const
+    {
+        for (uint32 word = beginWord; word < endWord; ++word)
+        {
+            uint64 const active = ActiveMask[word];
+            if (active == 0 || !frustum.IsValid())
+            {
+                outVisibility[word - beginWord] = active;
+                continue;
+            }
+
+            uint32 const base = word * SlotsPerWord;
+            const float* cx = CenterX.data() + base;
+            const float* cy = CenterY.data() + base;
+            const float* cz = CenterZ.data() + base;
+            const float* ex = ExtentX.data() + base;
+            const float* ey = ExtentY.data() + base;
+            const float* ez = ExtentZ.data() + base;
+            uint64 visible = 0;
+#if PLATFORM_CPU_X86_FAMILY && defined(__AVX__)
+            for (uint32 lane = 0; lane < SlotsPerWord; lane += 8)
+            {
+                visible |= static_cast<uint64>(CullEight(frustum, cx + lane, cy + lane, cz + lane, ex + lane, ey + lane, ez + lane)) << lane;
+            }
+#elif PLATFORM_CPU_X86_FAMILY
+            for (uint32 lane = 0; lane < SlotsPerWord; lane += 4)
+            {
+                visible |= static_cast<uint64>(CullFour(frustum, cx + lane, cy + lane, cz + lane, ex + lane, ey + lane, ez + lane)) << lane;
+            }
+#else
+            for (uint32 lane = 0; lane < SlotsPerWord; ++lane)
+            {
+                visible |= static_cast<uint64>(IsVisible(frustum, base + lane)) << lane;
+            }
+#endif
+            outVisibility[word - beginWord] = visible & active;
+        }
+    }
+
+    bool PrimitiveBoundsBuffer::IsVisible(const ViewFrustum& frustum, uint32 primitiveIndex) const
+    {
+        for (uint32 plane = 0; plane < frustum.NumPlanes; ++plane)
+        {
+            float const distance = frustum.NormalX[plane] * CenterX[primitiveIndex] + frustum.NormalY[plane] * CenterY[primitiveIndex]
+                + frustum.NormalZ[plane] * CenterZ[primitiveIndex] + frustum.Distance[plane];
+            float const radius = std::abs(frustum.NormalX[plane]) * ExtentX[primitiveIndex] + std::abs(frustum.NormalY[plane]) * ExtentY[primitiveIndex]
+                + std::abs(frustum.NormalZ[plane]) * ExtentZ[primitiveIndex];
+            if (distance + radius < 0.f)
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
@@ -0,0 +1,156 @@
+#include "PrimitiveSceneData.h"
+#include <algorithm>
+#include <bit>
+#include "Assertion.h"
+#include "IDynamicRHI.h"
+#include "Misc/CoreGlabal.h"
+
+namespace Thunder
+{
+    namespace
+    {
+        constexpr uint32 MinBufferCapacity = 1024;
+        constexpr uint32 MaxMergedRangeGap = 16; // Clean primitives copied along rather than starting a new region.
+        constexpr uint32 RowSize = sizeof(TVector4f);
+    }
+
+    void PrimitiveSceneDataBuffer::SetLocalToWorld(uint32 primitiveIndex, const TMatrix44f& localToWorld)
+    {
+        if (primitiveIndex >= GetNumPrimitives())
+        {
+            Rows.resize(static_cast<size_t>(primitiveIndex + 1) * RowsPerPrimitive);
+            DirtyMask.resize((primitiveIndex + 64) / 64, 0);
+        }
+
+        TVector4f* rows = &Rows[static_cast<size_t>(primitiveIndex) * RowsPerPrimitive];
+        rows[0] = localToWorld.GetColumn(0);
+        rows[1] = localToWorld.GetColumn(1);
+        rows[2] = localToWorld.GetColumn(2);
+        DirtyMask[primitiveIndex / 64] |= 1ull << (primitiveIndex % 64);
+    }
+
+    bool PrimitiveSceneDataBuffer::Upload_RenderThread(IRHICommandRecorder* recorder)
+    {
+        uint32 const numPrimitives = GetNumPrimitives();
+        if (numPrimitives == 0)
+        {
+            return false;
+        }
+
+        // Grow, the new buffer starts empty so every primitive is uploaded again.
+        bool recreated = false;
+        if (numPrimitives > BufferCapacity)
+        {
+            if (Buffer.IsValid())
+            {
+                RHIDeferredDeleteResource(std::move(Buffer));
+            }
+            uint32 const capacity = std::bit_ceil(std::max(numPrimitives, MinBufferCapacity));
+            Buffer = RHICreateStructuredBuffer(capacity * RowsPerPrimitive * RowSize, EBufferCreateFlags::Static);
+            if (!Buffer.IsValid()) [[unlikely]]
+            {
+                TAssertf(false, "Failed to create primitive scene data buffer.");
+                BufferCapacity = 0;
+                return false;
+            }
+            RHICreateShaderResourceView(*Buffer, {
+                .Format = RHIFormat::UNKNOWN,
+                .Type = ERHIViewDimension::Buffer,
+                .Width = capacity * RowsPerPrimitive,
+                .Height = 1,
+                .DepthOrArraySize = 1,
+                .StructureByteStride = RowSize
+            });
+            BufferCapacity = capacity;
+            std::fill(DirtyMask.begin(), DirtyMask.end(), ~0ull);
+            recreated = true;
+        }
+
+        // Coalesce dirty primitives into ranges, staged back to back.
+        StagingRows.clear();
+        CopyRegions.clear();
+        uint32 rangeBegin = 0;
+        uint32 rangeEnd = 0;
+        auto flushRange = [this, &rangeBegin, &rangeEnd]()
+        {
+            if (rangeEnd == rangeBegin)
+            {
+                return;
+            }
+            CopyRegions.push_back({
+                .DstOffset = static_cast<uint64>(rangeBegin) * RowsPerPrimitive * RowSize,
+                .SrcOffset = static_cast<uint64>(StagingRows.size()) * RowSize,
+                .NumBytes = static_cast<uint64>(rangeEnd - rangeBegin) * RowsPerPrimitive * RowSize });
+            StagingRows.insert(StagingRows.end(),
+                Rows.begin() + static_cast<size_t>(rangeBegin) * RowsPerPrimitive,
+                Rows.begin() + static_cast<size_t>(rangeEnd) * RowsPerPrimitive);
+        };
+        for (uint32 word = 0; word < static_cast<uint32>(DirtyMask.size()); ++word)
+        {
+            uint64 bits = DirtyMask[word];
+            DirtyMask[word] = 0;
+            while (bits != 0)
+            {
+                uint32 const primitiveIndex = word * 64 + static_cast<uint32>(std::countr_zero(bits));
+                bits &= bits - 1;
+                if (primitiveIndex >= numPrimitives)
+                {
+                    break;
+                }
+                if (rangeEnd != rangeBegin && primitiveIndex <= rangeEnd + MaxMergedRangeGap)
+                {
+                    rangeEnd = primitiveIndex + 1;
+                    continue;
+                }
+                flushRange();
+                rangeBegin = primitiveIndex;
+                rangeEnd = primitiveIndex + 1;
+            }
+        }
+        flushRange();
+        if (CopyRegions.empty())
+        {
+            return recreated;
+        }
+
+        uint32 const frameIndex = GFrameState->FrameNumberRenderThread.load(std::memory_order_acquire) % MAX_FRAME_LAG;
+        uint32 const numStagingRows = static_cast<uint32>(StagingRows.size());
+        if (!EnsureStagingBuffer(frameIndex, numStagingRows)) [[unlikely]]
+        {
+            return recreated;
+        }
+        RHIUpdateSharedMemoryResource(StagingBuffers[frameIndex].Get(), StagingRows.data(), numStagingRows * RowSize, 0);
+
+        auto* regions = static_cast<RHIBufferCopyRegion*>(recorder->Allocate<RHIBufferCopyRegion>(CopyRegions.size()));
+        memcpy(regions, CopyRegions.data(), CopyRegions.size() * sizeof(RHIBufferCopyRegion));
+        auto* command = recorder->NewCommand<RHIUpdateBufferRegionsCommand>();
+        command->Destination = Buffer.Get();
+        command->Source = StagingBuffers[frameIndex].Get();
+        command->Regions = regions;
+        command->NumRegions = static_cast<uint32>(CopyRegions.size());
+        recorder->AddCommand(command);
+        return recreated;
+    }
+
+    bool PrimitiveSceneDataBuffer::EnsureStagingBuffer(uint32 frameIndex, uint32 numRows)
+    {
+        RHIStructuredBufferRef& staging = StagingBuffers[frameIndex];
+        if (staging.IsValid() && StagingCapacity[frameIndex] >= numRows)
+        {
+            return true;
+        }
+        if (staging.IsValid())
+        {
+            RHIDeferredDeleteResource(std::move(staging));
+        }
+        StagingCapacity[frameIndex] = std::bit_ceil(std::max(numRows, MinBufferCapacity));
+        staging = RHICreateStructuredBuffer(StagingCapacity[frameIndex] * RowSize, EBufferCreateFlags::Dynamic);
+        if (!staging.IsValid()) [[unlikely]]
+        {
+            TAssertf(false, "Failed to create primitive scene data staging buffer.");
+            StagingCapacity[frameIndex] = 0;
+            return false;
+        }
+        return true;
+    }
+}
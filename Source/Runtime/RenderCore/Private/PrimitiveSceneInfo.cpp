@@ -10,6 +10,58 @@
 
 namespace Thunder
 {
+    namespace
+    {
+        constexpr uint32 InvalidMemberOffset = 0xFFFFFFFF;
+
+        // Members of the primitive layout written on the CPU, looked up once per layout instead of once per buffer.
+        struct PrimitiveUniformBufferOffsets
+        {
+            uint64 LayoutVersion = 0;
+            uint32 PackedSize = 0; // Rounded up to what the RHI copies out of the packed data.
+            uint32 PrimitiveId = InvalidMemberOffset;
+            uint32 PrimitiveInstanceGroup = InvalidMemberOffset;
+        };
+
+        uint32 ResolveIntMember(const UniformBufferLayout* layout, NameHandle parameterName)
+        {
+            UniformBufferMemberEntry memberEntry;
+            if (!layout->GetMemberEntry(parameterName, memberEntry)) [[unlikely]]
+            {
+                TAssertf(false, "Failed to set primitive parameter \"%s\", member not found.", parameterName.c_str());
+                return InvalidMemberOffset;
+            }
+            if (memberEntry.Type != EUniformBufferMemberType::Int) [[unlikely]]
+            {
+                TAssertf(false, "Failed to set primitive parameter \"%s\", type error.", parameterName.c_str());
+                return InvalidMemberOffset;
+            }
+            return memberEntry.Offset;
+        }
+
+        const PrimitiveUniformBufferOffsets& GetPrimitiveUniformBufferOffsets(const UniformBufferLayout* layout)
+        {
+            // Per thread, primitives are registered and instanced draws merged on different threads.
+            thread_local PrimitiveUniformBufferOffsets offsets;
+            if (offsets.LayoutVersion != layout->GetVersion()) [[unlikely]]
+            {
+                offsets.LayoutVersion = layout->GetVersion();
+                offsets.PackedSize = (layout->GetTotalSize() + 255u) & ~255u;
+                offsets.PrimitiveId = ResolveIntMember(layout, "PrimitiveId");
+                offsets.PrimitiveInstanceGroup = ResolveIntMember(layout, "PrimitiveInstanceGroup");
+            }
+            return offsets;
+        }
+
+        FORCEINLINE void WriteIntMember(byte* packedData, uint32 offset, int value)
+        {
+            if (offset != InvalidMemberOffset) [[likely]]
+            {
+                memcpy(packedData + offset, &value, sizeof(int));
+            }
+        }
+    }
+
     PrimitiveSceneInfo::PrimitiveSceneInfo(bool meshDrawCacheSupported) :
             MeshDrawCacheSupported(meshDrawCacheSupported)
     {
@@ -26,62 +78,103 @@ namespace Thunder
 
     void PrimitiveSceneInfo::CreateUniformBuffer()
     {
-        if (!PrimitiveUniformBuffer)
+        const auto layout = ShaderModule::GetPrimitiveUniformBufferLayout();
+        if (!layout) [[unlikely]]
         {
-            const auto layout = ShaderModule::GetPrimitiveUniformBufferLayout();
-            if (!layout) [[unlikely]]
-            {
-                TAssertf(false, "Cannot update uniform buffer: UniformBufferLayout \"primitive\" not found.");
-                return;
-            }
+            TAssertf(false, "Cannot create uniform buffer: UniformBufferLayout \"primitive\" not found.");
+            return;
+        }
 
-            uint32 const bufferSize = layout->GetTotalSize();
-            if (bufferSize == 0) [[unlikely]]
-            {
-                return;
-            }
+        uint32 const bufferSize = layout->GetTotalSize();
+        if (bufferSize == 0) [[unlikely]]
+        {
+            return;
+        }
 
-            // Pack and upload CPU data.
-            byte* packedData = static_cast<byte*>(TMemory::Malloc(bufferSize, 16));
-            memset(packedData, 0, bufferSize);
+        // Only the primitive index lives here, transforms are read from the scene data buffer.
+        const PrimitiveUniformBufferOffsets& offsets = GetPrimitiveUniformBufferOffsets(layout);
+        byte* packedData = static_cast<byte*>(TMemory::Malloc(offsets.PackedSize, 16));
+        memset(packedData, 0, offsets.PackedSize);
+        WriteIntMember(packedData, offsets.PrimitiveId, static_cast<int>(PrimitiveIndex));
+        WriteIntMember(packedData, offsets.PrimitiveInstanceGroup, -1);
 
-            PrimitiveUniformBuffer = RHICreateUniformBuffer(bufferSize, EUniformBufferFlags::UniformBuffer_MultiFrame, packedData);
+        if (PrimitiveUniformBuffer.IsValid())
+        {
+            RHIDeferredDeleteResource(std::move(PrimitiveUniformBuffer));
         }
+        PrimitiveUniformBuffer = RHICreateUniformBuffer(bufferSize, EUniformBufferFlags::UniformBuffer_MultiFrame, packedData);
+        TMemory::Free(packedData);
     }
 
-    void PrimitiveSceneInfo::UpdatePrimitiveUniformBuffer(RenderContext* context)
+    TRefCountPtr<RHIUniformBuffer> PrimitiveSceneInfo::CreateInstancedUniformBuffer(int instanceGroup)
     {
         const auto layout = ShaderModule::GetPrimitiveUniformBufferLayout();
         if (!layout) [[unlikely]]
         {
-            TAssertf(false, "Cannot update uniform buffer: UniformBufferLayout \"primitive\" not found.");
-            return;
+            TAssertf(false, "Cannot create uniform buffer: UniformBufferLayout \"primitive\" not found.");
+            return nullptr;
         }
 
         uint32 const bufferSize = layout->GetTotalSize();
         if (bufferSize == 0) [[unlikely]]
         {
-            return;
+            return nullptr;
         }
 
-        // Pack and upload CPU data.
-        byte* packedData = static_cast<byte*>(TMemory::Malloc(bufferSize, 16));
-        memset(packedData, 0, bufferSize);
+        const PrimitiveUniformBufferOffsets& offsets = GetPrimitiveUniformBufferOffsets(layout);
+        byte* packedData = static_cast<byte*>(TMemory::Malloc(offsets.PackedSize, 16));
+        memset(packedData, 0, offsets.PackedSize);
+        WriteIntMember(packedData, offsets.PrimitiveInstanceGroup, instanceGroup);
 
-        SetPrimitiveParameter(layout, "LocalToWorld0", Transform.GetColumn(0), packedData);
-        SetPrimitiveParameter(layout, "LocalToWorld1", Transform.GetColumn(1), packedData);
-        SetPrimitiveParameter(layout, "LocalToWorld2", Transform.GetColumn(2), packedData);
+        TRefCountPtr<RHIUniformBuffer> uniformBuffer = RHICreateUniformBuffer(bufferSize, EUniformBufferFlags::UniformBuffer_MultiFrame, packedData);
+        TMemory::Free(packedData);
+        return uniformBuffer;
+    }
 
-        if (PrimitiveUniformBuffer.IsValid())
+    bool PrimitiveSceneInfo::GetWorldBounds(AABB& outBounds) const
+    {
+        // Local bounds of all sub meshes.
+        bool hasBounds = false;
+        TVector3f localMin(FLT_MAX, FLT_MAX, FLT_MAX);
+        TVector3f localMax(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+        for (auto const& batch : StaticMeshes | std::views::values)
         {
-            RHIUpdateUniformBuffer(context, PrimitiveUniformBuffer, packedData);
+            for (auto const& element : batch->GetElements())
+            {
+                if (element.SubMesh == nullptr) [[unlikely]]
+                {
+                    continue;
+                }
+                AABB const& bounds = element.SubMesh->GetBoundingBox();
+                localMin = TVector3f(std::min(localMin.X, bounds.Min.X), std::min(localMin.Y, bounds.Min.Y), std::min(localMin.Z, bounds.Min.Z));
+                localMax = TVector3f(std::max(localMax.X, bounds.Max.X), std::max(localMax.Y, bounds.Max.Y), std::max(localMax.Z, bounds.Max.Z));
+                hasBounds = true;
+            }
         }
-        else
+        if (!hasBounds)
         {
-            PrimitiveUniformBuffer = RHICreateUniformBuffer(layout->GetTotalSize(), EUniformBufferFlags::UniformBuffer_MultiFrame, packedData);
+            return false;
         }
 
-        TMemory::Free(packedData);
+        // Transform center and extent, row vectors: world = local * Transform.
+        float const center[3] = { (localMin.X + localMax.X) * 0.5f, (localMin.Y + localMax.Y) * 0.5f, (localMin.Z + localMax.Z) * 0.5f };
+        float const extent[3] = { (localMax.X - localMin.X) * 0.5f, (localMax.Y - localMin.Y) * 0.5f, (localMax.Z - localMin.Z) * 0.5f };
+        float worldCenter[3];
+        float worldExtent[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            worldCenter[axis] = Transform.M[3][axis];
+            worldExtent[axis] = 0.f;
+            for (int row = 0; row < 3; ++row)
+            {
+                worldCenter[axis] += center[row] * Transform.M[row][axis];
+                worldExtent[axis] += extent[row] * std::abs(Transform.M[row][axis]);
+            }
+        }
+        outBounds = AABB(
+            TVector3f(worldCenter[0] - worldExtent[0], worldCenter[1] - worldExtent[1], worldCenter[2] - worldExtent[2]),
+            TVector3f(worldCenter[0] + worldExtent[0], worldCenter[1] + worldExtent[1], worldCenter[2] + worldExtent[2]));
+        return true;
     }
 
     bool PrimitiveSceneInfo::CacheMeshDrawCommand(RenderContext* context, EMeshPass meshPassType)
@@ -166,70 +259,4 @@ namespace Thunder
     {
         DestroyStaticMeshes();
     }
-    
-    void PrimitiveSceneInfo::SetPrimitiveParameter(const UniformBufferLayout* layout, NameHandle parameterName, TVector4f const& value, byte* packedData)
-    {
-        // Find member.
-        auto const& memberMap = layout->GetMemberMap();
-        auto memberIt = memberMap.find(parameterName);
-        if (memberIt == memberMap.end()) [[unlikely]]
-        {
-            TAssertf(false, "Failed to set primitive parameter \"%s\", member not found.", parameterName.c_str());
-            return;
-        }
-
-        // Check type.
-        auto const& memberEntry = memberIt->second;
-        if (memberEntry.Type != EUniformBufferMemberType::Float4) [[unlikely]]
-        {
-            TAssertf(false, "Failed to set primitive parameter \"%s\", type error.", parameterName.c_str());
-            return;
-        }
-
-        memcpy(packedData + memberEntry.Offset, &value, sizeof(TVector4f));
-    }
-
-    void PrimitiveSceneInfo::SetPrimitiveParameter(const UniformBufferLayout* layout, NameHandle parameterName, float value, byte* packedData)
-    {
-        // Find member.
-        auto const& memberMap = layout->GetMemberMap();
-        auto memberIt = memberMap.find(parameterName);
-        if (memberIt == memberMap.end()) [[unlikely]]
-        {
-            TAssertf(false, "Failed to set primitive parameter \"%s\", member not found.", parameterName.c_str());
-            return;
-        }
-
-        // Check type.
-        auto const& memberEntry = memberIt->second;
-        if (memberEntry.Type != EUniformBufferMemberType::Float) [[unlikely]]
-        {
-            TAssertf(false, "Failed to set primitive parameter \"%s\", type error.", parameterName.c_str());
-            return;
-        }
-
-        memcpy(packedData + memberEntry.Offset, &value, sizeof(float));
-    }
-
-    void PrimitiveSceneInfo::SetPrimitiveParameter(const UniformBufferLayout* layout, NameHandle parameterName, int value, byte* packedData)
-    {
-        // Find member.
-        auto const& memberMap = layout->GetMemberMap();
-        auto memberIt = memberMap.find(parameterName);
-        if (memberIt == memberMap.end()) [[unlikely]]
-        {
-            TAssertf(false, "Failed to set primitive parameter \"%s\", member not found.", parameterName.c_str());
-            return;
-        }
-
-        // Check type.
-        auto const& memberEntry = memberIt->second;
-        if (memberEntry.Type != EUniformBufferMemberType::Int) [[unlikely]]
-        {
-            TAssertf(false, "Failed to set primitive parameter \"%s\", type error.", parameterName.c_str());
-            return;
-        }
-
-        memcpy(packedData + memberEntry.Offset, &value, sizeof(int));
-    }
 }
@@ -20,13 +20,27 @@ namespace Thunder
     RenderContext::~RenderContext()
     {
         ClearCommands();
+        for (auto& destructors : CommandDestructors)
+        {
+            for (auto const& destructor : destructors)
+            {
+                destructor.Destruct(destructor.Command);
+            }
+            destructors.clear();
+        }
         delete TransientAllocatorPtr[0];
         delete TransientAllocatorPtr[1];
     }
 
-    void RenderContext::FreeAllocator() const
+    void RenderContext::FreeAllocator()
     {
-        GetTransientAllocator_RenderThread()->FreeAll();
+        uint32 const index = GFrameState->FrameNumberRenderThread.load(std::memory_order_acquire) % 2;
+        for (auto const& destructor : CommandDestructors[index])
+        {
+            destructor.Destruct(destructor.Command);
+        }
+        CommandDestructors[index].clear();
+        TransientAllocatorPtr[index]->FreeAll();
     }
 
     void RenderContext::AddCommand(IRHICommand* Command)
@@ -37,7 +51,7 @@ namespace Thunder
         }
     }
 
-    void RenderContext::AddCommandList(TArray<RHICachedDrawCommand*> commandList)
+    void RenderContext::AddCommandList(TArray<RHIDrawCommand*> const& commandList)
     {
         Commands.insert(Commands.end(), commandList.begin(), commandList.end());
     }
@@ -57,6 +71,7 @@ namespace Thunder
     void RenderContext::ClearCachedCommands()
     {
         CachedDrawCommands.clear();
+        FallbackSceneInfos.clear();
     }
 
     void RenderContext::ClearCommands()
@@ -70,6 +85,12 @@ namespace Thunder
         return TransientAllocatorPtr[index];
     }
 
+    void RenderContext::AddCommandDestructor(void* command, void (*destruct)(void*))
+    {
+        uint32 const index = GFrameState->FrameNumberRenderThread.load(std::memory_order_acquire) % 2;
+        CommandDestructors[index].push_back({ command, destruct });
+    }
+
     // TransientAllocator* FRenderContext::GetTransientAllocator_RHIThread() const
     // {
     //     uint32 index = GFrameState->FrameNumberRHIThread.load(std::memory_order_acquire) % 2;
@@ -84,11 +84,21 @@ namespace Thunder
             return;
         }
 
-        // todo: check layout update
-        byte* constantData = RenderModule::SetupUniformBufferParameters(context, ubLayout, ParameterCache, Archive->GetName().ToString());
+        // Called for every draw of the material, possibly from several contexts at once.
+        auto guard = UniformBufferLock.Guard();
+        bool bConstantsChanged = false;
+        const byte* constantData = RenderModule::SetupUniformBufferParameters(UniformBufferPacking, ubLayout, ParameterCache, Archive->GetName().ToString(), &bConstantsChanged);
+        if (!constantData) [[unlikely]]
+        {
+            return;
+        }
         if (MaterialUniformBuffer.IsValid())
         {
-            RHIUpdateUniformBuffer(context, MaterialUniformBuffer, constantData);
+            // Multi-frame buffer keeps its contents, only upload what differs from the last upload.
+            if (bConstantsChanged)
+            {
+                RHIUpdateUniformBuffer(context, MaterialUniformBuffer, constantData);
+            }
         }
         else
         {
@@ -121,7 +131,7 @@ namespace Thunder
 
         TextureCaches.clear();
 
-        for (auto const& [name, guid] : ParameterCache->TextureParameters)
+        for (auto const& [name, guid] : ParameterCache->GetTextureParameters())
         {
             if (!guid.IsValid())
             {
@@ -11,6 +11,7 @@
 #include "RenderMesh.h"
 #include "ShaderArchive.h"
 #include "ShaderModule.h"
+#include "PipelineStateCache.h"
 #include "RHIResource.h"
 
 namespace Thunder
@@ -58,17 +59,25 @@ namespace Thunder
 
 	RenderPass* RenderModule::GetRenderPass(RenderPassKey const& key)
 	{
-		// Todo : to be locked.
-		auto& renderPassMap = GetModule()->RenderPasses;
-		auto passIt = renderPassMap.find(key);
-		if (passIt != renderPassMap.end()) [[likely]]
+		// Looked up while recording from worker threads and from passes recorded in parallel.
+		RenderModule* module = GetModule();
+		auto& renderPassMap = module->RenderPasses;
 		{
-			return passIt->second;
+			auto lock = module->RenderPassLock.Read();
+			auto passIt = renderPassMap.find(key);
+			if (passIt != renderPassMap.end()) [[likely]]
+			{
+				return passIt->second;
+			}
 		}
 
-		RenderPass* pass = new RenderPass(key);
-		renderPassMap.insert({ key, pass });
-		return pass;
+		auto lock = module->RenderPassLock.Write();
+		auto [passIt, inserted] = renderPassMap.try_emplace(key, nullptr);
+		if (inserted)
+		{
+			passIt->second = new RenderPass(key);
+		}
+		return passIt->second;
 	}
 
 	MeshPassProcessor* RenderModule::GetMeshPassProcessor(EMeshPass passType)
@@ -143,90 +152,22 @@ namespace Thunder
 		return nullptr;
 	}
 
-	byte* RenderModule::SetupUniformBufferParameters(const RenderContext* context, const UniformBufferLayout* layout,
-		const ShaderParameterMap* parameterMap, const String& ubName)
+	const byte* RenderModule::SetupUniformBufferParameters(UniformBufferPackingProgram& program, const UniformBufferLayout* layout,
+		const ShaderParameterMap* parameterMap, const String& ubName, bool* outChanged)
 	{
-		uint32 const bufferSize = layout->GetTotalSize();
-		if (bufferSize == 0) [[unlikely]]
+		if (layout->GetTotalSize() == 0) [[unlikely]]
 		{
 			TAssertf(false, "Trying to update an empty uniform buffer \"%s\".", ubName);
 			return nullptr;
 		}
 
-        // Allocate temporary buffer for packing.
-        byte* packedData = static_cast<byte*>(context->Allocate<byte>(bufferSize));
-        memset(packedData, 0, bufferSize);
-
-        // Pack parameters into the buffer according to layout.
-		constexpr int32 defaultInt32 = 0;
-		constexpr float defaultFloat = 0.0f;
-		TVector4f defaultVector = TVector4f();
-        auto const& memberMap = layout->GetMemberMap();
-        for (auto const& [paramName, memberEntry] : memberMap)
-        {
-            void const* valuePtr = nullptr;
-            uint32 valueSize = 0;
-
-            // Find parameter value based on type.
-            switch (memberEntry.Type)
-            {
-            case EUniformBufferMemberType::Int:
-            {
-                valueSize = sizeof(int32);
-                auto it = parameterMap->IntParameters.find(paramName);
-                if (it != parameterMap->IntParameters.end()) [[likely]]
-                {
-                    valuePtr = &it->second;
-                }
-                else
-                {
-                	// todo : default value
-                	valuePtr = &defaultInt32;
-                }
-                break;
-            }
-            case EUniformBufferMemberType::Float:
-            {
-                valueSize = sizeof(float);
-                auto it = parameterMap->FloatParameters.find(paramName);
-                if (it != parameterMap->FloatParameters.end()) [[likely]]
-                {
-                    valuePtr = &it->second;
-                }
-                else
-                {
-                	valuePtr = &defaultFloat;
-                }
-                break;
-            }
-            case EUniformBufferMemberType::Float4:
-            {
-                valueSize = sizeof(TVector4f);
-                auto it = parameterMap->VectorParameters.find(paramName);
-                if (it != parameterMap->VectorParameters.end()) [[likely]]
-                {
-                    valuePtr = &it->second;
-                }
-                else
-                {
-					valuePtr = &defaultVector;
-                }
-                break;
-            }
-            default:
-                TAssertf(false, "Unsupported uniform buffer member type for parameter \"%s\".", paramName.c_str());
-                break;
-            }
-
-            // Copy value to buffer.
-            if (valuePtr && valueSize > 0) [[likely]]
-            {
-                TAssertf(valueSize == memberEntry.Size, "Parameter \"%s\" size mismatch: expected %u, got %u.",
-                    paramName.c_str(), memberEntry.Size, valueSize);
-                memcpy(packedData + memberEntry.Offset, valuePtr, valueSize);
-            }
-        }
-		return packedData;
+		// Copy list is only rebuilt when the layout or the parameter set changes.
+		bool const bChanged = program.Pack(layout, parameterMap);
+		if (outChanged)
+		{
+			*outChanged = bChanged;
+		}
+		return program.GetData();
 	}
 
 	namespace 
@@ -299,8 +240,8 @@ namespace Thunder
 
 	TRHIGraphicsPipelineState* RenderModule::GetPipelineState(const RenderContext* context, NameHandle subShaderName, ShaderArchive* archive, ShaderCombination* shaderCombination, const SubMesh* subMesh)
 	{
-		// Set shader.
-		TGraphicsPipelineStateDescriptor psoDesc;
+		// Set shader. The descriptor is reused so its vertex declaration keeps capacity, a cache hit allocates nothing.
+		thread_local TGraphicsPipelineStateDescriptor psoDesc;
 		if (!shaderCombination) [[unlikely]]
 		{
 			// Shader is not ready yet.
@@ -340,8 +281,7 @@ namespace Thunder
 			return nullptr;
 		}
 
-		auto pipelineStateObject = RHICreateGraphicsPipelineState(psoDesc);
-		return pipelineStateObject;
+		return GetGraphicsPipelineState(psoDesc);
 	}
 
 	void RenderModule::BuildDrawCommand(FrameGraph* graphBuilder, FrameGraphPass* pass, SubMesh* geometry)
@@ -367,7 +307,7 @@ namespace Thunder
 		NameHandle passName = pass->GetName();
 
 		// update pass uniform buffer
-        byte* constantData = SetupUniformBufferParameters(context, pass->PassUBLayout, pass->PassParameters, passName.ToString());
+        const byte* constantData = SetupUniformBufferParameters(pass->PassUBPacking, pass->PassUBLayout, pass->PassParameters, passName.ToString());
         if (pass->bLayoutNeedsUpdate)
         {
             if (pass->PassUniformBuffer.IsValid())
@@ -382,11 +322,20 @@ namespace Thunder
         }
         pass->bLayoutNeedsUpdate = false;
 
+        // Resolve the pipeline before allocating the command.
+        uint64 shaderVariantMask = ShaderModule::GetVariantMask(pass->Archive, pass->PassParameters->GetStaticSwitchParameters());
+        ShaderCombination* shaderVariant = ShaderModule::GetShaderCombination(archive, passName, shaderVariantMask);
+        TRHIGraphicsPipelineState* pso = GetPipelineState(context, passName, archive, shaderVariant, geometry);
+        if (!pso) [[unlikely]]
+        {
+            // Shader still compiling without a fallback, the pass draws nothing this frame.
+            return;
+        }
+
         // Dispatch command
-        RHIDrawCommand* newCommand = new (context->Allocate<RHIDrawCommand>()) RHIDrawCommand;
-        uint64 shaderVariantMask = ShaderModule::GetVariantMask(pass->Archive, pass->PassParameters->StaticSwitchParameters);
-        newCommand->Shader = ShaderModule::GetShaderCombination(archive, passName, shaderVariantMask);
-        newCommand->GraphicsPSO = GetPipelineState(context, passName, archive, newCommand->Shader, geometry);
+        RHIDrawCommand* newCommand = context->NewCommand<RHIDrawCommand>();
+        newCommand->Shader = shaderVariant;
+        newCommand->GraphicsPSO = pso;
 
         // vb ib
         newCommand->VBToSet = geometry->GetVerticesBuffer();
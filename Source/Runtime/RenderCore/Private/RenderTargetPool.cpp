@@ -1,7 +1,42 @@
 ﻿#include "RenderTargetPool.h"
+#include "IDynamicRHI.h"
+#include <bit>
 
 namespace Thunder
 {
+    namespace
+    {
+        RenderTexture2D* NewRenderTarget(const FGRenderTargetDesc& desc)
+        {
+            ETextureCreateFlags flags = ETextureCreateFlags::Static;
+            if (desc.bIsDepthStencil)
+            {
+                flags = static_cast<ETextureCreateFlags>(
+                    static_cast<uint32>(flags) | static_cast<uint32>(ETextureCreateFlags::DepthStencilTargetable));
+            }
+            else
+            {
+                flags = static_cast<ETextureCreateFlags>(
+                    static_cast<uint32>(flags) | static_cast<uint32>(ETextureCreateFlags::RenderTargetable));
+            }
+
+            RenderTexture2D* newTarget2D = new RenderTexture2D(desc.Width, desc.Height, desc.Format, nullptr, flags);
+            if (desc.bHasClearValue)
+            {
+                TOptimizedClearValue clearValue;
+                clearValue.bIsValid  = true;
+                clearValue.Color[0]  = desc.ClearValue.X;
+                clearValue.Color[1]  = desc.ClearValue.Y;
+                clearValue.Color[2]  = desc.ClearValue.Z;
+                clearValue.Color[3]  = desc.ClearValue.W;
+                clearValue.Depth     = desc.ClearDepth;
+                clearValue.Stencil   = desc.ClearStencil;
+                newTarget2D->SetOptimizedClearValue(clearValue);
+            }
+            return newTarget2D;
+        }
+    }
+
     FGRenderTarget::FGRenderTarget(NameHandle name, uint32 width, uint32 height, RHIFormat format)
         : Name(name), Desc(width, height, format)
     {
@@ -17,96 +52,267 @@ namespace Thunder
     {
     }
 
-    RenderTextureRef RenderTargetPool::AcquireRenderTarget(FGRenderTargetDesc& desc)
+    RenderTextureRef RHIRenderTargetFactory::CreateRenderTarget(const FGRenderTargetDesc& desc)
+    {
+        RenderTextureRef newTarget = NewRenderTarget(desc);
+        newTarget->InitRHI();
+        return newTarget;
+    }
+
+    void RHIRenderTargetFactory::DestroyRenderTarget(const RenderTextureRef& renderTarget)
+    {
+        if (renderTarget->GetTextureRHI().IsValid())
+        {
+            RHIDeferredDeleteResource(renderTarget->GetTextureRHI().Get());
+        }
+    }
+
+    uint64 RHIRenderTargetFactory::GetRenderTargetSize(const FGRenderTargetDesc& desc)
+    {
+        const uint64 key = desc.GetPoolKey();
+        auto sizeIt = Sizes.find(key);
+        if (sizeIt != Sizes.end())
+        {
+            return sizeIt->second;
+        }
+
+        uint64 size = 0;
+        uint64 alignment = 0;
+        const RenderTextureRef probe = NewRenderTarget(desc);
+        if (!RHIGetTextureAllocationInfo(static_cast<RenderTexture2D*>(probe.Get())->MakeResourceDescriptor(), size, alignment))
+        {
+            // Backend can't tell, estimate from the texel size.
+            size = static_cast<uint64>(desc.Width) * desc.Height * GetFormatBytesPerPixel(desc.Format);
+        }
+        Sizes.emplace(key, size);
+        return size;
+    }
+
+    RenderTargetPool::RenderTargetPool(IRenderTargetFactory* factory)
+        : Factory(factory)
+    {
+        if (!Factory)
+        {
+            static RHIRenderTargetFactory rhiFactory;
+            Factory = &rhiFactory;
+        }
+    }
+
+    RenderTextureRef RenderTargetPool::AcquireRenderTarget(const FGRenderTargetDesc& desc)
+    {
+        const uint64 key = desc.GetPoolKey();
+        PoolEntry entry;
+
+        // Most recently released first, it is the least likely to be trimmed next.
+        auto freeIt = FreeLists.find(key);
+        if (freeIt != FreeLists.end() && !freeIt->second.empty())
+        {
+            entry = std::move(freeIt->second.back());
+            freeIt->second.pop_back();
+            --NumFreeTargets;
+        }
+        else
+        {
+            entry.RenderTarget = Factory->CreateRenderTarget(desc);
+            entry.Key = key;
+            entry.Size = Factory->GetRenderTargetSize(desc);
+            PooledMemory += entry.Size;
+        }
+
+        RenderTextureRef result = entry.RenderTarget;
+        UsedTargets.emplace(result.Get(), std::move(entry));
+        TrimToBudget();
+        return result;
+    }
+
+    void RenderTargetPool::ReleaseRenderTarget(const RenderTextureRef& renderTarget)
     {
-        // Find compatible render target in available pool
-        for (auto it = AvailableTargets.begin(); it != AvailableTargets.end(); ++it)
+        // Released more than once per frame when several graph targets share it, only the first counts.
+        auto usedIt = UsedTargets.find(renderTarget.Get());
+        if (usedIt == UsedTargets.end())
         {
-            RenderTexture* rt = it->RenderTarget.Get();
+            return;
+        }
 
-            if (rt->GetSizeX() != desc.Width || rt->GetSizeY() != desc.Height)
+        PoolEntry& entry = usedIt->second;
+        entry.LastUsedFrame = FrameCounter;
+        FreeLists[entry.Key].push_back(std::move(entry));
+        ++NumFreeTargets;
+        UsedTargets.erase(usedIt);
+    }
+
+    void RenderTargetPool::TickUnusedFrameCounters()
+    {
+        ++FrameCounter;
+    }
+
+    void RenderTargetPool::ReleaseLongUnusedTargets()
+    {
+        uint32 releasedCount = 0;
+        for (auto listIt = FreeLists.begin(); listIt != FreeLists.end() && releasedCount < RENDERTARGET_MAX_RELEASE_PER_FRAME; )
+        {
+            // Each list is ordered by release, the stale ones are a prefix.
+            TArray<PoolEntry>& freeList = listIt->second;
+            size_t numStale = 0;
+            while (numStale < freeList.size() && releasedCount < RENDERTARGET_MAX_RELEASE_PER_FRAME
+                && FrameCounter - freeList[numStale].LastUsedFrame >= RENDERTARGET_UNUSED_FRAME_THRESHOLD)
             {
-                continue;
+                DestroyEntry(freeList[numStale++]);
+                releasedCount++;
             }
+            freeList.erase(freeList.begin(), freeList.begin() + static_cast<ptrdiff_t>(numStale));
+            NumFreeTargets -= static_cast<uint32>(numStale);
 
-            const RHITextureRef& textureRHI = rt->GetTextureRHI();
-            if (!textureRHI.IsValid() || textureRHI->GetResourceDescriptor()->Format != desc.Format)
+            if (freeList.empty())
             {
-                continue;
+                listIt = FreeLists.erase(listIt);
             }
-
-            if (desc.bIsDepthStencil != rt->IsDepthStencilTargetable())
+            else
             {
-                continue;
+                ++listIt;
             }
-
-            RenderTextureRef result = it->RenderTarget;
-            AvailableTargets.erase(it);
-            UsedTargets.push_back(result);
-            return result;
         }
+        TrimToBudget();
+    }
 
-        // Create new render target if no compatible one found.
-        ETextureCreateFlags flags = ETextureCreateFlags::Static;
-        if (desc.bIsDepthStencil)
+    void RenderTargetPool::Reset()
+    {
+        for (TArray<PoolEntry>& freeList : FreeLists | std::views::values)
         {
-            flags = static_cast<ETextureCreateFlags>(
-                static_cast<uint32>(flags) | static_cast<uint32>(ETextureCreateFlags::DepthStencilTargetable));
+            for (PoolEntry& entry : freeList)
+            {
+                DestroyEntry(entry);
+            }
         }
-        else
+        FreeLists.clear();
+        for (PoolEntry& entry : UsedTargets | std::views::values)
         {
-            flags = static_cast<ETextureCreateFlags>(
-                static_cast<uint32>(flags) | static_cast<uint32>(ETextureCreateFlags::RenderTargetable));
+            DestroyEntry(entry);
         }
+        UsedTargets.clear();
+        NumFreeTargets = 0;
+        PooledMemory = 0;
+    }
 
-        RenderTexture2D* newTarget2D = new RenderTexture2D(desc.Width, desc.Height, desc.Format, nullptr, flags);
-        if (desc.bHasClearValue)
+    void RenderTargetPool::SetMemoryBudget(uint64 budget)
+    {
+        MemoryBudget = budget;
+        TrimToBudget();
+    }
+
+    void RenderTargetPool::DestroyEntry(PoolEntry& entry)
+    {
+        Factory->DestroyRenderTarget(entry.RenderTarget);
+        entry.RenderTarget = nullptr;
+        PooledMemory -= entry.Size;
+    }
+
+    void RenderTargetPool::TrimToBudget()
+    {
+        // Used targets can't be trimmed, the pool may stay above budget until they are released.
+        while (MemoryBudget > 0 && PooledMemory > MemoryBudget && NumFreeTargets > 0)
         {
-            TOptimizedClearValue clearValue;
-            clearValue.bIsValid  = true;
-            clearValue.Color[0]  = desc.ClearValue.X;
-            clearValue.Color[1]  = desc.ClearValue.Y;
-            clearValue.Color[2]  = desc.ClearValue.Z;
-            clearValue.Color[3]  = desc.ClearValue.W;
-            clearValue.Depth     = desc.ClearDepth;
-            clearValue.Stencil   = desc.ClearStencil;
-            newTarget2D->SetOptimizedClearValue(clearValue);
-        }
-        RenderTextureRef newTarget = newTarget2D;
-        newTarget->InitRHI();
+            auto oldestIt = FreeLists.end();
+            for (auto listIt = FreeLists.begin(); listIt != FreeLists.end(); ++listIt)
+            {
+                if (!listIt->second.empty()
+                    && (oldestIt == FreeLists.end() || listIt->second.front().LastUsedFrame < oldestIt->second.front().LastUsedFrame))
+                {
+                    oldestIt = listIt;
+                }
+            }
 
-        UsedTargets.push_back(newTarget);
-        return newTarget;
+            TArray<PoolEntry>& freeList = oldestIt->second;
+            DestroyEntry(freeList.front());
+            freeList.erase(freeList.begin());
+            --NumFreeTargets;
+            if (freeList.empty())
+            {
+                FreeLists.erase(oldestIt);
+            }
+        }
     }
 
-    void RenderTargetPool::ReleaseRenderTarget(const RenderTextureRef& renderTarget)
+    bool TransientRenderTargetHeap::AllocateRenderTargets(const TArray<TransientRenderTargetRequest>& requests, TArray<RenderTextureRef>& outTargets)
     {
-        auto it = std::ranges::find(UsedTargets, renderTarget);
-        if (it != UsedTargets.end())
+        if (bUnsupported)
+        {
+            return false;
+        }
+
+        PlannerRequests.resize(requests.size());
+        for (size_t index = 0; index < requests.size(); ++index)
+        {
+            AllocationInfo info;
+            if (!GetAllocationInfo(*requests[index].Desc, info))
+            {
+                bUnsupported = true;
+                return false;
+            }
+            PlannerRequests[index] = { info.Size, info.Alignment, requests[index].FirstPass, requests[index].LastPass };
+        }
+        Planner.Plan(PlannerRequests, Plan);
+
+        if (Plan.HeapSize > GetHeapSize())
+        {
+            // Textures placed in the old heap may still be in flight, both go through deferred delete.
+            ReleasePlacedTargets();
+            if (Heap.IsValid())
+            {
+                RHIDeferredDeleteResource(Heap.Get());
+                Heap = nullptr;
+            }
+            Heap = RHICreateTransientHeap(Plan.HeapSize);
+            if (!Heap.IsValid()) [[unlikely]]
+            {
+                TAssertf(false, "Fail to create transient render target heap of %llu bytes.", Plan.HeapSize);
+                bUnsupported = true;
+                return false;
+            }
+            LOG("Transient render target heap: %.2f MB, %.2f MB without aliasing, %.2f MB live at most.",
+                static_cast<double>(Plan.HeapSize) / (1024.0 * 1024.0),
+                static_cast<double>(Plan.UnaliasedSize) / (1024.0 * 1024.0),
+                static_cast<double>(Plan.LiveSizeBound) / (1024.0 * 1024.0));
+        }
+
+        outTargets.resize(requests.size());
+        for (size_t index = 0; index < requests.size(); ++index)
         {
-            AvailableTargets.emplace_back(*it);
-            UsedTargets.erase(it);
+            const PlacedTargetKey key = MakePlacedTargetKey(Plan.Offsets[index], *requests[index].Desc);
+            auto placedIt = PlacedTargets.find(key);
+            if (placedIt == PlacedTargets.end())
+            {
+                RenderTexture2D* newTarget2D = NewRenderTarget(*requests[index].Desc);
+                newTarget2D->SetPlacement(Heap.Get(), key.Offset);
+                RenderTextureRef newTarget = newTarget2D;
+                newTarget->InitRHI();
+                placedIt = PlacedTargets.emplace(key, PooledRenderTarget(newTarget)).first;
+            }
+            placedIt->second.UnusedFrameCount = 0;
+            outTargets[index] = placedIt->second.RenderTarget;
         }
+        return true;
     }
 
-    void RenderTargetPool::TickUnusedFrameCounters()
+    void TransientRenderTargetHeap::TickUnusedFrameCounters()
     {
-        for (auto& pooledTarget : AvailableTargets)
+        for (auto& placedTarget : PlacedTargets | std::views::values)
         {
-            pooledTarget.UnusedFrameCount++;
+            placedTarget.UnusedFrameCount++;
         }
     }
 
-    void RenderTargetPool::ReleaseLongUnusedTargets()
+    void TransientRenderTargetHeap::ReleaseLongUnusedTargets()
     {
         uint32 releasedCount = 0;
-        auto it = AvailableTargets.begin();
+        auto it = PlacedTargets.begin();
 
-        while (it != AvailableTargets.end() && releasedCount < RENDERTARGET_MAX_RELEASE_PER_FRAME)
+        while (it != PlacedTargets.end() && releasedCount < RENDERTARGET_MAX_RELEASE_PER_FRAME)
         {
-            if (it->UnusedFrameCount >= RENDERTARGET_UNUSED_FRAME_THRESHOLD)
+            if (it->second.UnusedFrameCount >= RENDERTARGET_UNUSED_FRAME_THRESHOLD)
             {
-                it = AvailableTargets.erase(it);
+                RHIDeferredDeleteResource(it->second.RenderTarget->GetTextureRHI().Get());
+                it = PlacedTargets.erase(it);
                 releasedCount++;
             }
             else
@@ -116,10 +322,57 @@ namespace Thunder
         }
     }
 
-    void RenderTargetPool::Reset()
+    void TransientRenderTargetHeap::Reset()
     {
-        AvailableTargets.clear();
-        UsedTargets.clear();
+        ReleasePlacedTargets();
+        if (Heap.IsValid())
+        {
+            RHIDeferredDeleteResource(Heap.Get());
+            Heap = nullptr;
+        }
+    }
+
+    TransientRenderTargetHeap::PlacedTargetKey TransientRenderTargetHeap::MakePlacedTargetKey(uint64 offset, const FGRenderTargetDesc& desc)
+    {
+        PlacedTargetKey key { offset, desc.GetPoolKey(), {} };
+        if (desc.bHasClearValue)
+        {
+            key.ClearBits[0] = std::bit_cast<uint32>(desc.ClearValue.X);
+            key.ClearBits[1] = std::bit_cast<uint32>(desc.ClearValue.Y);
+            key.ClearBits[2] = std::bit_cast<uint32>(desc.ClearValue.Z);
+            key.ClearBits[3] = std::bit_cast<uint32>(desc.ClearValue.W);
+            key.ClearBits[4] = std::bit_cast<uint32>(desc.ClearDepth);
+            key.ClearBits[5] = desc.ClearStencil | (1u << 8);
+        }
+        return key;
+    }
+
+    bool TransientRenderTargetHeap::GetAllocationInfo(const FGRenderTargetDesc& desc, AllocationInfo& outInfo)
+    {
+        const uint64 descKey = desc.GetPoolKey();
+        auto infoIt = AllocationInfos.find(descKey);
+        if (infoIt != AllocationInfos.end())
+        {
+            outInfo = infoIt->second;
+            return true;
+        }
+
+        const RenderTextureRef probe = NewRenderTarget(desc);
+        if (!RHIGetTextureAllocationInfo(static_cast<RenderTexture2D*>(probe.Get())->MakeResourceDescriptor(), outInfo.Size, outInfo.Alignment))
+        {
+            return false;
+        }
+        AllocationInfos.emplace(descKey, outInfo);
+        return true;
+    }
+
+    void TransientRenderTargetHeap::ReleasePlacedTargets()
+    {
+        for (auto& placedTarget : PlacedTargets | std::views::values)
+        {
+            RHIDeferredDeleteResource(placedTarget.RenderTarget->GetTextureRHI().Get());
+        }
+        PlacedTargets.clear();
     }
     
 }
@@ -14,9 +14,8 @@ namespace Thunder
         TextureRHI.SafeRelease();
     }
 
-    void RenderTexture2D::CreateTexture_RenderThread()
+    RHIResourceDescriptor RenderTexture2D::MakeResourceDescriptor() const
     {
-
         const bool bNeedRTV = IsRenderTargetable();
         const bool bNeedDSV = IsDepthStencilTargetable();
 
@@ -44,8 +43,23 @@ namespace Thunder
             desc.OptimizedClearDepth        = OptimizedClear.Depth;
             desc.OptimizedClearStencil      = OptimizedClear.Stencil;
         }
+        return desc;
+    }
+
+    void RenderTexture2D::CreateTexture_RenderThread()
+    {
+        const bool bNeedRTV = IsRenderTargetable();
+        const bool bNeedDSV = IsDepthStencilTargetable();
+        const RHIResourceDescriptor desc = MakeResourceDescriptor();
 
-        TextureRHI = RHICreateTexture(desc, CreationFlags);
+        if (PlacementHeap.IsValid())
+        {
+            TextureRHI = RHICreatePlacedTexture(PlacementHeap.Get(), PlacementOffset, desc, CreationFlags);
+        }
+        else
+        {
+            TextureRHI = RHICreateTexture(desc, CreationFlags);
+        }
 
         RHICreateShaderResourceView(*TextureRHI, {
             .Format = desc.Format,
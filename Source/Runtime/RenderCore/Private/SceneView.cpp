@@ -7,60 +7,81 @@
 #include "Concurrent/TheadPool.h"
 #include "HAL/Event.h"
 #include "Misc/CoreGlabal.h"
+#include <bit>
 
 namespace Thunder
 {
     class TaskDispatcher;
 
+    bool SceneView::FrustumCull(PrimitiveSceneInfo* sceneInfo) const
+    {
+        uint32 const primitiveIndex = sceneInfo->GetPrimitiveIndex();
+        if (primitiveIndex == InvalidPrimitiveIndex) [[unlikely]]
+        {
+            return true;
+        }
+        return OwnerFrameGraph->GetPrimitiveBounds().IsVisible(Frustum, primitiveIndex);
+    }
+
+    float SceneView::GetViewDistanceSquared(const PrimitiveSceneInfo* sceneInfo) const
+    {
+        uint32 const primitiveIndex = sceneInfo->GetPrimitiveIndex();
+        if (primitiveIndex == InvalidPrimitiveIndex) [[unlikely]]
+        {
+            return 0.f;
+        }
+        TVector3f const center = OwnerFrameGraph->GetPrimitiveBounds().GetCenter(primitiveIndex);
+        float const dx = center.X - ViewOrigin.X;
+        float const dy = center.Y - ViewOrigin.Y;
+        float const dz = center.Z - ViewOrigin.Z;
+        return dx * dx + dy * dy + dz * dz;
+    }
+
     void SceneView::CullSceneProxies()
     {
         VisibleStaticSceneInfos.clear();
         VisibleDynamicSceneInfos.clear();
 
-        auto& infoSet = OwnerFrameGraph->GetSceneInfos();
-        TArray<PrimitiveSceneInfo*> allSceneInfos( infoSet.begin(), infoSet.end() );
-        uint32 proxyNum = static_cast<uint32>(allSceneInfos.size());
-        if (proxyNum > 0)
+        auto const& bounds = OwnerFrameGraph->GetPrimitiveBounds();
+        uint32 const numWords = bounds.GetNumWords();
+        if (numWords > 0)
         {
-            TArray<TArray<PrimitiveSceneInfo*>> LocalVisibleStaticSceneInfos(GSyncWorkers->GetNumThreads());
-            TArray<TArray<PrimitiveSceneInfo*>> LocalVisibleDynamicSceneInfos(GSyncWorkers->GetNumThreads());
+            Visibility.resize(numWords);
+
+            // One slot per ParallelForRange context.
+            TArray<TArray<PrimitiveSceneInfo*>> LocalVisibleStaticSceneInfos(GSyncWorkers->GetNumContexts());
+            TArray<TArray<PrimitiveSceneInfo*>> LocalVisibleDynamicSceneInfos(GSyncWorkers->GetNumContexts());
 
-            const auto doWorkEvent = FPlatformProcess::GetSyncEventFromPool();
-            auto* dispatcher = new (TMemory::Malloc<TaskDispatcher>()) TaskDispatcher(doWorkEvent);
-            dispatcher->Promise(static_cast<int>(proxyNum));
-            GSyncWorkers->ParallelFor([&allSceneInfos, &LocalVisibleStaticSceneInfos, &LocalVisibleDynamicSceneInfos, dispatcher, proxyNum, this](uint32 bundleBegin, uint32 bundleSize)
+            // Each batch owns a disjoint word range of the visibility bits, 64 primitives per word.
+            GSyncWorkers->ParallelForRange(numWords, [&bounds, &LocalVisibleStaticSceneInfos, &LocalVisibleDynamicSceneInfos, this](uint32 begin, uint32 end, uint32 contextIndex)
             {
-                uint32 threadId = GetContextId();
-                for (uint32 index = bundleBegin; index < bundleBegin + bundleSize; ++index)
+                bounds.Cull(Frustum, begin, end, &Visibility[begin]);
+
+                auto& localStatic = LocalVisibleStaticSceneInfos[contextIndex];
+                auto& localDynamic = LocalVisibleDynamicSceneInfos[contextIndex];
+                for (uint32 word = begin; word < end; ++word)
                 {
-                    if (index >= proxyNum)
+                    uint64 visibleBits = Visibility[word];
+                    while (visibleBits != 0)
                     {
-                        break;
-                    }
+                        uint32 const bit = static_cast<uint32>(std::countr_zero(visibleBits));
+                        visibleBits &= visibleBits - 1;
 
-                    auto const& sceneInfo = allSceneInfos[index];
-                    if (sceneInfo->NeedRenderView(ViewType))
-                    {
-                        if (FrustumCull(sceneInfo))
+                        auto const& sceneInfo = bounds.GetPrimitive(word * PrimitiveBoundsBuffer::SlotsPerWord + bit);
+                        if (sceneInfo->NeedRenderView(ViewType))
                         {
                             if (sceneInfo->IsMeshDrawCacheSupported())
                             {
-                                LocalVisibleStaticSceneInfos[threadId].push_back(sceneInfo);
+                                localStatic.push_back(sceneInfo);
                             }
                             else
                             {
-                                LocalVisibleDynamicSceneInfos[threadId].push_back(sceneInfo);
+                                localDynamic.push_back(sceneInfo);
                             }
                         }
                     }
-
-                    dispatcher->Notify();
                 }
-            }, proxyNum);
-
-            doWorkEvent->Wait();
-            FPlatformProcess::ReturnSyncEventToPool(doWorkEvent);
-            TMemory::Destroy(dispatcher);
+            }, 8);
 
             // Composite.
             size_t staticCount = 0;
@@ -87,4 +108,17 @@ namespace Thunder
 
         MarkCulled();
     }
+
+    void SceneView::CullSceneProxiesOnce()
+    {
+        if (IsCulled())
+        {
+            return;
+        }
+        auto guard = CullLock.Guard();
+        if (!IsCulled())
+        {
+            CullSceneProxies();
+        }
+    }
 }
@@ -0,0 +1,107 @@
+#include "TransientAliasingPlanner.h"
+#include <algorithm>
+
+namespace Thunder
+{
+    namespace
+    {
+        FORCEINLINE uint64 AlignOffset(uint64 offset, uint64 alignment)
+        {
+            return (offset + alignment - 1) & ~(alignment - 1);
+        }
+
+        FORCEINLINE bool LifetimesOverlap(const TransientAllocationRequest& a, const TransientAllocationRequest& b)
+        {
+            return a.FirstPass <= b.LastPass && b.FirstPass <= a.LastPass;
+        }
+    }
+
+    void TransientAliasingPlanner::Plan(const TArray<TransientAllocationRequest>& requests, TransientAliasingPlan& outPlan)
+    {
+        const uint32 numRequests = static_cast<uint32>(requests.size());
+        outPlan.Offsets.assign(numRequests, 0);
+        outPlan.HeapSize = 0;
+        outPlan.UnaliasedSize = 0;
+        outPlan.LiveSizeBound = 0;
+        if (numRequests == 0)
+        {
+            return;
+        }
+
+        // Largest first, ties by first use so that the plan is deterministic.
+        Order.resize(numRequests);
+        for (uint32 index = 0; index < numRequests; ++index)
+        {
+            Order[index] = index;
+        }
+        std::ranges::sort(Order, [&requests](uint32 a, uint32 b)
+        {
+            if (requests[a].Size != requests[b].Size)
+            {
+                return requests[a].Size > requests[b].Size;
+            }
+            if (requests[a].FirstPass != requests[b].FirstPass)
+            {
+                return requests[a].FirstPass < requests[b].FirstPass;
+            }
+            return a < b;
+        });
+
+        Placed.clear();
+        for (const uint32 index : Order)
+        {
+            const TransientAllocationRequest& request = requests[index];
+            TAssertf(request.FirstPass <= request.LastPass, "Transient allocation %u ends before it begins.", index);
+            TAssertf(request.Alignment > 0 && (request.Alignment & (request.Alignment - 1)) == 0,
+                "Transient allocation %u alignment %llu is not a power of two.", index, request.Alignment);
+
+            // Ranges already taken by allocations alive at the same time, in address order.
+            Conflicts.clear();
+            for (const uint32 placedIndex : Placed)
+            {
+                if (LifetimesOverlap(request, requests[placedIndex]))
+                {
+                    const uint64 begin = outPlan.Offsets[placedIndex];
+                    Conflicts.push_back({ begin, begin + requests[placedIndex].Size });
+                }
+            }
+            std::ranges::sort(Conflicts, {}, &PlacedRange::Begin);
+
+            // Lowest gap that fits.
+            uint64 offset = 0;
+            for (const PlacedRange& conflict : Conflicts)
+            {
+                if (AlignOffset(offset, request.Alignment) + request.Size <= conflict.Begin)
+                {
+                    break;
+                }
+                offset = std::max(offset, conflict.End);
+            }
+            offset = AlignOffset(offset, request.Alignment);
+
+            outPlan.Offsets[index] = offset;
+            outPlan.HeapSize = std::max(outPlan.HeapSize, offset + request.Size);
+            outPlan.UnaliasedSize += request.Size;
+            Placed.push_back(index);
+        }
+
+        // Sweep over the passes for the live-size lower bound.
+        uint32 numPasses = 0;
+        for (const TransientAllocationRequest& request : requests)
+        {
+            numPasses = std::max(numPasses, request.LastPass + 1);
+        }
+        LiveDeltas.assign(numPasses + 1, 0);
+        for (const TransientAllocationRequest& request : requests)
+        {
+            LiveDeltas[request.FirstPass] += static_cast<int64>(request.Size);
+            LiveDeltas[request.LastPass + 1] -= static_cast<int64>(request.Size);
+        }
+        int64 liveSize = 0;
+        for (uint32 pass = 0; pass < numPasses; ++pass)
+        {
+            liveSize += LiveDeltas[pass];
+            outPlan.LiveSizeBound = std::max(outPlan.LiveSizeBound, static_cast<uint64>(liveSize));
+        }
+    }
+}
@@ -1,14 +1,19 @@
 #pragma once
 
 #include "CoreMinimal.h"
+#include "Concurrent/Lock.h"
 #include "MeshDrawCommand.h"
 #include "MeshPass.h"
+#include "PrimitiveBounds.h"
+#include "PrimitiveSceneData.h"
 #include "RenderTargetPool.h"
 #include "RenderContext.h"
 #include "RenderPass.h"
 #include "RHI.h"
 #include "RHICommand.h"
 #include "SceneView.h"
+#include "UniformBufferPacking.h"
+#include <span>
 
 namespace Thunder
 {
@@ -64,6 +69,7 @@ namespace Thunder
         TRefCountPtr<ShaderBindingsLayout> BindingLayout;
         TRefCountPtr<UniformBufferLayout> PassUBLayout;
         ShaderParameterMap* PassParameters = nullptr;
+        UniformBufferPackingProgram PassUBPacking;
         TRefCountPtr<RHIUniformBuffer> PassUniformBuffer;
         bool bLayoutNeedsUpdate = true;
 
@@ -97,6 +103,10 @@ namespace Thunder
         RENDERCORE_API void UpdateSceneInfo_GameThread(PrimitiveSceneInfo* sceneInfo);
         RENDERCORE_API void UpdateSceneInfo_RenderThread();
         RENDERCORE_API void UpdatePassSceneInfo(EMeshPass passType);
+        RENDERCORE_API void MarkPrimitiveDirty(PrimitiveSceneInfo* sceneInfo);
+        RENDERCORE_API void UpdatePrimitiveData_RenderThread();
+        FORCEINLINE const PrimitiveBoundsBuffer& GetPrimitiveBounds() const { return PrimitiveBounds; }
+        FORCEINLINE uint64 GetPrimitiveSceneDataSRV() const { return PrimitiveSceneData.GetSRVHandle(); }
         RENDERCORE_API void ResolveVisibility(EViewType viewType, EMeshPass passType);
 
         // Internal methods used by FrameGraphBuilder
@@ -105,17 +115,19 @@ namespace Thunder
         RENDERCORE_API void RegisterRenderTarget(FGRenderTarget* renderTarget, TVector2u resolution = TVector2u(0, 0));
         FORCEINLINE void RegisterRenderTarget(FGRenderTargetRef const& renderTarget, TVector2u resolution = TVector2u(0, 0)) { RegisterRenderTarget(renderTarget.Get(), resolution); }
         RENDERCORE_API void ClearRenderTargetPool();
+        FORCEINLINE const TransientAliasingPlan& GetTransientRenderTargetPlan() const { return TransientHeap.GetLastPlan(); }
 
-        // Command execution support
-        FORCEINLINE RenderContext* GetMainContext() const { return MainContext; }
-        FORCEINLINE const TArray<RenderContext*>& GetRenderContexts() const { return RenderContexts; }
+        // Command execution support. Passes recorded in parallel get the contexts of their recording thread,
+        // so resolve these before starting a nested parallel loop.
+        RENDERCORE_API RenderContext* GetMainContext() const;
+        RENDERCORE_API const TArray<RenderContext*>& GetRenderContexts() const;
         FORCEINLINE TArray<IRHICommand*>& GetCurrentAllCommands(int frontIndex) { return AllCommands[frontIndex]; }
         FORCEINLINE TArray<RHIPassState*>& GetCurrentPassStates(int frontIndex) { return AllPassStates[frontIndex]; }
 
         FORCEINLINE void SetCurrentPass(FrameGraphPass* pass) const
         {
-            MainContext->SetCurrentPass(pass);
-            for (auto& context : RenderContexts)
+            GetMainContext()->SetCurrentPass(pass);
+            for (auto& context : GetRenderContexts())
             {
                 context->SetCurrentPass(pass);
             }
@@ -129,7 +141,12 @@ namespace Thunder
         RENDERCORE_API bool GetRenderTargetFormat(uint32 renderTargetIndex, RHIFormat& outFormat, bool& outIsDepthStencil) const;
         RENDERCORE_API TRefCountPtr<RenderTexture> GetAllocatedRenderTarget(uint32 textureID);
 
-        RENDERCORE_API TArray<RHICachedDrawCommand*> const& GetVisibleCachedDrawList(EMeshPass passType) { return VisibleCachedDrawLists[passType]; }
+        // Visible cached draws of a pass after sorting, identical draws are merged into transient instanced draws.
+        // Only valid on the thread recording the pass, after its ResolveVisibility.
+        FORCEINLINE TArray<RHIDrawCommand*> const& GetVisibleDrawList(EMeshPass passType) const
+        {
+            return PassVisibility[static_cast<size_t>(passType)].VisibleDrawList;
+        }
 
         FORCEINLINE ShaderParameterMap* GetGlobalParameters() const { return CachedGlobalParameters; }
         RENDERCORE_API void InitGlobalUniformBuffer();
@@ -148,17 +165,34 @@ namespace Thunder
         void CullUnusedPasses() const;
         void TopologicalSort();
         void ScheduleRenderTargetLifetime();
+        void ScheduleRecordingWaves();
+        uint64 HashGraphDeclarations();
+        bool AllocatePlacedRenderTargets();
         void AllocateRenderTargets();
         void AddRenderTargetClearOp();
         void SetPresentCommand();
 
         // Excute
+        struct PassRecordingSlot;
+        PassRecordingSlot& GetRecordingSlot(uint32 contextIndex);
+        void RecordPasses(uint32 waveBegin, uint32 waveEnd);
+        void RecordPass(FrameGraphPass* pass, PassRecordingSlot& slot, TArray<IRHICommand*>& outCommands);
+        static void GatherContextCommands(const PassRecordingSlot& slot, TArray<IRHICommand*>& outCommands);
         void AggregateContextCommands(uint32 frameIndex);
         void AddBeginFrameCommand(uint32 frameIndex);
-        void AddBeginPassCommand(FrameGraphPass* pass, uint32 frameIndex);
-        void AddPassState(uint32 frameIndex);
+        void AddBeginPassCommand(FrameGraphPass* pass, uint32 execIndex, uint32 frameIndex);
+        bool IsFirstUseOfPlacedTarget(uint32 rtId, uint32 execIndex) const;
+        void AddPassState(FrameGraphPass* pass, uint32 frameIndex);
         void AddEndPassCommand(FrameGraphPass* pass, uint32 frameIndex);
 
+        // Mesh-draw cache.
+        struct PassVisibilityState;
+        void RetireCachedDrawCommands(PrimitiveSceneInfo* sceneInfo, EMeshPass passType);
+        void FreeRetiredCachedDrawCommands(uint32 frameIndex);
+        void MergeInstancedDraws(PassVisibilityState& state);
+        uint64 UploadInstanceIds(PassVisibilityState& state);
+        static RHIUniformBuffer* GetInstanceGroupUniformBuffer(PassVisibilityState& state, uint32 group);
+
         // Passes.
         TSet<NameHandle> CurrentFramePasses;
         NameHandle PresentPassName;
@@ -169,7 +203,34 @@ namespace Thunder
         THashMap<uint32, FGRenderTargetRef> RenderTargets;
         THashMap<uint32, TRefCountPtr<RenderTexture>> AllocatedRenderTargets;
         THashMap<uint32, std::pair<size_t, size_t>> RenderTargetLifetimes; // target -> (first_use, last_use)
+
+        // Compiled graph, reused while the pass declarations hash the same.
+        struct CompiledPassTargetRange
+        {
+            uint32 Begin = 0; // Into CompiledTargetEvents, acquired targets then released ones.
+            uint32 NumAcquired = 0;
+            uint32 NumReleased = 0;
+        };
+        TArray<CompiledPassTargetRange> CompiledPassTargets; // By execution index.
+        TArray<uint32> CompiledTargetEvents;
+        TArray<uint32> CompiledWaveEnds; // Passes of a wave don't read each other's targets and are recorded in parallel.
+        uint64 CompiledDeclarationHash = 0;
+        bool bHasCompiledGraph = false;
+
+        FORCEINLINE std::span<const uint32> GetAcquiredTargets(size_t execIndex) const
+        {
+            const CompiledPassTargetRange& range = CompiledPassTargets[execIndex];
+            return { CompiledTargetEvents.data() + range.Begin, range.NumAcquired };
+        }
+        FORCEINLINE std::span<const uint32> GetReleasedTargets(size_t execIndex) const
+        {
+            const CompiledPassTargetRange& range = CompiledPassTargets[execIndex];
+            return { CompiledTargetEvents.data() + range.Begin + range.NumAcquired, range.NumReleased };
+        }
         RenderTargetPool Pool;
+        TransientRenderTargetHeap TransientHeap;
+        THashSet<uint32> PlacedRenderTargets; // Targets of this frame allocated in TransientHeap.
+        TVector2u TransientHeapResolution = { 0, 0 }; // Viewport resolution TransientHeap was last reset for.
 
         // Renderer.
         IRenderer* OwnerRenderer { nullptr };
@@ -180,7 +241,9 @@ namespace Thunder
         TSet<PrimitiveSceneInfo*> SceneInfoUnregistrationSet[2];
         TSet<PrimitiveSceneInfo*> SceneInfoCurrentUpdateSet; // Update CacheMeshDrawCommand
         TVector2u ViewportResolution = { 1920, 1080 };
-        TSet<PrimitiveSceneInfo*> PrimitivesNeedingUniformBufferUpdate; // Update Primitive UniformBuffer
+        PrimitiveBoundsBuffer PrimitiveBounds; // World bounds of registered primitives, indexed by primitive index.
+        PrimitiveSceneDataBuffer PrimitiveSceneData; // GPU transforms of registered primitives, same indexing.
+        TSet<PrimitiveSceneInfo*> PrimitiveDirtySet;
 
         // Command execution contexts.
         RenderContext* MainContext = nullptr;  // Main render thread context
@@ -188,15 +251,67 @@ namespace Thunder
         TArray<IRHICommand*> AllCommands[2];       // All commands for execution
         TArray<RHIPassState*> AllPassStates[2];
 
+        // Parallel pass recording, one slot per ParallelForRange context. The render thread records into RenderThreadSlot,
+        // which holds the contexts above, the others are created by their pool thread on first use.
+        struct PassRecordingSlot
+        {
+            const FrameGraph* Owner = nullptr;
+            RenderContext* MainContext = nullptr;
+            TArray<RenderContext*> RenderContexts;
+        };
+        static thread_local PassRecordingSlot* CurrentRecordingSlot;
+        TArray<PassRecordingSlot> RecordingSlots;
+        PassRecordingSlot RenderThreadSlot;
+        TArray<TArray<IRHICommand*>> RecordedPassCommands; // By position in the current wave.
+        bool bParallelPassRecording = true;
+
         // Mesh-draw.
-        TMap<EMeshPass, CachedPassMeshDrawList> CachedDrawLists;
-        TMap<EMeshPass, TArray<RHICachedDrawCommand*>> VisibleCachedDrawLists;
+        struct VisibleDrawSortItem
+        {
+            uint64 SortKey;
+            RHICachedDrawCommand* Command;
+            PrimitiveSceneInfo* SceneInfo;
+        };
+        struct MergedDrawItem
+        {
+            RHIDrawCommand* Command;
+            uint16 InstanceIdsSRVIndex;
+        };
+        struct InstanceIdsBuffer
+        {
+            RHIStructuredBufferRef Buffer;
+            uint32 NumIds = 0;
+        };
+
+        // Everything ResolveVisibility touches for one mesh pass. A mesh pass is resolved by a single frame-graph pass
+        // per frame, so passes recorded in parallel never share a state and don't need to lock it.
+        struct PassVisibilityState
+        {
+            CachedPassMeshDrawList CachedDrawList;
+            TArray<RHIDrawCommand*> VisibleDrawList;
+            TArray<VisibleDrawSortItem> SortItems; // Scratch for ResolveVisibility.
+            TArray<VisibleDrawSortItem> SortScratch;
+            TArray<MergedDrawItem> MergedDrawItems; // Scratch for MergeInstancedDraws.
+            TArray<uint32> InstanceIds;             // Group table, then the primitive index of every merged instance.
+            TArray<uint32> InstanceGroupOffsets;    // Scratch, first instance of every group before the table is prepended.
+            TArray<TRefCountPtr<RHIUniformBuffer>> InstanceGroupUniformBuffers; // By group, immutable and kept across frames.
+            InstanceIdsBuffer InstanceIdsBuffers[MAX_FRAME_LAG]; // Rewritten every MAX_FRAME_LAG frames.
+            TArray<PrimitiveSceneInfo*> FallbackSceneInfos; // Cached with a fallback shader this frame.
+        };
+        PassVisibilityState PassVisibility[static_cast<size_t>(EMeshPass::Num)];
+        TArray<RHICachedDrawCommand*> RetiredCachedDrawCommands[2]; // Freed once the RHI thread is done with the frame.
+        SpinLock RetiredCachedDrawCommandsLock; // Retired from every pass.
+        TSet<PrimitiveSceneInfo*> FallbackShaderSceneInfos; // Cached again once async compiles publish new variants.
+        uint64 FallbackShaderEpoch = 0;
 
         // Uniform buffer.
         ShaderParameterMap* CachedGlobalParameters = nullptr;
+        UniformBufferPackingProgram GlobalUBPacking;
         TRefCountPtr<RHIUniformBuffer> GlobalUniformBuffer;
         TMap<EMeshPass, ShaderParameterMap*> PassParameters;
+        TMap<EMeshPass, UniformBufferPackingProgram> PassUBPackings;
         TMap<EMeshPass, TRefCountPtr<RHIUniformBuffer>> PassUniformBufferMap;
+        mutable SpinLock PassParametersLock; // Guards the three maps above.
     };
 
     #define EVENT_NAME(Name) Name
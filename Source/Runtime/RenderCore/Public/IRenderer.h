@@ -5,6 +5,12 @@
 
 namespace Thunder
 {
+    struct PrimitiveTransformUpdate
+    {
+        PrimitiveSceneInfo* SceneInfo;
+        TMatrix44f Transform;
+    };
+
     class IRenderer
     {
     public:
@@ -44,15 +50,18 @@ namespace Thunder
         FORCEINLINE void RegisterSceneInfo(PrimitiveSceneInfo* sceneInfo) const { FrameGraph->RegisterSceneInfo_GameThread(sceneInfo); }
         FORCEINLINE void UnregisterSceneInfo(PrimitiveSceneInfo* sceneInfo) const { FrameGraph->UnregisterSceneInfo_GameThread(sceneInfo); }
 
-        RENDERCORE_API void UpdatePrimitiveUniformBuffer_GameThread(PrimitiveSceneInfo* sceneInfo);
-        RENDERCORE_API void UpdatePrimitiveUniformBuffer_RenderThread();
+        RENDERCORE_API void UpdatePrimitiveData_GameThread(PrimitiveSceneInfo* sceneInfo);
+        // New transforms of moved primitives, applied by the render thread in one go with the rest of the primitive data.
+        RENDERCORE_API void UpdatePrimitiveTransforms_GameThread(const PrimitiveTransformUpdate* updates, uint32 count);
+        RENDERCORE_API void UpdatePrimitiveData_RenderThread();
 
         FORCEINLINE FrameGraph* GetFrameGraph() const { return FrameGraph; }
 
     protected:
         TRefCountPtr<FrameGraph> FrameGraph;
 
-        // Primitive uniform buffer update list
-        TSet<PrimitiveSceneInfo*> PrimitiveUniformBufferUpdateSet[2]; // Game thread and render thread double buffer.
+        // Primitive data update list
+        TSet<PrimitiveSceneInfo*> PrimitiveDataUpdateSet[2]; // Game thread and render thread double buffer.
+        TArray<PrimitiveTransformUpdate> PrimitiveTransformUpdates[2];
     };
 }
\ No newline at end of file
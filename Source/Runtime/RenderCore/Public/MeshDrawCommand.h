@@ -1,16 +1,89 @@
 ﻿#pragma once
 
+#include "Container.h"
 #include "Platform.h"
 
 namespace Thunder
 {
+    constexpr uint64 InvalidCachedCommandIndex = ~0ull;
+
+    /**
+     * 64-bit draw sort key: | PSO 16 | shader 12 | material 16 | view depth 20 |.
+     * State fields are hashed pointers, equal prefixes group draws sharing state so the RHI can skip rebinding.
+     */
+    namespace DrawSortKey
+    {
+        constexpr uint32 DepthBits = 20;
+        constexpr uint64 DepthMask = (1ull << DepthBits) - 1;
+
+        FORCEINLINE uint64 HashField(const void* pointer, uint32 bits)
+        {
+            uint64 value = reinterpret_cast<uintptr_t>(pointer);
+            value ^= value >> 33;
+            value *= 0xff51afd7ed558ccdull;
+            value ^= value >> 33;
+            return value >> (64 - bits);
+        }
+
+        // State part, computed once when the command is built.
+        FORCEINLINE uint64 MakeState(const void* pipelineState, const void* shader, const void* material)
+        {
+            return (HashField(pipelineState, 16) << 48) | (HashField(shader, 12) << 36) | (HashField(material, 16) << DepthBits);
+        }
+
+        // Front to back within equal state. Non-negative float bits are monotonic, keep the top 20 below the sign.
+        FORCEINLINE uint64 MakeDepth(float viewDistanceSquared)
+        {
+            uint32 bits;
+            memcpy(&bits, &viewDistanceSquared, sizeof(bits));
+            return (bits >> 11) & DepthMask;
+        }
+    }
+
     struct MeshDrawCommandInfo
     {
-        uint64 CommandIndex;
+        uint64 CommandIndex = InvalidCachedCommandIndex;
     };
 
+    /**
+     * Cached mesh-draw commands of one pass, dense slots indexed by RHICachedDrawCommand::CachedCommandIndex.
+     * Released slots go to a free list and are handed out again before the array grows.
+     */
     struct CachedPassMeshDrawList
     {
-        TMap<uint64, struct RHICachedDrawCommand*> MeshDrawCommands;
+        TArray<struct RHICachedDrawCommand*> MeshDrawCommands;
+        TArray<uint64> FreeSlots;
+
+        uint64 Add(RHICachedDrawCommand* command)
+        {
+            if (!FreeSlots.empty())
+            {
+                uint64 const index = FreeSlots.back();
+                FreeSlots.pop_back();
+                MeshDrawCommands[index] = command;
+                return index;
+            }
+            MeshDrawCommands.push_back(command);
+            return MeshDrawCommands.size() - 1;
+        }
+
+        RHICachedDrawCommand* Remove(uint64 index)
+        {
+            if (index >= MeshDrawCommands.size() || MeshDrawCommands[index] == nullptr) [[unlikely]]
+            {
+                return nullptr;
+            }
+            RHICachedDrawCommand* command = MeshDrawCommands[index];
+            MeshDrawCommands[index] = nullptr;
+            FreeSlots.push_back(index);
+            return command;
+        }
+
+        FORCEINLINE RHICachedDrawCommand* Find(uint64 index) const
+        {
+            return index < MeshDrawCommands.size() ? MeshDrawCommands[index] : nullptr;
+        }
+
+        FORCEINLINE size_t Num() const { return MeshDrawCommands.size() - FreeSlots.size(); }
     };
 }
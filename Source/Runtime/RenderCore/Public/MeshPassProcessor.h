@@ -15,7 +15,7 @@ namespace Thunder
         RENDERCORE_API virtual bool Process(RenderContext* context, const MeshBatch* batch, EMeshPass meshPassType, bool cacheMeshDrawCommand = false);
         RENDERCORE_API virtual void FinalizeCommand(RenderContext* context, const MeshBatch* batch, class RHIDrawCommand* command, bool cacheMeshDrawCommand = false);
 
-        static class ShaderCombination* GetShaderCombination(EMeshPass meshPassType, const class RenderMaterial* material);
+        static class ShaderCombination* GetShaderCombination(EMeshPass meshPassType, const class RenderMaterial* material, bool* outIsFallback = nullptr);
         static class TRHIGraphicsPipelineState* GetPipelineState(const RenderContext* context, ShaderCombination* shaderCombination, EMeshPass meshPassType, const class SubMesh* subMesh, RenderMaterial* material);
         static void ApplyShaderBindings(RenderContext* context, RHIDrawCommand* command, ShaderCombination* shader, RenderMaterial* material, class PrimitiveSceneInfo* sceneInfo, EMeshPass meshPassType, bool cacheMeshDrawCommand);
     };
@@ -0,0 +1,75 @@
+#pragma once
+#include "Container.h"
+#include "Matrix.h"
+#include "MathUtilities.h"
+#include "Platform.h"
+
+namespace Thunder
+{
+    class PrimitiveSceneInfo;
+
+    constexpr uint32 InvalidPrimitiveIndex = 0xFFFFFFFF;
+
+    /**
+     * Frustum planes in SoA layout, a point p is inside when Normal.p + Distance >= 0 for every plane.
+     * Unused entries hold a plane that accepts everything.
+     */
+    struct ViewFrustum
+    {
+        static constexpr uint32 MaxPlanes = 8;
+
+        alignas(32) float NormalX[MaxPlanes] {};
+        alignas(32) float NormalY[MaxPlanes] {};
+        alignas(32) float NormalZ[MaxPlanes] {};
+        alignas(32) float Distance[MaxPlanes] {};
+        uint32 NumPlanes = 0;
+
+        // Extracts the six clip planes of a row-vector view-projection matrix (D3D depth range).
+        RENDERCORE_API void SetViewProjection(const TMatrix44f& viewProjection);
+        FORCEINLINE bool IsValid() const { return NumPlanes > 0; }
+    };
+
+    /**
+     * World-space bounds of all registered primitives in SoA layout (center/extent), indexed by a stable primitive index.
+     * Slots are handed out in words of 64 so visibility can be written as one bit per slot.
+     */
+    class PrimitiveBoundsBuffer
+    {
+    public:
+        static constexpr uint32 SlotsPerWord = 64;
+
+        RENDERCORE_API uint32 Allocate(PrimitiveSceneInfo* sceneInfo);
+        RENDERCORE_API void Free(uint32 primitiveIndex);
+        RENDERCORE_API void SetBounds(uint32 primitiveIndex, const AABB& worldBounds);
+        RENDERCORE_API void SetUnbounded(uint32 primitiveIndex);
+
+        FORCEINLINE uint32 GetNumWords() const { return static_cast<uint32>(ActiveMask.size()); }
+        FORCEINLINE uint32 GetNumSlots() const { return GetNumWords() * SlotsPerWord; }
+        FORCEINLINE uint32 GetNumPrimitives() const { return GetNumSlots() - static_cast<uint32>(FreeSlots.size()); }
+        FORCEINLINE PrimitiveSceneInfo* GetPrimitive(uint32 primitiveIndex) const { return Primitives[primitiveIndex]; }
+        FORCEINLINE TVector3f GetCenter(uint32 primitiveIndex) const
+        {
+            return TVector3f(CenterX[primitiveIndex], CenterY[primitiveIndex], CenterZ[primitiveIndex]);
+        }
+
+        /**
+         * Tests the slots of words [beginWord, endWord) against the frustum and writes one bit per slot to outVisibility
+         * (indexed from beginWord). Free slots are never visible. Without a valid frustum every active slot is visible.
+         */
+        RENDERCORE_API void Cull(const ViewFrustum& frustum, uint32 beginWord, uint32 endWord, uint64* outVisibility) const;
+        RENDERCORE_API bool IsVisible(const ViewFrustum& frustum, uint32 primitiveIndex) const;
+
+    private:
+        void Grow();
+
+        TArray<float> CenterX;
+        TArray<float> CenterY;
+        TArray<float> CenterZ;
+        TArray<float> ExtentX;
+        TArray<float> ExtentY;
+        TArray<float> ExtentZ;
+        TArray<uint64> ActiveMask;
+        TArray<PrimitiveSceneInfo*> Primitives;
+        TArray<uint32> FreeSlots;
+    };
+}
@@ -0,0 +1,46 @@
+#pragma once
+#include "Container.h"
+#include "Matrix.h"
+#include "Platform.h"
+#include "RHICommand.h"
+#include "RHIResource.h"
+
+namespace Thunder
+{
+    /**
+     * Scene-wide primitive data indexed by the stable primitive index, shaders read it as PrimitiveSceneData.
+     * The CPU copy is complete, dirty primitives are coalesced into ranges and copied to the GPU once per frame.
+     */
+    class PrimitiveSceneDataBuffer
+    {
+    public:
+        static constexpr uint32 RowsPerPrimitive = 3; // LocalToWorld rows, laid out like the old primitive constants.
+
+        RENDERCORE_API void SetLocalToWorld(uint32 primitiveIndex, const TMatrix44f& localToWorld);
+
+        // Records the copy of all dirty ranges. Returns true when the GPU buffer was recreated, views of the old one are stale.
+        RENDERCORE_API bool Upload_RenderThread(IRHICommandRecorder* recorder);
+
+        FORCEINLINE uint64 GetSRVHandle() const
+        {
+            RHIShaderResourceView* srv = Buffer.IsValid() ? Buffer->GetSRV().Get() : nullptr;
+            return srv ? srv->GetOfflineHandle() : 0;
+        }
+        FORCEINLINE uint32 GetNumPrimitives() const { return static_cast<uint32>(Rows.size()) / RowsPerPrimitive; }
+
+    private:
+        bool EnsureStagingBuffer(uint32 frameIndex, uint32 numRows);
+
+        TArray<TVector4f> Rows;
+        TArray<uint64> DirtyMask; // One bit per primitive.
+
+        RHIStructuredBufferRef Buffer;
+        uint32 BufferCapacity = 0; // In primitives.
+
+        // Upload heap staging, one per frame in flight so the GPU never reads rows being written.
+        RHIStructuredBufferRef StagingBuffers[MAX_FRAME_LAG];
+        uint32 StagingCapacity[MAX_FRAME_LAG] {}; // In rows.
+        TArray<TVector4f> StagingRows;
+        TArray<RHIBufferCopyRegion> CopyRegions;
+    };
+}
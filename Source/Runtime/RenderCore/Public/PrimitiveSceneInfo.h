@@ -5,6 +5,7 @@
 #include "MeshPass.h"
 #include "MeshDrawCommand.h"
 #include "NameHandle.h"
+#include "PrimitiveBounds.h"
 
 namespace Thunder
 {
@@ -20,23 +21,42 @@ namespace Thunder
         virtual ~PrimitiveSceneInfo();
 
         void SetTransform(const TMatrix44f& matrix) { Transform = matrix; }
+        const TMatrix44f& GetTransform() const { return Transform; }
+
+        // Stable slot in FrameGraph's primitive buffers, valid while registered.
+        FORCEINLINE uint32 GetPrimitiveIndex() const { return PrimitiveIndex; }
+        FORCEINLINE void SetPrimitiveIndex(uint32 index) { PrimitiveIndex = index; }
+        // World-space bounds of all static meshes, returns false when the primitive has none.
+        RENDERCORE_API bool GetWorldBounds(AABB& outBounds) const;
 
         virtual bool NeedRenderView(EViewType type) { return true; }
         TMap<MeshBatchKey, StaticMeshBatch*> const& GetStaticMeshes() { return StaticMeshes; }
 
         MeshDrawCommandInfo const& GetDrawCommandInfo(EMeshPass passType, MeshBatchKey batchKey)
         {
-            auto& meshDrawInfo = StaticMeshCommandInfos[passType][batchKey];
+            auto& meshDrawInfo = StaticMeshCommandInfos[static_cast<size_t>(passType)][batchKey];
             return meshDrawInfo;
         }
         void EmplaceDrawCommandInfo(EMeshPass passType, MeshBatchKey meshBatchKey, uint64 commandIndex)
         {
-            StaticMeshCommandInfos[passType][meshBatchKey] = MeshDrawCommandInfo{ commandIndex };
+            StaticMeshCommandInfos[static_cast<size_t>(passType)][meshBatchKey] = MeshDrawCommandInfo{ commandIndex };
+        }
+        // Forget the cached commands of a pass, their indices are appended to outCommandIndices for release.
+        void ReleaseDrawCommandInfos(EMeshPass passType, TArray<uint64>& outCommandIndices)
+        {
+            auto& passInfos = StaticMeshCommandInfos[static_cast<size_t>(passType)];
+            for (auto const& info : passInfos | std::views::values)
+            {
+                outCommandIndices.push_back(info.CommandIndex);
+            }
+            passInfos.clear();
         }
 
+        // Immutable per-primitive uniform buffer holding the primitive index, recreated when the index changes.
         RENDERCORE_API void CreateUniformBuffer();
-        RENDERCORE_API void UpdatePrimitiveUniformBuffer(RenderContext* context);
         const RHIUniformBuffer* GetPrimitiveUniformBuffer() const { return PrimitiveUniformBuffer.IsValid() ? PrimitiveUniformBuffer.Get() : nullptr; }
+        // Immutable primitive uniform buffer of a merged instanced draw group, primitive indices come from PrimitiveInstanceIds.
+        RENDERCORE_API static TRefCountPtr<RHIUniformBuffer> CreateInstancedUniformBuffer(int instanceGroup);
         RENDERCORE_API bool CacheMeshDrawCommand(RenderContext* context, EMeshPass meshPassType);
         RENDERCORE_API bool IsMeshDrawCacheSupported() const  { return MeshDrawCacheSupported; }
 
@@ -45,17 +65,14 @@ namespace Thunder
         void DestroyStaticMesh(MeshBatchKey key);
         void AddStaticMesh(MeshBatchKey const& key, SubMesh* const& subMesh, RenderMaterial* const& material);
 
-        static void SetPrimitiveParameter(const class UniformBufferLayout* layout, NameHandle parameterName, TVector4f const& value, byte* packedData);
-        static void SetPrimitiveParameter(const UniformBufferLayout* layout, NameHandle parameterName, float value, byte* packedData);
-        static void SetPrimitiveParameter(const UniformBufferLayout* layout, NameHandle parameterName, int value, byte* packedData);
-
     protected:
         TMatrix44f Transform;
 
-        TMap<EMeshPass, TMap<MeshBatchKey, MeshDrawCommandInfo>> StaticMeshCommandInfos; // Pass, batch.
+        TMap<MeshBatchKey, MeshDrawCommandInfo> StaticMeshCommandInfos[static_cast<size_t>(EMeshPass::Num)]; // By pass, passes recorded in parallel only touch their own.
         TMap<MeshBatchKey, StaticMeshBatch*> StaticMeshes;
         TMap<MeshBatchKey, StaticMeshBatchRelevance*> StaticMeshRelevances;
         bool MeshDrawCacheSupported = false;
+        uint32 PrimitiveIndex = InvalidPrimitiveIndex;
 
         TRefCountPtr<RHIUniformBuffer> PrimitiveUniformBuffer;
     };
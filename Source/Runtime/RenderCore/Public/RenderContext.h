@@ -19,15 +19,16 @@ namespace Thunder
         RENDERCORE_API RenderContext(class FrameGraph* owner);
         RENDERCORE_API ~RenderContext() override;
 
-        // Clear all commands and free allocator
-        RENDERCORE_API void FreeAllocator() const;
+        // Run registered command destructors and free allocator
+        RENDERCORE_API void FreeAllocator();
 
         // IRHICommandRecorder interface
         RENDERCORE_API void AddCommand(IRHICommand* Command) override;
         RENDERCORE_API TransientAllocator* GetTransientAllocator_RenderThread() const override;
+        RENDERCORE_API void AddCommandDestructor(void* command, void (*destruct)(void*)) override;
 
         // Add command list.
-        RENDERCORE_API void AddCommandList(TArray<struct RHICachedDrawCommand*> commandList);
+        RENDERCORE_API void AddCommandList(TArray<struct RHIDrawCommand*> const& commandList);
 
         // Get all commands recorded in this context
         FORCEINLINE const TArray<IRHICommand*>& GetCommands() const { return Commands; }
@@ -40,6 +41,9 @@ namespace Thunder
         RENDERCORE_API void AddCachedCommand(const class MeshBatch* batch, class RHICachedDrawCommand* command);
         FORCEINLINE TArray<std::tuple<const MeshBatch*, RHICachedDrawCommand*>> const& GetCachedCommands() const { return CachedDrawCommands; }
         RENDERCORE_API void ClearCachedCommands();
+        // Primitives whose cached commands use a fallback shader, gathered with the cached commands.
+        FORCEINLINE void AddFallbackSceneInfo(class PrimitiveSceneInfo* sceneInfo) { FallbackSceneInfos.push_back(sceneInfo); }
+        FORCEINLINE TArray<PrimitiveSceneInfo*> const& GetFallbackSceneInfos() const { return FallbackSceneInfos; }
 
         FORCEINLINE void SetCurrentPass(struct FrameGraphPass* pass) { CurrentPass = pass; }
         FORCEINLINE FrameGraphPass* GetCurrentPass() const { return CurrentPass; }
@@ -52,9 +56,18 @@ namespace Thunder
 
         // Cached commands.
         TArray<std::tuple<const MeshBatch*, RHICachedDrawCommand*>> CachedDrawCommands;
+        TArray<PrimitiveSceneInfo*> FallbackSceneInfos;
 
         // Transient allocator for command allocation
         TransientAllocator* TransientAllocatorPtr[2];
+
+        // Commands owning resources, destructed together when their allocator is freed.
+        struct CommandDestructor
+        {
+            void* Command;
+            void (*Destruct)(void*);
+        };
+        TArray<CommandDestructor> CommandDestructors[2];
         
         FrameGraph* FrameGraph = nullptr;
         FrameGraphPass* CurrentPass = nullptr;
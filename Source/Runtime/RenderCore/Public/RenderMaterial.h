@@ -6,6 +6,8 @@
 #include "MeshPass.h"
 #include "RHI.h"
 #include "ShaderParameterMap.h"
+#include "UniformBufferPacking.h"
+#include "Concurrent/Lock.h"
 
 namespace Thunder
 {
@@ -46,11 +48,11 @@ namespace Thunder
             uint64 variantId = 0) const;
 
         const ShaderParameterMap* GetParameterCache() const { return ParameterCache; }
-        const TMap<NameHandle, bool>& GetStaticSwitchParameters() const { return ParameterCache->StaticSwitchParameters; }
-        const TMap<NameHandle, TVector4f>& GetVectorParameters() const { return ParameterCache->VectorParameters; }
-        const TMap<NameHandle, TGuid>& GetTextureParameters() const { return ParameterCache->TextureParameters; }
-        const TMap<NameHandle, float>& GetFloatParameters() const { return ParameterCache->FloatParameters; }
-        const TMap<NameHandle, int>& GetIntParameters() const { return ParameterCache->IntParameters; }
+        const TMap<NameHandle, bool>& GetStaticSwitchParameters() const { return ParameterCache->GetStaticSwitchParameters(); }
+        const TMap<NameHandle, TVector4f>& GetVectorParameters() const { return ParameterCache->GetVectorParameters(); }
+        const TMap<NameHandle, TGuid>& GetTextureParameters() const { return ParameterCache->GetTextureParameters(); }
+        const TMap<NameHandle, float>& GetFloatParameters() const { return ParameterCache->GetFloatParameters(); }
+        const TMap<NameHandle, int>& GetIntParameters() const { return ParameterCache->GetIntParameters(); }
 
         bool GetRenderState(EMeshPass meshPassType, RHIBlendState& outBlendState, RHIRasterizerState& outRasterizerState, RHIDepthStencilState& outDepthStencilState);
 
@@ -59,6 +61,8 @@ namespace Thunder
         ShaderParameterMap* ParameterCache; //
 
         TRefCountPtr<RHIUniformBuffer> MaterialUniformBuffer;
+        UniformBufferPackingProgram UniformBufferPacking;
+        SpinLock UniformBufferLock;
 
         // Cached resolved textures (render thread only)
         TMap<NameHandle, RHITexture*> TextureCaches;
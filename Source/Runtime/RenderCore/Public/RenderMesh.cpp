@@ -94,8 +94,13 @@ namespace Thunder
         GRHIScheduler->PushTask([vb = VerticesBuffer, ib = IndicesBuffer,
                                   verts = Vertices, indices = Indices]()
         {
-            vb->SetBinaryData(verts->MoveData());
-            ib->SetBinaryData(indices->MoveData());
+            // Data read in place keeps its package mapped until the buffers are uploaded, not for the sub mesh's lifetime.
+            BinaryDataRef vertexSource;
+            BinaryDataRef indexSource;
+            byte* vertexData = verts->MoveData(vertexSource);
+            byte* indexData = indices->MoveData(indexSource);
+            vb->SetBinaryData(vertexData, std::move(vertexSource));
+            ib->SetBinaryData(indexData, std::move(indexSource));
             GRHIUpdateAsyncQueue.push_back(vb);
             GRHIUpdateAsyncQueue.push_back(ib);
         });
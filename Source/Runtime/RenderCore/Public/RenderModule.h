@@ -1,5 +1,6 @@
 #pragma once
 #include "Container.h"
+#include "Concurrent/Lock.h"
 #include "MeshPass.h"
 #include "Module/ModuleManager.h"
 #include <array>
@@ -11,6 +12,7 @@ namespace Thunder
 {
     class RenderTexture;
 	class UniformBufferLayout;
+	class UniformBufferPackingProgram;
 	class FrameGraph;
 	struct FrameGraphPass;
 	struct ShaderParameterMap;
@@ -35,8 +37,9 @@ namespace Thunder
     	RENDERCORE_API static RenderTexture* GetTextureResource_RenderThread(const TGuid& guid);
 
     	// Draw
-    	RENDERCORE_API static byte* SetupUniformBufferParameters(const RenderContext* context, const UniformBufferLayout* layout
-			, const ShaderParameterMap* parameterMap, const String& ubName);
+    	// Returns the packed contents, owned by the program. Single-frame buffers still have to be uploaded every frame.
+    	RENDERCORE_API static const byte* SetupUniformBufferParameters(UniformBufferPackingProgram& program, const UniformBufferLayout* layout
+			, const ShaderParameterMap* parameterMap, const String& ubName, bool* outChanged = nullptr);
     	RENDERCORE_API static TRHIGraphicsPipelineState* GetPipelineState(const RenderContext* context, NameHandle subShaderName,
     		ShaderArchive* archive, ShaderCombination* shaderCombination, const SubMesh* subMesh);
     	RENDERCORE_API static void BuildDrawCommand(FrameGraph* graphBuilder, FrameGraphPass* pass, SubMesh* geometry);
@@ -45,6 +48,7 @@ namespace Thunder
     	std::array<MeshPassProcessorRef, static_cast<size_t>(EMeshPass::Num)> MeshPassProcessors;
     	std::array<TFunction<class MeshPassProcessor*()>, static_cast<size_t>(EMeshPass::Num)> MeshPassProcessorCreators;
     	THashMap<RenderPassKey, RenderPassRef> RenderPasses;
+    	SharedLock RenderPassLock;
 
     	// Texture registry.
     	THashMap<TGuid, RenderTexture*> TextureRegistry;
@@ -1,6 +1,7 @@
 ﻿#pragma once
 
 #include "RenderTexture.h"
+#include "TransientAliasingPlanner.h"
 #include "Vector.h"
 
 namespace Thunder
@@ -41,6 +42,13 @@ namespace Thunder
         }
 
         FORCEINLINE void SetResolution(TVector2u newResolution) { Width = newResolution.X; Height = newResolution.Y; }
+
+        // Identifies interchangeable targets: size, format and bind flags, all single sample. The clear value is not part of it.
+        FORCEINLINE uint64 GetPoolKey() const
+        {
+            return static_cast<uint64>(Width) | (static_cast<uint64>(Height) << 20)
+                | (static_cast<uint64>(Format) << 40) | (static_cast<uint64>(bIsDepthStencil) << 56);
+        }
     };
 
     class FGRenderTarget : public RefCountedObject
@@ -82,17 +90,126 @@ namespace Thunder
             : RenderTarget(inRenderTarget) {}
     };
 
+    /**
+     * Creates the textures behind pooled render targets and frees them again.
+     * The pool only talks to the RHI through this, so it can be driven by a mock factory without a device.
+     */
+    class RENDERCORE_API IRenderTargetFactory
+    {
+    public:
+        virtual ~IRenderTargetFactory() = default;
+        virtual RenderTextureRef CreateRenderTarget(const FGRenderTargetDesc& desc) = 0;
+        virtual void DestroyRenderTarget(const RenderTextureRef& renderTarget) = 0;
+        virtual uint64 GetRenderTargetSize(const FGRenderTargetDesc& desc) = 0;
+    };
+
+    // Committed RHI textures, destroyed through deferred delete as the GPU may still use them.
+    class RENDERCORE_API RHIRenderTargetFactory : public IRenderTargetFactory
+    {
+    public:
+        RenderTextureRef CreateRenderTarget(const FGRenderTargetDesc& desc) override;
+        void DestroyRenderTarget(const RenderTextureRef& renderTarget) override;
+        uint64 GetRenderTargetSize(const FGRenderTargetDesc& desc) override;
+
+    private:
+        THashMap<uint64, uint64> Sizes; // Pool key -> allocation size.
+    };
+
+    /**
+     * Render targets bucketed by pool key, acquire and release are a hash lookup and a free list push or pop.
+     * Free targets unused for RENDERTARGET_UNUSED_FRAME_THRESHOLD frames are destroyed, and when the pool holds more
+     * than its memory budget the least recently used free targets go first. A budget of 0 means unlimited.
+     */
     class RENDERCORE_API RenderTargetPool
     {
     public:
-        RenderTextureRef AcquireRenderTarget(FGRenderTargetDesc& desc);
+        RenderTargetPool(IRenderTargetFactory* factory = nullptr); // Not owned, null uses the RHI factory.
+        RenderTargetPool(const RenderTargetPool&) = delete;
+        RenderTargetPool& operator=(const RenderTargetPool&) = delete;
+
+        RenderTextureRef AcquireRenderTarget(const FGRenderTargetDesc& desc);
         void ReleaseRenderTarget(const RenderTextureRef& renderTarget);
         void TickUnusedFrameCounters();
         void ReleaseLongUnusedTargets();
         void Reset();
 
+        void SetMemoryBudget(uint64 budget);
+        FORCEINLINE uint64 GetMemoryBudget() const { return MemoryBudget; }
+        FORCEINLINE uint64 GetPooledMemory() const { return PooledMemory; } // Used and free targets.
+        FORCEINLINE uint32 GetNumUsedTargets() const { return static_cast<uint32>(UsedTargets.size()); }
+        FORCEINLINE uint32 GetNumFreeTargets() const { return NumFreeTargets; }
+
+    private:
+        struct PoolEntry
+        {
+            RenderTextureRef RenderTarget;
+            uint64 Key = 0;
+            uint64 Size = 0;
+            uint64 LastUsedFrame = 0;
+        };
+
+        void DestroyEntry(PoolEntry& entry);
+        void TrimToBudget();
+
+        IRenderTargetFactory* Factory;
+        THashMap<uint64, TArray<PoolEntry>> FreeLists; // Per pool key, least recently released first.
+        THashMap<RenderTexture*, PoolEntry> UsedTargets;
+        uint64 FrameCounter = 0;
+        uint64 PooledMemory = 0;
+        uint64 MemoryBudget = 0;
+        uint32 NumFreeTargets = 0;
+    };
+
+    struct TransientRenderTargetRequest
+    {
+        FGRenderTargetDesc* Desc = nullptr;
+        uint32 FirstPass = 0; // Execution indices, both inclusive.
+        uint32 LastPass = 0;
+    };
+
+    /**
+     * Backs a frame's render targets with placed textures in one heap, targets with disjoint lifetimes share memory.
+     * Placed textures are cached by (offset, desc) and the heap only grows, so a stable graph creates nothing after warm-up.
+     * The first write of a placed target in a frame needs an aliasing barrier and a clear or discard.
+     */
+    class RENDERCORE_API TransientRenderTargetHeap
+    {
+    public:
+        // False when the RHI cannot place render targets, callers fall back to the pool.
+        bool AllocateRenderTargets(const TArray<TransientRenderTargetRequest>& requests, TArray<RenderTextureRef>& outTargets);
+        void TickUnusedFrameCounters();
+        void ReleaseLongUnusedTargets();
+        void Reset();
+
+        FORCEINLINE const TransientAliasingPlan& GetLastPlan() const { return Plan; }
+        FORCEINLINE uint64 GetHeapSize() const { return Heap.IsValid() ? Heap->GetSize() : 0; }
+
     private:
-        TArray<PooledRenderTarget> AvailableTargets;
-        TArray<RenderTextureRef> UsedTargets;
+        struct AllocationInfo
+        {
+            uint64 Size = 0;
+            uint64 Alignment = 0;
+        };
+
+        // The optimized clear value is baked in at creation, placed targets are only reused with the same one.
+        struct PlacedTargetKey
+        {
+            uint64 Offset;
+            uint64 DescKey;
+            uint32 ClearBits[6]; // Clear color, depth, then stencil and whether there is a clear value at all.
+            auto operator<=>(const PlacedTargetKey&) const = default;
+        };
+        static PlacedTargetKey MakePlacedTargetKey(uint64 offset, const FGRenderTargetDesc& desc);
+
+        bool GetAllocationInfo(const FGRenderTargetDesc& desc, AllocationInfo& outInfo);
+        void ReleasePlacedTargets();
+
+        TransientAliasingPlanner Planner;
+        TransientAliasingPlan Plan;
+        TArray<TransientAllocationRequest> PlannerRequests;
+        THashMap<uint64, AllocationInfo> AllocationInfos; // Desc key -> placement size and alignment.
+        TMap<PlacedTargetKey, PooledRenderTarget> PlacedTargets;
+        RHITransientHeapRef Heap;
+        bool bUnsupported = false;
     };
 }
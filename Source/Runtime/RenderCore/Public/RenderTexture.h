@@ -59,11 +59,16 @@ namespace Thunder
         }
 
         void SetOptimizedClearValue(const TOptimizedClearValue& clearValue) { OptimizedClear = clearValue; }
+        // Create the texture at an offset of a transient heap instead of in its own memory, set before InitRHI.
+        void SetPlacement(RHITransientHeap* heap, uint64 offset) { PlacementHeap = heap; PlacementOffset = offset; }
 
         uint32 GetSizeX() const override { return SizeX; }
         uint32 GetSizeY() const override { return SizeY; }
+        RHIResourceDescriptor MakeResourceDescriptor() const;
     private:
         void CreateTexture_RenderThread() final;
         TOptimizedClearValue OptimizedClear;
+        RHITransientHeapRef PlacementHeap;
+        uint64 PlacementOffset = 0;
     };
 }
@@ -2,6 +2,8 @@
 #include "Assertion.h"
 #include "Container.h"
 #include "Platform.h"
+#include "PrimitiveBounds.h"
+#include "Concurrent/Lock.h"
 #include "Misc/CoreGlabal.h"
 
 namespace Thunder
@@ -20,7 +22,16 @@ namespace Thunder
         RENDERCORE_API SceneView(class FrameGraph* owner, EViewType type) : OwnerFrameGraph(owner), ViewType(type) {}
 
         RENDERCORE_API void CullSceneProxies();
-        RENDERCORE_API bool FrustumCull(class PrimitiveSceneInfo* sceneInfo) { return true; }
+        // Passes recorded in parallel may share the view, the first one culls and the others wait for its result.
+        RENDERCORE_API void CullSceneProxiesOnce();
+        RENDERCORE_API bool FrustumCull(class PrimitiveSceneInfo* sceneInfo) const;
+
+        // Until set, the view has no frustum and every primitive passes culling.
+        FORCEINLINE void SetViewProjection(const TMatrix44f& viewProjection) { Frustum.SetViewProjection(viewProjection); }
+        FORCEINLINE const ViewFrustum& GetFrustum() const { return Frustum; }
+        FORCEINLINE void SetViewOrigin(const TVector3f& origin) { ViewOrigin = origin; }
+        // Squared distance from the view origin to the primitive's bounds center, used for draw sorting.
+        RENDERCORE_API float GetViewDistanceSquared(const PrimitiveSceneInfo* sceneInfo) const;
 
         FORCEINLINE bool IsCulled() const
         {
@@ -48,8 +59,12 @@ namespace Thunder
     private:
         FrameGraph* OwnerFrameGraph;
         EViewType ViewType = EViewType::Num;
+        ViewFrustum Frustum;
+        TVector3f ViewOrigin { 0.f, 0.f, 0.f };
+        TArray<uint64> Visibility; // One bit per primitive index.
 
         std::atomic_uint32_t CurrentFrameCulled = 0;
+        ExclusiveLock CullLock;
         TArray<PrimitiveSceneInfo*> VisibleStaticSceneInfos;
         TArray<PrimitiveSceneInfo*> VisibleDynamicSceneInfos;
     };
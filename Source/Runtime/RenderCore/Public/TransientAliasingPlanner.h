@@ -0,0 +1,45 @@
+#pragma once
+#include "CoreMinimal.h"
+
+namespace Thunder
+{
+    struct TransientAllocationRequest
+    {
+        uint64 Size = 0;
+        uint64 Alignment = 1; // Power of two.
+        uint32 FirstPass = 0; // Execution indices, both inclusive.
+        uint32 LastPass = 0;
+    };
+
+    struct TransientAliasingPlan
+    {
+        TArray<uint64> Offsets; // Per request, into one heap of HeapSize bytes.
+        uint64 HeapSize = 0; // Peak memory with aliasing.
+        uint64 UnaliasedSize = 0; // Peak memory with one allocation per request.
+        uint64 LiveSizeBound = 0; // Largest total size live during one pass, no placement goes below it.
+    };
+
+    /**
+     * Places transient allocations in a single heap so that allocations with disjoint pass lifetimes may overlap.
+     * Greedy by size: largest first, each at the lowest aligned offset that is free over its whole lifetime.
+     * Pure CPU, the frame graph feeds it compiled lifetimes and backs the plan with placed resources.
+     */
+    class RENDERCORE_API TransientAliasingPlanner
+    {
+    public:
+        void Plan(const TArray<TransientAllocationRequest>& requests, TransientAliasingPlan& outPlan);
+
+    private:
+        struct PlacedRange
+        {
+            uint64 Begin;
+            uint64 End;
+        };
+
+        // Scratch kept between frames.
+        TArray<uint32> Order;
+        TArray<uint32> Placed;
+        TArray<PlacedRange> Conflicts;
+        TArray<int64> LiveDeltas;
+    };
+}
@@ -84,8 +84,8 @@ namespace Thunder
                 FrameGraph->ResolveVisibility(EViewType::MainView, EMeshPass::PrePass);
 
                 // Add cached mesh batches.
-                TArray<RHICachedDrawCommand*> const& cachedDrawList = FrameGraph->GetVisibleCachedDrawList(EMeshPass::PrePass);
-                mainContext->AddCommandList(cachedDrawList);
+                TArray<RHIDrawCommand*> const& visibleDrawList = FrameGraph->GetVisibleDrawList(EMeshPass::PrePass);
+                mainContext->AddCommandList(visibleDrawList);
 
                 // Add dynamic mesh batches.
                 auto mainView = FrameGraph->GetSceneView(EViewType::MainView);
@@ -148,8 +148,8 @@ namespace Thunder
                 FrameGraph->ResolveVisibility(EViewType::MainView, EMeshPass::BasePass);
 
                 // Add cached mesh batches.
-                TArray<RHICachedDrawCommand*> const& cachedDrawList = FrameGraph->GetVisibleCachedDrawList(EMeshPass::BasePass);
-                mainContext->AddCommandList(cachedDrawList);
+                TArray<RHIDrawCommand*> const& visibleDrawList = FrameGraph->GetVisibleDrawList(EMeshPass::BasePass);
+                mainContext->AddCommandList(visibleDrawList);
 
                 // Add dynamic mesh batches.
                 auto mainView = FrameGraph->GetSceneView(EViewType::MainView);
@@ -157,35 +157,21 @@ namespace Thunder
                 uint32 const sceneInfoCount = static_cast<uint32>(sceneInfos.size());
                 if (sceneInfoCount > 0)
                 {
-                    const auto doWorkEvent = FPlatformProcess::GetSyncEventFromPool();
-                    auto* dispatcher = new (TMemory::Malloc<TaskDispatcher>()) TaskDispatcher(doWorkEvent);
-                    dispatcher->Promise(static_cast<int>(sceneInfoCount));
-                    GSyncWorkers->ParallelFor([this, &sceneInfos, dispatcher, sceneInfoCount](uint32 bundleBegin, uint32 bundleSize)
+                    // Resolved on the recording thread, workers of the nested loop record into this pass's contexts.
+                    auto const& renderContexts = FrameGraph->GetRenderContexts();
+                    GSyncWorkers->ParallelForRange(sceneInfoCount, [&renderContexts, &sceneInfos](uint32 begin, uint32 end, uint32 contextIndex)
                     {
-                        auto const& contexts = FrameGraph->GetRenderContexts();
-                        auto context = contexts[GetContextId()];
+                        auto context = renderContexts[contextIndex];
                         MeshPassProcessor* processor = RenderModule::GetMeshPassProcessor(EMeshPass::BasePass);
-                        for (uint32 index = bundleBegin; index < bundleBegin + bundleSize; ++index)
+                        for (uint32 index = begin; index < end; ++index)
                         {
-                            if (index >= sceneInfoCount)
-                            {
-                                break;
-                            }
-
-                            auto sceneInfo = sceneInfos[index];
-                            auto const& staticMeshes = sceneInfo->GetStaticMeshes();
+                            auto const& staticMeshes = sceneInfos[index]->GetStaticMeshes();
                             for (const auto& batch : staticMeshes | std::views::values)
                             {
                                 processor->AddMeshBatch(context, batch, EMeshPass::BasePass);
                             }
-
-                            dispatcher->Notify();
                         }
-                    }, sceneInfoCount);
-
-                    doWorkEvent->Wait();
-                    FPlatformProcess::ReturnSyncEventToPool(doWorkEvent);
-                    TMemory::Destroy(dispatcher);
+                    }, 4);
                 }
             });
         }
@@ -229,7 +215,7 @@ namespace Thunder
                 auto context = FrameGraph->GetMainContext();
                 FrameGraphPass* currentPass = context->GetCurrentPass();
                 
-                RHIDummyCommand* newCommand = new (context->Allocate<RHIDummyCommand>()) RHIDummyCommand;
+                RHIDummyCommand* newCommand = context->NewCommand<RHIDummyCommand>();
                 context->AddCommand(newCommand);
             });
         }
@@ -250,6 +236,9 @@ namespace Thunder
         // Update scene info.
         FrameGraph->UpdateSceneInfo_RenderThread();
 
-        UpdatePrimitiveUniformBuffer_RenderThread();
+        UpdatePrimitiveData_RenderThread();
+
+        // Refresh culling bounds and upload dirty transforms.
+        FrameGraph->UpdatePrimitiveData_RenderThread();
     }
 }
@@ -47,6 +47,17 @@ namespace Thunder
     
     namespace
     {
+    	// Textures and buffers are declared outside the constant buffer and bound through descriptor tables.
+    	bool IsObjectParameterType(const String& type)
+    	{
+    		return type.find("Texture") != std::string::npos || type.find("StructuredBuffer") != std::string::npos
+    			|| type.starts_with("Buffer") || type.starts_with("RWBuffer");
+    	}
+
+    	bool IsUnorderedAccessParameterType(const String& type)
+    	{
+    		return type.starts_with("RW") || type.starts_with("Append") || type.starts_with("Consume");
+    	}
     
     	template<typename InElementType>
     	void GenerateParameterCode(const InElementType& param, String& outCode)
@@ -126,9 +137,9 @@ namespace Thunder
     	{
     		for (auto& meta : param)
     		{
-    			if (strstr(meta.Type.c_str(), "Texture"))
+    			if (IsObjectParameterType(meta.Type))
     			{
-    				if (strstr(meta.Type.c_str(), "RWTexture"))
+    				if (IsUnorderedAccessParameterType(meta.Type))
     				{
     					outUAVNum++;
     				}
@@ -161,8 +172,10 @@ namespace Thunder
 
     void ShaderPass::CacheDefaultShaderCache()
     {
-    	//todo: gen default mask and default combination
-    	//todo: compile default
+    	// The fallback is the variant the archive declares as default, it stands in for variants that are still compiling.
+    	const uint64 fallbackVariantId = ShaderModule::GetVariantMask(Archive, {}) | Archive->GetDefaultVariantMask();
+    	FallbackVariantId.store(fallbackVariantId, std::memory_order_release);
+    	RequestVariant(fallbackVariantId, EShaderCompilePriority::Visible);
     }
 
 	void ShaderArchive::CalcRegisterCounts(NameHandle passName, TShaderRegisterCounts& outCount)
@@ -257,6 +270,107 @@ namespace Thunder
     	return syncCompilingEntry->Combination;
     }
 
+	ShaderCombination* ShaderPass::GetOrRequestShaderCombination(uint64 variantId, EShaderCompilePriority priority, bool* outIsFallback)
+    {
+    	if (outIsFallback)
+    	{
+    		*outIsFallback = false;
+    	}
+    	if (ShaderCombination* combination = FindPublishedVariant(variantId)) [[likely]]
+    	{
+    		return combination;
+    	}
+
+    	// Compiled synchronously, or didn't fit in the published table.
+    	if (ShaderCombination* combination = GetShaderCombination(variantId))
+    	{
+    		PublishVariant(variantId, combination);
+    		return combination;
+    	}
+
+    	RequestVariant(variantId, priority);
+    	if (outIsFallback)
+    	{
+    		*outIsFallback = true;
+    	}
+    	const uint64 fallbackVariantId = FallbackVariantId.load(std::memory_order_acquire);
+    	return fallbackVariantId != EmptyVariantSlot ? FindPublishedVariant(fallbackVariantId) : nullptr;
+    }
+
+	bool ShaderPass::CompileRequestedVariant(uint64 variantId)
+    {
+    	if (FindPublishedVariant(variantId))
+    	{
+    		return false;
+    	}
+    	if (ShaderCombination* combination = GetOrCompileShaderCombination(variantId))
+    	{
+    		PublishVariant(variantId, combination);
+    		return true;
+    	}
+    	return false;
+    }
+
+	void ShaderPass::RequestVariant(uint64 variantId, EShaderCompilePriority priority)
+    {
+	    {
+    		auto lock = RequestedVariantsLock.Guard();
+    		auto requestIt = RequestedVariants.find(variantId);
+    		if (requestIt != RequestedVariants.end() && requestIt->second <= priority)
+    		{
+    			// Already queued at this priority or a more urgent one.
+    			return;
+    		}
+    		RequestedVariants[variantId] = priority;
+    	}
+    	ShaderModule::QueueVariantCompile(this, variantId, priority);
+    }
+
+	ShaderCombination* ShaderPass::FindPublishedVariant(uint64 variantId) const
+    {
+    	uint32 slot = static_cast<uint32>((variantId * 0x9E3779B97F4A7C15ull) >> (64 - PublishedVariantSlotBits));
+    	for (uint32 probe = 0; probe < NumPublishedVariantSlots; ++probe)
+    	{
+    		const PublishedVariantSlot& entry = PublishedVariants[slot];
+    		const uint64 slotVariantId = entry.VariantId.load(std::memory_order_acquire);
+    		if (slotVariantId == variantId)
+    		{
+    			// Null while the publisher is between claiming the slot and storing the combination.
+    			return entry.Combination.load(std::memory_order_acquire);
+    		}
+    		if (slotVariantId == EmptyVariantSlot)
+    		{
+    			return nullptr;
+    		}
+    		slot = (slot + 1) & (NumPublishedVariantSlots - 1);
+    	}
+    	return nullptr;
+    }
+
+	void ShaderPass::PublishVariant(uint64 variantId, ShaderCombination* combination)
+    {
+    	uint32 slot = static_cast<uint32>((variantId * 0x9E3779B97F4A7C15ull) >> (64 - PublishedVariantSlotBits));
+    	for (uint32 probe = 0; probe < NumPublishedVariantSlots; ++probe)
+    	{
+    		PublishedVariantSlot& entry = PublishedVariants[slot];
+    		uint64 slotVariantId = entry.VariantId.load(std::memory_order_acquire);
+    		if (slotVariantId == EmptyVariantSlot
+    			&& entry.VariantId.compare_exchange_strong(slotVariantId, variantId, std::memory_order_acq_rel))
+    		{
+    			entry.Combination.store(combination, std::memory_order_release);
+    			return;
+    		}
+    		if (slotVariantId == variantId)
+    		{
+    			// Same combination, Variants holds one per id.
+    			entry.Combination.store(combination, std::memory_order_release);
+    			return;
+    		}
+    		slot = (slot + 1) & (NumPublishedVariantSlots - 1);
+    	}
+    	// Table full, the variant stays reachable through the locked map.
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////
     /// Compile Shader
     //////////////////////////////////////////////////////////////////////////////////////////
@@ -302,20 +416,22 @@ namespace Thunder
     		EShaderStageType stageType = stageMetaIt.first;
     		StageMeta& stageMeta = stageMetaIt.second;
 
-    		// Code-gen.
-    		String source = Archive->GenerateShaderSource(ShaderCodeGenConfig
+    		// Code-gen, into a buffer that keeps its capacity across the variants this thread compiles.
+    		thread_local String source;
+    		source.clear();
+    		Archive->GenerateShaderSource(ShaderCodeGenConfig
 			{
 				.SubShaderName = GetName(),
 				.VariantMask = variantId,
 				.Stage = stageType,
-			});
+			}, source);
 
     		ShaderStage* newStageVariant = new (TMemory::Malloc<ShaderStage>()) ShaderStage{};
     		auto& shaderStageMap = newVariant->GetShaders();
     		shaderStageMap[stageType] = newStageVariant;
 
     		String entryName = stageMeta.EntryPoint;
-    		ShaderModule::CompileShaderSource(source, entryName, stageType, newStageVariant->ByteCode, enableDebugInfo);
+    		ShaderModule::CompileShaderSource(source, entryName, stageType, variantId, newStageVariant->ByteCode, enableDebugInfo);
     		if (!newStageVariant->ByteCode.Data
     			|| newStageVariant->ByteCode.Size == 0)
     		{
@@ -328,11 +444,9 @@ namespace Thunder
 
     ShaderAST::~ShaderAST()
     {
-    	if (ASTRoot)
-    	{
-    		delete ASTRoot;
-    		ASTRoot = nullptr;
-    	}
+    	delete Arena;
+    	Arena = nullptr;
+    	ASTRoot = nullptr;
     }
 
 	void ShaderAST::Reflect(ShaderArchive* archive) const
@@ -431,23 +545,13 @@ namespace Thunder
     	// Generate constant buffer layout
     	archive->BuildUniformBufferLayout();
 
-    	// Generate global uniform buffer layout
-    	ShaderModule::GetModule()->SetGlobalUniformBufferLayout(archive->GetUniformBufferLayout("Global"));
-    	for (uint8 passIndex = 0; passIndex < static_cast<uint8>(EMeshPass::Num); ++passIndex)
-    	{
-    		ShaderModule::GetModule()->SetPassUniformBufferLayout(static_cast<EMeshPass>(passIndex), archive);
-    	}
-    	ShaderModule::GetModule()->SetPrimitiveUniformBufferLayout(archive);
-
     	// Generate bindings layout.
     	archive->BuildBindingsLayout();
 	}
 
-	String ShaderAST::GenerateShaderVariantSource(shader_codegen_state& state) const
+	void ShaderAST::GenerateShaderVariantSource(shader_codegen_state& state, String& outSource) const
     {
-    	String result;
-    	ASTRoot->generate_hlsl(result, state);
-    	return result;
+    	ASTRoot->generate_hlsl(outSource, state);
 	}
 
 	String ShaderAST::GetSubShaderEntry(String const& subShaderName, EShaderStageType stageType) const
@@ -479,7 +583,7 @@ namespace Thunder
     {
     	if (AST)
     	{
-    		TMemory::Free(AST);
+    		TMemory::Destroy(AST);
     	}
     }
 
@@ -550,6 +654,14 @@ namespace Thunder
     	return subShader->CompileShaderVariant(variantId);
     }
 
+	void ShaderArchive::RequestFallbackVariants()
+    {
+    	for (auto& subShader : SubShaders | std::views::values)
+    	{
+    		subShader->CacheDefaultShaderCache();
+    	}
+    }
+
 	void ShaderArchive::ParseVariants(ShaderCodeGenConfig const& config, shader_codegen_state& state) const
 	{
     	uint64 variantMask = config.VariantMask;
@@ -589,6 +701,20 @@ namespace Thunder
     	return mask;
 	}
 
+	uint64 ShaderArchive::GetDefaultVariantMask() const
+    {
+    	uint64 mask = 0;
+    	const int totalVariantNum = static_cast<int>(VariantMeta.size());
+    	for (int variantBitIndex = 0; variantBitIndex < totalVariantNum; ++variantBitIndex)
+    	{
+    		if (VariantMeta[variantBitIndex].Default)
+    		{
+    			mask = mask | (1ULL << variantBitIndex);
+    		}
+    	}
+    	return mask;
+    }
+
 	void ShaderArchive::VariantMaskToName(uint64 variantMask, THashMap<NameHandle, bool>& variantMap) const
     {
     	const int totalVariantNum = static_cast<int>(VariantMeta.size());
@@ -600,6 +726,17 @@ namespace Thunder
     	}
 	}
 
+	void ShaderArchive::RegisterModuleLayouts()
+	{
+    	// Generate global uniform buffer layout
+    	ShaderModule::GetModule()->SetGlobalUniformBufferLayout(GetUniformBufferLayout("Global"));
+    	for (uint8 passIndex = 0; passIndex < static_cast<uint8>(EMeshPass::Num); ++passIndex)
+    	{
+    		ShaderModule::GetModule()->SetPassUniformBufferLayout(static_cast<EMeshPass>(passIndex), this);
+    	}
+    	ShaderModule::GetModule()->SetPrimitiveUniformBufferLayout(this);
+	}
+
 	void ShaderArchive::BuildUniformBufferLayout()
 	{
     	for (auto const& [uniformBufferName, parameterMetas] : UniformParameterMeta)
@@ -613,8 +750,8 @@ namespace Thunder
 
     		for (auto const& paramMeta : parameterMetas)
     		{
-    			// Skip texture types as they are not part of uniform buffer.
-    			if (paramMeta.Type.find("Texture") != std::string::npos)
+    			// Skip texture and buffer types as they are not part of uniform buffer.
+    			if (IsObjectParameterType(paramMeta.Type))
     			{
     				continue;
     			}
@@ -720,9 +857,9 @@ namespace Thunder
     		}
     		for (auto const& uniformBufferParameter : uniformMetas.second)
     		{
-    			if (uniformBufferParameter.Type.find("Texture") != std::string::npos)
+    			if (IsObjectParameterType(uniformBufferParameter.Type))
     			{
-    				if (uniformBufferParameter.Type.starts_with("RW"))
+    				if (IsUnorderedAccessParameterType(uniformBufferParameter.Type))
     				{
     					if (currentUAVIndex < kMaxUAVBindings)
     					{
@@ -788,7 +925,7 @@ namespace Thunder
     					value = 0;
     				}
     			}
-    			shaderParameterMap->IntParameters.emplace(meta.Name, value);
+    			shaderParameterMap->AddDefaultIntParameter(meta.Name, value);
     		}
     		else if (meta.Type == "float")
     		{
@@ -803,7 +940,7 @@ namespace Thunder
     					value = 0.0f;
     				}
     			}
-    			shaderParameterMap->FloatParameters.emplace(meta.Name, value);
+    			shaderParameterMap->AddDefaultFloatParameter(meta.Name, value);
     		}
     		else if (meta.Type == "float4")
     		{
@@ -886,11 +1023,11 @@ namespace Thunder
     					value = TVector4f(0.0f, 0.0f, 0.0f, 0.0f);
     				}
     			}
-    			shaderParameterMap->VectorParameters.emplace(meta.Name, value);
+    			shaderParameterMap->AddDefaultVectorParameter(meta.Name, value);
     		}
     		else if (meta.Type.starts_with("Texture2D"))
     		{
-    			shaderParameterMap->TextureParameters.emplace(meta.Name, TGuid());
+    			shaderParameterMap->AddDefaultTextureParameter(meta.Name, TGuid());
     		}
 		    else
 		    {
@@ -899,7 +1036,7 @@ namespace Thunder
     	}
 	}
 
-	String ShaderArchive::GenerateShaderSource(ShaderCodeGenConfig const& config) const
+	void ShaderArchive::GenerateShaderSource(ShaderCodeGenConfig const& config, String& outSource) const
 	{
     	shader_codegen_state state
     	{
@@ -910,7 +1047,7 @@ namespace Thunder
     		.variants = {}
     	};
     	ParseVariants(config, state);
-    	return AST->GenerateShaderVariantSource(state);
+    	AST->GenerateShaderVariantSource(state, outSource);
     }
 
     String ShaderArchive::GetSubShaderEntry(String const& subShaderName, EShaderStageType stageType) const
@@ -935,26 +1072,26 @@ namespace Thunder
     	{
     		if (meta.Type == "int")
     		{
-    			shaderParameterMap->IntParameters.emplace(meta.Name, 0);
+    			shaderParameterMap->AddDefaultIntParameter(meta.Name, 0);
     		}
     		else if (meta.Type == "float")
     		{
-    			shaderParameterMap->FloatParameters.emplace(meta.Name, 0.f);
+    			shaderParameterMap->AddDefaultFloatParameter(meta.Name, 0.f);
     		}
     		else if (meta.Type == "float4")
     		{
-    			shaderParameterMap->VectorParameters.emplace(meta.Name, TVector4f());
+    			shaderParameterMap->AddDefaultVectorParameter(meta.Name, TVector4f());
     		}
     		else if (meta.Type == "Texture2D")
     		{
-    			shaderParameterMap->TextureParameters.emplace(meta.Name, TGuid());
+    			shaderParameterMap->AddDefaultTextureParameter(meta.Name, TGuid());
     		}
     	}
     	for (auto const& meta : VariantMeta)
     	{
     		if (meta.Visible)
     		{
-    			shaderParameterMap->StaticSwitchParameters.emplace(meta.Name, meta.Default);
+    			shaderParameterMap->AddDefaultStaticSwitchParameter(meta.Name, meta.Default);
     		}
     	}
     	for (auto& uniformMetas : UniformParameterMeta | std::views::values)
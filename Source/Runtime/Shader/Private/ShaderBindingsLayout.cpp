@@ -1,4 +1,5 @@
 #include "ShaderBindingsLayout.h"
+#include <atomic>
 
 #include "ShaderArchive.h"
 
@@ -45,8 +46,30 @@ namespace Thunder
             + (SamplersByName.size() * sizeof(ShaderBindingHandle));
     }
 
+    namespace
+    {
+        uint64 NewUniformBufferLayoutVersion()
+        {
+            static std::atomic<uint64> nextVersion = 1;
+            return nextVersion.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
     UniformBufferLayout::UniformBufferLayout(class ShaderArchive* inShader)
-        : Shader(inShader), TotalSize(0)
+        : Shader(inShader), TotalSize(0), Version(NewUniformBufferLayoutVersion())
+    {
+    }
+
+    void UniformBufferLayout::AddMember(NameHandle name, UniformBufferMemberEntry const& entry)
+    {
+        MemberMap[name] = entry;
+        TotalSize = std::max(TotalSize, entry.Offset + entry.Size);
+        Version = NewUniformBufferLayoutVersion();
+    }
+
+    void UniformBufferLayout::SetTotalSize(uint32 size)
     {
+        TotalSize = size;
+        Version = NewUniformBufferLayoutVersion();
     }
 }
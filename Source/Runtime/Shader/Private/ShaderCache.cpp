@@ -0,0 +1,452 @@
+#include "ShaderCache.h"
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+#include <fstream>
+#include "CRC.h"
+#include "ShaderCompiler.h"
+#include "Memory/MemoryBase.h"
+
+namespace Thunder
+{
+    namespace
+    {
+        constexpr uint32 ShaderCacheEntryMagic = 0x54534345; // "TSCE"
+        constexpr uint32 ShaderCacheIndexMagic = 0x54534349; // "TSCI"
+        constexpr uint32 ShaderCacheVersion = 1; // Bump when code-gen or compile flags change in a way the key doesn't capture.
+        constexpr const char* ShaderCacheIndexName = "ShaderCache.idx";
+        constexpr const char* ShaderCacheEntryExtension = ".tsc";
+        constexpr uint64 ShaderCacheEvictionPercent = 90; // Eviction goes below the cap, so the next stores don't evict again.
+
+        struct EntryHeader
+        {
+            uint32 Magic;
+            uint32 Version;
+            uint64 Key[2];
+            uint64 Size;
+            uint32 Crc;
+            uint32 Padding;
+        };
+
+        struct IndexHeader
+        {
+            uint32 Magic;
+            uint32 Version;
+            uint64 UseClock;
+            uint64 NumEntries;
+        };
+
+        struct IndexRecord
+        {
+            uint64 Key[2];
+            uint64 Size;
+            uint64 LastUse;
+        };
+
+        std::atomic<uint32> GTempFileCounter { 0 };
+
+        FORCEINLINE uint64 RotateLeft(uint64 value, int32 shift)
+        {
+            return (value << shift) | (value >> (64 - shift));
+        }
+
+        FORCEINLINE uint64 FinalMix(uint64 value)
+        {
+            value ^= value >> 33;
+            value *= 0xff51afd7ed558ccdull;
+            value ^= value >> 33;
+            value *= 0xc4ceb9fe1a85ec53ull;
+            value ^= value >> 33;
+            return value;
+        }
+
+        // MurmurHash3 x64 128, continuing from h1 and h2 so the parts of a key hash one after another.
+        void HashBytes(const void* data, size_t size, uint64& h1, uint64& h2)
+        {
+            constexpr uint64 c1 = 0x87c37b91114253d5ull;
+            constexpr uint64 c2 = 0x4cf5ad432745937full;
+            const uint8* bytes = static_cast<const uint8*>(data);
+            const size_t numBlocks = size / 16;
+
+            for (size_t block = 0; block < numBlocks; ++block)
+            {
+                uint64 k1, k2;
+                memcpy(&k1, bytes + block * 16, sizeof(uint64));
+                memcpy(&k2, bytes + block * 16 + 8, sizeof(uint64));
+
+                k1 *= c1; k1 = RotateLeft(k1, 31); k1 *= c2; h1 ^= k1;
+                h1 = RotateLeft(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+                k2 *= c2; k2 = RotateLeft(k2, 33); k2 *= c1; h2 ^= k2;
+                h2 = RotateLeft(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+            }
+
+            const uint8* tail = bytes + numBlocks * 16;
+            const size_t tailSize = size & 15;
+            uint64 k1 = 0, k2 = 0;
+            for (size_t i = tailSize; i > 8; --i)
+            {
+                k2 ^= static_cast<uint64>(tail[i - 1]) << ((i - 9) * 8);
+            }
+            if (tailSize > 8)
+            {
+                k2 *= c2; k2 = RotateLeft(k2, 33); k2 *= c1; h2 ^= k2;
+            }
+            for (size_t i = std::min<size_t>(tailSize, 8); i > 0; --i)
+            {
+                k1 ^= static_cast<uint64>(tail[i - 1]) << ((i - 1) * 8);
+            }
+            if (tailSize > 0)
+            {
+                k1 *= c1; k1 = RotateLeft(k1, 31); k1 *= c2; h1 ^= k1;
+            }
+
+            h1 ^= size; h2 ^= size;
+            h1 += h2; h2 += h1;
+            h1 = FinalMix(h1); h2 = FinalMix(h2);
+            h1 += h2; h2 += h1;
+        }
+
+        bool ParseEntryFileName(const String& stem, uint64& outKeyLow, uint64& outKeyHigh)
+        {
+            if (stem.size() != 32 || !std::all_of(stem.begin(), stem.end(), [](char c) { return std::isxdigit(static_cast<unsigned char>(c)); }))
+            {
+                return false;
+            }
+            outKeyLow = std::stoull(stem.substr(0, 16), nullptr, 16);
+            outKeyHigh = std::stoull(stem.substr(16), nullptr, 16);
+            return true;
+        }
+    }
+
+    ShaderCache::ShaderCache(const String& inDirectory, uint64 inMaxSize)
+        : Directory(inDirectory)
+        , MaxSize(inMaxSize)
+    {
+        std::error_code error;
+        std::filesystem::create_directories(Directory, error);
+        if (!LoadIndex())
+        {
+            ScanDirectory();
+        }
+        LOG("Shader cache: %u entries, %llu bytes in %s", GetNumEntries(), GetTotalSize(), Directory.c_str());
+    }
+
+    ShaderCache::~ShaderCache()
+    {
+        SaveIndex();
+        LOG("Shader cache: %llu hits, %llu misses", GetNumHits(), GetNumMisses());
+    }
+
+    ShaderBytecodeHash ShaderCache::MakeKey(const String& source, const String& entryPoint, EShaderStageType stage, uint64 variantMask,
+        const String& compilerIdentity, bool debug)
+    {
+        uint64 h1 = ShaderCacheVersion;
+        uint64 h2 = ShaderCacheVersion;
+        const uint8 stageValue = static_cast<uint8>(stage);
+        const uint8 flags = debug ? 1 : 0;
+        HashBytes(source.data(), source.size(), h1, h2);
+        HashBytes(entryPoint.data(), entryPoint.size(), h1, h2);
+        HashBytes(&stageValue, sizeof(stageValue), h1, h2);
+        HashBytes(&variantMask, sizeof(variantMask), h1, h2);
+        HashBytes(compilerIdentity.data(), compilerIdentity.size(), h1, h2);
+        HashBytes(&flags, sizeof(flags), h1, h2);
+        return ShaderBytecodeHash{ { h1, h2 } };
+    }
+
+    void ShaderCache::GetOrCompile(ICompiler* compiler, const String& source, const String& entryPoint, EShaderStageType stage, uint64 variantMask,
+        BinaryData& outByteCode, bool debug)
+    {
+        const ShaderBytecodeHash key = MakeKey(source, entryPoint, stage, variantMask, compiler->GetIdentity(), debug);
+        if (Load(key, outByteCode))
+        {
+            NumHits.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+
+        NumMisses.fetch_add(1, std::memory_order_relaxed);
+        compiler->Compile(source, entryPoint, stage, outByteCode, debug);
+        Store(key, outByteCode);
+    }
+
+    bool ShaderCache::Load(const ShaderBytecodeHash& key, BinaryData& outByteCode)
+    {
+        {
+            auto lock = IndexLock.Guard();
+            auto entryIt = Entries.find(key.Hash[0]);
+            if (entryIt == Entries.end() || entryIt->second.KeyHigh != key.Hash[1])
+            {
+                return false;
+            }
+        }
+
+        std::ifstream file(GetEntryPath(key.Hash[0], key.Hash[1]), std::ios::binary);
+        EntryHeader header{};
+        uint8* data = nullptr;
+        bool bValid = file.read(reinterpret_cast<char*>(&header), sizeof(header))
+            && header.Magic == ShaderCacheEntryMagic && header.Version == ShaderCacheVersion
+            && header.Key[0] == key.Hash[0] && header.Key[1] == key.Hash[1] && header.Size > 0 && header.Size <= UINT32_MAX;
+        if (bValid)
+        {
+            data = TMemory::Malloc<uint8>(header.Size);
+            bValid = file.read(reinterpret_cast<char*>(data), static_cast<std::streamsize>(header.Size))
+                && FCrc::BinaryCrc32(data, static_cast<uint32>(header.Size)) == header.Crc;
+        }
+        file.close();
+
+        if (!bValid) [[unlikely]]
+        {
+            if (data)
+            {
+                TMemory::Destroy(data);
+            }
+            LOG("Shader cache: dropping invalid entry %016llx%016llx", key.Hash[0], key.Hash[1]);
+            RemoveEntry(key);
+            return false;
+        }
+
+        outByteCode.Data = data;
+        outByteCode.Size = header.Size;
+
+        auto lock = IndexLock.Guard();
+        auto entryIt = Entries.find(key.Hash[0]);
+        if (entryIt != Entries.end())
+        {
+            entryIt->second.LastUse = ++UseClock;
+        }
+        return true;
+    }
+
+    void ShaderCache::Store(const ShaderBytecodeHash& key, const BinaryData& byteCode)
+    {
+        if (!byteCode.Data || byteCode.Size == 0 || byteCode.Size > UINT32_MAX)
+        {
+            return;
+        }
+
+        // Written aside and renamed into place, so readers never see a partial entry.
+        const String path = GetEntryPath(key.Hash[0], key.Hash[1]);
+        const String tempPath = path + "." + std::to_string(GTempFileCounter.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
+        const EntryHeader header
+        {
+            .Magic = ShaderCacheEntryMagic,
+            .Version = ShaderCacheVersion,
+            .Key = { key.Hash[0], key.Hash[1] },
+            .Size = byteCode.Size,
+            .Crc = FCrc::BinaryCrc32(static_cast<const uint8*>(byteCode.Data), static_cast<uint32>(byteCode.Size)),
+            .Padding = 0,
+        };
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(static_cast<const char*>(byteCode.Data), static_cast<std::streamsize>(byteCode.Size));
+            if (!file)
+            {
+                file.close();
+                std::error_code error;
+                std::filesystem::remove(tempPath, error);
+                return;
+            }
+        }
+        std::error_code error;
+        std::filesystem::rename(tempPath, path, error);
+        if (error)
+        {
+            std::filesystem::remove(tempPath, error);
+            return;
+        }
+
+        {
+            auto lock = IndexLock.Guard();
+            auto [entryIt, bInserted] = Entries.try_emplace(key.Hash[0]);
+            if (!bInserted)
+            {
+                TotalSize -= entryIt->second.Size;
+            }
+            entryIt->second = Entry{ key.Hash[1], byteCode.Size, ++UseClock };
+            TotalSize += byteCode.Size;
+        }
+        Evict();
+    }
+
+    void ShaderCache::SaveIndex()
+    {
+        IndexHeader header{ ShaderCacheIndexMagic, ShaderCacheVersion, 0, 0 };
+        TArray<IndexRecord> records;
+        {
+            auto lock = IndexLock.Guard();
+            records.reserve(Entries.size());
+            for (const auto& [keyLow, entry] : Entries)
+            {
+                records.push_back(IndexRecord{ { keyLow, entry.KeyHigh }, entry.Size, entry.LastUse });
+            }
+            header.UseClock = UseClock;
+            header.NumEntries = records.size();
+        }
+
+        const String indexPath = (std::filesystem::path(Directory) / ShaderCacheIndexName).string();
+        const String tempPath = indexPath + ".tmp";
+        {
+            std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            file.write(reinterpret_cast<const char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(IndexRecord)));
+            if (!file)
+            {
+                return;
+            }
+        }
+        std::error_code error;
+        std::filesystem::rename(tempPath, indexPath, error);
+    }
+
+    uint64 ShaderCache::GetTotalSize() const
+    {
+        auto lock = IndexLock.Guard();
+        return TotalSize;
+    }
+
+    uint32 ShaderCache::GetNumEntries() const
+    {
+        auto lock = IndexLock.Guard();
+        return static_cast<uint32>(Entries.size());
+    }
+
+    String ShaderCache::GetEntryPath(uint64 keyLow, uint64 keyHigh) const
+    {
+        char fileName[40];
+        snprintf(fileName, sizeof(fileName), "%016llx%016llx", static_cast<unsigned long long>(keyLow), static_cast<unsigned long long>(keyHigh));
+        return (std::filesystem::path(Directory) / (String(fileName) + ShaderCacheEntryExtension)).string();
+    }
+
+    bool ShaderCache::LoadIndex()
+    {
+        // The index is removed once read and rewritten on shutdown: when it is missing, entries may have been added
+        // without being indexed and the directory is scanned instead.
+        const String indexPath = (std::filesystem::path(Directory) / ShaderCacheIndexName).string();
+        std::error_code error;
+        const uint64 fileSize = std::filesystem::file_size(indexPath, error);
+        std::ifstream file(indexPath, std::ios::binary);
+        IndexHeader header{};
+        if (error || !file.read(reinterpret_cast<char*>(&header), sizeof(header))
+            || header.Magic != ShaderCacheIndexMagic || header.Version != ShaderCacheVersion
+            || fileSize != sizeof(IndexHeader) + header.NumEntries * sizeof(IndexRecord))
+        {
+            return false;
+        }
+
+        TArray<IndexRecord> records(header.NumEntries);
+        if (!file.read(reinterpret_cast<char*>(records.data()), static_cast<std::streamsize>(records.size() * sizeof(IndexRecord))))
+        {
+            return false;
+        }
+        file.close();
+        std::filesystem::remove(indexPath, error);
+
+        auto lock = IndexLock.Guard();
+        for (const IndexRecord& record : records)
+        {
+            Entries[record.Key[0]] = Entry{ record.Key[1], record.Size, record.LastUse };
+            TotalSize += record.Size;
+        }
+        UseClock = header.UseClock;
+        return true;
+    }
+
+    void ShaderCache::ScanDirectory()
+    {
+        // Only the entry headers are read, the byte code is validated when it's loaded.
+        std::error_code error;
+        for (const auto& directoryEntry : std::filesystem::directory_iterator(Directory, error))
+        {
+            const std::filesystem::path& path = directoryEntry.path();
+            if (path.extension() == ".tmp")
+            {
+                std::filesystem::remove(path, error); // Left by an interrupted store.
+                continue;
+            }
+            if (path.extension() != ShaderCacheEntryExtension)
+            {
+                continue;
+            }
+
+            uint64 keyLow = 0, keyHigh = 0;
+            EntryHeader header{};
+            std::ifstream file(path, std::ios::binary);
+            const bool bValid = ParseEntryFileName(path.stem().string(), keyLow, keyHigh)
+                && file.read(reinterpret_cast<char*>(&header), sizeof(header))
+                && header.Magic == ShaderCacheEntryMagic && header.Version == ShaderCacheVersion
+                && header.Key[0] == keyLow && header.Key[1] == keyHigh
+                && directoryEntry.file_size(error) == sizeof(EntryHeader) + header.Size;
+            file.close();
+            if (!bValid)
+            {
+                std::filesystem::remove(path, error);
+                continue;
+            }
+
+            auto lock = IndexLock.Guard();
+            Entries[keyLow] = Entry{ keyHigh, header.Size, 0 };
+            TotalSize += header.Size;
+        }
+        Evict();
+    }
+
+    void ShaderCache::RemoveEntry(const ShaderBytecodeHash& key)
+    {
+        {
+            auto lock = IndexLock.Guard();
+            auto entryIt = Entries.find(key.Hash[0]);
+            if (entryIt == Entries.end() || entryIt->second.KeyHigh != key.Hash[1])
+            {
+                return;
+            }
+            TotalSize -= entryIt->second.Size;
+            Entries.erase(entryIt);
+        }
+        std::error_code error;
+        std::filesystem::remove(GetEntryPath(key.Hash[0], key.Hash[1]), error);
+    }
+
+    void ShaderCache::Evict()
+    {
+        if (MaxSize == 0)
+        {
+            return;
+        }
+
+        TArray<ShaderBytecodeHash> victims;
+        {
+            auto lock = IndexLock.Guard();
+            if (TotalSize <= MaxSize)
+            {
+                return;
+            }
+
+            TArray<std::pair<uint64, uint64>> useOrder; // (LastUse, key low)
+            useOrder.reserve(Entries.size());
+            for (const auto& [keyLow, entry] : Entries)
+            {
+                useOrder.emplace_back(entry.LastUse, keyLow);
+            }
+            std::sort(useOrder.begin(), useOrder.end());
+
+            const uint64 targetSize = MaxSize / 100 * ShaderCacheEvictionPercent;
+            for (const auto& [lastUse, keyLow] : useOrder)
+            {
+                if (TotalSize <= targetSize)
+                {
+                    break;
+                }
+                auto entryIt = Entries.find(keyLow);
+                victims.push_back(ShaderBytecodeHash{ { keyLow, entryIt->second.KeyHigh } });
+                TotalSize -= entryIt->second.Size;
+                Entries.erase(entryIt);
+            }
+        }
+
+        std::error_code error;
+        for (const ShaderBytecodeHash& victim : victims)
+        {
+            std::filesystem::remove(GetEntryPath(victim.Hash[0], victim.Hash[1]), error);
+        }
+    }
+}
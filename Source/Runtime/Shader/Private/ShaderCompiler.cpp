@@ -1,8 +1,10 @@
 ﻿#include "ShaderCompiler.h"
+#include <filesystem>
 #include "Assertion.h"
 #include "CoreModule.h"
 #include "d3dcompiler.h"
 #include "ShaderArchive.h"
+#include "ShaderIncludeCache.h"
 #include "ShaderModule.h"
 #include "FileSystem/FileModule.h"
 
@@ -32,13 +34,12 @@ namespace Thunder
     			const ShaderArchive* archive = ShaderModule::GetShaderArchive(ShaderName);
     			const String fullPath = archive->GetShaderSourceDir() + "\\" + includedFilename;
     
-    			const size_t pos = IncludeSourceList.size();
-    			IncludeSourceList.push_back("");
-    			auto& IncludeSource = IncludeSourceList[pos];
-    			if (FileModule::LoadFileToString(fullPath, IncludeSource))
+    			ShaderIncludeFileRef includeFile = ShaderIncludeCache::Get().Find(fullPath);
+    			if (includeFile.IsValid())
     			{
-    				*ppData = IncludeSource.c_str();
-    				*pBytes = static_cast<UINT>(IncludeSource.size());
+    				*ppData = includeFile->Contents.c_str();
+    				*pBytes = static_cast<UINT>(includeFile->Contents.size());
+    				PinnedFiles.push_back(std::move(includeFile));
     				return S_OK;
     			}
     			else
@@ -51,8 +52,58 @@ namespace Thunder
     private:
     	const String IncludeCode;
     	NameHandle ShaderName;
-    	TArray<String> IncludeSourceList;
+    	TArray<ShaderIncludeFileRef> PinnedFiles; // Keeps the cached contents handed to the compiler alive until it is done.
     };
+
+	// Serves DXC includes from the shader include cache, the blobs point into the cached contents instead of copying them.
+	// Lives on the stack for one Compile call, so COM reference counting is a no-op.
+	class ThunderDxcIncludeHandler : public IDxcIncludeHandler
+	{
+	public:
+		explicit ThunderDxcIncludeHandler(IDxcUtils* inUtils) : Utils(inUtils) {}
+		virtual ~ThunderDxcIncludeHandler() = default;
+
+		HRESULT STDMETHODCALLTYPE LoadSource(LPCWSTR pFilename, IDxcBlob** ppIncludeSource) override
+		{
+			*ppIncludeSource = nullptr;
+			const std::filesystem::path includePath(pFilename);
+			const String fullPath = includePath.is_absolute() ? includePath.string()
+				: (std::filesystem::path(FileModule::GetEngineShaderRoot()) / includePath).string();
+			ShaderIncludeFileRef includeFile = ShaderIncludeCache::Get().Find(fullPath);
+			if (!includeFile.IsValid())
+			{
+				return E_FAIL;
+			}
+
+			ComPtr<IDxcBlobEncoding> includeBlob;
+			const HRESULT hr = Utils->CreateBlobFromPinned(includeFile->Contents.data(), static_cast<uint32>(includeFile->Contents.size()),
+				DXC_CP_UTF8, &includeBlob);
+			if (FAILED(hr))
+			{
+				return hr;
+			}
+			PinnedFiles.push_back(std::move(includeFile));
+			*ppIncludeSource = includeBlob.Detach();
+			return S_OK;
+		}
+
+		HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvObject) override
+		{
+			if (riid == __uuidof(IDxcIncludeHandler) || riid == __uuidof(IUnknown))
+			{
+				*ppvObject = static_cast<IDxcIncludeHandler*>(this);
+				return S_OK;
+			}
+			*ppvObject = nullptr;
+			return E_NOINTERFACE;
+		}
+		ULONG STDMETHODCALLTYPE AddRef() override { return 1; }
+		ULONG STDMETHODCALLTYPE Release() override { return 1; }
+
+	private:
+		IDxcUtils* Utils;
+		TArray<ShaderIncludeFileRef> PinnedFiles;
+	};
     
     FXCCompiler::FXCCompiler()
     {
@@ -62,6 +113,11 @@ namespace Thunder
     		{EShaderStageType::Compute, "cs_5_0"}
     	};
     }
+
+    String FXCCompiler::GetIdentity() const
+    {
+    	return "FXC " + std::to_string(D3D_COMPILER_VERSION);
+    }
     
     void FXCCompiler::Compile(NameHandle archiveName, const String& inSource, SIZE_T srcDataSize, const THashMap<NameHandle, bool>& marco, const String& includeStr, const String& pEntryPoint, const String& pTarget, BinaryData& outByteCode)
     {
@@ -117,6 +173,14 @@ namespace Thunder
     	{
     		LOG("Fail to Creat DXCCompiler");
     	}
+
+    	ComPtr<IDxcVersionInfo> versionInfo;
+    	if (ShaderCompiler && SUCCEEDED(ShaderCompiler.As(&versionInfo)))
+    	{
+    		uint32 major = 0, minor = 0;
+    		versionInfo->GetVersion(&major, &minor);
+    		Identity = "DXC " + std::to_string(major) + "." + std::to_string(minor);
+    	}
     }
     
     void DXCCompiler::Compile(NameHandle archiveName, const String& inSource, SIZE_T srcDataSize, const THashMap<NameHandle, bool>& marco, const String& includeStr, const String& pEntryPoint, const String& pTarget, BinaryData& outByteCode)
@@ -147,19 +211,13 @@ namespace Thunder
     			// -Qstrip_debug    -Qembed_debug
     		};
     
-    		ComPtr<IDxcIncludeHandler> pIncludeHandler;
-    		HRESULT hr = ShaderUtils->CreateDefaultIncludeHandler(&pIncludeHandler);
-    		if (FAILED(hr))
-    		{
-    			LOG("Fail to CreateDefaultIncludeHandler.");
-    			return;
-    		}
+    		ThunderDxcIncludeHandler includeHandler(ShaderUtils.Get());
     	
     		DxcBuffer sourceBlob{};
     		sourceBlob.Ptr = inSource.c_str();
     		sourceBlob.Size = inSource.size();
     		ComPtr<IDxcResult> pResult;
-    		hr = compiler3->Compile(&sourceBlob, pszArgs, _countof(pszArgs), pIncludeHandler.Get(), IID_PPV_ARGS(&pResult));
+    		HRESULT hr = compiler3->Compile(&sourceBlob, pszArgs, _countof(pszArgs), &includeHandler, IID_PPV_ARGS(&pResult));
     		if (SUCCEEDED(hr))
     		{
     			hr = pResult->GetStatus(&hr);
@@ -277,19 +335,13 @@ namespace Thunder
     			args.push_back(L"-O3");
     		}
 
-    		ComPtr<IDxcIncludeHandler> pIncludeHandler;
-    		HRESULT hr = ShaderUtils->CreateDefaultIncludeHandler(&pIncludeHandler);
-    		if (FAILED(hr))
-    		{
-    			LOG("Fail to CreateDefaultIncludeHandler.");
-    			return;
-    		}
+    		ThunderDxcIncludeHandler includeHandler(ShaderUtils.Get());
     	
     		DxcBuffer sourceBlob{};
     		sourceBlob.Ptr = inSource.c_str();
     		sourceBlob.Size = inSource.size();
     		ComPtr<IDxcResult> pResult;
-    		hr = compiler3->Compile(&sourceBlob, args.data(), static_cast<uint32>(args.size()), pIncludeHandler.Get(), IID_PPV_ARGS(&pResult));
+    		HRESULT hr = compiler3->Compile(&sourceBlob, args.data(), static_cast<uint32>(args.size()), &includeHandler, IID_PPV_ARGS(&pResult));
     		if (SUCCEEDED(hr))
     		{
     			hr = pResult->GetStatus(&hr);
@@ -380,5 +432,17 @@ namespace Thunder
     		}
     	}
     }
+
+    void NullCompiler::Compile(NameHandle archiveName, const String& inSource, SIZE_T srcDataSize, const THashMap<NameHandle, bool>& marco, const String& includeStr, const String& pEntryPoint, const String& pTarget, BinaryData& outByteCode)
+    {
+    	Compile(inSource, pEntryPoint, EShaderStageType::Unknown, outByteCode);
+    }
+
+    void NullCompiler::Compile(const String& inSource, const String& entryPoint, EShaderStageType stage, BinaryData& outByteCode, bool debug/* = false*/)
+    {
+    	outByteCode.Size = inSource.size() + 1;
+    	outByteCode.Data = TMemory::Malloc<uint8>(outByteCode.Size);
+    	memcpy(outByteCode.Data, inSource.c_str(), outByteCode.Size);
+    }
 }
 
@@ -2,6 +2,8 @@
 #pragma optimize("", off)
 
 #include "ShaderModule.h"
+#include <algorithm>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 #include "Assertion.h"
@@ -12,15 +14,21 @@
 #include "ShaderLang.h"
 #include "rapidjson/document.h"
 #include "ShaderArchive.h"
+#include "ShaderIncludeCache.h"
 #include "ShaderParameterMap.h"
 #include "Concurrent/TaskScheduler.h"
 #include "FileSystem/FileModule.h"
 #include "Memory/MemoryBase.h"
 
-extern Thunder::shader_lang_state* ThunderParse(const char* text);
+extern bool ThunderParse(Thunder::shader_lang_state* state, const char* text);
 namespace Thunder
 {
 	IMPLEMENT_MODULE(Shader, ShaderModule)
+
+	namespace
+	{
+		constexpr uint64 DefaultShaderCacheSizeMB = 256;
+	}
 	
 	const THashMap<EFixedVariant, String> GFixedVariantMap = 
 	{
@@ -30,6 +38,12 @@ namespace Thunder
 
 	void ShaderModule::ShutDown()
 	{
+		// Normally already drained before the async workers were shut down, compiles still running here would write
+		// into the archives and the byte code cache released below.
+		DrainVariantCompiles();
+		BytecodeCache.SafeRelease(); // Writes the cache index.
+		LOG("Shader include cache: %llu hits, %llu misses", ShaderIncludeCache::Get().GetNumHits(), ShaderIncludeCache::Get().GetNumMisses());
+		ShaderIncludeCache::Get().Clear();
 		for (auto archive : ShaderMap | std::views::values)
 		{
 			if (archive)
@@ -60,8 +74,35 @@ namespace Thunder
 				ShaderCompiler = MakeRefCount<FXCCompiler>();
 				break;
 			}
+		case EGfxApiType::Null:
+			{
+				ShaderCompiler = MakeRefCount<NullCompiler>();
+				break;
+			}
 		case EGfxApiType::Invalid: break;
 		}
+
+		// Byte code cache, not for the null compiler whose output is the source itself. "ShaderCacheSizeMB" 0 turns it off.
+		uint64 cacheSizeMB = DefaultShaderCacheSizeMB;
+		auto engineConfig = GConfigManager ? GConfigManager->GetConfig("BaseEngine") : nullptr;
+		if (engineConfig && engineConfig->Layout.contains("ShaderCacheSizeMB"))
+		{
+			cacheSizeMB = static_cast<uint64>(engineConfig->GetFloatAsInt("ShaderCacheSizeMB"));
+		}
+		if (ShaderCompiler && type != EGfxApiType::Null && cacheSizeMB > 0)
+		{
+			BytecodeCache = MakeRefCount<ShaderCache>((std::filesystem::path(FileModule::GetProjectRoot()) / "Saved" / "ShaderCache").string(),
+				cacheSizeMB * 1024 * 1024);
+		}
+
+		if (engineConfig && engineConfig->Layout.contains("AsyncShaderCompilation"))
+		{
+			bAsyncCompilation = engineConfig->GetBool("AsyncShaderCompilation");
+		}
+		if (engineConfig && engineConfig->Layout.contains("MaxConcurrentShaderCompiles"))
+		{
+			MaxRunningVariantCompiles = std::max(static_cast<uint32>(engineConfig->GetFloatAsInt("MaxConcurrentShaderCompiles")), 1u);
+		}
 	}
 
 	namespace
@@ -82,32 +123,68 @@ namespace Thunder
 		}
 	}
 
+	ShaderArchive* ShaderModule::LoadShaderArchive(const String& path)
+	{
+		std::ifstream file(path);
+		std::stringstream buffer;
+		buffer << file.rdbuf();
+		std::string raw_text = buffer.str();
+		String processed_text = PreProcessor::Process(raw_text).c_str();
+
+		// Every parse has its own state, nothing is shared with other archives being parsed.
+		shader_lang_state st{};
+		if (!ThunderParse(&st, processed_text.c_str())) [[unlikely]]
+		{
+			TAssertf(false, "Parse Error, file \"%s\".", path.c_str());
+			return nullptr;
+		}
+		//DebugCodeGen(&st, path);
+
+		ShaderAST* newAst = new (TMemory::Malloc<ShaderAST>()) ShaderAST(st.ast_root, st.release_arena(), std::move(st.custom_types));
+		ShaderArchive* newArchive = new (TMemory::Malloc<ShaderArchive>()) ShaderArchive(path, st.shader_name);
+		newArchive->SetAST(newAst);
+		return newArchive;
+	}
+
 	// load all shader archive
 	void ShaderModule::InitShaderMap()
 	{
 		TArray<String> shaderNameList;
 		FileModule::TraverseFileFromFolderWithFormat(FileModule::GetEngineShaderRoot(), shaderNameList, "tsf");
-		
-		for (const String& metaFileName: shaderNameList)
-		{
-			LOG("ParseShaderFile: %s", metaFileName.c_str());
-			std::ifstream file(metaFileName);
-			std::stringstream buffer;
-			buffer << file.rdbuf();
-			std::string raw_text = buffer.str();
-			String processed_text = PreProcessor::Process(raw_text).c_str();
-			shader_lang_state* st = ThunderParse(processed_text.c_str());
-			fflush(stdout);
 
-			TAssertf( st->ast_root != nullptr, "Parse Error");
-			//DebugCodeGen(st, metaFileName);
+		// Archives are independent until they are registered, load them on the sync workers.
+		const uint32 numArchives = static_cast<uint32>(shaderNameList.size());
+		TArray<ShaderArchive*> loadedArchives(numArchives, nullptr);
+		auto loadArchives = [&shaderNameList, &loadedArchives](uint32 begin, uint32 end, uint32)
+		{
+			for (uint32 index = begin; index < end; ++index)
+			{
+				LOG("ParseShaderFile: %s", shaderNameList[index].c_str());
+				loadedArchives[index] = LoadShaderArchive(shaderNameList[index]);
+				if (loadedArchives[index])
+				{
+					LOG("Succeed to Parse %s", shaderNameList[index].c_str());
+				}
+			}
+		};
+		if (GSyncWorkers)
+		{
+			GSyncWorkers->ParallelForRange(numArchives, loadArchives, 1);
+		}
+		else
+		{
+			loadArchives(0, numArchives, 0);
+		}
+		fflush(stdout);
 
-			ShaderAST* newAst = new (TMemory::Malloc<ShaderAST>()) ShaderAST(st->ast_root, std::move(st->custom_types));
-			ShaderArchive* newArchive = new (TMemory::Malloc<ShaderArchive>()) ShaderArchive(metaFileName, st->shader_name);
-			GetModule()->ShaderMap[st->shader_name] = newArchive;
-			newArchive->SetAST(newAst);
-			st->reset();
-			LOG("Succeed to Parse %s", metaFileName.c_str());
+		// Registered in file order, so the module layouts don't depend on which archive finished first.
+		for (ShaderArchive* archive : loadedArchives)
+		{
+			if (archive)
+			{
+				GetModule()->ShaderMap[archive->GetName()] = archive;
+				archive->RegisterModuleLayouts();
+			}
 		}
 
 		// print all shader
@@ -117,6 +194,15 @@ namespace Thunder
 			LOG("Name: %s, SourcePath: %s", fst.c_str(), snd->GetSourcePath().c_str());
 		}
 		LOG("--------- All Shader End ---------\n");
+
+		// Fallbacks are queued once the whole map is built, their compile tasks look archives up in it.
+		if (IsAsyncCompilationEnabled())
+		{
+			for (ShaderArchive* archive : GetModule()->ShaderMap | std::views::values)
+			{
+				archive->RequestFallbackVariants();
+			}
+		}
 	}
 
 	uint64 ShaderModule::GetVariantMask(ShaderArchive* archive, const TMap<NameHandle, bool>& parameters)
@@ -138,11 +224,12 @@ namespace Thunder
 		return variantMask;
 	}
 
-	ShaderCombination* ShaderModule::GetShaderCombination(ShaderArchive* archive, EMeshPass meshPassType, uint64 variantMask)
+	ShaderCombination* ShaderModule::GetShaderCombination(ShaderArchive* archive, EMeshPass meshPassType, uint64 variantMask, bool* outIsFallback)
 	{
 		if (ShaderPass* subShader = archive->GetSubShader(meshPassType))
 		{
-			return subShader->GetOrCompileShaderCombination(variantMask);
+			return IsAsyncCompilationEnabled() ? subShader->GetOrRequestShaderCombination(variantMask, EShaderCompilePriority::Visible, outIsFallback)
+				: subShader->GetOrCompileShaderCombination(variantMask);
 		}
 		return nullptr;
 	}
@@ -151,11 +238,97 @@ namespace Thunder
 	{
 		if (ShaderPass* subShader = archive->GetSubShader(subShaderName))
 		{
-			return subShader->GetOrCompileShaderCombination(variantMask);
+			return IsAsyncCompilationEnabled() ? subShader->GetOrRequestShaderCombination(variantMask, EShaderCompilePriority::Visible)
+				: subShader->GetOrCompileShaderCombination(variantMask);
 		}
 		return nullptr;
 	}
 
+	void ShaderModule::PrewarmShaderCombination(ShaderArchive* archive, EMeshPass meshPassType, uint64 variantMask)
+	{
+		if (!IsAsyncCompilationEnabled())
+		{
+			return;
+		}
+		if (ShaderPass* subShader = archive->GetSubShader(meshPassType))
+		{
+			subShader->GetOrRequestShaderCombination(variantMask, EShaderCompilePriority::Prewarm);
+		}
+	}
+
+	void ShaderModule::QueueVariantCompile(ShaderPass* pass, uint64 variantId, EShaderCompilePriority priority)
+	{
+		ShaderModule* module = GetModule();
+		{
+			auto lock = module->VariantCompileLock.Guard();
+			if (module->bVariantCompilesDrained)
+			{
+				return;
+			}
+			module->VariantCompileQueues[static_cast<uint8>(priority)].push_back({ pass, variantId });
+		}
+		module->PumpVariantCompiles();
+	}
+
+	void ShaderModule::DrainVariantCompiles()
+	{
+		{
+			auto lock = VariantCompileLock.Guard();
+			bVariantCompilesDrained = true;
+			for (auto& queue : VariantCompileQueues)
+			{
+				queue.clear();
+			}
+		}
+
+		// Nothing is queued any more, so each running compile only decrements the counter when it is done.
+		while (true)
+		{
+			{
+				auto lock = VariantCompileLock.Guard();
+				if (NumRunningVariantCompiles == 0)
+				{
+					return;
+				}
+			}
+			FPlatformProcess::Sleep(0.f);
+		}
+	}
+
+	void ShaderModule::PumpVariantCompiles()
+	{
+		TArray<VariantCompileRequest> startedRequests;
+		{
+			auto lock = VariantCompileLock.Guard();
+			for (auto& queue : VariantCompileQueues)
+			{
+				while (!queue.empty() && NumRunningVariantCompiles < MaxRunningVariantCompiles)
+				{
+					startedRequests.push_back(queue.front());
+					queue.pop_front();
+					++NumRunningVariantCompiles;
+				}
+			}
+		}
+
+		// A variant raised from prewarm to visible is queued twice, the second compile finds it published and returns.
+		for (const VariantCompileRequest& request : startedRequests)
+		{
+			GAsyncWorkers->PushTask([this, request]()
+			{
+				if (request.Pass->CompileRequestedVariant(request.VariantId))
+				{
+					PublishedVariantEpoch.fetch_add(1, std::memory_order_release);
+				}
+				{
+					auto lock = VariantCompileLock.Guard();
+					--NumRunningVariantCompiles;
+				}
+				PumpVariantCompiles();
+			});
+		}
+	}
+
 	TRHIPipelineState* ShaderModule::GetPSO(uint64 psoKey)
 	{
 		if (GetModule()->PSOMap.contains(psoKey))
@@ -244,9 +417,15 @@ namespace Thunder
 		return archive->CompileShaderVariant(passName, variantId);
     }
 
-    void ShaderModule::CompileShaderSource(const String& inSource, const String& entryPoint, EShaderStageType stage, BinaryData& outByteCode, bool debug)
+    void ShaderModule::CompileShaderSource(const String& inSource, const String& entryPoint, EShaderStageType stage, uint64 variantMask, BinaryData& outByteCode, bool debug)
 	{
-		GetModule()->ShaderCompiler->Compile(inSource, entryPoint, stage, outByteCode, debug);
+		ShaderModule* module = GetModule();
+		if (module->BytecodeCache)
+		{
+			module->BytecodeCache->GetOrCompile(module->ShaderCompiler, inSource, entryPoint, stage, variantMask, outByteCode, debug);
+			return;
+		}
+		module->ShaderCompiler->Compile(inSource, entryPoint, stage, outByteCode, debug);
     }
 
     enum_shader_stage ShaderModule::GetShaderASTStage(EShaderStageType stage)
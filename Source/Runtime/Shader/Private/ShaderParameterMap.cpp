@@ -1,8 +1,68 @@
 
 #include "ShaderParameterMap.h"
+#include <algorithm>
+#include <atomic>
+#include <ranges>
 
 namespace Thunder
 {
+	namespace
+	{
+		template <typename MapType>
+		bool HasSameParameters(const MapType& lhs, const MapType& rhs)
+		{
+			return lhs.size() == rhs.size() && std::ranges::equal(lhs | std::views::keys, rhs | std::views::keys);
+		}
+
+		// Both maps hold the same keys, so their entries line up in order.
+		template <typename MapType>
+		void CopyParameterValues(MapType& dest, const MapType& source)
+		{
+			auto sourceIt = source.begin();
+			for (auto& value : dest | std::views::values)
+			{
+				value = (sourceIt++)->second;
+			}
+		}
+	}
+
+	uint64 ShaderParameterMap::NewStructureVersion()
+	{
+		static std::atomic<uint64> nextVersion = 1;
+		return nextVersion.fetch_add(1, std::memory_order_relaxed);
+	}
+
+	ShaderParameterMap& ShaderParameterMap::operator=(const ShaderParameterMap& other)
+	{
+		if (this == &other)
+		{
+			return *this;
+		}
+
+		// Overwriting the values in place keeps the entries, so pointers cached against the version stay valid.
+		if (HasSameParameters(IntParameters, other.IntParameters)
+			&& HasSameParameters(FloatParameters, other.FloatParameters)
+			&& HasSameParameters(VectorParameters, other.VectorParameters)
+			&& HasSameParameters(TextureParameters, other.TextureParameters)
+			&& HasSameParameters(StaticSwitchParameters, other.StaticSwitchParameters))
+		{
+			CopyParameterValues(IntParameters, other.IntParameters);
+			CopyParameterValues(FloatParameters, other.FloatParameters);
+			CopyParameterValues(VectorParameters, other.VectorParameters);
+			CopyParameterValues(TextureParameters, other.TextureParameters);
+			CopyParameterValues(StaticSwitchParameters, other.StaticSwitchParameters);
+			return *this;
+		}
+
+		IntParameters = other.IntParameters;
+		FloatParameters = other.FloatParameters;
+		VectorParameters = other.VectorParameters;
+		TextureParameters = other.TextureParameters;
+		StaticSwitchParameters = other.StaticSwitchParameters;
+		MarkStructureChanged();
+		return *this;
+	}
+
 	void ShaderParameterMap::Reset()
 	{
 		IntParameters.clear();
@@ -10,36 +70,95 @@ namespace Thunder
 		VectorParameters.clear();
 		TextureParameters.clear();
 		StaticSwitchParameters.clear();
+		MarkStructureChanged();
 	}
 
 	void ShaderParameterMap::SetIntParameter(const NameHandle& paramName, int32 value)
 	{
-		IntParameters[paramName] = value;
+		if (IntParameters.insert_or_assign(paramName, value).second)
+		{
+			MarkStructureChanged();
+		}
 	}
 
 	void ShaderParameterMap::SetFloatParameter(const NameHandle& paramName, float value)
 	{
-		FloatParameters[paramName] = value;
+		if (FloatParameters.insert_or_assign(paramName, value).second)
+		{
+			MarkStructureChanged();
+		}
 	}
 
 	void ShaderParameterMap::SetVectorParameter(const NameHandle& paramName, const TVector4f& value)
 	{
-		VectorParameters[paramName] = value;
+		if (VectorParameters.insert_or_assign(paramName, value).second)
+		{
+			MarkStructureChanged();
+		}
 	}
 
 	void ShaderParameterMap::SetTextureParameter(const NameHandle& paramName, const TGuid& textureGuid)
 	{
-		TextureParameters[paramName] = textureGuid;
+		if (TextureParameters.insert_or_assign(paramName, textureGuid).second)
+		{
+			MarkStructureChanged();
+		}
 	}
 
 	void ShaderParameterMap::SetTextureParameter(const NameHandle& paramName, uint32 textureId)
 	{
-		TextureParameters[paramName] = TGuid(textureId);
+		if (TextureParameters.insert_or_assign(paramName, TGuid(textureId)).second)
+		{
+			MarkStructureChanged();
+		}
 	}
 
 	void ShaderParameterMap::SetStaticSwitchParameter(const NameHandle& paramName, bool value)
 	{
-		StaticSwitchParameters[paramName] = value;
+		if (StaticSwitchParameters.insert_or_assign(paramName, value).second)
+		{
+			MarkStructureChanged();
+		}
+	}
+
+	void ShaderParameterMap::AddDefaultIntParameter(const NameHandle& paramName, int32 value)
+	{
+		if (IntParameters.emplace(paramName, value).second)
+		{
+			MarkStructureChanged();
+		}
+	}
+
+	void ShaderParameterMap::AddDefaultFloatParameter(const NameHandle& paramName, float value)
+	{
+		if (FloatParameters.emplace(paramName, value).second)
+		{
+			MarkStructureChanged();
+		}
+	}
+
+	void ShaderParameterMap::AddDefaultVectorParameter(const NameHandle& paramName, const TVector4f& value)
+	{
+		if (VectorParameters.emplace(paramName, value).second)
+		{
+			MarkStructureChanged();
+		}
+	}
+
+	void ShaderParameterMap::AddDefaultTextureParameter(const NameHandle& paramName, const TGuid& textureGuid)
+	{
+		if (TextureParameters.emplace(paramName, textureGuid).second)
+		{
+			MarkStructureChanged();
+		}
+	}
+
+	void ShaderParameterMap::AddDefaultStaticSwitchParameter(const NameHandle& paramName, bool value)
+	{
+		if (StaticSwitchParameters.emplace(paramName, value).second)
+		{
+			MarkStructureChanged();
+		}
 	}
 
 	bool ShaderParameterMap::GetIntParameter(const NameHandle& paramName, int32& outValue) const
@@ -99,26 +218,41 @@ namespace Thunder
 
 	void ShaderParameterMap::RemoveIntParameter(const NameHandle& paramName)
 	{
-		IntParameters.erase(paramName);
+		if (IntParameters.erase(paramName) > 0)
+		{
+			MarkStructureChanged();
+		}
 	}
 
 	void ShaderParameterMap::RemoveFloatParameter(const NameHandle& paramName)
 	{
-		FloatParameters.erase(paramName);
+		if (FloatParameters.erase(paramName) > 0)
+		{
+			MarkStructureChanged();
+		}
 	}
 
 	void ShaderParameterMap::RemoveVectorParameter(const NameHandle& paramName)
 	{
-		VectorParameters.erase(paramName);
+		if (VectorParameters.erase(paramName) > 0)
+		{
+			MarkStructureChanged();
+		}
 	}
 
 	void ShaderParameterMap::RemoveTextureParameter(const NameHandle& paramName)
 	{
-		TextureParameters.erase(paramName);
+		if (TextureParameters.erase(paramName) > 0)
+		{
+			MarkStructureChanged();
+		}
 	}
 
 	void ShaderParameterMap::RemoveStaticSwitchParameter(const NameHandle& paramName)
 	{
-		StaticSwitchParameters.erase(paramName);
+		if (StaticSwitchParameters.erase(paramName) > 0)
+		{
+			MarkStructureChanged();
+		}
 	}
 }
@@ -0,0 +1,123 @@
+#include "UniformBufferPacking.h"
+#include <algorithm>
+
+namespace Thunder
+{
+    namespace
+    {
+        constexpr uint32 PackedDataAlignment = 256; // Constant buffer placement alignment.
+
+        template <typename ValueType>
+        const byte* FindParameterValue(const TMap<NameHandle, ValueType>& parameters, NameHandle name)
+        {
+            auto it = parameters.find(name);
+            return it != parameters.end() ? reinterpret_cast<const byte*>(&it->second) : nullptr;
+        }
+    }
+
+    UniformBufferPackingProgram::~UniformBufferPackingProgram()
+    {
+        if (PackedData)
+        {
+            TMemory::Free(PackedData);
+            PackedData = nullptr;
+        }
+    }
+
+    bool UniformBufferPackingProgram::Pack(const UniformBufferLayout* layout, const ShaderParameterMap* parameterMap)
+    {
+        if (layout != Layout || layout->GetVersion() != LayoutVersion
+            || parameterMap != ParameterMap || parameterMap->GetStructureVersion() != ParameterMapVersion) [[unlikely]]
+        {
+            Compile(layout, parameterMap);
+            for (const CopyOp& op : CopyOps)
+            {
+                memcpy(PackedData + op.DestOffset, op.Source, op.Size);
+            }
+            return true;
+        }
+
+        // Only members whose value changed are rewritten.
+        bool bChanged = false;
+        for (const CopyOp& op : CopyOps)
+        {
+            byte* dest = PackedData + op.DestOffset;
+            if (memcmp(dest, op.Source, op.Size) != 0)
+            {
+                memcpy(dest, op.Source, op.Size);
+                bChanged = true;
+            }
+        }
+        return bChanged;
+    }
+
+    void UniformBufferPackingProgram::Invalidate()
+    {
+        Layout = nullptr;
+        ParameterMap = nullptr;
+    }
+
+    void UniformBufferPackingProgram::Compile(const UniformBufferLayout* layout, const ShaderParameterMap* parameterMap)
+    {
+        uint32 const packedSize = (layout->GetTotalSize() + PackedDataAlignment - 1) & ~(PackedDataAlignment - 1);
+        if (packedSize != PackedSize)
+        {
+            if (PackedData)
+            {
+                TMemory::Free(PackedData);
+            }
+            PackedData = packedSize > 0 ? static_cast<byte*>(TMemory::Malloc(packedSize, 16)) : nullptr;
+            PackedSize = packedSize;
+        }
+        if (PackedData)
+        {
+            // Members without a value in the map keep this zero default.
+            memset(PackedData, 0, PackedSize);
+        }
+
+        CopyOps.clear();
+        for (auto const& [paramName, memberEntry] : layout->GetMemberMap())
+        {
+            const byte* source = nullptr;
+            uint32 size = 0;
+            switch (memberEntry.Type)
+            {
+            case EUniformBufferMemberType::Int:
+                source = FindParameterValue(parameterMap->GetIntParameters(), paramName);
+                size = sizeof(int32);
+                break;
+            case EUniformBufferMemberType::Float:
+                source = FindParameterValue(parameterMap->GetFloatParameters(), paramName);
+                size = sizeof(float);
+                break;
+            case EUniformBufferMemberType::Float4:
+                source = FindParameterValue(parameterMap->GetVectorParameters(), paramName);
+                size = sizeof(TVector4f);
+                break;
+            default:
+                TAssertf(false, "Unsupported uniform buffer member type for parameter \"%s\".", paramName.c_str());
+                break;
+            }
+
+            if (!source)
+            {
+                continue;
+            }
+            if (size != memberEntry.Size || memberEntry.Offset + size > layout->GetTotalSize()) [[unlikely]]
+            {
+                TAssertf(false, "Parameter \"%s\" does not fit its member: offset %u, size %u, got %u.",
+                    paramName.c_str(), memberEntry.Offset, memberEntry.Size, size);
+                continue;
+            }
+            CopyOps.push_back({ source, memberEntry.Offset, size });
+        }
+
+        // Member map is ordered by name, write the buffer front to back instead.
+        std::ranges::sort(CopyOps, {}, &CopyOp::DestOffset);
+
+        Layout = layout;
+        ParameterMap = parameterMap;
+        LayoutVersion = layout->GetVersion();
+        ParameterMapVersion = parameterMap->GetStructureVersion();
+    }
+}
@@ -1,4 +1,5 @@
 ﻿#pragma once
+#include <atomic>
 #include "ShaderDefinition.h"
 #include "Concurrent/Lock.h"
 #include "Templates/RefCounting.h"
@@ -10,6 +11,7 @@ namespace Thunder
 {
 	enum class EMeshPass : uint8;
 	class ast_node;
+	class ast_arena;
 
 	struct SyncCompilingCombinationEntry
 	{
@@ -64,6 +66,12 @@ namespace Thunder
     	}
 
 		ShaderCombination* GetOrCompileShaderCombination(uint64 variantId);
+		// Never blocks: the combination when it's compiled, otherwise the variant is queued on the async workers and the
+		// fallback combination is returned, null until the fallback variant is compiled too. outIsFallback tells them apart.
+		ShaderCombination* GetOrRequestShaderCombination(uint64 variantId, EShaderCompilePriority priority, bool* outIsFallback = nullptr);
+		// Async worker side of a request, publishes the compiled variant to GetOrRequestShaderCombination.
+		// False when there was nothing new to publish.
+		bool CompileRequestedVariant(uint64 variantId);
 
     	bool CompileShader(NameHandle archiveName, const String& shaderSource, const String& includeStr, uint64 variantId);
     	ShaderCombination* CompileShaderVariant(uint64 variantId);
@@ -83,6 +91,10 @@ namespace Thunder
 		EShaderStencilState GetStencilState() const { return StencilState; }
 
     private:
+		void RequestVariant(uint64 variantId, EShaderCompilePriority priority);
+		ShaderCombination* FindPublishedVariant(uint64 variantId) const;
+		void PublishVariant(uint64 variantId, ShaderCombination* combination);
+
 		ShaderArchive* Archive = nullptr;
     	NameHandle Name;
 		TShaderRegisterCounts RegisterCounts{};
@@ -92,6 +104,21 @@ namespace Thunder
 		SharedLock SyncCompilingVariantsLock;
     	THashMap<uint64, SyncCompilingCombinationEntry*> SyncCompilingVariants;
 
+		// Compiled variants readable without locks: insert-only open addressing, published combinations are never removed.
+		// Variants that don't fit stay reachable through Variants.
+		static constexpr uint32 PublishedVariantSlotBits = 8;
+		static constexpr uint32 NumPublishedVariantSlots = 1u << PublishedVariantSlotBits;
+		static constexpr uint64 EmptyVariantSlot = ~0ull;
+		struct PublishedVariantSlot
+		{
+			std::atomic<uint64> VariantId { EmptyVariantSlot };
+			std::atomic<ShaderCombination*> Combination { nullptr };
+		};
+		PublishedVariantSlot PublishedVariants[NumPublishedVariantSlots];
+		std::atomic<uint64> FallbackVariantId { EmptyVariantSlot };
+		SpinLock RequestedVariantsLock;
+		THashMap<uint64, EShaderCompilePriority> RequestedVariants; // Highest priority each variant was queued with.
+
 		// Pass meta.
 		bool bMeshPass = false;
 		EMeshPass MeshPass = EMeshPass::Num;
@@ -103,17 +130,20 @@ namespace Thunder
 
 	struct ShaderAST
 	{
-		ShaderAST(ast_node* inRoot, TArray<ast_node*>&& inCustomTypes): ASTRoot(inRoot), CustomTypes(std::move(inCustomTypes)) {}
+		ShaderAST(ast_node* inRoot, ast_arena* inArena, TArray<ast_node*>&& inCustomTypes)
+			: ASTRoot(inRoot), Arena(inArena), CustomTypes(std::move(inCustomTypes)) {}
 		~ShaderAST();
 
 		// parse ast to obtain Property/Variant/Parameters
 		void Reflect(class ShaderArchive* archive) const;
-    	String GenerateShaderVariantSource(struct shader_codegen_state& state) const;
+    	// Appends to outSource, callers reuse one buffer across variants.
+    	void GenerateShaderVariantSource(struct shader_codegen_state& state, String& outSource) const;
 		String GetSubShaderEntry(String const& subShaderName, EShaderStageType stageType) const;
 		const TArray<ast_node*>& GetCustomTypes() const { return CustomTypes; }
 
 	private:
 		ast_node* ASTRoot = nullptr;
+		ast_arena* Arena = nullptr; // Owns ASTRoot and every node below it.
 		TArray<ast_node*> CustomTypes;
 	};
 
@@ -161,10 +191,12 @@ namespace Thunder
 		void CalcRegisterCounts(NameHandle passName, TShaderRegisterCounts& outCount);
 	    static void QuantizeRegisterCounts(TShaderRegisterCounts& outCount);
     	ShaderCombination* CompileShaderVariant(NameHandle subShaderName, uint64 variantId);
+    	void RequestFallbackVariants(); // Queues each pass's fallback variant, see ShaderPass::CacheDefaultShaderCache.
+    	uint64 GetDefaultVariantMask() const;
     	ShaderAST* GetAST() const { return AST; }
     	void SetAST(ShaderAST* ast) { AST = ast; AST->Reflect(this); }
 
-    	String GenerateShaderSource(ShaderCodeGenConfig const& config) const;
+    	void GenerateShaderSource(ShaderCodeGenConfig const& config, String& outSource) const;
     	String GetSubShaderEntry(String const& subShaderName, EShaderStageType stageType) const;
     	bool GenerateDefaultUBParameters(String const& ubName, struct ShaderParameterMap* shaderParameterMap);
     	void GenerateDefaultParameters(struct ShaderParameterMap* shaderParameterMap);
@@ -173,6 +205,8 @@ namespace Thunder
     	void VariantMaskToName(uint64 variantMask, THashMap<NameHandle, bool>& variantMap) const;
     	void BuildUniformBufferLayout();
     	void BuildBindingsLayout();
+    	// Hands the global, pass and primitive layouts to the shader module, the first archive defining each one wins.
+    	void RegisterModuleLayouts();
     	class ShaderBindingsLayout* GetBindingsLayout() const { return BindingsLayout.Get(); }
     	class UniformBufferLayout* GetUniformBufferLayout(NameHandle cbName);
 
@@ -88,6 +88,7 @@ namespace Thunder
         _NODISCARD_ class ShaderArchive* GetShader() const { return Shader; }
         _NODISCARD_ TMap<NameHandle, UniformBufferMemberEntry> const& GetMemberMap() const { return MemberMap; }
         _NODISCARD_ uint32 GetTotalSize() const { return TotalSize; }
+        _NODISCARD_ uint64 GetVersion() const { return Version; } // Unique per layout contents, changes with every member added.
 
         bool GetMemberEntry(NameHandle name, UniformBufferMemberEntry& outEntry) const
         {
@@ -100,22 +101,15 @@ namespace Thunder
             return false;
         }
 
-        void AddMember(NameHandle name, UniformBufferMemberEntry const& entry)
-        {
-            MemberMap[name] = entry;
-            TotalSize = std::max(TotalSize, entry.Offset + entry.Size);
-        }
-
-        void SetTotalSize(uint32 size)
-        {
-            TotalSize = size;
-        }
+        void AddMember(NameHandle name, UniformBufferMemberEntry const& entry);
+        void SetTotalSize(uint32 size);
 
     protected:
         // Parent.
         ShaderArchive* Shader = nullptr;
         TMap<NameHandle, UniformBufferMemberEntry> MemberMap;
         uint32 TotalSize = 0;
+        uint64 Version = 0;
     };
     using UniformBufferLayoutRef = TRefCountPtr<UniformBufferLayout>;
 }
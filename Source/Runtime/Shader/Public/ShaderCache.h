@@ -0,0 +1,65 @@
+#pragma once
+#include <atomic>
+#include "ShaderDefinition.h"
+#include "Concurrent/Lock.h"
+
+namespace Thunder
+{
+    class ICompiler;
+
+    /**
+     * Persistent cache of shader byte code: one file per entry in a directory, plus a compact index of their sizes and
+     * last use that is written on shutdown. Entries are keyed by a 128-bit hash of everything that determines the byte
+     * code (generated source, entry point, stage, variant mask, compiler identity and flags), validated when read, and
+     * evicted least recently used first once the cache grows past its size cap.
+     * Thread-safe, the index lock is never held across file IO.
+     */
+    class SHADER_API ShaderCache : public RefCountedObject
+    {
+    public:
+        ShaderCache(const String& inDirectory, uint64 inMaxSize);
+        ~ShaderCache() override;
+
+        static ShaderBytecodeHash MakeKey(const String& source, const String& entryPoint, EShaderStageType stage, uint64 variantMask,
+            const String& compilerIdentity, bool debug);
+
+        // Loads the byte code from the cache, or compiles it and stores the result. The byte code is a TMemory allocation either way.
+        void GetOrCompile(ICompiler* compiler, const String& source, const String& entryPoint, EShaderStageType stage, uint64 variantMask,
+            BinaryData& outByteCode, bool debug);
+
+        bool Load(const ShaderBytecodeHash& key, BinaryData& outByteCode);
+        void Store(const ShaderBytecodeHash& key, const BinaryData& byteCode);
+        void SaveIndex();
+
+        _NODISCARD_ uint64 GetTotalSize() const;
+        _NODISCARD_ uint32 GetNumEntries() const;
+        _NODISCARD_ uint64 GetNumHits() const { return NumHits.load(std::memory_order_relaxed); }
+        _NODISCARD_ uint64 GetNumMisses() const { return NumMisses.load(std::memory_order_relaxed); }
+
+    private:
+        struct Entry
+        {
+            uint64 KeyHigh; // Hash[1] of the key, the map is keyed by Hash[0].
+            uint64 Size;    // Byte code size, without the entry header.
+            uint64 LastUse;
+        };
+
+        String GetEntryPath(uint64 keyLow, uint64 keyHigh) const;
+        bool LoadIndex();
+        void ScanDirectory();
+        void RemoveEntry(const ShaderBytecodeHash& key);
+        void Evict();
+
+        String Directory;
+        uint64 MaxSize = 0;
+
+        mutable SpinLock IndexLock;
+        THashMap<uint64, Entry> Entries;
+        uint64 TotalSize = 0;
+        uint64 UseClock = 0;
+
+        std::atomic<uint64> NumHits { 0 };
+        std::atomic<uint64> NumMisses { 0 };
+    };
+    using ShaderCacheRef = TRefCountPtr<ShaderCache>;
+}
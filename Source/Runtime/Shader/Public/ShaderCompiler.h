@@ -19,6 +19,8 @@ namespace Thunder
     		const String& includeStr, const String& pEntryPoint, const String& pTarget, BinaryData& outByteCode) = 0; // Deprecated.
 
 		SHADER_API virtual void Compile(const String& inSource, const String& entryPoint, EShaderStageType stage, BinaryData& outByteCode, bool debug = false) = 0;
+		// Compiler and version, part of the shader cache key.
+		SHADER_API virtual String GetIdentity() const = 0;
     };
     
     class FXCCompiler : public ICompiler
@@ -29,6 +31,7 @@ namespace Thunder
     		const String& includeStr, const String& pEntryPoint, const String& pTarget, BinaryData& outByteCode) override; // Deprecated.
 
     	SHADER_API void Compile(const String& inSource, const String& entryPoint, EShaderStageType stage, BinaryData& outByteCode, bool debug = false) override {}
+    	SHADER_API String GetIdentity() const override;
     };
     
     class DXCCompiler : public ICompiler
@@ -39,8 +42,21 @@ namespace Thunder
     		const String& includeStr, const String& pEntryPoint, const String& pTarget, BinaryData& outByteCode) override; // Deprecated.
 
     	SHADER_API void Compile(const String& inSource, const String& entryPoint, EShaderStageType stage, BinaryData& outByteCode, bool debug = false) override;
+    	SHADER_API String GetIdentity() const override { return Identity; }
     private:
         ComPtr<IDxcUtils> ShaderUtils;
         ComPtr<IDxcCompiler> ShaderCompiler;
+        String Identity = "DXC";
+    };
+
+    // For the null RHI, which never runs shaders: the generated source stands in for the byte code.
+    class NullCompiler : public ICompiler
+    {
+    public:
+    	SHADER_API void Compile(NameHandle archiveName, const String& inSource, SIZE_T srcDataSize, const THashMap<NameHandle, bool>& marco,
+    		const String& includeStr, const String& pEntryPoint, const String& pTarget, BinaryData& outByteCode) override; // Deprecated.
+
+    	SHADER_API void Compile(const String& inSource, const String& entryPoint, EShaderStageType stage, BinaryData& outByteCode, bool debug = false) override;
+    	SHADER_API String GetIdentity() const override { return "Null"; }
     };
 }
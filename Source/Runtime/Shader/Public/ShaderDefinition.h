@@ -27,6 +27,13 @@ namespace Thunder
 		Num
     };
 
+	enum class EShaderCompilePriority : uint8
+	{
+		Visible = 0, // Drawn this frame.
+		Prewarm,     // Expected to be drawn soon.
+		Num
+	};
+
     struct StageMeta
     {
     	String EntryPoint;
@@ -1,6 +1,7 @@
 #pragma once
 #include "ShaderDefinition.h"
 #include "Module/ModuleManager.h"
+#include "ShaderCache.h"
 #include "ShaderCompiler.h"
 #include "ShaderLang.h"
 #include "RenderStates.h"
@@ -32,12 +33,17 @@ namespace Thunder
     	SHADER_API void ShutDown() override;
     	SHADER_API void InitShaderCompiler(EGfxApiType type);
     	SHADER_API static void InitShaderMap();
+    	// Preprocesses, parses and reflects one .tsf, safe to call concurrently. Null when the file fails to parse.
+    	SHADER_API static ShaderArchive* LoadShaderArchive(const String& path);
 
     	// Shader
     	SHADER_API static ShaderArchive* GetShaderArchive(NameHandle name);
     	SHADER_API static uint64 GetVariantMask(ShaderArchive* archive, const TMap<NameHandle, bool>& parameters);
-    	SHADER_API static ShaderCombination* GetShaderCombination(ShaderArchive* archive, EMeshPass meshPassType, uint64 variantMask);
+    	// outIsFallback is set when the pass's fallback combination stands in for a variant that is still compiling.
+    	SHADER_API static ShaderCombination* GetShaderCombination(ShaderArchive* archive, EMeshPass meshPassType, uint64 variantMask, bool* outIsFallback = nullptr);
     	SHADER_API static ShaderCombination* GetShaderCombination(ShaderArchive* archive, NameHandle subShaderName, uint64 variantMask);
+    	// Queues the variant behind everything that is visible, so it is likely compiled by the time it is drawn.
+    	SHADER_API static void PrewarmShaderCombination(ShaderArchive* archive, EMeshPass meshPassType, uint64 variantMask);
 	    SHADER_API static bool GetPassRegisterCounts(ShaderArchive* archive, EMeshPass meshPassType, TShaderRegisterCounts& outRegisterCounts);
 	    SHADER_API static bool GetPassRegisterCounts(ShaderArchive* archive, NameHandle subShaderName, TShaderRegisterCounts& outRegisterCounts);
 		SHADER_API static TRHIPipelineState* GetPSO(uint64 psoKey);
@@ -47,7 +53,18 @@ namespace Thunder
     	SHADER_API bool CompileShaderCollection(NameHandle shaderType, NameHandle passName, const THashMap<NameHandle, bool>& variantParameters, bool force = false);
     	SHADER_API bool CompileShaderCollection(NameHandle shaderType, NameHandle passName, uint64 variantId, bool force = false);
 	    SHADER_API static ShaderCombination* CompileShaderVariant(NameHandle archiveName, NameHandle passName, uint64 variantId);
-    	SHADER_API static void CompileShaderSource(const String& inSource, const String& entryPoint, EShaderStageType stage, BinaryData& outByteCode, bool debug = false);
+    	// Goes through the byte code cache when there is one.
+    	SHADER_API static void CompileShaderSource(const String& inSource, const String& entryPoint, EShaderStageType stage, uint64 variantMask, BinaryData& outByteCode, bool debug = false);
+    	SHADER_API static ShaderCache* GetShaderCache() { return GetModule()->BytecodeCache.Get(); }
+    	// When on, GetShaderCombination never blocks on the compiler: missing variants compile on the async workers and the
+    	// pass's fallback combination (or null) stands in until they are done.
+    	SHADER_API static bool IsAsyncCompilationEnabled() { return GetModule()->bAsyncCompilation; }
+    	SHADER_API static void QueueVariantCompile(class ShaderPass* pass, uint64 variantId, EShaderCompilePriority priority);
+    	// Drops the queued variant compiles and waits for the running ones, later requests are ignored. Must be called
+    	// while the async workers are still alive.
+    	SHADER_API static void FlushVariantCompiles() { GetModule()->DrainVariantCompiles(); }
+    	// Bumped every time an async compile publishes a variant, results built with a fallback are rebuilt when it changes.
+    	SHADER_API static uint64 GetPublishedVariantEpoch() { return GetModule()->PublishedVariantEpoch.load(std::memory_order_acquire); }
 
     	// Translators.
 	    SHADER_API static enum_shader_stage GetShaderASTStage(EShaderStageType stage);
@@ -69,8 +86,26 @@ namespace Thunder
     	SHADER_API static ShaderParameterMap* GetPassDefaultParameters(EMeshPass pass);
 
     private:
+    	void PumpVariantCompiles();
+    	void DrainVariantCompiles();
+
     	THashMap<NameHandle, ShaderArchive*> ShaderMap;
     	TRefCountPtr<ICompiler> ShaderCompiler;
+    	ShaderCacheRef BytecodeCache;
+
+    	// Async variant compilation, visible requests are always started before prewarm ones.
+    	struct VariantCompileRequest
+    	{
+    		class ShaderPass* Pass;
+    		uint64 VariantId;
+    	};
+    	bool bAsyncCompilation = false;
+    	bool bVariantCompilesDrained = false; // Guarded by VariantCompileLock.
+    	SpinLock VariantCompileLock;
+    	TDeque<VariantCompileRequest> VariantCompileQueues[static_cast<uint8>(EShaderCompilePriority::Num)];
+    	uint32 NumRunningVariantCompiles = 0;
+    	uint32 MaxRunningVariantCompiles = 2; // Leaves async workers for other tasks.
+    	std::atomic<uint64> PublishedVariantEpoch { 0 };
     	THashMap<uint64, TRHIPipelineState*> PSOMap;
 
     	// uniform buffer manager
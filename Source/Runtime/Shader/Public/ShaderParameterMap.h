@@ -7,15 +7,9 @@ namespace Thunder
 {
 	struct SHADER_API ShaderParameterMap
 	{
-		TMap<NameHandle, int32> IntParameters;
-		TMap<NameHandle, float> FloatParameters;
-		TMap<NameHandle, TVector4f> VectorParameters;
-		TMap<NameHandle, TGuid> TextureParameters;
-		TMap<NameHandle, bool> StaticSwitchParameters;
-
-		ShaderParameterMap() = default;
+		ShaderParameterMap() : StructureVersion(NewStructureVersion()) {}
 
-		ShaderParameterMap(const ShaderParameterMap& other)
+		ShaderParameterMap(const ShaderParameterMap& other) : StructureVersion(NewStructureVersion())
 		{
 			if (this == &other)
 			{
@@ -28,7 +22,7 @@ namespace Thunder
 			StaticSwitchParameters = other.StaticSwitchParameters;
 		}
 
-		ShaderParameterMap(ShaderParameterMap&& other) noexcept
+		ShaderParameterMap(ShaderParameterMap&& other) noexcept : StructureVersion(NewStructureVersion())
 		{
 			if (this == &other)
 			{
@@ -39,20 +33,11 @@ namespace Thunder
 			VectorParameters = std::move(other.VectorParameters);
 			TextureParameters = std::move(other.TextureParameters);
 			StaticSwitchParameters = std::move(other.StaticSwitchParameters);
+			other.MarkStructureChanged();
 		}
 
-		ShaderParameterMap& operator=(const ShaderParameterMap& other)
-		{
-			if (this != &other)
-			{
-				IntParameters = other.IntParameters;
-				FloatParameters = other.FloatParameters;
-				VectorParameters = other.VectorParameters;
-				TextureParameters = other.TextureParameters;
-				StaticSwitchParameters = other.StaticSwitchParameters;
-			}
-			return *this;
-		}
+		// Keeps the structure version when other holds the same parameters, only the values are copied then.
+		ShaderParameterMap& operator=(const ShaderParameterMap& other);
 
 		ShaderParameterMap& operator=(ShaderParameterMap&& other) noexcept
 		{
@@ -65,6 +50,8 @@ namespace Thunder
 			VectorParameters = std::move(other.VectorParameters);
 			TextureParameters = std::move(other.TextureParameters);
 			StaticSwitchParameters = std::move(other.StaticSwitchParameters);
+			MarkStructureChanged();
+			other.MarkStructureChanged();
 			return *this;
 		}
 
@@ -77,6 +64,13 @@ namespace Thunder
 		void SetTextureParameter(const NameHandle& paramName, uint32 textureId);
 		void SetStaticSwitchParameter(const NameHandle& paramName, bool value);
 
+		// Defaults only add missing parameters, values already set are kept.
+		void AddDefaultIntParameter(const NameHandle& paramName, int32 value);
+		void AddDefaultFloatParameter(const NameHandle& paramName, float value);
+		void AddDefaultVectorParameter(const NameHandle& paramName, const TVector4f& value);
+		void AddDefaultTextureParameter(const NameHandle& paramName, const TGuid& textureGuid);
+		void AddDefaultStaticSwitchParameter(const NameHandle& paramName, bool value);
+
 		bool GetIntParameter(const NameHandle& paramName, int32& outValue) const;
 		bool GetFloatParameter(const NameHandle& paramName, float& outValue) const;
 		bool GetVectorParameter(const NameHandle& paramName, TVector4f& outValue) const;
@@ -88,6 +82,30 @@ namespace Thunder
 		void RemoveVectorParameter(const NameHandle& paramName);
 		void RemoveTextureParameter(const NameHandle& paramName);
 		void RemoveStaticSwitchParameter(const NameHandle& paramName);
+
+		const TMap<NameHandle, int32>& GetIntParameters() const { return IntParameters; }
+		const TMap<NameHandle, float>& GetFloatParameters() const { return FloatParameters; }
+		const TMap<NameHandle, TVector4f>& GetVectorParameters() const { return VectorParameters; }
+		const TMap<NameHandle, TGuid>& GetTextureParameters() const { return TextureParameters; }
+		const TMap<NameHandle, bool>& GetStaticSwitchParameters() const { return StaticSwitchParameters; }
+
+		/**
+		 * Changes whenever parameters are added or removed or the maps are reassigned, i.e. whenever pointers to values may dangle.
+		 * Value updates keep it. Unique across maps, so a new map at a recycled address never matches an old version.
+		 */
+		uint64 GetStructureVersion() const { return StructureVersion; }
+
+	private:
+		static uint64 NewStructureVersion();
+		void MarkStructureChanged() { StructureVersion = NewStructureVersion(); }
+
+		TMap<NameHandle, int32> IntParameters;
+		TMap<NameHandle, float> FloatParameters;
+		TMap<NameHandle, TVector4f> VectorParameters;
+		TMap<NameHandle, TGuid> TextureParameters;
+		TMap<NameHandle, bool> StaticSwitchParameters;
+
+		uint64 StructureVersion;
 	};
 }
 
@@ -0,0 +1,48 @@
+#pragma once
+#include "ShaderBindingsLayout.h"
+#include "ShaderParameterMap.h"
+
+namespace Thunder
+{
+    /**
+     * Packs a parameter map into a uniform buffer layout through a flat copy list, compiled once per (layout, map structure).
+     * The copies read straight from the map's value nodes, so a pack does no name lookups, only a compare and copy per member.
+     * The packed data persists between packs and is padded to 256 bytes, the size the RHI copies out of it.
+     * Not thread-safe, each owner of a uniform buffer keeps its own program.
+     */
+    class SHADER_API UniformBufferPackingProgram
+    {
+    public:
+        UniformBufferPackingProgram() = default;
+        ~UniformBufferPackingProgram();
+        UniformBufferPackingProgram(const UniformBufferPackingProgram&) = delete;
+        UniformBufferPackingProgram& operator=(const UniformBufferPackingProgram&) = delete;
+
+        // Returns true when the packed data changed since the previous pack, always after a (re)compile.
+        bool Pack(const UniformBufferLayout* layout, const ShaderParameterMap* parameterMap);
+        void Invalidate(); // The next pack recompiles, e.g. when the uniform buffer it fed was recreated.
+
+        _NODISCARD_ const byte* GetData() const { return PackedData; }
+        _NODISCARD_ uint32 GetNumCopies() const { return static_cast<uint32>(CopyOps.size()); }
+
+    private:
+        struct CopyOp
+        {
+            const byte* Source;
+            uint32 DestOffset;
+            uint32 Size;
+        };
+
+        void Compile(const UniformBufferLayout* layout, const ShaderParameterMap* parameterMap);
+
+        TArray<CopyOp> CopyOps;
+        byte* PackedData = nullptr;
+        uint32 PackedSize = 0;
+
+        // What the copy list was compiled against.
+        const UniformBufferLayout* Layout = nullptr;
+        const ShaderParameterMap* ParameterMap = nullptr;
+        uint64 LayoutVersion = 0;
+        uint64 ParameterMapVersion = 0;
+    };
+}
@@ -0,0 +1,40 @@
+#include "AstArena.h"
+#include <algorithm>
+#include "Memory/MemoryBase.h"
+
+namespace Thunder
+{
+    ast_arena::~ast_arena()
+    {
+        for (destructor_entry* entry = destructors; entry; entry = entry->next)
+        {
+            entry->destroy(entry->object);
+        }
+        while (blocks)
+        {
+            block* next = blocks->next;
+            TMemory::Free(blocks);
+            blocks = next;
+        }
+    }
+
+    void* ast_arena::allocate(size_t size, size_t alignment)
+    {
+        uint8* aligned = reinterpret_cast<uint8*>((reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1));
+        if (!cursor || aligned + size > end) [[unlikely]]
+        {
+            // Blocks grow to fit oversized requests.
+            const size_t usable_size = std::max(block_size, size + alignment);
+            auto* new_block = static_cast<block*>(TMemory::Malloc(sizeof(block) + usable_size, alignof(std::max_align_t)));
+            new_block->next = blocks;
+            new_block->size = usable_size;
+            blocks = new_block;
+            cursor = reinterpret_cast<uint8*>(new_block + 1);
+            end = cursor + usable_size;
+            aligned = reinterpret_cast<uint8*>((reinterpret_cast<uintptr_t>(cursor) + alignment - 1) & ~(alignment - 1));
+        }
+        cursor = aligned + size;
+        allocated_bytes += size;
+        return aligned;
+    }
+}
@@ -7,8 +7,6 @@
 
 namespace Thunder
 {
-    shader_lang_state* sl_state = nullptr;
-
     static void print_blank(int indent) {
         for (int i = 0; i < indent; i++) printf("  ");
     }
@@ -211,10 +209,12 @@ namespace Thunder
     void ast_node_variable::generate_hlsl(String& outResult, shader_codegen_state& state)
     {
         type->generate_hlsl(outResult, state);
-        outResult += " " + name;
+        outResult += ' ';
+        outResult += name;
         if (type->is_semantic)
         {
-            outResult += " : " + semantic;
+            outResult += " : ";
+            outResult += semantic;
         }
     }
 
@@ -246,6 +246,36 @@ namespace Thunder
             TAssertf(false, "Empty subshader.");
             return;
         }
+
+        {
+            auto lock = codegen_lock.Read();
+            auto cache_it = codegen_caches.find(state.sub_shader_name);
+            if (cache_it != codegen_caches.end())
+            {
+                const codegen_cache& cache = cache_it->second;
+                outResult.reserve(outResult.size() + cache.output_size);
+                for (const codegen_segment& segment : cache.segments)
+                {
+                    outResult += segment.text;
+                    if (segment.function)
+                    {
+                        segment.function->generate_hlsl(outResult, state);
+                    }
+                }
+                return;
+            }
+        }
+
+        codegen_cache cache;
+        generate_sub_shader(outResult, state, cache);
+        auto lock = codegen_lock.Write();
+        codegen_caches.try_emplace(state.sub_shader_name, std::move(cache));
+    }
+
+    void ast_node_archive::generate_sub_shader(String& outResult, shader_codegen_state& state, codegen_cache& cache)
+    {
+        const size_t output_begin = outResult.size();
+        size_t segment_begin = output_begin;
         TArray<ast_node_variable*> objects;
         for (auto const& uniform_buffer_entry : uniform_buffer_parameters)
         {
@@ -258,16 +288,20 @@ namespace Thunder
                 continue;
             }
             uint16 const buffer_index = uniform_buffer_definition_it->second.index;
+            outResult += "cbuffer cb";
             if (buffer_name == "Pass")
             {
-                outResult += "cbuffer cb" + state.sub_shader_name.ToString() + " : register(b" + std::to_string(buffer_index) + ", space0)\n{\n";
+                outResult += state.sub_shader_name.c_str();
                 buffer_parameters = pass_cb_parameters.at(state.sub_shader_name.ToString());
             }
             else
             {
-                outResult += "cbuffer cb" + buffer_name + " : register(b" + std::to_string(buffer_index) + ", space0)\n{\n";
+                outResult += buffer_name;
                 buffer_parameters = uniform_buffer_entry.second;
             }
+            outResult += " : register(b";
+            outResult += std::to_string(buffer_index);
+            outResult += ", space0)\n{\n";
             for (auto const& parameter : buffer_parameters)
             {
                 if (parameter->type->is_object())
@@ -285,33 +319,64 @@ namespace Thunder
         for (const auto& obj : objects)
         {
             obj->type->generate_hlsl(outResult, state);
-            outResult += " " + obj->name + " : register(t" + std::to_string(object_index++) + ");\n";
+            outResult += ' ';
+            outResult += obj->name;
+            outResult += " : register(t";
+            outResult += std::to_string(object_index++);
+            outResult += ");\n";
         }
 
         // custom sampler
         for (size_t i = 0; i < sampler_parameters.size(); i++)
         {
-            outResult += "SamplerState " + sampler_parameters[i]->name + " : register(s" + std::to_string(i) + ", space0);\n";
+            outResult += "SamplerState ";
+            outResult += sampler_parameters[i]->name;
+            outResult += " : register(s";
+            outResult += std::to_string(i);
+            outResult += ", space0);\n";
         }
         // static sampler
         for (size_t i = 0; i < GStaticSamplerNames.size(); i++)
         {
-            outResult += "SamplerState " + GStaticSamplerNames[i].ToString() + " : register(s" + std::to_string(i) + ", space1000);\n";
+            outResult += "SamplerState ";
+            outResult += GStaticSamplerNames[i].c_str();
+            outResult += " : register(s";
+            outResult += std::to_string(i);
+            outResult += ", space1000);\n";
         }
 
         outResult += "\n";
 
+        // Same output as ast_node_pass::generate_hlsl, cut around the functions that read variants.
         bool find_valid_pass = false;
         for (const auto pass : passes)
         {
             if (pass->get_name() == state.sub_shader_name.ToString())
             {
                 find_valid_pass = true;
-                pass->generate_hlsl(outResult, state);
+                for (const auto& def : pass->structures)
+                {
+                    def->generate_hlsl(outResult, state);
+                    outResult += "\n";
+                }
+                for (const auto& def : pass->functions)
+                {
+                    const size_t function_begin = outResult.size();
+                    const uint32 variant_reads = state.variant_reads;
+                    def->generate_hlsl(outResult, state);
+                    if (state.variant_reads != variant_reads)
+                    {
+                        cache.segments.push_back({ outResult.substr(segment_begin, function_begin - segment_begin), def });
+                        segment_begin = outResult.size();
+                    }
+                    outResult += "\n";
+                }
                 outResult += "\n";
             }
         }
         TAssertf(find_valid_pass, "Unknown subshader name : \"%s\".", state.sub_shader_name);
+        cache.segments.push_back({ outResult.substr(segment_begin), nullptr });
+        cache.output_size = outResult.size() - output_begin;
     }
 
     void ast_node_pass::generate_hlsl(String& outResult, shader_codegen_state& state)
@@ -330,7 +395,9 @@ namespace Thunder
     
     void ast_node_struct::generate_hlsl(String& outResult, shader_codegen_state& state)
     {
-        outResult += "struct " + name + " {\n";
+        outResult += "struct ";
+        outResult += name;
+        outResult += " {\n";
         for (const auto& member : members)
         {
             member->generate_hlsl(outResult, state);
@@ -341,32 +408,28 @@ namespace Thunder
 
     void ast_node_function::generate_hlsl(std::string& outResult, shader_codegen_state& state)
     {
-        String paramList;
-        for (const auto& param : params)
+        return_type->generate_hlsl(outResult, state);
+        outResult += ' ';
+        outResult += func_name.c_str();
+        outResult += '(';
+        for (size_t index = 0; index < params.size(); ++index)
         {
-            if (!paramList.empty())
+            if (index > 0)
             {
-                paramList += ", ";
+                outResult += ", ";
             }
-            param->generate_hlsl(paramList, state);
+            params[index]->generate_hlsl(outResult, state);
         }
-
-        String funcSignature;
-        return_type->generate_hlsl(funcSignature, state);
-        funcSignature += " " + func_name.ToString() + "(" + paramList + ")";
+        outResult += ')';
 
         if (!semantic.empty())
         {
-            funcSignature += " : " + semantic + "\n";
+            outResult += " : ";
+            outResult += semantic;
         }
-        else
-        {
-            funcSignature += "\n";
-        }
-
-        String funcBody;
-        body->generate_hlsl(funcBody, state);
-        outResult += funcSignature + "{\n" + funcBody + "}\n";
+        outResult += "\n{\n";
+        body->generate_hlsl(outResult, state);
+        outResult += "}\n";
     }
 
     void ast_node_block::generate_hlsl(String& outResult, shader_codegen_state& state)
@@ -579,7 +642,8 @@ namespace Thunder
 
     void constant_float_expression::generate_hlsl(String& outResult, shader_codegen_state& state)
     {
-        outResult += std::to_string(value) + "f";
+        outResult += std::to_string(value);
+        outResult += 'f';
     }
 
     void constant_bool_expression::generate_hlsl(String& outResult, shader_codegen_state& state)
@@ -592,14 +656,13 @@ namespace Thunder
         outResult += "for (";
         if (init_stmt)
         {
-            String init_str;
-            init_stmt->generate_hlsl(init_str, state);
+            const size_t init_begin = outResult.size();
+            init_stmt->generate_hlsl(outResult, state);
             // Remove trailing semicolon and newline from init statement
-            if (!init_str.empty() && init_str.back() == '\n')
-                init_str.pop_back();
-            if (!init_str.empty() && init_str.back() == ';')
-                init_str.pop_back();
-            outResult += init_str;
+            if (outResult.size() > init_begin && outResult.back() == '\n')
+                outResult.pop_back();
+            if (outResult.size() > init_begin && outResult.back() == ';')
+                outResult.pop_back();
         }
         outResult += "; ";
         
@@ -624,17 +687,17 @@ namespace Thunder
 
     void function_call_expression::generate_hlsl(String& outResult, shader_codegen_state& state)
     {
-        outResult += function_name + "(";
-        String arguments_string;
+        outResult += function_name;
+        outResult += '(';
+        const size_t arguments_begin = outResult.size();
         for (const auto argument : arguments)
         {
-            if (arguments_string.length() > 0)
+            if (outResult.size() > arguments_begin)
             {
-                arguments_string += ", ";
+                outResult += ", ";
             }
-            argument->generate_hlsl(arguments_string, state);
+            argument->generate_hlsl(outResult, state);
         }
-        outResult += arguments_string;
         outResult += ")";
     }
 
@@ -652,16 +715,15 @@ namespace Thunder
             constructor_type->generate_hlsl(outResult, state);
         }
         outResult += "(";
-        String arguments_string;
+        const size_t arguments_begin = outResult.size();
         for (const auto argument : arguments)
         {
-            if (arguments_string.length() > 0)
+            if (outResult.size() > arguments_begin)
             {
-                arguments_string += ", ";
+                outResult += ", ";
             }
-            argument->generate_hlsl(arguments_string, state);
+            argument->generate_hlsl(outResult, state);
         }
-        outResult += arguments_string;
         outResult += ")";
     }
 
@@ -1881,6 +1943,7 @@ namespace Thunder
             auto variant_it = state.variants.find(variable_name);
             if (variant_it != state.variants.end())
             {
+                ++state.variant_reads;
                 return { variant_it->second };
             }
         }
@@ -2139,10 +2202,10 @@ namespace Thunder
         return String(text);
     }
 
-    int tokenize(token_data& t, const parse_location* loc, const char* text, int text_len, int token)
+    int tokenize(shader_lang_state* state, token_data& t, const parse_location* loc, const char* text, int text_len, int token)
     {
-        sl_state->current_text = text;
-        memcpy(sl_state->current_location, loc, sizeof(parse_location));
+        state->current_text = text;
+        memcpy(state->current_location, loc, sizeof(parse_location));
         
         t.first_line = loc->first_line;
         t.first_column = loc->first_column;
@@ -2155,12 +2218,12 @@ namespace Thunder
         {
         case TOKEN_IDENTIFIER:
             {
-                if (sl_state->is_key_identifier(text))
+                if (state->is_key_identifier(text))
                 {
                     token = KEY_ID;
                     break;
                 }
-                const ast_node* symbol_node = sl_state->get_global_symbol(text);
+                const ast_node* symbol_node = state->get_global_symbol(text);
                 if(symbol_node == nullptr)
                 {
                     token = NEW_ID;
@@ -2168,7 +2231,7 @@ namespace Thunder
                 else if (symbol_node->node_type == enum_ast_node_type::type_format ||
                     symbol_node->node_type == enum_ast_node_type::structure)
                 {
-                    sl_state->output_parse_log("TYPE_ID : " + sl_state->current_text, loc);
+                    state->output_parse_log("TYPE_ID : " + state->current_text, loc);
                     token = TYPE_ID;
                 }
                 break;
@@ -2,15 +2,31 @@
 #define TCPP_IMPLEMENTATION
 #include "Assertion.h"
 #include "TcppLibrary.h"
-#include <fstream>
-#include <sstream>
-#include <filesystem>
 #include "CoreModule.h"
+#include "ShaderIncludeCache.h"
 #include "FileSystem/FileModule.h"
 
 namespace Thunder
 {
 	using namespace tcpp;
+
+	namespace
+	{
+		// Feeds the lexer the lines of a cached header, nothing is read or split again.
+		class ShaderIncludeInputStream : public IInputStream
+		{
+		public:
+			explicit ShaderIncludeInputStream(ShaderIncludeFileRef inFile) : File(std::move(inFile)) {}
+
+			std::string ReadLine() TCPP_NOEXCEPT override { return File->Lines[NextLine++]; }
+			bool HasNextLine() const TCPP_NOEXCEPT override { return NextLine < File->Lines.size(); }
+
+		private:
+			ShaderIncludeFileRef File;
+			size_t NextLine = 0;
+		};
+	}
+
 	String PreProcessor::Process(const String& input)
 	{
 		Lexer lexer(std::make_unique<StringInputStream>(input));
@@ -22,13 +38,13 @@ namespace Thunder
 			TAssert(false);
 		}, [](const std::string& path, bool isSystem)
 		{
-			String shaderRoot = FileModule::GetEngineShaderRoot();
-			
-			std::ifstream file(shaderRoot + path);
-			std::stringstream buffer;
-			buffer << file.rdbuf();
-			std::string raw_text = buffer.str();
-			return std::make_unique<StringInputStream>(raw_text);
+			ShaderIncludeFileRef file = ShaderIncludeCache::Get().Find(FileModule::GetEngineShaderRoot() + path);
+			if (!file.IsValid()) [[unlikely]]
+			{
+				TAssertf(false, "Failed to read shader include \"%s\".", path.c_str());
+				return TInputStreamUniquePtr(std::make_unique<StringInputStream>(""));
+			}
+			return TInputStreamUniquePtr(std::make_unique<ShaderIncludeInputStream>(std::move(file)));
 		},
 		true });
 
@@ -0,0 +1,63 @@
+﻿#include "ShaderIncludeCache.h"
+#include "FileSystem/FileModule.h"
+
+namespace Thunder
+{
+	ShaderIncludeCache& ShaderIncludeCache::Get()
+	{
+		static ShaderIncludeCache Singleton;
+		return Singleton;
+	}
+
+	ShaderIncludeFileRef ShaderIncludeCache::Find(const String& path)
+	{
+		const String key = std::filesystem::path(path).lexically_normal().string();
+		std::error_code error;
+		const auto modifiedTime = std::filesystem::last_write_time(key, error);
+		if (error)
+		{
+			return nullptr;
+		}
+
+		{
+			auto lock = FilesLock.Read();
+			auto fileIt = Files.find(key);
+			if (fileIt != Files.end() && fileIt->second->ModifiedTime == modifiedTime)
+			{
+				NumHits.fetch_add(1, std::memory_order_relaxed);
+				return fileIt->second;
+			}
+		}
+
+		NumMisses.fetch_add(1, std::memory_order_relaxed);
+		ShaderIncludeFileRef file = MakeRefCount<ShaderIncludeFile>();
+		file->Path = key;
+		file->ModifiedTime = modifiedTime;
+		if (!FileModule::LoadFileToString(key, file->Contents))
+		{
+			return nullptr;
+		}
+		for (size_t lineBegin = 0; lineBegin < file->Contents.size();)
+		{
+			const size_t lineEnd = file->Contents.find('\n', lineBegin);
+			const size_t nextLine = lineEnd == String::npos ? file->Contents.size() : lineEnd + 1;
+			file->Lines.emplace_back(file->Contents, lineBegin, nextLine - lineBegin);
+			lineBegin = nextLine;
+		}
+
+		// Two threads missing on the same file both read it, the newest version wins.
+		auto lock = FilesLock.Write();
+		ShaderIncludeFileRef& cached = Files[key];
+		if (!cached.IsValid() || cached->ModifiedTime <= modifiedTime)
+		{
+			cached = file;
+		}
+		return file;
+	}
+
+	void ShaderIncludeCache::Clear()
+	{
+		auto lock = FilesLock.Write();
+		Files.clear();
+	}
+}
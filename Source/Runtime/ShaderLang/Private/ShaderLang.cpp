@@ -39,6 +39,7 @@ namespace Thunder
 	shader_lang_state::shader_lang_state()
 	{
 		current_location = new parse_location(0, 0, 0, 0, 0, 0);
+		arena = new ast_arena();
 	}
 
 	shader_lang_state::~shader_lang_state()
@@ -48,6 +49,15 @@ namespace Thunder
 			delete current_location;
 			current_location = nullptr;
 		}
+		delete arena;
+		arena = nullptr;
+	}
+
+	ast_arena* shader_lang_state::release_arena()
+	{
+		ast_arena* released = arena;
+		arena = new ast_arena();
+		return released;
 	}
 
 	void shader_lang_state::reset()
@@ -144,7 +154,7 @@ namespace Thunder
 	void shader_lang_state::parsing_archive_begin(const token_data& name)
 	{
 		shader_name = name.text;
-		current_archive = new ast_node_archive(name.text);
+		current_archive = arena->create<ast_node_archive>(name.text);
 		push_scope(current_archive->begin_archive());
 	}
 
@@ -168,7 +178,7 @@ namespace Thunder
 			return;
 		}
 
-		const auto variable = new ast_node_variable(type, name.text);
+		const auto variable = arena->create<ast_node_variable>(type, name.text);
 		
 		if (default_value != nullptr)
 		{
@@ -248,7 +258,7 @@ namespace Thunder
 	void shader_lang_state::parsing_pass_begin(const token_data& name)
 	{
 		TAssert(current_pass == nullptr);
-		current_pass = new ast_node_pass(name.text);
+		current_pass = arena->create<ast_node_pass>(name.text);
 		current_attributes = shader_attributes(); // reset
 	}
 
@@ -350,12 +360,12 @@ namespace Thunder
 	{
 		TAssert(current_structure == nullptr);
 		TAssert(name.token_id == NEW_ID);
-		const auto type = new ast_node_type_format();
+		const auto type = arena->create<ast_node_type_format>();
 		type->basic_type = enum_basic_type::tp_struct;
 		//type->type_text = name.text;
 		type->indirect_index = static_cast<uint16>(custom_types.size());
 
-		current_structure = new ast_node_struct(type, name.text);
+		current_structure = arena->create<ast_node_struct>(type, name.text);
 		custom_types.push_back(current_structure);
 		current_scope()->push_symbol(name.text, enum_symbol_type::structure, current_structure);
 		push_scope(current_structure->begin_structure(current_scope()));
@@ -373,7 +383,7 @@ namespace Thunder
 	void shader_lang_state::add_struct_member(ast_node_type_format* type, const token_data& name, const token_data& modifier, const parse_location* loc)
 	{
 		TAssert(name.token_id == NEW_ID);
-		const auto variable = new ast_node_variable(type, name.text);
+		const auto variable = arena->create<ast_node_variable>(type, name.text);
 		if(type->is_semantic)
 		{
 			variable->semantic = modifier.text;
@@ -393,7 +403,7 @@ namespace Thunder
 	{
 		TAssert(current_function == nullptr);
 		TAssert(name.token_id == NEW_ID);
-		current_function = new ast_node_function(name.text);
+		current_function = arena->create<ast_node_function>(name.text);
 		current_function->set_return_type(type);
 		current_scope()->push_symbol(name.text, enum_symbol_type::function, current_function);
 		push_scope(current_function->begin_function(current_scope()));
@@ -417,7 +427,7 @@ namespace Thunder
 	void shader_lang_state::add_function_param(ast_node_type_format* type, const token_data& name, const token_data& modifier, const parse_location* loc)
 	{
 		TAssert(name.token_id == NEW_ID);
-		const auto variable = new ast_node_variable(type, name.text);
+		const auto variable = arena->create<ast_node_variable>(type, name.text);
 		if (modifier.token_id == TOKEN_SV)
 		{
 			type->is_semantic = true;
@@ -436,7 +446,7 @@ namespace Thunder
 
 	void shader_lang_state::parsing_block_begin()
 	{
-		auto* new_block = new ast_node_block;
+		auto* new_block = arena->create<ast_node_block>();
 		push_scope(new_block->begin_block(current_scope()));
 		block_stacks.push_back(new_block);
 	}
@@ -515,7 +525,7 @@ namespace Thunder
 
 	ast_node_type_format* shader_lang_state::create_basic_type_node(const token_data& type_info)
 	{
-		const auto node = new ast_node_type_format;
+		const auto node = arena->create<ast_node_type_format>();
 		String sub;
 		switch (type_info.token_id)
 		{
@@ -607,7 +617,7 @@ namespace Thunder
 
 	ast_node_type_format* shader_lang_state::create_object_type_node(const token_data& object)
 	{
-		const auto node = new ast_node_type_format();
+		const auto node = arena->create<ast_node_type_format>();
 		node->basic_type = enum_basic_type::tp_none;
 		node->object_type = parse_object_type_from_name(object.text);
 		TAssert(node->object_type != enum_object_type::none);
@@ -617,7 +627,7 @@ namespace Thunder
 	// Create an object type node with template parameters
 	ast_node_type_format* shader_lang_state::create_object_type_node(const token_data& object, const token_data& content)
 	{
-		ast_node_type_format* node = new ast_node_type_format();
+		ast_node_type_format* node = arena->create<ast_node_type_format>();
 		ast_node_type_format* content_node = create_basic_type_node(content);
 		node->packed_flags = content_node->packed_flags;
 		LOG("packed_flags: %d", node->packed_flags);
@@ -675,65 +685,65 @@ namespace Thunder
 		const dimensions& dim, ast_node_expression* expr)
 	{
 		TAssert(get_local_symbol(name.text) == nullptr);
-		const auto variable = new ast_node_variable(type, name.text);
+		const auto variable = arena->create<ast_node_variable>(type, name.text);
 		variable->dimension = dim;
 		current_scope()->push_symbol(name.text, enum_symbol_type::variable, variable);
-		const auto node = new variable_declaration_statement(variable, expr);
+		const auto node = arena->create<variable_declaration_statement>(variable, expr);
 		return node;
 	}
 
 	ast_node_statement* shader_lang_state::create_return_statement(ast_node_expression* expr)
 	{
-		return new return_statement(expr);
+		return arena->create<return_statement>(expr);
 	}
 
 	ast_node_statement* shader_lang_state::create_break_statement()
 	{
-		return new break_statement();
+		return arena->create<break_statement>();
 	}
 
 	ast_node_statement* shader_lang_state::create_continue_statement()
 	{
-		return new continue_statement();
+		return arena->create<continue_statement>();
 	}
 
 	ast_node_statement* shader_lang_state::create_discard_statement()
 	{
-		return new discard_statement();
+		return arena->create<discard_statement>();
 	}
 
 	ast_node_statement* shader_lang_state::create_expression_statement(ast_node_expression* expr)
 	{
-		return new expression_statement(expr);
+		return arena->create<expression_statement>(expr);
 	}
 
 	ast_node_statement* shader_lang_state::create_condition_statement(
 		ast_node_expression* cond, ast_node_statement* true_stmt, ast_node_statement* false_stmt)
 	{
-		return new condition_statement(cond, true_stmt, false_stmt);
+		return arena->create<condition_statement>(cond, true_stmt, false_stmt);
 	}
 
 	ast_node_statement* shader_lang_state::create_for_statement(
 		ast_node_statement* init, ast_node_expression* cond, ast_node_expression* update, ast_node_statement* body)
 	{
-		return new for_statement(init, cond, update, body);
+		return arena->create<for_statement>(init, cond, update, body);
 	}
 
 	ast_node_expression* shader_lang_state::create_function_call_expression(const token_data& func_name)
 	{
-		return new function_call_expression(func_name.text);
+		return arena->create<function_call_expression>(func_name.text);
 	}
 
 	ast_node_expression* shader_lang_state::create_method_call_expression(ast_node_expression* object, ast_node_expression* post_obj)
 	{
 		TAssert(post_obj != nullptr && post_obj->expr_type == enum_expr_type::function_call);
-		method_call_expression* method_exp = new method_call_expression(object, static_cast<function_call_expression*>(post_obj));
+		method_call_expression* method_exp = arena->create<method_call_expression>(object, static_cast<function_call_expression*>(post_obj));
 		return method_exp;
 	}
 
 	ast_node_expression* shader_lang_state::create_constructor_expression(ast_node_type_format* type)
 	{
-		return new constructor_expression(type);
+		return arena->create<constructor_expression>(type);
 	}
 
 	void shader_lang_state::append_argument(ast_node_expression* func_call_expr, ast_node_expression* arg_expr)
@@ -757,12 +767,12 @@ namespace Thunder
 
 	ast_node_expression* shader_lang_state::create_assignment_expression(ast_node_expression* lhs, ast_node_expression* rhs)
 	{
-		return new assignment_expression(lhs, rhs);
+		return arena->create<assignment_expression>(lhs, rhs);
 	}
 
 	ast_node_expression* shader_lang_state::create_conditional_expression(ast_node_expression* cond, ast_node_expression* true_expr, ast_node_expression* false_expr)
 	{
-		return new conditional_expression(cond, true_expr, false_expr);
+		return arena->create<conditional_expression>(cond, true_expr, false_expr);
 	}
 
 	ast_node_expression* shader_lang_state::create_chain_expression(ast_node_expression* prev, ast_node_expression* next)
@@ -775,7 +785,7 @@ namespace Thunder
 		}
 		else
 		{
-			chain_expr = new chain_expression(prev);
+			chain_expr = arena->create<chain_expression>(prev);
 			chain_expr->add_expression(next);
 			return chain_expr;
 		}
@@ -783,12 +793,12 @@ namespace Thunder
 
 	ast_node_expression* shader_lang_state::create_cast_expression(ast_node_type_format* target_type, ast_node_expression* operand)
 	{
-		return new cast_expression(target_type, operand);
+		return arena->create<cast_expression>(target_type, operand);
 	}
 
 	ast_node_expression* shader_lang_state::create_reference_expression(const token_data& name)
 	{
-		const auto ref_expr = new reference_expression(name.text, get_global_symbol(name.text));
+		const auto ref_expr = arena->create<reference_expression>(name.text, get_global_symbol(name.text));
 		if (current_archive->find_symbol(name.text))
 		{
 			current_pass->add_parameter(name.text);
@@ -799,7 +809,7 @@ namespace Thunder
 	ast_node_expression* shader_lang_state::create_binary_expression(
 		enum_binary_op op, ast_node_expression* left, ast_node_expression* right)
 	{
-		const auto node = new binary_expression;
+		const auto node = arena->create<binary_expression>();
 		node->op = op;
 		node->left = left;
 		node->right = right;
@@ -810,12 +820,12 @@ namespace Thunder
 
 	ast_node_expression* shader_lang_state::create_unary_expression(int op, ast_node_expression* operand)
 	{
-		return new unary_expression(static_cast<enum_unary_op>(op), operand);
+		return arena->create<unary_expression>(static_cast<enum_unary_op>(op), operand);
 	}
 
 	ast_node_expression* shader_lang_state::create_compound_assignment_expression(int op, ast_node_expression* lhs, ast_node_expression* rhs)
 	{
-		return new compound_assignment_expression(static_cast<enum_assignment_op>(op), lhs, rhs);
+		return arena->create<compound_assignment_expression>(static_cast<enum_assignment_op>(op), lhs, rhs);
 	}
 
 	ast_node_expression* shader_lang_state::create_shuffle_or_component_expression(
@@ -851,7 +861,7 @@ namespace Thunder
 
 		if (is_shuffle)
 		{
-			auto* prev = new shuffle_expression(expr, order);
+			auto* prev = arena->create<shuffle_expression>(expr, order);
 			return prev;
 		}
 		else
@@ -863,7 +873,7 @@ namespace Thunder
 				return nullptr;
 			}*/
 
-			const auto component = new component_expression(expr, comp.text);
+			const auto component = arena->create<component_expression>(expr, comp.text);
 			return component;
 		}
 	}
@@ -871,22 +881,22 @@ namespace Thunder
 	ast_node_expression* shader_lang_state::create_index_expression(ast_node_expression* expr,
 		ast_node_expression* index_expr)
 	{
-		return new index_expression(expr, index_expr);
+		return arena->create<index_expression>(expr, index_expr);
 	}
 
 	ast_node_expression* shader_lang_state::create_constant_int_expression(int value)
 	{
-		return new constant_int_expression(value);
+		return arena->create<constant_int_expression>(value);
 	}
 
 	ast_node_expression* shader_lang_state::create_constant_float_expression(float value)
 	{
-		return new constant_float_expression(value);
+		return arena->create<constant_float_expression>(value);
 	}
 
 	ast_node_expression* shader_lang_state::create_constant_bool_expression(bool value)
 	{
-		return new constant_bool_expression(value);
+		return arena->create<constant_bool_expression>(value);
 	}
 
 	//todo locating file
@@ -920,7 +930,7 @@ namespace Thunder
 	{
 		if (ast_root == nullptr)
 		{
-			output_parse_error_log("Parse Error, current text : " + sl_state->current_text);
+			output_parse_error_log("Parse Error, current text : " + current_text);
 			return;
 		}
 		printf("\n");
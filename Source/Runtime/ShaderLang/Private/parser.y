@@ -12,9 +12,9 @@ extern void lexer_constructor(struct shader_lang_state *state, const char* text)
 extern void lexer_lexer_dtor(struct shader_lang_state *state);
 extern int yyparse(struct shader_lang_state *state);
 
-shader_lang_state* ThunderParse(const char* text);
+bool ThunderParse(shader_lang_state* state, const char* text);
 
-#define YYLEX_PARAM sl_state->scanner
+#define YYLEX_PARAM state->scanner
 #define YYLTYPE parse_location
 #define YYSTYPE parse_node
 #define YYLLOC_DEFAULT(Current, Rhs, N)                                \
@@ -56,7 +56,7 @@ int yylex(YYSTYPE *, parse_location*, void*);
    @$.last_source = 0;
 }
 
-%lex-param			{ void* sl_state->scanner }
+%lex-param			{ void* scanner }
 %parse-param		{ struct shader_lang_state *state }
 
 
@@ -134,7 +134,7 @@ int yylex(YYSTYPE *, parse_location*, void*);
 %%
 
 program:
-    archive_definition { sl_state->ast_root = $1; }
+    archive_definition { state->ast_root = $1; }
     ;
 
 identifier:
@@ -166,12 +166,12 @@ array_dimensions:
 |	LBRACKET expression RBRACKET
 		{
 			$$ = dimensions{};
-            $$.add_dimension(sl_state->evaluate_integer_expression($2, @2));
+            $$.add_dimension(state->evaluate_integer_expression($2, @2));
 		}
 |	array_dimensions LBRACKET expression RBRACKET
 		{
 			$$ = $1;
-            $$.add_dimension(sl_state->evaluate_integer_expression($3, @3));
+            $$.add_dimension(state->evaluate_integer_expression($3, @3));
 		}
 ;
 
@@ -204,10 +204,10 @@ COLON TOKEN_SV
 
 archive_definition:
     TOKEN_SHADER STRING_CONSTANT LBRACE {
-        sl_state->parsing_archive_begin($2);
+        state->parsing_archive_begin($2);
     }
     definitions passes RBRACE {
-        $$ = sl_state->parsing_archive_end($6);
+        $$ = state->parsing_archive_end($6);
     }
     ;
 
@@ -227,13 +227,13 @@ properties_definition:
 
 variable:
     type new_identifier SEMICOLON {
-        sl_state->add_variable_to_list($1, $2, nullptr);
+        state->add_variable_to_list($1, $2, nullptr);
     }
     | type new_identifier ASSIGN assignment_expr SEMICOLON {
-        sl_state->add_variable_to_list($1, $2, $4);
+        state->add_variable_to_list($1, $2, $4);
     }
     | type new_identifier ASSIGN LBRACE expression RBRACE SEMICOLON {
-        sl_state->add_variable_to_list($1, $2, $5);
+        state->add_variable_to_list($1, $2, $5);
     }
     ;
 
@@ -245,14 +245,14 @@ variable_list:
 variants_definition:
     TOKEN_VARIANTS LBRACE variable_list RBRACE {
         token_data data;
-        sl_state->parsing_variable_end($1, data);
+        state->parsing_variable_end($1, data);
         $$ = nullptr;
     }
     ;
 
 parameters_definition:
     TOKEN_PARAMETERS STRING_CONSTANT LBRACE variable_list RBRACE {
-        sl_state->parsing_variable_end($1, $2);
+        state->parsing_variable_end($1, $2);
         $$ = nullptr;
     }
     ;
@@ -264,10 +264,10 @@ passes:
 
 pass_definition:
     TOKEN_SUBSHADER STRING_CONSTANT LBRACE {
-        sl_state->parsing_pass_begin($2);
+        state->parsing_pass_begin($2);
     }
     pass_content RBRACE{
-        $$ = sl_state->parsing_pass_end();
+        $$ = state->parsing_pass_end();
     }
     ;
 
@@ -275,18 +275,18 @@ pass_content:
     stage_definition
     | attributes_definition
     | struct_definition {
-        sl_state->add_definition_member($1);
+        state->add_definition_member($1);
     }
     | function_definition {
-        sl_state->add_definition_member($1);
+        state->add_definition_member($1);
     }
     | pass_content stage_definition
     | pass_content attributes_definition
     | pass_content struct_definition {
-        sl_state->add_definition_member($2);
+        state->add_definition_member($2);
     }
     | pass_content function_definition {
-        sl_state->add_definition_member($2);
+        state->add_definition_member($2);
     }
     ;
 
@@ -301,13 +301,13 @@ attribute_list:
 
 attribute_entry:
     TOKEN_MESHDRAWTYPE COLON STRING_CONSTANT {
-        sl_state->add_attribute_entry($1, $3);
+        state->add_attribute_entry($1, $3);
     }
     | TOKEN_DEPTHTEST COLON STRING_CONSTANT {
-        sl_state->add_attribute_entry($1, $3);
+        state->add_attribute_entry($1, $3);
     }
     | TOKEN_BLENDMODE COLON STRING_CONSTANT {
-        sl_state->add_attribute_entry($1, $3);
+        state->add_attribute_entry($1, $3);
     }
     ;
 
@@ -322,17 +322,17 @@ stage_token:
 
 stage_definition:
     TOKEN_USING stage_token ASSIGN primary_identifier SEMICOLON {
-        sl_state->add_stage_entry($2, $4);
+        state->add_stage_entry($2, $4);
         $$ = nullptr;
     }
     ;
 
 struct_definition:
     TOKEN_STRUCT new_identifier LBRACE {
-        sl_state->parsing_struct_begin($2);
+        state->parsing_struct_begin($2);
     }
     struct_members RBRACE SEMICOLON {
-        $$ = sl_state->parsing_struct_end();
+        $$ = state->parsing_struct_end();
     }
     ;
 
@@ -343,21 +343,21 @@ struct_members:
 
 struct_member:
     type new_identifier SEMICOLON {
-        sl_state->add_struct_member($1, $2, $3, &yylloc);
+        state->add_struct_member($1, $2, $3, &yylloc);
     }
     ;
 |    type new_identifier semantic_postfix SEMICOLON {
-        sl_state->apply_modifier($1, $3);
-        sl_state->add_struct_member($1, $2, $3, &yylloc);
+        state->apply_modifier($1, $3);
+        state->add_struct_member($1, $2, $3, &yylloc);
     }
     ;
 
 function_definition:
     type new_identifier LPAREN {
-        sl_state->parsing_function_begin($1, $2);
+        state->parsing_function_begin($1, $2);
     }
     param_list RPAREN maybe_semantic_postfix function_body {
-        $$ = sl_state->parsing_function_end($7, $8);
+        $$ = state->parsing_function_end($7, $8);
     }
     ;
 
@@ -371,8 +371,8 @@ param_list:
 
 param:
     maybe_type_qualifications type new_identifier maybe_semantic_postfix{
-        sl_state->combine_modifier($2,$1);
-        sl_state->add_function_param($2, $3, $4, &yylloc);
+        state->combine_modifier($2,$1);
+        state->add_function_param($2, $3, $4, &yylloc);
     }
     ;
 
@@ -386,22 +386,22 @@ primitive_types:
 
 type:
     primitive_types {
-        $$ = sl_state->create_basic_type_node($1);
+        $$ = state->create_basic_type_node($1);
     }
     | TYPE_SAMPLER {
-        $$ = sl_state->create_basic_type_node($1);
+        $$ = state->create_basic_type_node($1);
     }
     | TYPE_OBJECT {
-        $$ = sl_state->create_object_type_node($1);
+        $$ = state->create_object_type_node($1);
     }
     | TYPE_OBJECT LT primitive_types GT {
-        $$ = sl_state->create_object_type_node($1, $3);
+        $$ = state->create_object_type_node($1, $3);
     }
     | TYPE_OBJECT LT type_identifier GT {
-        $$ = sl_state->create_object_type_node($1, $3);
+        $$ = state->create_object_type_node($1, $3);
     }
     | type_identifier {
-        $$ = sl_state->create_basic_type_node($1);
+        $$ = state->create_basic_type_node($1);
     }
     ;
 
@@ -416,18 +416,18 @@ type_qualification:
 type_qualifications:
 	type_qualification
     {
-        $$ = new ast_node_type_format();
-        sl_state->apply_modifier($$, $1);
+        $$ = state->arena->create<ast_node_type_format>();
+        state->apply_modifier($$, $1);
     }
     | type_qualifications type_qualification
     {
-        sl_state->apply_modifier($$ = $1, $2);
+        state->apply_modifier($$ = $1, $2);
     }
     ;
 
 maybe_type_qualifications:
     {
-        $$ = new ast_node_type_format();
+        $$ = state->arena->create<ast_node_type_format>();
     }
     | type_qualifications
     {
@@ -468,7 +468,7 @@ function_body:
 block_begin:
 	LBRACE
     {
-        sl_state->parsing_block_begin();
+        state->parsing_block_begin();
     }
     ;
 
@@ -479,22 +479,22 @@ block_end:
 block:
     block_begin block_end
     {
-        $$ = sl_state->parsing_block_end();
+        $$ = state->parsing_block_end();
     }
     | block_begin block_statements block_end
     {
-        $$ = sl_state->parsing_block_end();
+        $$ = state->parsing_block_end();
     }
     ;
 
 block_statements:
     statement 
     {
-        sl_state->add_block_statement($1, &yylloc);
+        state->add_block_statement($1, &yylloc);
     }
     | block_statements statement
     {
-        sl_state->add_block_statement($2, &yylloc);
+        state->add_block_statement($2, &yylloc);
     }
 
 statement:
@@ -510,25 +510,25 @@ statement:
 declaration_statement:
     variable_type primary_identifier maybe_array local_variable_initializer SEMICOLON
     {
-        $$ = sl_state->create_declaration_statement($1, $2, $3, $4);
+        $$ = state->create_declaration_statement($1, $2, $3, $4);
     }
     ;
 
 jump_statement:
     TOKEN_RETURN expression SEMICOLON {
-        $$ = sl_state->create_return_statement($2);
+        $$ = state->create_return_statement($2);
     }
     | TOKEN_RETURN SEMICOLON {
-        $$ = sl_state->create_return_statement(nullptr);
+        $$ = state->create_return_statement(nullptr);
     }
     | TOKEN_BREAK SEMICOLON {
-        $$ = sl_state->create_break_statement();
+        $$ = state->create_break_statement();
     }
     | TOKEN_CONTINUE SEMICOLON {
-        $$ = sl_state->create_continue_statement();
+        $$ = state->create_continue_statement();
     }
     | TOKEN_DISCARD SEMICOLON {
-        $$ = sl_state->create_discard_statement();
+        $$ = state->create_discard_statement();
     }
     ;
 
@@ -542,7 +542,7 @@ empty_statement:
 expression_statement:
 	expression SEMICOLON
     {
-        $$ = sl_state->create_expression_statement($1);
+        $$ = state->create_expression_statement($1);
     }
     ;
 
@@ -553,21 +553,21 @@ if_head:
 if_then_statement:
 	if_head LPAREN expression RPAREN statement %prec LOWER_THAN_ELSE
     {
-        $$ = sl_state->create_condition_statement($3, $5, nullptr);
+        $$ = state->create_condition_statement($3, $5, nullptr);
     }
 ;
 
 if_then_else_statement:
     if_head LPAREN expression RPAREN statement TOKEN_ELSE statement
     {
-        $$ = sl_state->create_condition_statement($3, $5, $7);
+        $$ = state->create_condition_statement($3, $5, $7);
     }
     ;
 
 for_statement:
 	TOKEN_FOR LPAREN for_init_statement maybe_condition SEMICOLON maybe_expression RPAREN statement
     {
-        $$ = sl_state->create_for_statement($3, $4, $6, $8);
+        $$ = state->create_for_statement($3, $4, $6, $8);
     }
     ;
 
@@ -607,7 +607,7 @@ expression:
     assignment_expr
     | expression COMMA assignment_expr
     {
-        $$ = sl_state->create_chain_expression($1, $3);
+        $$ = state->create_chain_expression($1, $3);
     }
     ;
 
@@ -615,7 +615,7 @@ assignment_expr:
     conditional_expr
     | unary_expr assignment_operator assignment_expr
     {
-        $$ = sl_state->create_compound_assignment_expression($2, $1, $3);
+        $$ = state->create_compound_assignment_expression($2, $1, $3);
     }
     ;
 
@@ -623,7 +623,7 @@ conditional_expr:
     logical_or_expr
     | logical_or_expr QUESTION expression COLON assignment_expr
     {
-        $$ = sl_state->create_conditional_expression($1, $3, $5);
+        $$ = state->create_conditional_expression($1, $3, $5);
     }
     ;
 
@@ -634,7 +634,7 @@ logical_or_expr:
     }
     | logical_or_expr OR logical_and_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::logical_or, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::logical_or, $1, $3);
     }
     ;
 
@@ -645,7 +645,7 @@ logical_and_expr:
     }
     | logical_and_expr AND inclusive_or_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::logical_and, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::logical_and, $1, $3);
     }
     ;
 
@@ -656,7 +656,7 @@ inclusive_or_expr:
     }
     | inclusive_or_expr BITOR exclusive_or_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::bit_or, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::bit_or, $1, $3);
     }
     ;
 
@@ -667,7 +667,7 @@ exclusive_or_expr:
     }
     | exclusive_or_expr BITXOR and_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::bit_xor, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::bit_xor, $1, $3);
     }
     ;
 
@@ -678,7 +678,7 @@ and_expr:
     }
     | and_expr BITAND equality_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::bit_and, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::bit_and, $1, $3);
     }
     ;
 
@@ -689,11 +689,11 @@ equality_expr:
     }
     | equality_expr EQ relational_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::equal, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::equal, $1, $3);
     }
     | equality_expr NE relational_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::not_equal, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::not_equal, $1, $3);
     }
     ;
 
@@ -704,19 +704,19 @@ relational_expr:
     }
     | relational_expr LT shift_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::less, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::less, $1, $3);
     }
     | relational_expr LE shift_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::less_equal, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::less_equal, $1, $3);
     }
     | relational_expr GT shift_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::greater, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::greater, $1, $3);
     }
     | relational_expr GE shift_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::greater_equal, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::greater_equal, $1, $3);
     }
     ;
 
@@ -727,11 +727,11 @@ shift_expr:
     }
     | shift_expr LSHIFT additive_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::left_shift, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::left_shift, $1, $3);
     }
     | shift_expr RSHIFT additive_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::right_shift, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::right_shift, $1, $3);
     }
     ;
 
@@ -742,11 +742,11 @@ additive_expr:
     }
     | additive_expr ADD multiplicative_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::add, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::add, $1, $3);
     }
     | additive_expr SUB multiplicative_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::sub, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::sub, $1, $3);
     }
     ;
 
@@ -757,22 +757,22 @@ multiplicative_expr:
     }
     | multiplicative_expr MUL unary_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::mul, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::mul, $1, $3);
     }
     | multiplicative_expr DIV unary_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::div, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::div, $1, $3);
     }
     | multiplicative_expr MOD unary_expr
     {
-        $$ = sl_state->create_binary_expression(enum_binary_op::mod, $1, $3);
+        $$ = state->create_binary_expression(enum_binary_op::mod, $1, $3);
     }
     ;
 
 primary_expr:
     primary_identifier
     {
-        $$ = sl_state->create_reference_expression($1);
+        $$ = state->create_reference_expression($1);
     }
     | constant_expr
     {
@@ -789,19 +789,19 @@ primary_expr:
 constant_expr:
     TOKEN_INTEGER
     {
-        $$ = new constant_int_expression(std::stoi($1.text));
+        $$ = state->arena->create<constant_int_expression>(std::stoi($1.text));
     }
     | TOKEN_FLOAT
     {
-        $$ = new constant_float_expression(std::stof($1.text));
+        $$ = state->arena->create<constant_float_expression>(std::stof($1.text));
     }
     | TOKEN_TRUE
     {
-        $$ = new constant_bool_expression(true);
+        $$ = state->arena->create<constant_bool_expression>(true);
     }
     | TOKEN_FALSE
     {
-        $$ = new constant_bool_expression(false);
+        $$ = state->arena->create<constant_bool_expression>(false);
     }
     ;
 
@@ -886,11 +886,11 @@ unary_expr:
     }
     | unary_operator unary_expr
     {
-        $$ = sl_state->create_unary_expression($1, $2);
+        $$ = state->create_unary_expression($1, $2);
     }
     | LPAREN type RPAREN unary_expr
     {
-        $$ = sl_state->create_cast_expression($2, $4);
+        $$ = state->create_cast_expression($2, $4);
     }
     ;
 
@@ -902,19 +902,19 @@ postfix_expr:
     }
     | postfix_expr '.' primary_identifier
     {
-        $$ = sl_state->create_shuffle_or_component_expression($1, $3);
+        $$ = state->create_shuffle_or_component_expression($1, $3);
     }
     | postfix_expr INC
     {
-        $$ = sl_state->create_unary_expression(static_cast<int>(enum_unary_op::post_inc), $1);
+        $$ = state->create_unary_expression(static_cast<int>(enum_unary_op::post_inc), $1);
     }
     | postfix_expr DEC
     {
-        $$ = sl_state->create_unary_expression(static_cast<int>(enum_unary_op::post_dec), $1);
+        $$ = state->create_unary_expression(static_cast<int>(enum_unary_op::post_dec), $1);
     }
     | postfix_expr LBRACKET expression RBRACKET
     {
-        $$ = sl_state->create_index_expression($1, $3);
+        $$ = state->create_index_expression($1, $3);
     }
     | function_call
     {
@@ -922,18 +922,18 @@ postfix_expr:
     }
     | postfix_expr '.' function_call
     {
-        $$ = sl_state->create_method_call_expression($1, $3);
+        $$ = state->create_method_call_expression($1, $3);
     }
     ;
 
 function_call_header:
     type LPAREN
     {
-        $$ = sl_state->create_constructor_expression($1);
+        $$ = state->create_constructor_expression($1);
     }
     | primary_identifier LPAREN
     {
-        $$ = sl_state->create_function_call_expression($1);
+        $$ = state->create_function_call_expression($1);
     }
     ;
 
@@ -969,17 +969,14 @@ void yyerror(parse_location *loc, shader_lang_state* st, const char* msg){
     printf("ERROR: %s\n",msg);
 }
 
-shader_lang_state* ThunderParse(const char* text)
+// Parses one archive into the given state, which carries everything the scanner and the grammar actions touch, so
+// separate states can parse concurrently. The caller owns the returned AST.
+bool ThunderParse(shader_lang_state* state, const char* text)
 {
     //yydebug = 1;
-    if (sl_state == nullptr)
-    {
-        sl_state = new shader_lang_state();
-    }
-
-    lexer_constructor(sl_state, text);
-    yyparse(sl_state);
-    //sl_state->post_process_ast();
-	lexer_lexer_dtor(sl_state);
-    return sl_state;
-}
\ No newline at end of file
+    lexer_constructor(state, text);
+    const int result = yyparse(state);
+    //state->post_process_ast();
+    lexer_lexer_dtor(state);
+    return result == 0 && state->ast_root != nullptr;
+}
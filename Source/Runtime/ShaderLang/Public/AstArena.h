@@ -0,0 +1,61 @@
+#pragma once
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "Platform.h"
+
+namespace Thunder
+{
+    /**
+     * Bump allocator owning every node of one archive's AST. Nodes are never freed one by one: destroying the arena
+     * runs the destructors of what it created, newest first, then releases its blocks in one go.
+     * Not thread-safe, an arena is filled by a single parse.
+     */
+    class SHADERLANG_API ast_arena
+    {
+    public:
+        ast_arena() = default;
+        ~ast_arena();
+        ast_arena(const ast_arena&) = delete;
+        ast_arena& operator=(const ast_arena&) = delete;
+
+        template<typename T, typename... Args>
+        T* create(Args&&... args)
+        {
+            T* object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+            if constexpr (!std::is_trivially_destructible_v<T>)
+            {
+                auto* entry = new (allocate(sizeof(destructor_entry), alignof(destructor_entry))) destructor_entry;
+                entry->destroy = [](void* ptr) { static_cast<T*>(ptr)->~T(); };
+                entry->object = object;
+                entry->next = destructors;
+                destructors = entry;
+            }
+            return object;
+        }
+
+        void* allocate(size_t size, size_t alignment);
+        _NODISCARD_ size_t get_allocated_bytes() const noexcept { return allocated_bytes; }
+
+    private:
+        struct block
+        {
+            block* next;
+            size_t size; // Usable bytes after the header.
+        };
+        struct destructor_entry
+        {
+            void (*destroy)(void*);
+            void* object;
+            destructor_entry* next;
+        };
+
+        static constexpr size_t block_size = 64 * 1024;
+
+        block* blocks = nullptr;
+        uint8* cursor = nullptr;
+        uint8* end = nullptr;
+        destructor_entry* destructors = nullptr;
+        size_t allocated_bytes = 0;
+    };
+}
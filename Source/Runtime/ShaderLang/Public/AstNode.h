@@ -1,7 +1,9 @@
 #pragma once
 #include "Assertion.h"
+#include "AstArena.h"
 #include "Container.h"
 #include "NameHandle.h"
+#include "Concurrent/Lock.h"
 #include "Templates/RefCounting.h"
 
 namespace Thunder
@@ -15,6 +17,7 @@ namespace Thunder
         enum_shader_stage stage;
         TArray<class ast_node*> custom_types;
         THashMap<NameHandle, bool> variants;
+        uint32 variant_reads = 0; // Variant values consulted so far, output emitted without any is the same for every mask.
     };
 
     enum class enum_ast_node_type : uint8
@@ -477,10 +480,24 @@ namespace Thunder
         }
         void reflect_pass_cb_parameters();
 
+        // Emits the variant independent parts of a sub-shader from a cache built by its first generation, only the
+        // functions whose output depends on variants are generated again. Thread-safe.
         void generate_hlsl(String& outResult, shader_codegen_state& state) override;
         void print_ast(int indent) override;
 
     private:
+        struct codegen_segment
+        {
+            String text; // Fixed output preceding the function.
+            class ast_node_function* function = nullptr; // Re-emitted for every variant, null for the last segment.
+        };
+        struct codegen_cache
+        {
+            TArray<codegen_segment> segments;
+            size_t output_size = 0; // Size of the first output, reserved up front.
+        };
+        void generate_sub_shader(String& outResult, shader_codegen_state& state, codegen_cache& cache);
+
         friend class ShaderAST;
         String name;
         scope_ref global_scope;
@@ -490,6 +507,9 @@ namespace Thunder
         TMap<String, TArray<ast_node_variable*>> pass_cb_parameters;
         TArray<ast_node_variable*> sampler_parameters;
         TArray<ast_node_pass*> passes;
+
+        SharedLock codegen_lock;
+        THashMap<NameHandle, codegen_cache> codegen_caches; // By sub-shader name.
     };
 
     class ast_node_pass : public ast_node
@@ -527,6 +547,7 @@ namespace Thunder
         void print_ast(int indent) override;
     private:
         friend class ShaderAST;
+        friend class ast_node_archive;
         String name;
         shader_attributes attributes;
         THashMap<enum class enum_shader_stage, String> stage_entries;
@@ -1073,5 +1094,5 @@ namespace Thunder
     //////////////////////////////////////////////////////////////////////////
     // Tokenize
 
-    int tokenize(token_data& t, const parse_location* loc, const char* text, int text_len, int token);
+    int tokenize(struct shader_lang_state* state, token_data& t, const parse_location* loc, const char* text, int text_len, int token);
 }
@@ -0,0 +1,45 @@
+﻿#pragma once
+#include <atomic>
+#include <filesystem>
+#include "Container.h"
+#include "Concurrent/Lock.h"
+#include "Templates/RefCounting.h"
+#include "Templates/RefCountObject.h"
+
+namespace Thunder
+{
+	// One version of a shader header, never modified once cached: a newer version replaces the entry instead.
+	struct ShaderIncludeFile : public RefCountedObject
+	{
+		String Path;
+		String Contents;
+		TArray<String> Lines; // Contents split after each '\n', the unit the preprocessor's lexer reads.
+		std::filesystem::file_time_type ModifiedTime;
+	};
+	using ShaderIncludeFileRef = TRefCountPtr<ShaderIncludeFile>;
+
+	/**
+	 * Process-wide cache of the headers included by shader archives, shared by the preprocessor and the compiler include
+	 * handlers. Entries are keyed by normalized path and read again when the file's modification time changes.
+	 * Thread-safe, files are read outside the lock.
+	 */
+	class ShaderIncludeCache
+	{
+	public:
+		SHADERLANG_API static ShaderIncludeCache& Get();
+
+		// Null when the file can't be read. The entry stays valid for as long as the reference is held.
+		SHADERLANG_API ShaderIncludeFileRef Find(const String& path);
+		SHADERLANG_API void Clear();
+
+		_NODISCARD_ uint64 GetNumHits() const { return NumHits.load(std::memory_order_relaxed); }
+		_NODISCARD_ uint64 GetNumMisses() const { return NumMisses.load(std::memory_order_relaxed); }
+
+	private:
+		SharedLock FilesLock;
+		THashMap<String, ShaderIncludeFileRef> Files;
+
+		std::atomic<uint64> NumHits { 0 };
+		std::atomic<uint64> NumMisses { 0 };
+	};
+}
@@ -62,6 +62,9 @@ namespace Thunder
 		// Abstract Syntax Tree
 		String shader_name;
 		ast_node* ast_root = nullptr;
+		ast_arena* arena = nullptr; // Owns every node of ast_root until it is released.
+		// Hands the nodes over to the caller, the state starts a new arena for its next parse.
+		ast_arena* release_arena();
 		
 		TArray<scope*> symbol_scopes;
 
@@ -161,5 +164,4 @@ namespace Thunder
 		void post_process_ast() const;
 
 	};
-	extern shader_lang_state* sl_state;
 }